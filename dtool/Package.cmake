@@ -96,6 +96,7 @@ if(THIRDPARTY_DIRECTORY)
     HarfBuzz
     JPEG
     LibSquish
+    LZ4
     ODE
     Ogg
     OpenAL
@@ -109,6 +110,7 @@ if(THIRDPARTY_DIRECTORY)
     VorbisFile
     VRPN
     ZLIB
+    Zstd
   )
 
     string(TOLOWER "${_Package}" _package)
@@ -367,6 +369,26 @@ package_option(ZLIB
 
 package_status(ZLIB "zlib")
 
+# Zstandard
+find_package(Zstd MODULE QUIET)
+
+package_option(Zstd
+  "Enables support for compression of Panda assets with Zstandard, which
+compresses as well as zlib while decompressing considerably faster."
+  IMPORTED_AS zstd::libzstd_shared zstd::libzstd_static)
+
+package_status(Zstd "Zstandard")
+
+# LZ4
+find_package(LZ4 MODULE QUIET)
+
+package_option(LZ4
+  "Enables support for compression of Panda assets with LZ4, which
+decompresses several times faster than zlib."
+  IMPORTED_AS LZ4::lz4_shared LZ4::lz4_static)
+
+package_status(LZ4 "LZ4")
+
 
 #
 # ------------ Image formats ------------
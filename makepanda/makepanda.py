@@ -86,6 +86,7 @@ PkgListSet(["PYTHON", "DIRECT",                        # Python support
   "ODE", "BULLET", "PANDAPHYSICS",                     # Physics
   "SPEEDTREE",                                         # SpeedTree
   "ZLIB", "PNG", "JPEG", "TIFF", "OPENEXR", "SQUISH",  # 2D Formats support
+  "ZSTD", "LZ4",                                       # Fast compression
   "FCOLLADA", "ASSIMP", "EGG",                         # 3D Formats support
   "FREETYPE", "HARFBUZZ",                              # Text rendering
   "VRPN", "OPENSSL",                                   # Transport
@@ -698,6 +699,8 @@ if (COMPILER == "MSVC"):
         IncDirectory("OPENEXR", GetThirdpartyDir() + "openexr/include/Imath")
     if (PkgSkip("JPEG")==0):     LibName("JPEG",     GetThirdpartyDir() + "jpeg/lib/jpeg-static.lib")
     if (PkgSkip("ZLIB")==0):     LibName("ZLIB",     GetThirdpartyDir() + "zlib/lib/zlibstatic.lib")
+    if (PkgSkip("ZSTD")==0):     LibName("ZSTD",     GetThirdpartyDir() + "zstd/lib/zstd_static.lib")
+    if (PkgSkip("LZ4")==0):      LibName("LZ4",      GetThirdpartyDir() + "lz4/lib/lz4_static.lib")
     if (PkgSkip("VRPN")==0):     LibName("VRPN",     GetThirdpartyDir() + "vrpn/lib/vrpn.lib")
     if (PkgSkip("VRPN")==0):     LibName("VRPN",     GetThirdpartyDir() + "vrpn/lib/quat.lib")
     if (PkgSkip("NVIDIACG")==0): LibName("CGGL",     GetThirdpartyDir() + "nvidiacg/lib/cgGL.lib")
@@ -850,6 +853,8 @@ if (COMPILER=="GCC"):
     SmartPkgEnable("VRPN",      "",          ("vrpn", "quat"), ("vrpn", "quat.h", "vrpn/vrpn_Types.h"))
     SmartPkgEnable("OPUS",      "opusfile",  ("opusfile", "opus", "ogg"), ("ogg/ogg.h", "opus/opusfile.h", "opus"))
     SmartPkgEnable("JPEG",      "",          ("jpeg"), "jpeglib.h")
+    SmartPkgEnable("ZSTD",      "libzstd",   ("zstd"), "zstd.h")
+    SmartPkgEnable("LZ4",       "liblz4",    ("lz4"), "lz4frame.h")
     SmartPkgEnable("MIMALLOC",  "",          ("mimalloc"), "mimalloc.h")
 
     if GetTarget() != 'emscripten':
@@ -964,6 +969,12 @@ if (COMPILER=="GCC"):
             LibName("OPUS", "-Wl,--exclude-libs,libopus.a")
             LibName("OPUS", "-Wl,--exclude-libs,libopusfile.a")
 
+        if not PkgSkip("ZSTD"):
+            LibName("ZSTD", "-Wl,--exclude-libs,libzstd.a")
+
+        if not PkgSkip("LZ4"):
+            LibName("LZ4", "-Wl,--exclude-libs,liblz4.a")
+
         if not PkgSkip("VRPN"):
             LibName("VRPN", "-Wl,--exclude-libs,libvrpn.a")
             LibName("VRPN", "-Wl,--exclude-libs,libquat.a")
@@ -3581,7 +3592,13 @@ TargetAdd('p3pandabase_pandabase.obj', opts=OPTS, input='pandabase.cxx')
 # DIRECTORY: panda/src/express/
 #
 
-OPTS=['DIR:panda/src/express', 'BUILDING:PANDAEXPRESS', 'OPENSSL', 'ZLIB']
+if not PkgSkip("ZSTD"):
+    DefSymbol("ZSTD", "HAVE_ZSTD")
+
+if not PkgSkip("LZ4"):
+    DefSymbol("LZ4", "HAVE_LZ4")
+
+OPTS=['DIR:panda/src/express', 'BUILDING:PANDAEXPRESS', 'OPENSSL', 'ZLIB', 'ZSTD', 'LZ4']
 TargetAdd('p3express_composite1.obj', opts=OPTS, input='p3express_composite1.cxx')
 TargetAdd('p3express_composite2.obj', opts=OPTS, input='p3express_composite2.cxx')
 
@@ -3617,7 +3634,7 @@ TargetAdd('libpandaexpress.dll', input='p3express_composite1.obj')
 TargetAdd('libpandaexpress.dll', input='p3express_composite2.obj')
 TargetAdd('libpandaexpress.dll', input='p3pandabase_pandabase.obj')
 TargetAdd('libpandaexpress.dll', input=COMMON_DTOOL_LIBS)
-TargetAdd('libpandaexpress.dll', opts=['ADVAPI', 'WINSOCK2', 'OPENSSL', 'ZLIB', 'WINGDI', 'WINUSER', 'ANDROID'])
+TargetAdd('libpandaexpress.dll', opts=['ADVAPI', 'WINSOCK2', 'OPENSSL', 'ZLIB', 'ZSTD', 'LZ4', 'WINGDI', 'WINUSER', 'ANDROID'])
 
 #
 # DIRECTORY: panda/src/pipeline/
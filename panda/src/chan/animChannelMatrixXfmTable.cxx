@@ -23,14 +23,18 @@
 #include "bamWriter.h"
 #include "fftCompressor.h"
 #include "config_linmath.h"
+#include "lightMutexHolder.h"
 
 TypeHandle AnimChannelMatrixXfmTable::_type_handle;
+LightMutex AnimChannelMatrixXfmTable::_matrices_lock("AnimChannelMatrixXfmTable::_matrices_lock");
 
 /**
  * Used only for bam loader.
  */
 AnimChannelMatrixXfmTable::
-AnimChannelMatrixXfmTable() {
+AnimChannelMatrixXfmTable() :
+  _matrices_state(MS_unknown)
+{
   for (int i = 0; i < num_matrix_components; i++) {
     _tables[i] = CPTA_stdfloat(get_class_type());
   }
@@ -43,10 +47,12 @@ AnimChannelMatrixXfmTable() {
  */
 AnimChannelMatrixXfmTable::
 AnimChannelMatrixXfmTable(AnimGroup *parent, const AnimChannelMatrixXfmTable &copy) :
-  AnimChannelMatrix(parent, copy)
+  AnimChannelMatrix(parent, copy),
+  _matrices_state(MS_unknown)
 {
   for (int i = 0; i < num_matrix_components; i++) {
     _tables[i] = copy._tables[i];
+    _compressed[i] = copy._compressed[i];
   }
 }
 
@@ -55,7 +61,8 @@ AnimChannelMatrixXfmTable(AnimGroup *parent, const AnimChannelMatrixXfmTable &co
  */
 AnimChannelMatrixXfmTable::
 AnimChannelMatrixXfmTable(AnimGroup *parent, const std::string &name)
-  : AnimChannelMatrix(parent, name)
+  : AnimChannelMatrix(parent, name),
+  _matrices_state(MS_unknown)
 {
   for (int i = 0; i < num_matrix_components; i++) {
     _tables[i] = CPTA_stdfloat(get_class_type());
@@ -80,7 +87,12 @@ has_changed(int last_frame, double last_frac,
             int this_frame, double this_frac) {
   if (last_frame != this_frame) {
     for (int i = 0; i < num_matrix_components; i++) {
-      if (_tables[i].size() > 1) {
+      if (_compressed[i] != nullptr) {
+        if (_compressed[i]->get_value(last_frame) !=
+            _compressed[i]->get_value(this_frame)) {
+          return true;
+        }
+      } else if (_tables[i].size() > 1) {
         if (_tables[i][last_frame % _tables[i].size()] !=
             _tables[i][this_frame % _tables[i].size()]) {
           return true;
@@ -93,7 +105,12 @@ has_changed(int last_frame, double last_frac,
     // If we have some fractional changes, also check the next subsequent
     // frame (since we'll be blending with that).
     for (int i = 0; i < num_matrix_components; i++) {
-      if (_tables[i].size() > 1) {
+      if (_compressed[i] != nullptr) {
+        if (_compressed[i]->get_value(last_frame) !=
+            _compressed[i]->get_value(this_frame + 1)) {
+          return true;
+        }
+      } else if (_tables[i].size() > 1) {
         if (_tables[i][last_frame % _tables[i].size()] !=
             _tables[i][(this_frame + 1) % _tables[i].size()]) {
           return true;
@@ -110,19 +127,86 @@ has_changed(int last_frame, double last_frac,
  */
 void AnimChannelMatrixXfmTable::
 get_value(int frame, LMatrix4 &mat) {
+  int state = _matrices_state.load(std::memory_order_acquire);
+  if (state == MS_unknown && cache_anim_matrices) {
+    state = cache_matrices() ? MS_cached : MS_not_cached;
+  }
+  if (state == MS_cached) {
+    mat = _matrices[frame % _matrices.size()];
+    return;
+  }
+
   PN_stdfloat components[num_matrix_components];
 
   for (int i = 0; i < num_matrix_components; i++) {
-    if (_tables[i].empty()) {
-      components[i] = get_default_value(i);
-    } else {
-      components[i] = _tables[i][frame % _tables[i].size()];
-    }
+    components[i] = get_component(i, frame);
   }
 
   compose_matrix(mat, components);
 }
 
+/**
+ * Discards the composed matrices, after one of the tables has changed.
+ */
+void AnimChannelMatrixXfmTable::
+clear_matrices() {
+  LightMutexHolder holder(_matrices_lock);
+  _matrices_state.store(MS_unknown, std::memory_order_relaxed);
+  _matrices.clear();
+}
+
+/**
+ * Composes the matrix for each frame ahead of time, so that get_value() need
+ * only look it up.  Returns true if the matrices are now available, or false
+ * if they can't be cached because the tables are not all of the same length,
+ * or because they have been compressed.
+ */
+bool AnimChannelMatrixXfmTable::
+cache_matrices() {
+  LightMutexHolder holder(_matrices_lock);
+  int state = _matrices_state.load(std::memory_order_relaxed);
+  if (state != MS_unknown) {
+    // Another thread beat us to it.
+    return (state == MS_cached);
+  }
+
+  // Tables of a single value are constant; the others must all have the same
+  // number of frames, so that we can index the matrices the same way.
+  size_t num_frames = 1;
+  for (int i = 0; i < num_matrix_components; i++) {
+    if (_compressed[i] != nullptr) {
+      // Expanding the matrices would defeat the purpose of compressing the
+      // tables in the first place.
+      _matrices_state.store(MS_not_cached, std::memory_order_relaxed);
+      return false;
+    }
+    size_t size = _tables[i].size();
+    if (size > 1) {
+      if (num_frames > 1 && size != num_frames) {
+        _matrices_state.store(MS_not_cached, std::memory_order_relaxed);
+        return false;
+      }
+      num_frames = size;
+    }
+  }
+
+  _matrices.resize(num_frames);
+  for (size_t frame = 0; frame < num_frames; ++frame) {
+    PN_stdfloat components[num_matrix_components];
+    for (int i = 0; i < num_matrix_components; i++) {
+      if (_tables[i].empty()) {
+        components[i] = get_default_value(i);
+      } else {
+        components[i] = _tables[i][frame % _tables[i].size()];
+      }
+    }
+    compose_matrix(_matrices[frame], components);
+  }
+
+  _matrices_state.store(MS_cached, std::memory_order_release);
+  return true;
+}
+
 /**
  * Gets the value of the channel at the indicated frame, without any scale or
  * shear information.
@@ -138,11 +222,7 @@ get_value_no_scale_shear(int frame, LMatrix4 &mat) {
   components[5] = 0.0f;
 
   for (int i = 6; i < num_matrix_components; i++) {
-    if (_tables[i].empty()) {
-      components[i] = get_default_value(i);
-    } else {
-      components[i] = _tables[i][frame % _tables[i].size()];
-    }
+    components[i] = get_component(i, frame);
   }
 
   compose_matrix(mat, components);
@@ -154,11 +234,7 @@ get_value_no_scale_shear(int frame, LMatrix4 &mat) {
 void AnimChannelMatrixXfmTable::
 get_scale(int frame, LVecBase3 &scale) {
   for (int i = 0; i < 3; i++) {
-    if (_tables[i].empty()) {
-      scale[i] = 1.0f;
-    } else {
-      scale[i] = _tables[i][frame % _tables[i].size()];
-    }
+    scale[i] = get_component(i, frame);
   }
 }
 
@@ -169,11 +245,7 @@ get_scale(int frame, LVecBase3 &scale) {
 void AnimChannelMatrixXfmTable::
 get_hpr(int frame, LVecBase3 &hpr) {
   for (int i = 0; i < 3; i++) {
-    if (_tables[i + 6].empty()) {
-      hpr[i] = 0.0f;
-    } else {
-      hpr[i] = _tables[i + 6][frame % _tables[i + 6].size()];
-    }
+    hpr[i] = get_component(i + 6, frame);
   }
 }
 
@@ -186,11 +258,7 @@ void AnimChannelMatrixXfmTable::
 get_quat(int frame, LQuaternion &quat) {
   LVecBase3 hpr;
   for (int i = 0; i < 3; i++) {
-    if (_tables[i + 6].empty()) {
-      hpr[i] = 0.0f;
-    } else {
-      hpr[i] = _tables[i + 6][frame % _tables[i + 6].size()];
-    }
+    hpr[i] = get_component(i + 6, frame);
   }
 
   quat.set_hpr(hpr);
@@ -203,11 +271,7 @@ get_quat(int frame, LQuaternion &quat) {
 void AnimChannelMatrixXfmTable::
 get_pos(int frame, LVecBase3 &pos) {
   for (int i = 0; i < 3; i++) {
-    if (_tables[i + 9].empty()) {
-      pos[i] = 0.0f;
-    } else {
-      pos[i] = _tables[i + 9][frame % _tables[i + 9].size()];
-    }
+    pos[i] = get_component(i + 9, frame);
   }
 }
 
@@ -218,11 +282,7 @@ get_pos(int frame, LVecBase3 &pos) {
 void AnimChannelMatrixXfmTable::
 get_shear(int frame, LVecBase3 &shear) {
   for (int i = 0; i < 3; i++) {
-    if (_tables[i + 3].empty()) {
-      shear[i] = 0.0f;
-    } else {
-      shear[i] = _tables[i + 3][frame % _tables[i + 3].size()];
-    }
+    shear[i] = get_component(i + 3, frame);
   }
 }
 
@@ -249,6 +309,8 @@ set_table(char table_id, const CPTA_stdfloat &table) {
   }
 
   _tables[i] = table;
+  _compressed[i] = nullptr;
+  clear_matrices();
 }
 
 
@@ -260,7 +322,32 @@ void AnimChannelMatrixXfmTable::
 clear_all_tables() {
   for (int i = 0; i < num_matrix_components; i++) {
     _tables[i] = CPTA_stdfloat(get_class_type());
+    _compressed[i] = nullptr;
+  }
+  clear_matrices();
+}
+
+/**
+ * Replaces each of the tables with a compressed representation, which is
+ * sampled directly during playback.  The tolerance is the largest error that
+ * is acceptable for any frame, as a fraction of the range of values in the
+ * table.  Tables that would not get any smaller are left alone.
+ *
+ * This is done automatically when a channel is loaded from a bam file if
+ * compress-anim-tables is set.
+ */
+void AnimChannelMatrixXfmTable::
+compress_tables(PN_stdfloat tolerance) {
+  for (int i = 0; i < num_matrix_components; i++) {
+    if (_tables[i].size() > 1) {
+      PT(AnimCompressedTable) compressed = new AnimCompressedTable;
+      if (compressed->compress(_tables[i].p(), _tables[i].size(), tolerance)) {
+        _compressed[i] = std::move(compressed);
+        _tables[i] = CPTA_stdfloat(get_class_type());
+      }
+    }
   }
+  clear_matrices();
 }
 
 /**
@@ -274,7 +361,11 @@ write(std::ostream &out, int indent_level) const {
   // Write a list of all the sub-tables that have data.
   bool found_any = false;
   for (int i = 0; i < num_matrix_components; i++) {
-    if (!_tables[i].empty()) {
+    if (_compressed[i] != nullptr) {
+      out << get_table_id(i) << _compressed[i]->get_num_frames()
+          << "(" << _compressed[i]->get_num_keys() << " keys)";
+      found_any = true;
+    } else if (!_tables[i].empty()) {
       out << get_table_id(i) << _tables[i].size();
       found_any = true;
     }
@@ -327,6 +418,16 @@ void AnimChannelMatrixXfmTable::
 write_datagram(BamWriter *manager, Datagram &me) {
   AnimChannelMatrix::write_datagram(manager, me);
 
+  // Any tables that are compressed in memory are written out in full.
+  CPTA_stdfloat tables[num_matrix_components];
+  for (int i = 0; i < num_matrix_components; i++) {
+    if (_compressed[i] != nullptr) {
+      tables[i] = _compressed[i]->decompress();
+    } else {
+      tables[i] = _tables[i];
+    }
+  }
+
   if (compress_channels) {
     chan_cat.warning()
       << "FFT compression of animations is deprecated.  For compatibility "
@@ -347,9 +448,9 @@ write_datagram(BamWriter *manager, Datagram &me) {
   if (!compress_channels) {
     // Write out everything uncompressed, as a stream of floats.
     for (int i = 0; i < num_matrix_components; i++) {
-      me.add_uint16(_tables[i].size());
-      for(int j = 0; j < (int)_tables[i].size(); j++) {
-        me.add_stdfloat(_tables[i][j]);
+      me.add_uint16(tables[i].size());
+      for(int j = 0; j < (int)tables[i].size(); j++) {
+        me.add_stdfloat(tables[i][j]);
       }
     }
 
@@ -363,18 +464,18 @@ write_datagram(BamWriter *manager, Datagram &me) {
     // First, write out the scales and shears.
     int i;
     for (i = 0; i < 6; i++) {
-      compressor.write_reals(me, _tables[i], _tables[i].size());
+      compressor.write_reals(me, tables[i], tables[i].size());
     }
 
     // Now, write out the joint angles.  For these we need to build up a HPR
     // array.
     pvector<LVecBase3> hprs;
-    int hprs_length = std::max(std::max(_tables[6].size(), _tables[7].size()), _tables[8].size());
+    int hprs_length = std::max(std::max(tables[6].size(), tables[7].size()), tables[8].size());
     hprs.reserve(hprs_length);
     for (i = 0; i < hprs_length; i++) {
-      PN_stdfloat h = _tables[6].empty() ? 0.0f : _tables[6][i % _tables[6].size()];
-      PN_stdfloat p = _tables[7].empty() ? 0.0f : _tables[7][i % _tables[7].size()];
-      PN_stdfloat r = _tables[8].empty() ? 0.0f : _tables[8][i % _tables[8].size()];
+      PN_stdfloat h = tables[6].empty() ? 0.0f : tables[6][i % tables[6].size()];
+      PN_stdfloat p = tables[7].empty() ? 0.0f : tables[7][i % tables[7].size()];
+      PN_stdfloat r = tables[8].empty() ? 0.0f : tables[8][i % tables[8].size()];
       hprs.push_back(LVecBase3(h, p, r));
     }
     const LVecBase3 *hprs_array = nullptr;
@@ -385,7 +486,7 @@ write_datagram(BamWriter *manager, Datagram &me) {
 
     // And now the translations.
     for(i = 9; i < num_matrix_components; i++) {
-      compressor.write_reals(me, _tables[i], _tables[i].size());
+      compressor.write_reals(me, tables[i], tables[i].size());
     }
   }
 }
@@ -405,6 +506,23 @@ fillin(DatagramIterator &scan, BamReader *manager) {
   // have to convert the HPR values to the new convention.
   bool new_hpr = scan.get_bool();
 
+  // The tables make up the rest of the datagram, and don't depend on anything
+  // else, so they may be decoded on another thread.
+  int file_minor_ver = manager->get_file_minor_ver();
+  if (!manager->defer_decode(this, scan, [=] (DatagramIterator &scan) {
+        fillin_tables(scan, wrote_compressed, new_hpr, file_minor_ver);
+      })) {
+    fillin_tables(scan, wrote_compressed, new_hpr, file_minor_ver);
+  }
+}
+
+/**
+ * Reads the tables from the datagram.  This is called by fillin(), or later
+ * on, if the BamReader chose to defer it.
+ */
+void AnimChannelMatrixXfmTable::
+fillin_tables(DatagramIterator &scan, bool wrote_compressed, bool new_hpr,
+              int file_minor_ver) {
   if (!wrote_compressed) {
     // Regular floats.
 
@@ -462,7 +580,7 @@ fillin(DatagramIterator &scan, BamReader *manager) {
     }
 
     FFTCompressor compressor;
-    compressor.read_header(scan, manager->get_file_minor_ver());
+    compressor.read_header(scan, file_minor_ver);
 
     int i;
     // First, read in the scales and shears.
@@ -505,6 +623,12 @@ fillin(DatagramIterator &scan, BamReader *manager) {
       _tables[i] = ind_table;
     }
   }
+
+  clear_matrices();
+
+  if (compress_anim_tables) {
+    compress_tables(compress_anim_tables_tolerance);
+  }
 }
 
 /**
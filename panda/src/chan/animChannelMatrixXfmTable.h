@@ -21,6 +21,10 @@
 #include "pointerToArray.h"
 #include "pta_stdfloat.h"
 #include "compose_matrix.h"
+#include "animCompressedTable.h"
+#include "epvector.h"
+#include "lightMutex.h"
+#include "patomic.h"
 
 /**
  * An animation channel that issues a matrix each frame, read from a table
@@ -61,6 +65,9 @@ PUBLISHED:
 
   MAKE_MAP_PROPERTY(tables, has_table, get_table, set_table, clear_table);
 
+  void compress_tables(PN_stdfloat tolerance);
+  INLINE bool is_table_compressed(char table_id) const;
+
 public:
   virtual void write(std::ostream &out, int indent_level) const;
 
@@ -70,9 +77,31 @@ protected:
   INLINE static char get_table_id(int table_index);
   static int get_table_index(char table_id);
   INLINE static PN_stdfloat get_default_value(int table_index);
+  INLINE PN_stdfloat get_component(int table_index, int frame) const;
+  void clear_matrices();
 
   CPTA_stdfloat _tables[num_matrix_components];
 
+  // If compress_tables() has been called, the tables that could be
+  // compressed are stored here instead of in _tables.
+  PT(AnimCompressedTable) _compressed[num_matrix_components];
+
+private:
+  bool cache_matrices();
+
+  enum MatricesState {
+    MS_unknown,
+    MS_cached,
+    MS_not_cached,
+  };
+
+  // The composed matrix for each frame, which is filled in by the first call
+  // to get_value() if cache-anim-matrices is set.
+  typedef epvector<LMatrix4> Matrices;
+  Matrices _matrices;
+  patomic<int> _matrices_state;
+  static LightMutex _matrices_lock;
+
 public:
   static void register_with_read_factory();
   virtual void write_datagram(BamWriter* manager, Datagram &me);
@@ -82,6 +111,10 @@ public:
 protected:
   void fillin(DatagramIterator& scan, BamReader* manager);
 
+private:
+  void fillin_tables(DatagramIterator &scan, bool wrote_compressed,
+                     bool new_hpr, int file_minor_ver);
+
 public:
   virtual TypeHandle get_type() const {
     return get_class_type();
@@ -0,0 +1,126 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file animCompressedTable.cxx
+ * @author agent
+ * @date 2026-10-16
+ */
+
+#include "animCompressedTable.h"
+
+/**
+ * Builds the compressed representation of the indicated table.  The
+ * tolerance is the maximum error that is acceptable for any frame, expressed
+ * as a fraction of the range of values in the table.
+ *
+ * Returns true on success, or false if the table could not be compressed, or
+ * if it would not get any smaller.
+ */
+bool AnimCompressedTable::
+compress(const PN_stdfloat *data, size_t num_frames, PN_stdfloat tolerance) {
+  _keys.clear();
+  _num_frames = 0;
+
+  // Frame numbers are stored in 16 bits, which is also the limit imposed by
+  // the bam format.
+  if (num_frames < 2 || num_frames > 0x10000) {
+    return false;
+  }
+
+  PN_stdfloat min_value = data[0];
+  PN_stdfloat max_value = data[0];
+  for (size_t i = 1; i < num_frames; ++i) {
+    min_value = std::min(min_value, data[i]);
+    max_value = std::max(max_value, data[i]);
+  }
+
+  _num_frames = num_frames;
+  _base = min_value;
+  _scale = (max_value - min_value) / 65535.0f;
+
+  if (_scale <= 0.0f) {
+    // The table is constant.
+    _keys.push_back({0, 0});
+    return true;
+  }
+
+  pvector<uint16_t> quantized(num_frames);
+  for (size_t i = 0; i < num_frames; ++i) {
+    PN_stdfloat q = (data[i] - min_value) / _scale + 0.5f;
+    quantized[i] = (uint16_t)std::min(std::max(q, (PN_stdfloat)0), (PN_stdfloat)65535);
+  }
+
+  // Each key is extended as far as possible, as long as the straight line to
+  // the next key passes within the tolerance of every frame in between.  We
+  // keep track of the range of slopes that satisfy all of the frames seen so
+  // far; as soon as the slope to a frame falls outside it, the previous frame
+  // becomes the next key.  Part of the tolerance has already been used up by
+  // the quantization.
+  PN_stdfloat tol = std::max(tolerance * 65535.0f - 0.5f, (PN_stdfloat)0);
+  size_t start = 0;
+  PN_stdfloat min_slope = -std::numeric_limits<PN_stdfloat>::infinity();
+  PN_stdfloat max_slope = std::numeric_limits<PN_stdfloat>::infinity();
+  _keys.push_back({0, quantized[0]});
+
+  for (size_t j = 1; j < num_frames; ++j) {
+    PN_stdfloat dt = (PN_stdfloat)(j - start);
+    PN_stdfloat delta = (PN_stdfloat)quantized[j] - (PN_stdfloat)quantized[start];
+    PN_stdfloat slope = delta / dt;
+    if (slope < min_slope || slope > max_slope) {
+      start = j - 1;
+      _keys.push_back({(uint16_t)start, quantized[start]});
+      min_slope = -std::numeric_limits<PN_stdfloat>::infinity();
+      max_slope = std::numeric_limits<PN_stdfloat>::infinity();
+      dt = 1.0f;
+      delta = (PN_stdfloat)quantized[j] - (PN_stdfloat)quantized[start];
+    }
+    min_slope = std::max(min_slope, (delta - tol) / dt);
+    max_slope = std::min(max_slope, (delta + tol) / dt);
+  }
+
+  _keys.push_back({(uint16_t)(num_frames - 1), quantized[num_frames - 1]});
+
+  if (_keys.size() * sizeof(Key) >= num_frames * sizeof(PN_stdfloat)) {
+    // Not worth it.
+    _keys.clear();
+    _num_frames = 0;
+    return false;
+  }
+
+  Keys(_keys).swap(_keys);
+  return true;
+}
+
+/**
+ * Expands the table back out to a value for each frame.
+ */
+PTA_stdfloat AnimCompressedTable::
+decompress() const {
+  PTA_stdfloat table = PTA_stdfloat::empty_array(_num_frames);
+  if (_keys.empty()) {
+    return table;
+  }
+
+  for (size_t ki = 0; ki + 1 < _keys.size(); ++ki) {
+    const Key &prev = _keys[ki];
+    const Key &next = _keys[ki + 1];
+    PN_stdfloat span = (PN_stdfloat)(next._frame - prev._frame);
+    PN_stdfloat delta = (PN_stdfloat)next._value - (PN_stdfloat)prev._value;
+    for (size_t f = prev._frame; f < next._frame; ++f) {
+      PN_stdfloat t = (PN_stdfloat)(f - prev._frame) / span;
+      table[f] = decode(prev._value + delta * t);
+    }
+  }
+
+  // The last key, and any frames following it if the table is constant.
+  const Key &last = _keys.back();
+  for (size_t f = last._frame; f < _num_frames; ++f) {
+    table[f] = decode(last._value);
+  }
+  return table;
+}
@@ -0,0 +1,62 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file animCompressedTable.h
+ * @author agent
+ * @date 2026-10-16
+ */
+
+#ifndef ANIMCOMPRESSEDTABLE_H
+#define ANIMCOMPRESSEDTABLE_H
+
+#include "pandabase.h"
+
+#include "referenceCount.h"
+#include "pta_stdfloat.h"
+#include "pvector.h"
+
+/**
+ * A compact in-memory representation of one component table of an animation
+ * channel.  The values are quantized to 16 bits over the range of the table,
+ * and frames that can be reconstructed by linearly interpolating between
+ * their neighbors, within the given tolerance, are dropped.
+ *
+ * The value for any frame can be sampled directly, without decompressing the
+ * rest of the table.
+ */
+class EXPCL_PANDA_CHAN AnimCompressedTable : public ReferenceCount {
+public:
+  INLINE AnimCompressedTable();
+
+  bool compress(const PN_stdfloat *data, size_t num_frames,
+                PN_stdfloat tolerance);
+  PTA_stdfloat decompress() const;
+
+  INLINE size_t get_num_frames() const;
+  INLINE size_t get_num_keys() const;
+  INLINE PN_stdfloat get_value(int frame) const;
+
+private:
+  INLINE PN_stdfloat decode(PN_stdfloat quantized) const;
+
+  class Key {
+  public:
+    uint16_t _frame;
+    uint16_t _value;
+  };
+  typedef pvector<Key> Keys;
+  Keys _keys;
+
+  size_t _num_frames;
+  float _base;
+  float _scale;
+};
+
+#include "animCompressedTable.I"
+
+#endif
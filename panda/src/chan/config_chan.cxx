@@ -85,6 +85,30 @@ PRC_DESC("Set this true to interpolate character animations between frames, "
          "also be changed on a per-character basis with "
          "PartBundle::set_frame_blend_flag()."));
 
+ConfigVariableBool cache_anim_matrices
+("cache-anim-matrices", false,
+PRC_DESC("Set this true to compose the matrix for each frame of a table-based "
+         "joint animation channel the first time the channel is evaluated, "
+         "and to look it up thereafter, rather than composing it again from "
+         "the individual scale, rotation and translation components for "
+         "every joint of every character each frame.  This costs one matrix "
+         "per frame of each animation channel that is actually played."));
+
+ConfigVariableBool compress_anim_tables
+("compress-anim-tables", false,
+PRC_DESC("Set this true to keep the tables of joint animation channels in a "
+         "compressed form in memory after they have been loaded from a bam "
+         "file.  The values are quantized to 16 bits, and frames that can be "
+         "interpolated from their neighbors are dropped.  The compressed "
+         "tables are sampled directly during playback.  This implies that "
+         "cache-anim-matrices has no effect on these channels."));
+
+ConfigVariableDouble compress_anim_tables_tolerance
+("compress-anim-tables-tolerance", 0.001,
+PRC_DESC("The largest error that compress-anim-tables may introduce in any "
+         "frame of an animation table, expressed as a fraction of the range "
+         "of values in that table."));
+
 ConfigVariableBool restore_initial_pose
 ("restore-initial-pose", true,
 PRC_DESC("When this is true, setting all control effects on an Actor to 0 "
@@ -28,7 +28,8 @@ TypeHandle MovingPartBase::_type_handle;
 MovingPartBase::
 MovingPartBase(PartGroup *parent, const std::string &name) :
   PartGroup(parent, name),
-  _effective_control(nullptr)
+  _effective_control(nullptr),
+  _lod_excluded(false)
 {
 }
 
@@ -37,7 +38,8 @@ MovingPartBase(PartGroup *parent, const std::string &name) :
  */
 MovingPartBase::
 MovingPartBase() :
-  _effective_control(nullptr)
+  _effective_control(nullptr),
+  _lod_excluded(false)
 {
 }
 
@@ -114,7 +116,12 @@ do_update(PartBundle *root, const CycleData *root_cdata, PartGroup *parent,
 
   // See if any of the channel values have changed since last time.
 
-  if (!needs_update) {
+  if (_lod_excluded && ((const PartBundle::CData *)root_cdata)->_lod_reduced) {
+    // Not while the bundle is at reduced detail, though.  We still follow
+    // our parent around.
+    needs_update = false;
+
+  } else if (!needs_update) {
     if (_forced_channel != nullptr) {
       needs_update = _forced_channel->has_changed(0, 0.0, 0, 0.0);
 
@@ -295,6 +302,24 @@ find_bound_joints(int &joint_index, bool is_included, BitArray &bound_joints,
   PartGroup::find_bound_joints(joint_index, is_included, bound_joints, subset);
 }
 
+/**
+ * Recursively marks the parts of the hierarchy that are included in the
+ * indicated subset as the ones that are still animated while the bundle is
+ * animated at reduced detail.  See PartBundle::set_lod_subset().
+ */
+void MovingPartBase::
+mark_lod_joints(bool is_included, const PartSubset &subset) {
+  if (subset.matches_include(get_name())) {
+    is_included = true;
+  } else if (subset.matches_exclude(get_name())) {
+    is_included = false;
+  }
+
+  _lod_excluded = !is_included;
+
+  PartGroup::mark_lod_joints(is_included, subset);
+}
+
 /**
  * Should be called whenever the ChannelBlend values have changed, this
  * recursively updates the _effective_channel member in each part.
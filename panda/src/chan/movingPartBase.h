@@ -73,6 +73,7 @@ protected:
   virtual void find_bound_joints(int &joint_index, bool is_included,
                                  BitArray &bound_joints,
                                  const PartSubset &subset);
+  virtual void mark_lod_joints(bool is_included, const PartSubset &subset);
   virtual void determine_effective_channels(const CycleData *root_cdata);
 
   // This is the vector of all channels bound to this part.
@@ -90,6 +91,10 @@ protected:
   // set_forced_channel().  It overrides all of the above if set.
   PT(AnimChannelBase) _forced_channel;
 
+  // This is true if the part is left out of the bundle's LOD subset, and
+  // hence keeps its current value while the bundle is at reduced detail.
+  bool _lod_excluded;
+
 public:
   virtual void write_datagram(BamWriter *manager, Datagram &dg);
   virtual int complete_pointers(TypedWritable **plist, BamReader *manager);
@@ -9,6 +9,7 @@
 #include "animChannelMatrixXfmTable.cxx"
 #include "animChannelScalarDynamic.cxx"
 #include "animChannelScalarTable.cxx"
+#include "animCompressedTable.cxx"
 #include "animControl.cxx"
 #include "animControlCollection.cxx"
 #include "animGroup.cxx"
@@ -55,6 +55,7 @@ PartBundle(const PartBundle &copy) :
 {
   _anim_preload = copy._anim_preload;
   _update_delay = 0.0;
+  _update_interval = copy._update_interval;
 
   CDWriter cdata(_cycler, true);
   CDReader cdata_from(copy._cycler);
@@ -73,6 +74,7 @@ PartBundle(const string &name) :
   PartGroup(name)
 {
   _update_delay = 0.0;
+  _update_interval = 0.0;
 }
 
 /**
@@ -465,23 +467,65 @@ release_joint(const string &joint_name) {
   return child->clear_forced_channel();
 }
 
+/**
+ * Specifies the parts that should continue to be animated while the bundle is
+ * animated at reduced detail, for instance because its Character is far away
+ * from the camera (see Character::set_lod_subset()).  The other parts keep
+ * the value they had, relative to their parent, until the bundle is animated
+ * in full detail again.  The subset is interpreted as it is by bind_anim().
+ *
+ * The subset is a property of the bundle, so it applies to every Character
+ * that shares this bundle.
+ */
+void PartBundle::
+set_lod_subset(const PartSubset &subset) {
+  mark_lod_joints(subset.is_include_empty(), subset);
+
+  CDWriter cdata(_cycler, false);
+  cdata->_anim_changed = true;
+}
+
+/**
+ * Undoes the effect of a previous call to set_lod_subset(), so that all of the
+ * parts are animated even while the bundle is at reduced detail.
+ */
+void PartBundle::
+clear_lod_subset() {
+  set_lod_subset(PartSubset());
+}
+
 /**
  * Updates all the parts in the bundle to reflect the data for the current
  * frame (as set in each of the AnimControls).
  *
+ * If lod_reduced is true, only the parts in the subset passed to
+ * set_lod_subset() are recomputed; the others keep their value relative to
+ * their parent.  This is normally determined by Character, which passes its
+ * own distance-based decision, so that each Character sharing this bundle
+ * makes its own.  If the bundle was last recomputed at reduced detail, a
+ * request for full detail brings all of the parts up to date right away, even
+ * if it is made later in the same frame.
+ *
  * Returns true if any part has changed as a result of this, or false
  * otherwise.
  */
 bool PartBundle::
-update() {
+update(bool lod_reduced) {
   Thread *current_thread = Thread::get_current_thread();
   CDWriter cdata(_cycler, false, current_thread);
   bool any_changed = false;
 
+  if (cdata->_lod_reduced && !lod_reduced) {
+    // Make sure that the parts that were left alone are brought up to date.
+    cdata->_anim_changed = true;
+  }
+
   double now = ClockObject::get_global_clock()->get_frame_time(current_thread);
-  if (now > cdata->_last_update + _update_delay || cdata->_anim_changed) {
+  double delay = std::max(_update_delay, _update_interval);
+  if (now > cdata->_last_update + delay || cdata->_anim_changed) {
     bool anim_changed = cdata->_anim_changed;
     bool frame_blend_flag = cdata->_frame_blend_flag;
+    cdata->_lod_reduced = lod_reduced;
 
     any_changed = do_update(this, cdata, nullptr, false, anim_changed,
                             current_thread);
@@ -508,6 +552,7 @@ bool PartBundle::
 force_update() {
   Thread *current_thread = Thread::get_current_thread();
   CDWriter cdata(_cycler, false, current_thread);
+  cdata->_lod_reduced = false;
   bool any_changed = do_update(this, cdata, nullptr, true, true, current_thread);
 
   // Now update all the controls for next time.
@@ -823,6 +868,7 @@ CData() {
   _last_control_set = nullptr;
   _anim_changed = false;
   _last_update = 0.0;
+  _lod_reduced = false;
 }
 
 /**
@@ -837,7 +883,8 @@ CData(const PartBundle::CData &copy) :
   _last_control_set(copy._last_control_set),
   _blend(copy._blend),
   _anim_changed(copy._anim_changed),
-  _last_update(copy._last_update)
+  _last_update(copy._last_update),
+  _lod_reduced(copy._lod_reduced)
 {
   // Note that this copy constructor is not used by the PartBundle copy
   // constructor!  Any elements that must be copied between PartBundles should
@@ -142,7 +142,14 @@ PUBLISHED:
   bool control_joint(const std::string &joint_name, PandaNode *node);
   bool release_joint(const std::string &joint_name);
 
-  bool update();
+  INLINE void set_update_interval(double interval);
+  INLINE double get_update_interval() const;
+  MAKE_PROPERTY(update_interval, get_update_interval, set_update_interval);
+
+  void set_lod_subset(const PartSubset &subset);
+  void clear_lod_subset();
+
+  bool update(bool lod_reduced = false);
   bool force_update();
 
 public:
@@ -175,6 +182,7 @@ private:
   AppliedTransforms _applied_transforms;
 
   double _update_delay;
+  double _update_interval;
 
   // This is the data that must be cycled between pipeline stages.
   class CData : public CycleData {
@@ -197,6 +205,7 @@ private:
     ChannelBlend _blend;
     bool _anim_changed;
     double _last_update;
+    bool _lod_reduced;
   };
 
   PipelineCycler<CData> _cycler;
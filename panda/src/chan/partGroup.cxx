@@ -621,6 +621,24 @@ find_bound_joints(int &joint_index, bool is_included, BitArray &bound_joints,
   }
 }
 
+/**
+ * Recursively marks the parts of the hierarchy that are included in the
+ * indicated subset as the ones that are still animated while the bundle is
+ * animated at reduced detail.  See PartBundle::set_lod_subset().
+ */
+void PartGroup::
+mark_lod_joints(bool is_included, const PartSubset &subset) {
+  if (subset.matches_include(get_name())) {
+    is_included = true;
+  } else if (subset.matches_exclude(get_name())) {
+    is_included = false;
+  }
+
+  for (PartGroup *child : _children) {
+    child->mark_lod_joints(is_included, subset);
+  }
+}
+
 /**
  * Function to write the important information in the particular object to a
  * Datagram
@@ -111,6 +111,7 @@ protected:
   virtual void find_bound_joints(int &joint_index, bool is_included,
                                  BitArray &bound_joints,
                                  const PartSubset &subset);
+  virtual void mark_lod_joints(bool is_included, const PartSubset &subset);
 
   typedef pvector< PT(PartGroup) > Children;
   Children _children;
@@ -46,6 +46,9 @@ Character(const Character &copy, bool copy_bundles) :
   _lod_near_distance(copy._lod_near_distance),
   _lod_delay_factor(copy._lod_delay_factor),
   _do_lod_animation(copy._do_lod_animation),
+  _lod_subset_distance(copy._lod_subset_distance),
+  _do_lod_subset(copy._do_lod_subset),
+  _lod_reduced(false),
   _joints_pcollector(copy._joints_pcollector),
   _skinning_pcollector(copy._skinning_pcollector)
 {
@@ -83,6 +86,9 @@ Character(const std::string &name) :
 {
   set_cull_callback();
   clear_lod_animation();
+  _lod_subset_distance = 0.0f;
+  _do_lod_subset = false;
+  _lod_reduced = false;
 }
 
 /**
@@ -168,7 +174,7 @@ cull_callback(CullTraverser *trav, CullTraverserData &data) {
   // We may need a better way to do this optimization later, to handle
   // characters that might animate themselves in front of the view frustum.
 
-  if (_do_lod_animation) {
+  if (_do_lod_animation || _do_lod_subset) {
     int this_frame = ClockObject::get_global_clock()->get_frame_count();
 
     CPT(TransformState) rel_transform = get_rel_transform(trav, data);
@@ -182,17 +188,26 @@ cull_callback(CullTraverser *trav, CullTraverserData &data) {
       // Now compute the lod delay.
       PN_stdfloat dist = sqrt(dist2);
       double delay = 0.0;
-      if (dist > _lod_near_distance) {
-        delay = _lod_delay_factor * (dist - _lod_near_distance) / (_lod_far_distance - _lod_near_distance);
-        nassertr(delay > 0.0, false);
+      if (_do_lod_animation) {
+        if (dist > _lod_near_distance) {
+          delay = _lod_delay_factor * (dist - _lod_near_distance) / (_lod_far_distance - _lod_near_distance);
+          nassertr(delay > 0.0, false);
+        }
+        set_lod_current_delay(delay);
+      }
+
+      // And whether to animate only the joints in the lod subset.
+      bool reduced = false;
+      if (_do_lod_subset) {
+        reduced = (dist > _lod_subset_distance);
+        set_lod_current_reduced(reduced);
       }
-      set_lod_current_delay(delay);
 
       if (char_cat.is_spam()) {
         char_cat.spam()
           << "Distance to " << NodePath::any_path(this) << " in frame "
           << this_frame << " is " << dist << ", computed delay is " << delay
-          << "\n";
+          << (reduced ? ", reduced detail" : "") << "\n";
       }
     }
   }
@@ -320,6 +335,52 @@ clear_lod_animation() {
   set_lod_current_delay(0.0);
 }
 
+/**
+ * Activates a special mode in which only some of the character's joints are
+ * animated while it is further than the indicated distance from the camera.
+ * The remaining joints hold their last pose relative to their parent joint,
+ * which is typically unnoticeable from afar for joints such as fingers or
+ * facial features, and saves the time spent computing them.
+ *
+ * The subset specifies the joints that are still animated at a distance, in
+ * the same way as a subset passed to PartBundle::bind_anim().  The distance
+ * is measured from the center given to set_lod_animation(), or from the
+ * origin of the character if that has not been called, to the closest camera
+ * that views the character.  This may be combined with set_lod_animation().
+ *
+ * The subset is stored on the character's bundles, so it is shared with any
+ * other Character that shares them; each Character still decides on its own
+ * whether it is far enough away to use it.
+ */
+void Character::
+set_lod_subset(const PartSubset &subset, PN_stdfloat distance) {
+  nassertv(distance >= 0.0f);
+  _lod_subset_distance = distance;
+  _do_lod_subset = true;
+
+  LightMutexHolder holder(_lock);
+  for (PartBundleHandle *handle : _bundles) {
+    handle->get_bundle()->set_lod_subset(subset);
+  }
+}
+
+/**
+ * Undoes the effect of a recent call to set_lod_subset().  Henceforth, all of
+ * the character's joints are animated, regardless of its distance from the
+ * camera.
+ */
+void Character::
+clear_lod_subset() {
+  _lod_subset_distance = 0.0f;
+  _do_lod_subset = false;
+
+  LightMutexHolder holder(_lock);
+  _lod_reduced = false;
+  for (PartBundleHandle *handle : _bundles) {
+    handle->get_bundle()->clear_lod_subset();
+  }
+}
+
 /**
  * Returns a pointer to the joint with the given name, if there is such a
  * joint, or NULL if there is no such joint.  This will not return a pointer
@@ -548,7 +609,7 @@ do_update() {
     }
   } else {
     for (PartBundleHandle *handle : _bundles) {
-      handle->get_bundle()->update();
+      handle->get_bundle()->update(_lod_reduced);
     }
   }
 }
@@ -565,6 +626,18 @@ set_lod_current_delay(double delay) {
   }
 }
 
+/**
+ * Changes whether the bundles are animated at reduced detail, as determined
+ * by set_lod_subset().  This is recorded on the Character rather than on the
+ * bundles, which may be shared with other Characters; it is passed on to the
+ * bundles when they are next updated.
+ */
+void Character::
+set_lod_current_reduced(bool reduced) {
+  LightMutexHolder holder(_lock);
+  _lod_reduced = reduced;
+}
+
 /**
  * After the joint hierarchy has already been copied from the indicated
  * hierarchy, this recursively walks through the joints and builds up a
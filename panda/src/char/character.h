@@ -67,6 +67,9 @@ PUBLISHED:
                          PN_stdfloat delay_factor);
   void clear_lod_animation();
 
+  void set_lod_subset(const PartSubset &subset, PN_stdfloat distance);
+  void clear_lod_subset();
+
   CharacterJoint *find_joint(const std::string &name) const;
   CharacterSlider *find_slider(const std::string &name) const;
 
@@ -87,6 +90,7 @@ protected:
 private:
   void do_update();
   void set_lod_current_delay(double delay);
+  void set_lod_current_reduced(bool reduced);
 
   typedef pmap<const PandaNode *, PandaNode *> NodeMap;
   typedef pmap<const PartGroup *, PartGroup *> JointMap;
@@ -140,6 +144,13 @@ private:
   PN_stdfloat _lod_delay_factor;
   bool _do_lod_animation;
 
+  PN_stdfloat _lod_subset_distance;
+  bool _do_lod_subset;
+
+  // Whether the bundles should currently be updated at reduced detail.
+  // Protected by _lock.
+  bool _lod_reduced;
+
   // Statistics
   PStatCollector _joints_pcollector;
   PStatCollector _skinning_pcollector;
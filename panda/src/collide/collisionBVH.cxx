@@ -0,0 +1,195 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file collisionBVH.cxx
+ * @author agent
+ * @date 2026-10-16
+ */
+
+#include "collisionBVH.h"
+#include "boundingSphere.h"
+
+#include <algorithm>
+
+// The maximum number of items that are stored together in one leaf.
+static const int max_leaf_items = 4;
+
+// The deepest the tree is allowed to get; find_overlaps() relies on this.
+static const int max_depth = 48;
+
+/**
+ * Adds a new item with the indicated bounding box.  Its index is the number
+ * of items that were added before it.
+ */
+void CollisionBVH::
+add_item(const LPoint3 &min_point, const LPoint3 &max_point) {
+  nassertv(_nodes.empty());
+
+  Item item;
+  item._min = min_point;
+  item._max = max_point;
+  item._center = (min_point + max_point) * 0.5f;
+  item._index = (int)_num_items++;
+  _items.push_back(item);
+}
+
+/**
+ * Adds a new item that has no finite bounding box, such as a plane.  It will
+ * be returned by every call to find_overlaps().
+ */
+void CollisionBVH::
+add_unbounded_item() {
+  nassertv(_nodes.empty());
+
+  _unbounded_items.push_back((int)_num_items++);
+}
+
+/**
+ * Builds the hierarchy over the items that have been added.  This must be
+ * called once, after all items have been added and before find_overlaps() is
+ * called.
+ */
+void CollisionBVH::
+build() {
+  nassertv(_nodes.empty());
+
+  if (_items.empty()) {
+    return;
+  }
+
+  // A binary tree with leaves of at least one item has fewer than twice as
+  // many nodes as it has items.
+  _nodes.reserve(_items.size() * 2);
+  _nodes.push_back(Node());
+  r_build(0, 0, (int)_items.size(), 0);
+}
+
+/**
+ * Fills the indicated vector with the indices of all of the items whose
+ * bounding box might intersect with the indicated volume, in increasing
+ * order.  The vector is not cleared first.
+ */
+void CollisionBVH::
+find_overlaps(const GeometricBoundingVolume *volume, pvector<int> &items) const {
+  size_t first_result = items.size();
+  items.insert(items.end(), _unbounded_items.begin(), _unbounded_items.end());
+
+  if (_nodes.empty() || volume->is_empty()) {
+    return;
+  }
+
+  // Spheres are by far the most common, so we test them directly.
+  LPoint3 center;
+  const LPoint3 *sphere_center = nullptr;
+  PN_stdfloat sphere_radius = 0;
+  const BoundingSphere *sphere = volume->as_bounding_sphere();
+  if (sphere != nullptr && !sphere->is_infinite()) {
+    center = sphere->get_center();
+    sphere_center = &center;
+    sphere_radius = sphere->get_radius();
+  }
+
+  int stack[max_depth + 2];
+  int stack_size = 0;
+  stack[stack_size++] = 0;
+
+  while (stack_size > 0) {
+    const Node &node = _nodes[stack[--stack_size]];
+    if (!overlaps(node._min, node._max, volume, sphere_center, sphere_radius)) {
+      continue;
+    }
+
+    if (node._num_items == 0) {
+      stack[stack_size++] = node._first + 1;
+      stack[stack_size++] = node._first;
+    } else {
+      const Item *item = &_items[node._first];
+      const Item *end = item + node._num_items;
+      for (; item != end; ++item) {
+        if (node._num_items == 1 ||
+            overlaps(item->_min, item->_max, volume, sphere_center, sphere_radius)) {
+          items.push_back(item->_index);
+        }
+      }
+    }
+  }
+
+  // Report the items in the order they were added, so that the caller visits
+  // them in the same order as it would without the hierarchy.
+  std::sort(items.begin() + first_result, items.end());
+}
+
+/**
+ *
+ */
+void CollisionBVH::
+output(std::ostream &out) const {
+  out << "CollisionBVH, " << _num_items << " items in " << _nodes.size()
+      << " nodes";
+}
+
+/**
+ * Recursively fills in the indicated node with the items in the range [begin,
+ * end), splitting it further if there are too many.
+ */
+void CollisionBVH::
+r_build(int index, int begin, int end, int depth) {
+  LPoint3 min_point = _items[begin]._min;
+  LPoint3 max_point = _items[begin]._max;
+  LPoint3 min_center = _items[begin]._center;
+  LPoint3 max_center = _items[begin]._center;
+  for (int i = begin + 1; i < end; ++i) {
+    const Item &item = _items[i];
+    for (int j = 0; j < 3; ++j) {
+      min_point[j] = std::min(min_point[j], item._min[j]);
+      max_point[j] = std::max(max_point[j], item._max[j]);
+      min_center[j] = std::min(min_center[j], item._center[j]);
+      max_center[j] = std::max(max_center[j], item._center[j]);
+    }
+  }
+
+  _nodes[index]._min = min_point;
+  _nodes[index]._max = max_point;
+
+  // Split along the axis on which the item centers are spread out the most.
+  LVector3 extent = max_center - min_center;
+  int axis = 0;
+  if (extent[1] > extent[axis]) {
+    axis = 1;
+  }
+  if (extent[2] > extent[axis]) {
+    axis = 2;
+  }
+
+  if (end - begin <= max_leaf_items || depth >= max_depth ||
+      extent[axis] <= 0) {
+    // Too few items to be worth splitting, or no way to split them.
+    _nodes[index]._first = begin;
+    _nodes[index]._num_items = end - begin;
+    return;
+  }
+
+  // Put the half of the items with the smallest centers on the left.
+  int middle = (begin + end) / 2;
+  std::nth_element(_items.begin() + begin, _items.begin() + middle,
+                   _items.begin() + end,
+                   [axis](const Item &a, const Item &b) {
+    return a._center[axis] < b._center[axis];
+  });
+
+  // The children are allocated next to each other, so that we only need to
+  // store the index of the first.
+  int first = (int)_nodes.size();
+  _nodes[index]._first = first;
+  _nodes[index]._num_items = 0;
+  _nodes.push_back(Node());
+  _nodes.push_back(Node());
+
+  r_build(first, begin, middle, depth + 1);
+  r_build(first + 1, middle, end, depth + 1);
+}
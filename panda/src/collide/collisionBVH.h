@@ -0,0 +1,94 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file collisionBVH.h
+ * @author agent
+ * @date 2026-10-16
+ */
+
+#ifndef COLLISIONBVH_H
+#define COLLISIONBVH_H
+
+#include "pandabase.h"
+
+#include "referenceCount.h"
+#include "geometricBoundingVolume.h"
+#include "boundingBox.h"
+#include "luse.h"
+#include "pvector.h"
+
+/**
+ * A bounding volume hierarchy over a number of items, each of which is
+ * represented by an axis-aligned box.  It is used by the CollisionTraverser to
+ * quickly find the few solids of a large CollisionNode, or the few triangles
+ * of a large Geom, that might intersect with a particular collider, without
+ * having to test the bounding volume of each one of them.
+ *
+ * The items are identified by the order in which they were added.  Once
+ * build() has been called, the hierarchy may be queried from multiple threads
+ * at once, but it may not be modified any further.
+ */
+class EXPCL_PANDA_COLLIDE CollisionBVH : public ReferenceCount {
+public:
+  CollisionBVH() = default;
+
+  INLINE void reserve(size_t num_items);
+  void add_item(const LPoint3 &min_point, const LPoint3 &max_point);
+  void add_unbounded_item();
+  void build();
+
+  INLINE size_t get_num_items() const;
+
+  void find_overlaps(const GeometricBoundingVolume *volume,
+                     pvector<int> &items) const;
+
+  void output(std::ostream &out) const;
+
+private:
+  void r_build(int index, int begin, int end, int depth);
+  INLINE static bool overlaps(const LPoint3 &min_point, const LPoint3 &max_point,
+                              const GeometricBoundingVolume *volume,
+                              const LPoint3 *sphere_center,
+                              PN_stdfloat sphere_radius);
+
+private:
+  // A node is a leaf if _num_items is nonzero, in which case it references a
+  // range of _items.  Otherwise, its children are found at _first and
+  // _first + 1.
+  class Node {
+  public:
+    LPoint3 _min;
+    LPoint3 _max;
+    int _first;
+    int _num_items;
+  };
+
+  class Item {
+  public:
+    LPoint3 _min;
+    LPoint3 _max;
+    LPoint3 _center;
+    int _index;
+  };
+
+  pvector<Node> _nodes;
+  pvector<Item> _items;
+
+  // Items without finite bounds, which must always be tested.
+  pvector<int> _unbounded_items;
+  size_t _num_items = 0;
+};
+
+INLINE std::ostream &operator << (std::ostream &out, const CollisionBVH &bvh) {
+  bvh.output(out);
+  return out;
+}
+
+#include "collisionBVH.I"
+
+#endif
@@ -294,6 +294,6 @@ throw_event_pattern(const string &pattern, CollisionEntry *entry) {
   }
 
   if (!event.empty()) {
-    throw_event(event, EventParameter(entry));
+    throw_event(_event_names.get_name(event), EventParameter(entry));
   }
 }
@@ -21,6 +21,7 @@
 #include "collisionEntry.h"
 
 #include "vector_string.h"
+#include "eventNameCache.h"
 #include "pointerTo.h"
 #include "extension.h"
 
@@ -83,6 +84,10 @@ protected:
   vector_string _again_patterns;
   vector_string _out_patterns;
 
+  // The names of the events thrown recently, so that throwing them again
+  // does not involve the global table of EventNames.
+  EventNameCache _event_names;
+
   int _index;
 
   class SortEntries {
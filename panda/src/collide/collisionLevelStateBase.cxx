@@ -90,3 +90,18 @@ prepare_collider(const ColliderDef &def, const NodePath &root) {
 
   _parent_bounds = _local_bounds;
 }
+
+/**
+ * Called by add_level() to record the increment in the vector passed to
+ * set_deferred_levels().
+ */
+void CollisionLevelStateBase::
+defer_level(PStatCollector &collector, double increment) const {
+  for (LevelCounts::value_type &level : *_deferred_levels) {
+    if (level.first == &collector) {
+      level.second += increment;
+      return;
+    }
+  }
+  _deferred_levels->push_back(LevelCounts::value_type(&collector, increment));
+}
@@ -23,6 +23,7 @@
 #include "workingNodePath.h"
 #include "pointerTo.h"
 #include "plist.h"
+#include "pvector.h"
 #include "pStatCollector.h"
 #include "bitMask.h"
 #include "lvector3.h"
@@ -32,6 +33,7 @@
 
 class CollisionSolid;
 class CollisionNode;
+class CollisionHandler;
 
 /**
  * This is the state information the CollisionTraverser retains for each level
@@ -47,6 +49,7 @@ public:
     CPT(CollisionSolid) _collider;
     CollisionNode *_node;
     NodePath _node_path;
+    CollisionHandler *_handler;
   };
 
   INLINE CollisionLevelStateBase(const NodePath &node_path);
@@ -69,6 +72,7 @@ public:
   INLINE const CollisionSolid *get_collider(int n) const;
   INLINE CollisionNode *get_collider_node(int n) const;
   INLINE NodePath get_collider_node_path(int n) const;
+  INLINE CollisionHandler *get_collider_handler(int n) const;
   INLINE const GeometricBoundingVolume *get_node_bound() const;
   INLINE const GeometricBoundingVolume *get_local_bound(int n) const;
   INLINE const GeometricBoundingVolume *get_parent_bound(int n) const;
@@ -76,6 +80,13 @@ public:
   INLINE void set_include_mask(CollideMask include_mask);
   INLINE CollideMask get_include_mask() const;
 
+  typedef pvector<std::pair<PStatCollector *, double> > LevelCounts;
+  INLINE void set_deferred_levels(LevelCounts *deferred_levels);
+  INLINE void add_level(PStatCollector &collector, double increment) const;
+
+private:
+  void defer_level(PStatCollector &collector, double increment) const;
+
 protected:
   WorkingNodePath _node_path;
 
@@ -89,6 +100,10 @@ protected:
   BoundingVolumes _local_bounds;
   BoundingVolumes _parent_bounds;
 
+  // If this is set, the PStats levels are counted here instead, to be added
+  // to the collectors later by the thread that started the traversal.
+  LevelCounts *_deferred_levels = nullptr;
+
   static PStatCollector _node_volume_pcollector;
 
 public:
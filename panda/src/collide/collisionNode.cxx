@@ -29,6 +29,7 @@
 #include "boundingSphere.h"
 #include "boundingBox.h"
 #include "config_mathutil.h"
+#include "lightMutexHolder.h"
 
 TypeHandle CollisionNode::_type_handle;
 
@@ -108,6 +109,7 @@ xform(const LMatrix4 &mat) {
     solid->xform(mat);
   }
   mark_internal_bounds_stale();
+  mark_bvh_stale();
 }
 
 /**
@@ -136,6 +138,7 @@ combine_with(PandaNode *other) {
         const COWPT(CollisionSolid) *solids_end = solids_begin + cother->_solids.size();
         _solids.insert(_solids.end(), solids_begin, solids_end);
         mark_internal_bounds_stale();
+        mark_bvh_stale();
         return this;
       }
 
@@ -251,6 +254,42 @@ set_from_collide_mask(CollideMask mask) {
   _from_collide_mask = mask;
 }
 
+/**
+ * Returns a bounding volume hierarchy over the solids of this node, which the
+ * CollisionTraverser uses to find the solids that a particular collider might
+ * intersect with.  It is built the first time it is requested, and rebuilt
+ * after the solids have changed.  Returns NULL if the node has fewer solids
+ * than collision-bvh-min-solids, in which case it is faster to simply test
+ * each of the solids' bounding volumes.
+ */
+CPT(CollisionBVH) CollisionNode::
+get_bvh(Thread *current_thread) const {
+  int min_solids = collision_bvh_min_solids;
+  if (min_solids <= 0 || _solids.size() < (size_t)min_solids) {
+    return nullptr;
+  }
+
+  LightMutexHolder holder(_bvh_lock);
+  if (_bvh == nullptr) {
+    PT(CollisionBVH) bvh = new CollisionBVH;
+    bvh->reserve(_solids.size());
+
+    for (const COWPT(CollisionSolid) &solid : _solids) {
+      CPT(BoundingVolume) bv = solid.get_read_pointer(current_thread)->get_bounds();
+      const FiniteBoundingVolume *fbv = bv->as_finite_bounding_volume();
+      if (fbv != nullptr && !fbv->is_empty() && !fbv->is_infinite()) {
+        bvh->add_item(fbv->get_min(), fbv->get_max());
+      } else {
+        bvh->add_unbounded_item();
+      }
+    }
+
+    bvh->build();
+    _bvh = std::move(bvh);
+  }
+  return _bvh;
+}
+
 /**
  * Called when needed to recompute the node's _internal_bound object.  Nodes
  * that contain anything of substance should redefine this to do the right
@@ -326,6 +365,16 @@ get_last_pos_state() {
 }
 
 
+/**
+ * Throws away the bounding volume hierarchy, so that it will be rebuilt the
+ * next time it is needed.  Must be called whenever the solids change.
+ */
+void CollisionNode::
+mark_bvh_stale() {
+  LightMutexHolder holder(_bvh_lock);
+  _bvh.clear();
+}
+
 /**
  * Tells the BamReader how to create objects of type CollisionNode.
  */
@@ -17,9 +17,11 @@
 #include "pandabase.h"
 
 #include "collisionSolid.h"
+#include "collisionBVH.h"
 
 #include "collideMask.h"
 #include "pandaNode.h"
+#include "lightMutex.h"
 
 /**
  * A node in the scene graph that can hold any number of CollisionSolids.
@@ -77,6 +79,9 @@ PUBLISHED:
   INLINE static CollideMask get_default_collide_mask();
   MAKE_PROPERTY(default_collide_mask, get_default_collide_mask);
 
+public:
+  CPT(CollisionBVH) get_bvh(Thread *current_thread = Thread::get_current_thread()) const;
+
 protected:
   virtual void compute_internal_bounds(CPT(BoundingVolume) &internal_bounds,
                                        int &internal_vertices,
@@ -85,6 +90,7 @@ protected:
 
 private:
   CPT(RenderState) get_last_pos_state();
+  void mark_bvh_stale();
 
   // This data is not cycled, for now.  We assume the collision traversal will
   // take place in App only.  Perhaps we will revisit this later.
@@ -94,6 +100,11 @@ private:
   typedef pvector< COWPT(CollisionSolid) > Solids;
   Solids _solids;
 
+  // The hierarchy over the solids' bounding volumes, which is built on demand
+  // by get_bvh().  It is cleared whenever the set of solids changes.
+  mutable LightMutex _bvh_lock;
+  mutable CPT(CollisionBVH) _bvh;
+
   friend class CollisionTraverser;
 
 public:
@@ -36,8 +36,19 @@
 #include "nodePath.h"
 #include "pStatTimer.h"
 #include "indent.h"
+#include "asyncTaskManager.h"
+#include "patomic.h"
+#include "collisionBVH.h"
+#include "collisionTriangleBatch.h"
+#include "collisionRay.h"
+#include "collisionLine.h"
+#include "collisionSegment.h"
+#include "lightMutex.h"
+#include "lightMutexHolder.h"
+#include "weakPointerTo.h"
 
 #include <algorithm>
+#include <float.h>
 
 using std::min;
 
@@ -66,6 +77,214 @@ public:
   const CollisionTraverser &_trav;
 };
 
+/**
+ * A CollisionHandler that stands in for the real handler of a collider while
+ * its group is traversed by a worker thread.  It just queues up the entries,
+ * along with the real handler, so that they can be handed over later on the
+ * thread that called traverse().
+ */
+class DeferredCollisionHandler final : public CollisionHandler {
+public:
+  typedef pvector<std::pair<CollisionHandler *, PT(CollisionEntry)> > Entries;
+
+  DeferredCollisionHandler(CollisionHandler *handler, Entries &entries) :
+    _handler(handler),
+    _entries(entries)
+  {
+    _wants_all_potential_collidees = handler->wants_all_potential_collidees();
+  }
+
+  virtual void add_entry(CollisionEntry *entry) override {
+    _entries.push_back(std::make_pair(_handler, entry));
+  }
+
+  CollisionHandler *const _handler;
+
+private:
+  Entries &_entries;
+};
+
+/**
+ * The state shared between the threads cooperating on a single call to
+ * parallel_traverse().  This is reference-counted, since a worker task may not
+ * get around to starting until after the calling thread has already finished
+ * all of the work by itself and moved on.
+ */
+class CollisionTraverser::ParallelJob : public ReferenceCount {
+public:
+  // These may only be accessed by a thread that has claimed a pass.
+  CollisionTraverser *_trav;
+  LevelStatesSingle _level_states;
+  int _pipeline_stage;
+
+  // The entries detected in each pass, in the order they were found.
+  pvector<DeferredCollisionHandler::Entries> _results;
+  pvector<PT(DeferredCollisionHandler)> _handlers;
+
+  // The PStats levels counted during each pass.
+  pvector<CollisionLevelStateBase::LevelCounts> _levels;
+
+  patomic<size_t> _next_pass {0};
+  patomic_unsigned_lock_free _num_done {0};
+};
+
+/**
+ * The triangles of a Geom that is collided with as visible geometry, along
+ * with a hierarchy over them, so that a large Geom need not be decomposed and
+ * tested in its entirety for every collider.  See get_geom_triangle_bvh().
+ */
+class GeomTriangleBVH final : public CollisionBVH {
+public:
+  WCPT(Geom) _geom;
+  UpdateSeq _modified;
+
+  // Three vertices for each triangle.
+  pvector<LPoint3> _vertices;
+
+  // The same triangles again, packed for testing against lines.
+  CollisionTriangleBatch _batch;
+};
+
+typedef pmap<const Geom *, CPT(GeomTriangleBVH)> GeomTriangleBVHs;
+static LightMutex geom_triangle_bvhs_lock("CollisionTraverser::geom_triangle_bvhs");
+static GeomTriangleBVHs geom_triangle_bvhs;
+static size_t geom_triangle_bvhs_purge_size = 64;
+
+/**
+ * Appends the three vertices of each valid triangle of the indicated Geom to
+ * the vector, in the order they appear in the Geom.
+ */
+static void
+collect_geom_triangles(pvector<LPoint3> &vertices, const Geom *geom,
+                       const GeomVertexData *data) {
+  GeomVertexReader vertex(data, InternalName::get_vertex());
+
+  int num_primitives = geom->get_num_primitives();
+  for (int i = 0; i < num_primitives; ++i) {
+    const GeomPrimitive *primitive = geom->get_primitive(i);
+    CPT(GeomPrimitive) tris = primitive->decompose();
+    nassertv(tris->is_of_type(GeomTriangles::get_class_type()));
+
+    if (tris->is_indexed()) {
+      // Indexed case.
+      GeomVertexReader index(tris->get_vertices(), 0);
+      while (!index.is_at_end()) {
+        LPoint3 v[3];
+
+        vertex.set_row_unsafe(index.get_data1i());
+        v[0] = vertex.get_data3();
+        vertex.set_row_unsafe(index.get_data1i());
+        v[1] = vertex.get_data3();
+        vertex.set_row_unsafe(index.get_data1i());
+        v[2] = vertex.get_data3();
+
+        if (CollisionPolygon::verify_points(v[0], v[1], v[2])) {
+          vertices.insert(vertices.end(), v, v + 3);
+        }
+      }
+    } else {
+      // Non-indexed case.
+      vertex.set_row_unsafe(primitive->get_first_vertex());
+      int num_vertices = primitive->get_num_vertices();
+      for (int i = 0; i < num_vertices; i += 3) {
+        LPoint3 v[3];
+
+        v[0] = vertex.get_data3();
+        v[1] = vertex.get_data3();
+        v[2] = vertex.get_data3();
+
+        if (CollisionPolygon::verify_points(v[0], v[1], v[2])) {
+          vertices.insert(vertices.end(), v, v + 3);
+        }
+      }
+    }
+  }
+}
+
+/**
+ * Returns the cached triangles of the indicated Geom, with a hierarchy over
+ * them, building them first if they are not already cached or if the Geom
+ * was modified since.  Returns NULL if the Geom has fewer triangles than
+ * collision-bvh-min-solids, or if its vertices are animated, in which case it
+ * isn't worth keeping them around.
+ */
+static CPT(GeomTriangleBVH)
+get_geom_triangle_bvh(const Geom *geom, const GeomVertexData *data,
+                      Thread *current_thread) {
+  int min_triangles = collision_bvh_min_solids;
+  if (min_triangles <= 0 || data != geom->get_vertex_data(current_thread)) {
+    return nullptr;
+  }
+
+  // Any change to the Geom, its primitives or its vertices gets a newer
+  // modified stamp than anything that came before it.
+  UpdateSeq modified = std::max(geom->get_modified(current_thread),
+                                data->get_modified(current_thread));
+  int num_vertices = 0;
+  int num_primitives = geom->get_num_primitives();
+  for (int i = 0; i < num_primitives; ++i) {
+    const GeomPrimitive *primitive = geom->get_primitive(i);
+    modified = std::max(modified, primitive->get_modified());
+    num_vertices += primitive->get_num_vertices();
+  }
+  for (size_t ai = 0; ai < data->get_num_arrays(); ++ai) {
+    modified = std::max(modified, data->get_array(ai)->get_modified());
+  }
+
+  if (num_vertices < min_triangles * 3) {
+    return nullptr;
+  }
+
+  {
+    LightMutexHolder holder(geom_triangle_bvhs_lock);
+    GeomTriangleBVHs::const_iterator it = geom_triangle_bvhs.find(geom);
+    if (it != geom_triangle_bvhs.end()) {
+      const GeomTriangleBVH *bvh = (*it).second;
+      if (!bvh->_geom.was_deleted() && bvh->_modified == modified) {
+        return bvh;
+      }
+    }
+  }
+
+  PT(GeomTriangleBVH) bvh = new GeomTriangleBVH;
+  bvh->_geom = geom;
+  bvh->_modified = modified;
+  collect_geom_triangles(bvh->_vertices, geom, data);
+
+  size_t num_triangles = bvh->_vertices.size() / 3;
+  bvh->reserve(num_triangles);
+  bvh->_batch.reserve(num_triangles);
+  for (size_t ti = 0; ti < num_triangles; ++ti) {
+    const LPoint3 *v = &bvh->_vertices[ti * 3];
+    bvh->_batch.add_triangle(v[0], v[1], v[2]);
+    LPoint3 min_point = v[0];
+    LPoint3 max_point = v[0];
+    for (int j = 0; j < 3; ++j) {
+      min_point[j] = std::min(std::min(min_point[j], v[1][j]), v[2][j]);
+      max_point[j] = std::max(std::max(max_point[j], v[1][j]), v[2][j]);
+    }
+    bvh->add_item(min_point, max_point);
+  }
+  bvh->build();
+
+  LightMutexHolder holder(geom_triangle_bvhs_lock);
+  geom_triangle_bvhs[geom] = bvh;
+
+  if (geom_triangle_bvhs.size() >= geom_triangle_bvhs_purge_size) {
+    // Every so often, get rid of the entries of Geoms that have gone away.
+    GeomTriangleBVHs::iterator it = geom_triangle_bvhs.begin();
+    while (it != geom_triangle_bvhs.end()) {
+      if ((*it).second->_geom.was_deleted()) {
+        it = geom_triangle_bvhs.erase(it);
+      } else {
+        ++it;
+      }
+    }
+    geom_triangle_bvhs_purge_size = std::max((size_t)64, geom_triangle_bvhs.size() * 2);
+  }
+  return bvh;
+}
+
 /**
  *
  */
@@ -75,6 +294,7 @@ CollisionTraverser(const std::string &name) :
   _this_pcollector(_collisions_pcollector, name)
 {
   _respect_prev_transform = respect_prev_transform;
+  _num_threads = collision_num_threads;
   #ifdef DO_COLLISION_RECORDING
   _recorder = nullptr;
   #endif
@@ -273,8 +493,27 @@ traverse(const NodePath &root) {
   }
 
   bool traversal_done = false;
-  if ((int)_colliders.size() <= CollisionLevelStateSingle::get_max_colliders() ||
-      !allow_collider_multiple) {
+  if (_num_threads > 0 && _colliders.size() > 1 &&
+#ifdef DO_COLLISION_RECORDING
+      !has_recorder() &&
+#endif
+      Thread::is_threading_supported()) {
+    // Divide the colliders into enough groups to keep all of the threads
+    // busy, and traverse those in parallel.  There is no point in making the
+    // groups any bigger than a single pass can handle, though.
+    int num_colliders = (int)_colliders.size();
+    int max_colliders = (num_colliders + _num_threads) / (_num_threads + 1);
+    max_colliders = min(max_colliders, CollisionLevelStateSingle::get_max_colliders());
+
+    LevelStatesSingle level_states;
+    prepare_colliders_single(level_states, root, max_colliders);
+    parallel_traverse(level_states);
+    traversal_done = true;
+  }
+
+  if (!traversal_done &&
+      ((int)_colliders.size() <= CollisionLevelStateSingle::get_max_colliders() ||
+       !allow_collider_multiple)) {
     // Use the single-word-at-a-time traverser, which might need to make lots
     // of passes.
     LevelStatesSingle level_states;
@@ -490,13 +729,15 @@ write(std::ostream &out, int indent_level) const {
  * use.
  *
  * This flavor uses a CollisionLevelStateSingle, which is limited to a certain
- * number of colliders per pass (typically 32).
+ * number of colliders per pass (typically 32).  A smaller limit may be given
+ * in order to spread the colliders out over more passes.
  */
 void CollisionTraverser::
 prepare_colliders_single(CollisionTraverser::LevelStatesSingle &level_states,
-                         const NodePath &root) {
+                         const NodePath &root, int max_colliders) {
+  nassertv(max_colliders > 0 &&
+           max_colliders <= CollisionLevelStateSingle::get_max_colliders());
   int num_colliders = _colliders.size();
-  int max_colliders = CollisionLevelStateSingle::get_max_colliders();
 
   CollisionLevelStateSingle level_state(root);
   // This reserve() call is only correct if there is exactly one solid per
@@ -536,6 +777,10 @@ prepare_colliders_single(CollisionTraverser::LevelStatesSingle &level_states,
       def._node = cnode;
       def._node_path = cnode_path;
 
+      Colliders::const_iterator ci = _colliders.find(cnode_path);
+      nassertv(ci != _colliders.end());
+      def._handler = (*ci).second;
+
       int num_solids = cnode->get_num_solids();
       for (int s = 0; s < num_solids; ++s) {
         CPT(CollisionSolid) collider = cnode->get_solid(s);
@@ -596,7 +841,7 @@ r_traverse_single(CollisionLevelStateSingle &level_state, size_t pass) {
           entry._from = level_state.get_collider(c);
 
           compare_collider_to_node(
-              entry,
+              level_state, entry, level_state.get_collider_handler(c),
               level_state.get_parent_bound(c),
               level_state.get_local_bound(c),
               level_state.get_node_bound());
@@ -635,7 +880,7 @@ r_traverse_single(CollisionLevelStateSingle &level_state, size_t pass) {
           entry._from = level_state.get_collider(c);
 
           compare_collider_to_geom_node(
-              entry,
+              level_state, entry, level_state.get_collider_handler(c),
               level_state.get_parent_bound(c),
               level_state.get_local_bound(c),
               level_state.get_node_bound());
@@ -695,6 +940,132 @@ r_traverse_single(CollisionLevelStateSingle &level_state, size_t pass) {
   }
 }
 
+/**
+ * Traverses the given passes, as traverse() would, but divides them up between
+ * the current thread and the threads of the task manager's "parallel" task
+ * chain.  The entries detected by each pass are handed to the handlers
+ * afterwards, in pass order, so that the result does not depend on which
+ * thread got to which pass first.
+ */
+void CollisionTraverser::
+parallel_traverse(LevelStatesSingle &level_states) {
+  size_t num_passes = level_states.size();
+  if (num_passes == 0) {
+    return;
+  }
+
+  PT(ParallelJob) job = new ParallelJob;
+  job->_trav = this;
+  job->_level_states.swap(level_states);
+  job->_results.resize(num_passes);
+  job->_levels.resize(num_passes);
+  job->_pipeline_stage = Thread::get_current_pipeline_stage();
+
+  // Point each collider at a stand-in handler that stores its entries in the
+  // results for its own pass, since the real handlers can't be called from
+  // more than one thread at once.
+  for (size_t pass = 0; pass < num_passes; ++pass) {
+    CollisionLevelStateSingle &level_state = job->_level_states[pass];
+    size_t first_handler = job->_handlers.size();
+
+    int num_colliders = level_state.get_num_colliders();
+    for (int c = 0; c < num_colliders; ++c) {
+      CollisionLevelStateBase::ColliderDef &def = level_state._colliders[c];
+
+      DeferredCollisionHandler *deferred = nullptr;
+      for (size_t hi = first_handler; hi < job->_handlers.size(); ++hi) {
+        if (job->_handlers[hi]->_handler == def._handler) {
+          deferred = job->_handlers[hi];
+          break;
+        }
+      }
+      if (deferred == nullptr) {
+        deferred = new DeferredCollisionHandler(def._handler, job->_results[pass]);
+        job->_handlers.push_back(deferred);
+      }
+      def._handler = deferred;
+    }
+  }
+
+  if (num_passes > 1) {
+    AsyncTaskChain *chain = AsyncTaskManager::get_global_ptr()->get_parallel_chain();
+    int num_threads = std::min(_num_threads, chain->get_num_threads());
+
+    // The current thread pitches in too, so we need one task fewer than we
+    // have passes.
+    size_t num_tasks = std::min((size_t)std::max(num_threads, 0), num_passes - 1);
+    for (size_t ti = 0; ti < num_tasks; ++ti) {
+      chain->add([job](AsyncTask *task) {
+        do_parallel_job(job);
+        return AsyncTask::DS_done;
+      }, "collide");
+    }
+  }
+
+  do_parallel_job(job);
+
+  // Wait for the other threads to finish the passes they have claimed.
+  uint32_t num_done = job->_num_done.load(std::memory_order_acquire);
+  while (num_done < num_passes) {
+    job->_num_done.wait(num_done, std::memory_order_acquire);
+    num_done = job->_num_done.load(std::memory_order_acquire);
+  }
+
+  for (DeferredCollisionHandler::Entries &entries : job->_results) {
+    for (auto &pair : entries) {
+      pair.first->add_entry(pair.second);
+    }
+  }
+
+  for (const CollisionLevelStateBase::LevelCounts &levels : job->_levels) {
+    for (const CollisionLevelStateBase::LevelCounts::value_type &level : levels) {
+      level.first->add_level(level.second);
+    }
+  }
+}
+
+/**
+ * Claims and traverses passes of the given job until none are left.  Runs on
+ * any of the threads taking part in a parallel traversal.
+ */
+void CollisionTraverser::
+do_parallel_job(ParallelJob *job) {
+  size_t num_passes = job->_level_states.size();
+  size_t pass = job->_next_pass.fetch_add(1);
+  if (pass >= num_passes) {
+    // Someone else has already taken care of everything.
+    return;
+  }
+
+  // The worker threads must look at the same pipeline stage as the thread
+  // that started the job.
+  Thread *current_thread = Thread::get_current_thread();
+  int pipeline_stage = current_thread->get_pipeline_stage();
+  if (pipeline_stage != job->_pipeline_stage) {
+    current_thread->set_pipeline_stage(job->_pipeline_stage);
+  }
+
+  do {
+    // The PStats levels are counted separately for each pass, and added up
+    // by the thread that started the job.
+    CollisionLevelStateSingle &level_state = job->_level_states[pass];
+    level_state.set_deferred_levels(&job->_levels[pass]);
+    if (level_state.any_in_bounds()) {
+      job->_trav->r_traverse_single(level_state, pass);
+    }
+
+    if (job->_num_done.fetch_add(1, std::memory_order_release) + 1 == num_passes) {
+      job->_num_done.notify_all();
+    }
+
+    pass = job->_next_pass.fetch_add(1);
+  } while (pass < num_passes);
+
+  if (pipeline_stage != job->_pipeline_stage) {
+    current_thread->set_pipeline_stage(pipeline_stage);
+  }
+}
+
 /**
  * Fills up the set of LevelStates corresponding to the active colliders in
  * use.
@@ -746,6 +1117,10 @@ prepare_colliders_double(CollisionTraverser::LevelStatesDouble &level_states,
       def._node = cnode;
       def._node_path = cnode_path;
 
+      Colliders::const_iterator ci = _colliders.find(cnode_path);
+      nassertv(ci != _colliders.end());
+      def._handler = (*ci).second;
+
       int num_solids = cnode->get_num_solids();
       for (int s = 0; s < num_solids; ++s) {
         CPT(CollisionSolid) collider = cnode->get_solid(s);
@@ -805,7 +1180,7 @@ r_traverse_double(CollisionLevelStateDouble &level_state, size_t pass) {
           entry._from = level_state.get_collider(c);
 
           compare_collider_to_node(
-              entry,
+              level_state, entry, level_state.get_collider_handler(c),
               level_state.get_parent_bound(c),
               level_state.get_local_bound(c),
               level_state.get_node_bound());
@@ -844,7 +1219,7 @@ r_traverse_double(CollisionLevelStateDouble &level_state, size_t pass) {
           entry._from = level_state.get_collider(c);
 
           compare_collider_to_geom_node(
-              entry,
+              level_state, entry, level_state.get_collider_handler(c),
               level_state.get_parent_bound(c),
               level_state.get_local_bound(c),
               level_state.get_node_bound());
@@ -955,6 +1330,10 @@ prepare_colliders_quad(CollisionTraverser::LevelStatesQuad &level_states,
       def._node = cnode;
       def._node_path = cnode_path;
 
+      Colliders::const_iterator ci = _colliders.find(cnode_path);
+      nassertv(ci != _colliders.end());
+      def._handler = (*ci).second;
+
       int num_solids = cnode->get_num_solids();
       for (int s = 0; s < num_solids; ++s) {
         CPT(CollisionSolid) collider = cnode->get_solid(s);
@@ -1014,7 +1393,7 @@ r_traverse_quad(CollisionLevelStateQuad &level_state, size_t pass) {
           entry._from = level_state.get_collider(c);
 
           compare_collider_to_node(
-              entry,
+              level_state, entry, level_state.get_collider_handler(c),
               level_state.get_parent_bound(c),
               level_state.get_local_bound(c),
               level_state.get_node_bound());
@@ -1053,7 +1432,7 @@ r_traverse_quad(CollisionLevelStateQuad &level_state, size_t pass) {
           entry._from = level_state.get_collider(c);
 
           compare_collider_to_geom_node(
-              entry,
+              level_state, entry, level_state.get_collider_handler(c),
               level_state.get_parent_bound(c),
               level_state.get_local_bound(c),
               level_state.get_node_bound());
@@ -1117,7 +1496,8 @@ r_traverse_quad(CollisionLevelStateQuad &level_state, size_t pass) {
  *
  */
 void CollisionTraverser::
-compare_collider_to_node(CollisionEntry &entry,
+compare_collider_to_node(const CollisionLevelStateBase &level_state,
+                         CollisionEntry &entry, CollisionHandler *handler,
                          const GeometricBoundingVolume *from_parent_gbv,
                          const GeometricBoundingVolume *from_node_gbv,
                          const GeometricBoundingVolume *into_node_gbv) {
@@ -1125,7 +1505,7 @@ compare_collider_to_node(CollisionEntry &entry,
   if (from_parent_gbv != nullptr &&
       into_node_gbv != nullptr) {
     within_node_bounds = (into_node_gbv->contains(from_parent_gbv) != 0);
-    _cnode_volume_pcollector.add_level(1);
+    level_state.add_level(_cnode_volume_pcollector, 1);
   }
 
   if (within_node_bounds) {
@@ -1147,23 +1527,44 @@ compare_collider_to_node(CollisionEntry &entry,
     // we just tested, is the same as the solid's bounding volume.)
     if (num_solids == 1) {
       entry._into = cnode->_solids[0].get_read_pointer(current_thread);
-      Colliders::const_iterator ci;
-      ci = _colliders.find(entry.get_from_node_path());
-      nassertv(ci != _colliders.end());
-      entry.test_intersection((*ci).second, this);
+      test_intersection(level_state, entry, handler);
     } else {
-      CollisionNode::Solids::const_iterator si;
-      for (si = cnode->_solids.begin(); si != cnode->_solids.end(); ++si) {
-        entry._into = (*si).get_read_pointer(current_thread);
-
-        // We should allow a collision test for solid into itself, because the
-        // solid might be simply instanced into multiple different
-        // CollisionNodes.  We are already filtering out tests for a
-        // CollisionNode into itself.
-        CPT(BoundingVolume) solid_bv = entry._into->get_bounds();
-        const GeometricBoundingVolume *solid_gbv = solid_bv->as_geometric_bounding_volume();
-
-        compare_collider_to_solid(entry, from_node_gbv, solid_gbv);
+      CPT(CollisionBVH) bvh;
+      if (from_node_gbv != nullptr) {
+        bvh = cnode->get_bvh(current_thread);
+      }
+
+      if (bvh != nullptr) {
+        // The node has lots of solids.  Let the hierarchy pick out the few
+        // that are close enough to the collider to be worth testing.
+        nassertv(bvh->get_num_items() == cnode->_solids.size());
+        pvector<int> solids;
+        bvh->find_overlaps(from_node_gbv, solids);
+
+        for (int si : solids) {
+          entry._into = cnode->_solids[si].get_read_pointer(current_thread);
+
+          CPT(BoundingVolume) solid_bv = entry._into->get_bounds();
+          const GeometricBoundingVolume *solid_gbv = solid_bv->as_geometric_bounding_volume();
+
+          compare_collider_to_solid(level_state, entry, handler,
+                                    from_node_gbv, solid_gbv);
+        }
+      } else {
+        CollisionNode::Solids::const_iterator si;
+        for (si = cnode->_solids.begin(); si != cnode->_solids.end(); ++si) {
+          entry._into = (*si).get_read_pointer(current_thread);
+
+          // We should allow a collision test for solid into itself, because
+          // the solid might be simply instanced into multiple different
+          // CollisionNodes.  We are already filtering out tests for a
+          // CollisionNode into itself.
+          CPT(BoundingVolume) solid_bv = entry._into->get_bounds();
+          const GeometricBoundingVolume *solid_gbv = solid_bv->as_geometric_bounding_volume();
+
+          compare_collider_to_solid(level_state, entry, handler,
+                                    from_node_gbv, solid_gbv);
+        }
       }
     }
   }
@@ -1173,7 +1574,8 @@ compare_collider_to_node(CollisionEntry &entry,
  *
  */
 void CollisionTraverser::
-compare_collider_to_geom_node(CollisionEntry &entry,
+compare_collider_to_geom_node(const CollisionLevelStateBase &level_state,
+                              CollisionEntry &entry, CollisionHandler *handler,
                               const GeometricBoundingVolume *from_parent_gbv,
                               const GeometricBoundingVolume *from_node_gbv,
                               const GeometricBoundingVolume *into_node_gbv) {
@@ -1181,7 +1583,7 @@ compare_collider_to_geom_node(CollisionEntry &entry,
   if (from_parent_gbv != nullptr &&
       into_node_gbv != nullptr) {
     within_node_bounds = (into_node_gbv->contains(from_parent_gbv) != 0);
-    _gnode_volume_pcollector.add_level(1);
+    level_state.add_level(_gnode_volume_pcollector, 1);
   }
 
   if (within_node_bounds) {
@@ -1203,7 +1605,8 @@ compare_collider_to_geom_node(CollisionEntry &entry,
           geom_gbv = geom_bv->as_geometric_bounding_volume();
         }
 
-        compare_collider_to_geom(entry, geom, from_node_gbv, geom_gbv);
+        compare_collider_to_geom(level_state, entry, handler, geom,
+                                 from_node_gbv, geom_gbv);
       }
     }
   }
@@ -1213,7 +1616,8 @@ compare_collider_to_geom_node(CollisionEntry &entry,
  *
  */
 void CollisionTraverser::
-compare_collider_to_solid(CollisionEntry &entry,
+compare_collider_to_solid(const CollisionLevelStateBase &level_state,
+                          CollisionEntry &entry, CollisionHandler *handler,
                           const GeometricBoundingVolume *from_node_gbv,
                           const GeometricBoundingVolume *solid_gbv) {
   bool within_solid_bounds = true;
@@ -1221,7 +1625,8 @@ compare_collider_to_solid(CollisionEntry &entry,
       solid_gbv != nullptr) {
     within_solid_bounds = (solid_gbv->contains(from_node_gbv) != 0);
     #ifdef DO_PSTATS
-    ((CollisionSolid *)entry.get_into())->get_volume_pcollector().add_level(1);
+    CollisionSolid *into = (CollisionSolid *)entry.get_into();
+    level_state.add_level(into->get_volume_pcollector(), 1);
     #endif  // DO_PSTATS
 #ifndef NDEBUG
     if (collide_cat.is_spam()) {
@@ -1233,10 +1638,7 @@ compare_collider_to_solid(CollisionEntry &entry,
 #endif  // NDEBUG
   }
   if (within_solid_bounds) {
-    Colliders::const_iterator ci;
-    ci = _colliders.find(entry.get_from_node_path());
-    nassertv(ci != _colliders.end());
-    entry.test_intersection((*ci).second, this);
+    test_intersection(level_state, entry, handler);
   }
 }
 
@@ -1244,99 +1646,156 @@ compare_collider_to_solid(CollisionEntry &entry,
  *
  */
 void CollisionTraverser::
-compare_collider_to_geom(CollisionEntry &entry, const Geom *geom,
+compare_collider_to_geom(const CollisionLevelStateBase &level_state,
+                         CollisionEntry &entry, CollisionHandler *handler,
+                         const Geom *geom,
                          const GeometricBoundingVolume *from_node_gbv,
                          const GeometricBoundingVolume *geom_gbv) {
   bool within_geom_bounds = true;
   if (from_node_gbv != nullptr &&
       geom_gbv != nullptr) {
     within_geom_bounds = (geom_gbv->contains(from_node_gbv) != 0);
-    _geom_volume_pcollector.add_level(1);
+    level_state.add_level(_geom_volume_pcollector, 1);
   }
   if (within_geom_bounds) {
-    Colliders::const_iterator ci;
-    ci = _colliders.find(entry.get_from_node_path());
-    nassertv(ci != _colliders.end());
-
     if (geom->get_primitive_type() == Geom::PT_polygons) {
       Thread *current_thread = Thread::get_current_thread();
       CPT(GeomVertexData) data = geom->get_animated_vertex_data(true, current_thread);
-      GeomVertexReader vertex(data, InternalName::get_vertex());
-
-      int num_primitives = geom->get_num_primitives();
-      for (int i = 0; i < num_primitives; ++i) {
-        const GeomPrimitive *primitive = geom->get_primitive(i);
-        CPT(GeomPrimitive) tris = primitive->decompose();
-        nassertv(tris->is_of_type(GeomTriangles::get_class_type()));
-
-        if (tris->is_indexed()) {
-          // Indexed case.
-          GeomVertexReader index(tris->get_vertices(), 0);
-          while (!index.is_at_end()) {
-            LPoint3 v[3];
-
-            vertex.set_row_unsafe(index.get_data1i());
-            v[0] = vertex.get_data3();
-            vertex.set_row_unsafe(index.get_data1i());
-            v[1] = vertex.get_data3();
-            vertex.set_row_unsafe(index.get_data1i());
-            v[2] = vertex.get_data3();
-
-            // Generate a temporary CollisionGeom on the fly for each triangle
-            // in the Geom.
-            if (CollisionPolygon::verify_points(v[0], v[1], v[2])) {
-              bool within_solid_bounds = true;
-              if (from_node_gbv != nullptr) {
-                BoundingSphere sphere;
-                sphere.around(v, v + 3);
-                within_solid_bounds = (sphere.contains(from_node_gbv) != 0);
-#ifdef DO_PSTATS
-                CollisionGeom::_volume_pcollector.add_level(1);
-#endif  // DO_PSTATS
-              }
-              if (within_solid_bounds) {
-                PT(CollisionGeom) cgeom = new CollisionGeom(v[0], v[1], v[2]);
-                entry._into = cgeom;
-                entry.test_intersection((*ci).second, this);
-              }
-            }
-          }
-        } else {
-          // Non-indexed case.
-          vertex.set_row_unsafe(primitive->get_first_vertex());
-          int num_vertices = primitive->get_num_vertices();
-          for (int i = 0; i < num_vertices; i += 3) {
-            LPoint3 v[3];
-
-            v[0] = vertex.get_data3();
-            v[1] = vertex.get_data3();
-            v[2] = vertex.get_data3();
-
-            // Generate a temporary CollisionGeom on the fly for each triangle
-            // in the Geom.
-            if (CollisionPolygon::verify_points(v[0], v[1], v[2])) {
-              bool within_solid_bounds = true;
-              if (from_node_gbv != nullptr) {
-                BoundingSphere sphere;
-                sphere.around(v, v + 3);
-                within_solid_bounds = (sphere.contains(from_node_gbv) != 0);
-#ifdef DO_PSTATS
-                CollisionGeom::_volume_pcollector.add_level(1);
-#endif  // DO_PSTATS
-              }
-              if (within_solid_bounds) {
-                PT(CollisionGeom) cgeom = new CollisionGeom(v[0], v[1], v[2]);
-                entry._into = cgeom;
-                entry.test_intersection((*ci).second, this);
-              }
-            }
-          }
+
+      CPT(GeomTriangleBVH) bvh;
+      if (from_node_gbv != nullptr) {
+        bvh = get_geom_triangle_bvh(geom, data, current_thread);
+      }
+
+      if (bvh != nullptr) {
+        // The Geom has lots of triangles.  Let the hierarchy pick out the few
+        // that are close enough to the collider to be worth testing.
+        pvector<int> triangles;
+        bvh->find_overlaps(from_node_gbv, triangles);
+
+        LPoint3 origin;
+        LVector3 direction;
+        PN_stdfloat t_min, t_max;
+        if (!triangles.empty() &&
+            get_line_params(entry, handler, origin, direction, t_min, t_max)) {
+          // Rays, lines and segments are first tested against the triangles
+          // several at a time, which rules out most of them much more
+          // cheaply than the full test does.
+          pvector<int> candidates;
+          candidates.swap(triangles);
+          bvh->_batch.test_line(origin, direction, t_min, t_max,
+                                &candidates[0], candidates.size(), triangles);
+        }
+
+        for (int ti : triangles) {
+          compare_collider_to_triangle(level_state, entry, handler,
+                                       &bvh->_vertices[ti * 3], from_node_gbv);
+        }
+      } else {
+        pvector<LPoint3> vertices;
+        collect_geom_triangles(vertices, geom, data);
+
+        size_t num_vertices = vertices.size();
+        for (size_t vi = 0; vi < num_vertices; vi += 3) {
+          compare_collider_to_triangle(level_state, entry, handler,
+                                       &vertices[vi], from_node_gbv);
         }
       }
     }
   }
 }
 
+/**
+ * Asks the entry to test for an intersection between its from and into
+ * solids, passing the result to the indicated handler, and counts the test.
+ */
+void CollisionTraverser::
+test_intersection(const CollisionLevelStateBase &level_state,
+                  CollisionEntry &entry, CollisionHandler *handler) const {
+  entry.test_intersection(handler, this);
+#ifdef DO_PSTATS
+  CollisionSolid *into = (CollisionSolid *)entry.get_into();
+  level_state.add_level(into->get_test_pcollector(), 1);
+#endif  // DO_PSTATS
+}
+
+/**
+ * If the collider of the indicated entry is a ray, line or segment, fills in
+ * its origin and direction in the space of the into node, and the range of
+ * parameters along it that it covers, and returns true.  Otherwise, or if the
+ * line cannot be tested by a CollisionTriangleBatch without affecting the
+ * results, returns false.
+ */
+bool CollisionTraverser::
+get_line_params(const CollisionEntry &entry, const CollisionHandler *handler,
+                LPoint3 &origin, LVector3 &direction,
+                PN_stdfloat &t_min, PN_stdfloat &t_max) const {
+  if (handler->wants_all_potential_collidees()) {
+    // The handler wants to hear about the triangles that were not hit, too.
+    return false;
+  }
+#ifdef DO_COLLISION_RECORDING
+  if (has_recorder()) {
+    return false;
+  }
+#endif  // DO_COLLISION_RECORDING
+
+  const CollisionSolid *from = entry.get_from();
+  TypeHandle type = from->get_type();
+  if (type == CollisionRay::get_class_type()) {
+    const CollisionRay *ray = (const CollisionRay *)from;
+    origin = ray->get_origin();
+    direction = ray->get_direction();
+    t_min = 0;
+    t_max = FLT_MAX;
+
+  } else if (type == CollisionLine::get_class_type()) {
+    const CollisionLine *line = (const CollisionLine *)from;
+    origin = line->get_origin();
+    direction = line->get_direction();
+    t_min = -FLT_MAX;
+    t_max = FLT_MAX;
+
+  } else if (type == CollisionSegment::get_class_type()) {
+    const CollisionSegment *segment = (const CollisionSegment *)from;
+    origin = segment->get_point_a();
+    direction = segment->get_point_b() - segment->get_point_a();
+    t_min = 0;
+    t_max = 1;
+
+  } else {
+    return false;
+  }
+
+  const LMatrix4 &wrt_mat = entry.get_wrt_mat();
+  origin = origin * wrt_mat;
+  direction = direction * wrt_mat;
+  return true;
+}
+
+/**
+ * Tests the collider against a single triangle of a Geom, by generating a
+ * temporary CollisionGeom for it on the fly.
+ */
+void CollisionTraverser::
+compare_collider_to_triangle(const CollisionLevelStateBase &level_state,
+                             CollisionEntry &entry, CollisionHandler *handler,
+                             const LPoint3 *v,
+                             const GeometricBoundingVolume *from_node_gbv) {
+  bool within_solid_bounds = true;
+  if (from_node_gbv != nullptr) {
+    BoundingSphere sphere;
+    sphere.around(v, v + 3);
+    within_solid_bounds = (sphere.contains(from_node_gbv) != 0);
+    level_state.add_level(CollisionGeom::_volume_pcollector, 1);
+  }
+  if (within_solid_bounds) {
+    PT(CollisionGeom) cgeom = new CollisionGeom(v[0], v[1], v[2]);
+    entry._into = cgeom;
+    test_intersection(level_state, entry, handler);
+  }
+}
+
 /**
  * Removes the indicated CollisionHandler from the list of handlers to be
  * processed, and returns the iterator to the next handler in the list.  This
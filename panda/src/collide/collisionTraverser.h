@@ -53,6 +53,10 @@ PUBLISHED:
   MAKE_PROPERTY(respect_prev_transform, get_respect_prev_transform,
                                         set_respect_prev_transform);
 
+  INLINE void set_num_threads(int num_threads);
+  INLINE int get_num_threads() const;
+  MAKE_PROPERTY(num_threads, get_num_threads, set_num_threads);
+
   void add_collider(const NodePath &collider, CollisionHandler *handler);
   bool remove_collider(const NodePath &collider);
   bool has_collider(const NodePath &collider) const;
@@ -85,9 +89,14 @@ PUBLISHED:
 
 private:
   typedef pvector<CollisionLevelStateSingle> LevelStatesSingle;
-  void prepare_colliders_single(LevelStatesSingle &level_states, const NodePath &root);
+  void prepare_colliders_single(LevelStatesSingle &level_states, const NodePath &root,
+                                int max_colliders = CollisionLevelStateSingle::get_max_colliders());
   void r_traverse_single(CollisionLevelStateSingle &level_state, size_t pass);
 
+  class ParallelJob;
+  void parallel_traverse(LevelStatesSingle &level_states);
+  static void do_parallel_job(ParallelJob *job);
+
   typedef pvector<CollisionLevelStateDouble> LevelStatesDouble;
   void prepare_colliders_double(LevelStatesDouble &level_states, const NodePath &root);
   void r_traverse_double(CollisionLevelStateDouble &level_state, size_t pass);
@@ -96,20 +105,34 @@ private:
   void prepare_colliders_quad(LevelStatesQuad &level_states, const NodePath &root);
   void r_traverse_quad(CollisionLevelStateQuad &level_state, size_t pass);
 
-  void compare_collider_to_node(CollisionEntry &entry,
+  void compare_collider_to_node(const CollisionLevelStateBase &level_state,
+                                CollisionEntry &entry, CollisionHandler *handler,
                                 const GeometricBoundingVolume *from_parent_gbv,
                                 const GeometricBoundingVolume *from_node_gbv,
                                 const GeometricBoundingVolume *into_node_gbv);
-  void compare_collider_to_geom_node(CollisionEntry &entry,
+  void compare_collider_to_geom_node(const CollisionLevelStateBase &level_state,
+                                     CollisionEntry &entry, CollisionHandler *handler,
                                      const GeometricBoundingVolume *from_parent_gbv,
                                      const GeometricBoundingVolume *from_node_gbv,
                                      const GeometricBoundingVolume *into_node_gbv);
-  void compare_collider_to_solid(CollisionEntry &entry,
+  void compare_collider_to_solid(const CollisionLevelStateBase &level_state,
+                                 CollisionEntry &entry, CollisionHandler *handler,
                                  const GeometricBoundingVolume *from_node_gbv,
                                  const GeometricBoundingVolume *solid_gbv);
-  void compare_collider_to_geom(CollisionEntry &entry, const Geom *geom,
+  void compare_collider_to_geom(const CollisionLevelStateBase &level_state,
+                                CollisionEntry &entry, CollisionHandler *handler,
+                                const Geom *geom,
                                 const GeometricBoundingVolume *from_node_gbv,
                                 const GeometricBoundingVolume *solid_gbv);
+  void compare_collider_to_triangle(const CollisionLevelStateBase &level_state,
+                                    CollisionEntry &entry, CollisionHandler *handler,
+                                    const LPoint3 *v,
+                                    const GeometricBoundingVolume *from_node_gbv);
+  void test_intersection(const CollisionLevelStateBase &level_state,
+                         CollisionEntry &entry, CollisionHandler *handler) const;
+  bool get_line_params(const CollisionEntry &entry, const CollisionHandler *handler,
+                       LPoint3 &origin, LVector3 &direction,
+                       PN_stdfloat &t_min, PN_stdfloat &t_max) const;
 
   PStatCollector &get_pass_collector(int pass);
 
@@ -133,6 +156,7 @@ private:
   Handlers::iterator remove_handler(Handlers::iterator hi);
 
   bool _respect_prev_transform;
+  int _num_threads;
 #ifdef DO_COLLISION_RECORDING
   CollisionRecorder *_recorder;
   NodePath _collision_visualizer_np;
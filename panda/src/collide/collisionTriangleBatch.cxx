@@ -0,0 +1,394 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file collisionTriangleBatch.cxx
+ * @author agent
+ * @date 2026-10-16
+ */
+
+#include "collisionTriangleBatch.h"
+#include "config_collide.h"
+
+#include <float.h>
+
+#if defined(__SSE2__) || (_M_IX86_FP >= 2) || defined(_M_X64) || defined(_M_AMD64)
+// SSE2 support enabled at compile time.
+#define COLLIDE_SSE2 1
+#include <xmmintrin.h>
+#include <emmintrin.h>
+
+// AVX2 support is checked at runtime.  GCC and clang need to be told that
+// they may use AVX2 instructions in that particular function.
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && !defined(__EMSCRIPTEN__)
+#define COLLIDE_AVX2 1
+#define COLLIDE_TARGET_AVX2 __attribute__((target("avx2")))
+#include <immintrin.h>
+#elif defined(_MSC_VER)
+#define COLLIDE_AVX2 1
+#define COLLIDE_TARGET_AVX2
+#include <immintrin.h>
+#include <intrin.h>
+#endif
+#endif
+
+// The test is made this much more generous than it strictly needs to be, to
+// make sure that rounding errors never cause a triangle to be missed.  The
+// barycentric coordinates and the line parameter are dimensionless.
+static const float barycentric_epsilon = 0.01f;
+static const float t_epsilon = 0.001f;
+
+// Lines that are more parallel to a triangle than this are always let
+// through, since the above test is not reliable for those.
+static const float parallel_epsilon = 1.0e-6f;
+
+/**
+ * Tests the triangles in the range [begin, end) one at a time, and adds the
+ * indices of those that might intersect with the line to hits.
+ */
+static void
+test_line_scalar(const CollisionTriangleBatch::LineParams &p,
+                 const float *const *c, size_t begin, size_t end,
+                 int *hits, size_t &num_hits) {
+  typedef CollisionTriangleBatch CTB;
+
+  const float dx = p._direction[0];
+  const float dy = p._direction[1];
+  const float dz = p._direction[2];
+
+  for (size_t i = begin; i < end; ++i) {
+    float e1x = c[CTB::C_e1_x][i], e1y = c[CTB::C_e1_y][i], e1z = c[CTB::C_e1_z][i];
+    float e2x = c[CTB::C_e2_x][i], e2y = c[CTB::C_e2_y][i], e2z = c[CTB::C_e2_z][i];
+
+    float px = dy * e2z - dz * e2y;
+    float py = dz * e2x - dx * e2z;
+    float pz = dx * e2y - dy * e2x;
+    float det = e1x * px + e1y * py + e1z * pz;
+
+    if (fabsf(det) <= c[CTB::C_scale][i] * p._det_epsilon) {
+      hits[num_hits++] = (int)i;
+      continue;
+    }
+
+    float tx = p._origin[0] - c[CTB::C_v0_x][i];
+    float ty = p._origin[1] - c[CTB::C_v0_y][i];
+    float tz = p._origin[2] - c[CTB::C_v0_z][i];
+
+    float qx = ty * e1z - tz * e1y;
+    float qy = tz * e1x - tx * e1z;
+    float qz = tx * e1y - ty * e1x;
+
+    float inv_det = 1.0f / det;
+    float u = (tx * px + ty * py + tz * pz) * inv_det;
+    float v = (dx * qx + dy * qy + dz * qz) * inv_det;
+    float t = (e2x * qx + e2y * qy + e2z * qz) * inv_det;
+
+    if (u >= -barycentric_epsilon && v >= -barycentric_epsilon &&
+        u + v <= 1.0f + barycentric_epsilon &&
+        t >= p._t_min && t <= p._t_max) {
+      hits[num_hits++] = (int)i;
+    }
+  }
+}
+
+#ifdef COLLIDE_SSE2
+/**
+ * The SSE2 version of test_line_scalar(), which tests four triangles at once.
+ */
+static void
+test_line_sse2(const CollisionTriangleBatch::LineParams &p,
+               const float *const *c, size_t begin, size_t end,
+               int *hits, size_t &num_hits) {
+  typedef CollisionTriangleBatch CTB;
+
+  const __m128 ox = _mm_set1_ps(p._origin[0]);
+  const __m128 oy = _mm_set1_ps(p._origin[1]);
+  const __m128 oz = _mm_set1_ps(p._origin[2]);
+  const __m128 dx = _mm_set1_ps(p._direction[0]);
+  const __m128 dy = _mm_set1_ps(p._direction[1]);
+  const __m128 dz = _mm_set1_ps(p._direction[2]);
+  const __m128 t_min = _mm_set1_ps(p._t_min);
+  const __m128 t_max = _mm_set1_ps(p._t_max);
+  const __m128 det_epsilon = _mm_set1_ps(p._det_epsilon);
+  const __m128 neg_epsilon = _mm_set1_ps(-barycentric_epsilon);
+  const __m128 max_uv = _mm_set1_ps(1.0f + barycentric_epsilon);
+  const __m128 one = _mm_set1_ps(1.0f);
+  const __m128 abs_mask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+
+  size_t i = begin;
+  for (; i + 4 <= end; i += 4) {
+    __m128 e1x = _mm_loadu_ps(c[CTB::C_e1_x] + i);
+    __m128 e1y = _mm_loadu_ps(c[CTB::C_e1_y] + i);
+    __m128 e1z = _mm_loadu_ps(c[CTB::C_e1_z] + i);
+    __m128 e2x = _mm_loadu_ps(c[CTB::C_e2_x] + i);
+    __m128 e2y = _mm_loadu_ps(c[CTB::C_e2_y] + i);
+    __m128 e2z = _mm_loadu_ps(c[CTB::C_e2_z] + i);
+
+    __m128 px = _mm_sub_ps(_mm_mul_ps(dy, e2z), _mm_mul_ps(dz, e2y));
+    __m128 py = _mm_sub_ps(_mm_mul_ps(dz, e2x), _mm_mul_ps(dx, e2z));
+    __m128 pz = _mm_sub_ps(_mm_mul_ps(dx, e2y), _mm_mul_ps(dy, e2x));
+    __m128 det = _mm_add_ps(_mm_add_ps(_mm_mul_ps(e1x, px), _mm_mul_ps(e1y, py)),
+                            _mm_mul_ps(e1z, pz));
+
+    __m128 tx = _mm_sub_ps(ox, _mm_loadu_ps(c[CTB::C_v0_x] + i));
+    __m128 ty = _mm_sub_ps(oy, _mm_loadu_ps(c[CTB::C_v0_y] + i));
+    __m128 tz = _mm_sub_ps(oz, _mm_loadu_ps(c[CTB::C_v0_z] + i));
+
+    __m128 qx = _mm_sub_ps(_mm_mul_ps(ty, e1z), _mm_mul_ps(tz, e1y));
+    __m128 qy = _mm_sub_ps(_mm_mul_ps(tz, e1x), _mm_mul_ps(tx, e1z));
+    __m128 qz = _mm_sub_ps(_mm_mul_ps(tx, e1y), _mm_mul_ps(ty, e1x));
+
+    __m128 inv_det = _mm_div_ps(one, det);
+    __m128 u = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(tx, px), _mm_mul_ps(ty, py)),
+                                     _mm_mul_ps(tz, pz)), inv_det);
+    __m128 v = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, qx), _mm_mul_ps(dy, qy)),
+                                     _mm_mul_ps(dz, qz)), inv_det);
+    __m128 t = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(e2x, qx), _mm_mul_ps(e2y, qy)),
+                                     _mm_mul_ps(e2z, qz)), inv_det);
+
+    __m128 inside = _mm_and_ps(_mm_cmpge_ps(u, neg_epsilon),
+                               _mm_cmpge_ps(v, neg_epsilon));
+    inside = _mm_and_ps(inside, _mm_cmple_ps(_mm_add_ps(u, v), max_uv));
+    inside = _mm_and_ps(inside, _mm_cmpge_ps(t, t_min));
+    inside = _mm_and_ps(inside, _mm_cmple_ps(t, t_max));
+
+    __m128 scale = _mm_loadu_ps(c[CTB::C_scale] + i);
+    __m128 parallel = _mm_cmple_ps(_mm_and_ps(det, abs_mask),
+                                   _mm_mul_ps(scale, det_epsilon));
+
+    int mask = _mm_movemask_ps(_mm_or_ps(inside, parallel));
+    for (int lane = 0; mask != 0; ++lane, mask >>= 1) {
+      if (mask & 1) {
+        hits[num_hits++] = (int)(i + lane);
+      }
+    }
+  }
+
+  test_line_scalar(p, c, i, end, hits, num_hits);
+}
+#endif  // COLLIDE_SSE2
+
+#ifdef COLLIDE_AVX2
+/**
+ * The AVX2 version of test_line_scalar(), which tests eight triangles at once.
+ * This may only be called if the CPU supports AVX2.
+ */
+COLLIDE_TARGET_AVX2 static void
+test_line_avx2(const CollisionTriangleBatch::LineParams &p,
+               const float *const *c, size_t begin, size_t end,
+               int *hits, size_t &num_hits) {
+  typedef CollisionTriangleBatch CTB;
+
+  const __m256 ox = _mm256_set1_ps(p._origin[0]);
+  const __m256 oy = _mm256_set1_ps(p._origin[1]);
+  const __m256 oz = _mm256_set1_ps(p._origin[2]);
+  const __m256 dx = _mm256_set1_ps(p._direction[0]);
+  const __m256 dy = _mm256_set1_ps(p._direction[1]);
+  const __m256 dz = _mm256_set1_ps(p._direction[2]);
+  const __m256 t_min = _mm256_set1_ps(p._t_min);
+  const __m256 t_max = _mm256_set1_ps(p._t_max);
+  const __m256 det_epsilon = _mm256_set1_ps(p._det_epsilon);
+  const __m256 neg_epsilon = _mm256_set1_ps(-barycentric_epsilon);
+  const __m256 max_uv = _mm256_set1_ps(1.0f + barycentric_epsilon);
+  const __m256 one = _mm256_set1_ps(1.0f);
+  const __m256 abs_mask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+
+  size_t i = begin;
+  for (; i + 8 <= end; i += 8) {
+    __m256 e1x = _mm256_loadu_ps(c[CTB::C_e1_x] + i);
+    __m256 e1y = _mm256_loadu_ps(c[CTB::C_e1_y] + i);
+    __m256 e1z = _mm256_loadu_ps(c[CTB::C_e1_z] + i);
+    __m256 e2x = _mm256_loadu_ps(c[CTB::C_e2_x] + i);
+    __m256 e2y = _mm256_loadu_ps(c[CTB::C_e2_y] + i);
+    __m256 e2z = _mm256_loadu_ps(c[CTB::C_e2_z] + i);
+
+    __m256 px = _mm256_sub_ps(_mm256_mul_ps(dy, e2z), _mm256_mul_ps(dz, e2y));
+    __m256 py = _mm256_sub_ps(_mm256_mul_ps(dz, e2x), _mm256_mul_ps(dx, e2z));
+    __m256 pz = _mm256_sub_ps(_mm256_mul_ps(dx, e2y), _mm256_mul_ps(dy, e2x));
+    __m256 det = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(e1x, px), _mm256_mul_ps(e1y, py)),
+                               _mm256_mul_ps(e1z, pz));
+
+    __m256 tx = _mm256_sub_ps(ox, _mm256_loadu_ps(c[CTB::C_v0_x] + i));
+    __m256 ty = _mm256_sub_ps(oy, _mm256_loadu_ps(c[CTB::C_v0_y] + i));
+    __m256 tz = _mm256_sub_ps(oz, _mm256_loadu_ps(c[CTB::C_v0_z] + i));
+
+    __m256 qx = _mm256_sub_ps(_mm256_mul_ps(ty, e1z), _mm256_mul_ps(tz, e1y));
+    __m256 qy = _mm256_sub_ps(_mm256_mul_ps(tz, e1x), _mm256_mul_ps(tx, e1z));
+    __m256 qz = _mm256_sub_ps(_mm256_mul_ps(tx, e1y), _mm256_mul_ps(ty, e1x));
+
+    __m256 inv_det = _mm256_div_ps(one, det);
+    __m256 u = _mm256_mul_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(tx, px), _mm256_mul_ps(ty, py)),
+                                           _mm256_mul_ps(tz, pz)), inv_det);
+    __m256 v = _mm256_mul_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(dx, qx), _mm256_mul_ps(dy, qy)),
+                                           _mm256_mul_ps(dz, qz)), inv_det);
+    __m256 t = _mm256_mul_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(e2x, qx), _mm256_mul_ps(e2y, qy)),
+                                           _mm256_mul_ps(e2z, qz)), inv_det);
+
+    __m256 inside = _mm256_and_ps(_mm256_cmp_ps(u, neg_epsilon, _CMP_GE_OQ),
+                                  _mm256_cmp_ps(v, neg_epsilon, _CMP_GE_OQ));
+    inside = _mm256_and_ps(inside, _mm256_cmp_ps(_mm256_add_ps(u, v), max_uv, _CMP_LE_OQ));
+    inside = _mm256_and_ps(inside, _mm256_cmp_ps(t, t_min, _CMP_GE_OQ));
+    inside = _mm256_and_ps(inside, _mm256_cmp_ps(t, t_max, _CMP_LE_OQ));
+
+    __m256 scale = _mm256_loadu_ps(c[CTB::C_scale] + i);
+    __m256 parallel = _mm256_cmp_ps(_mm256_and_ps(det, abs_mask),
+                                    _mm256_mul_ps(scale, det_epsilon), _CMP_LE_OQ);
+
+    int mask = _mm256_movemask_ps(_mm256_or_ps(inside, parallel));
+    for (int lane = 0; mask != 0; ++lane, mask >>= 1) {
+      if (mask & 1) {
+        hits[num_hits++] = (int)(i + lane);
+      }
+    }
+  }
+
+  test_line_scalar(p, c, i, end, hits, num_hits);
+}
+
+/**
+ * Returns true if the CPU and operating system support AVX2 instructions.
+ */
+static bool
+has_avx2() {
+#ifdef _MSC_VER
+  int info[4];
+  __cpuid(info, 1);
+  if ((info[2] & (1 << 27)) == 0 || (info[2] & (1 << 28)) == 0) {
+    // No OSXSAVE or no AVX.
+    return false;
+  }
+  if ((_xgetbv(0) & 6) != 6) {
+    // The OS does not save the YMM registers.
+    return false;
+  }
+  __cpuidex(info, 7, 0);
+  return (info[1] & (1 << 5)) != 0;
+#else
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("avx2") != 0;
+#endif
+}
+#endif  // COLLIDE_AVX2
+
+/**
+ * Indicates an intention to add the indicated number of triangles.
+ */
+void CollisionTriangleBatch::
+reserve(size_t num_triangles) {
+  for (int ci = 0; ci < C_num_components; ++ci) {
+    _components[ci].reserve(num_triangles);
+  }
+}
+
+/**
+ * Adds a new triangle.  Its index is the number of triangles that were added
+ * before it.
+ */
+void CollisionTriangleBatch::
+add_triangle(const LPoint3 &a, const LPoint3 &b, const LPoint3 &c) {
+  LVector3 e1 = b - a;
+  LVector3 e2 = c - a;
+
+  for (int i = 0; i < 3; ++i) {
+    _components[C_v0_x + i].push_back((float)a[i]);
+    _components[C_e1_x + i].push_back((float)e1[i]);
+    _components[C_e2_x + i].push_back((float)e2[i]);
+  }
+  _components[C_scale].push_back((float)(e1.length() * e2.length()));
+}
+
+/**
+ * Finds which of the triangles with the indicated indices, which should be in
+ * increasing order, might intersect with the line through origin in the
+ * indicated direction, between the parameters t_min and t_max (which may be
+ * +/- FLT_MAX to indicate a ray or an infinite line), and adds their indices
+ * to hits in the same order.
+ */
+void CollisionTriangleBatch::
+test_line(const LPoint3 &origin, const LVector3 &direction,
+          PN_stdfloat t_min, PN_stdfloat t_max,
+          const int *triangles, size_t num_triangles,
+          pvector<int> &hits) const {
+  if (num_triangles == 0) {
+    return;
+  }
+
+  LineParams params;
+  make_line_params(params, origin, direction, t_min, t_max);
+
+  LineKernel *kernel = get_line_kernel();
+
+  // Copy the triangles into a small packed block at a time, so that the
+  // kernel can still process several of them at once.
+  static const size_t block_size = 64;
+  float block[C_num_components][block_size];
+  const float *components[C_num_components];
+  for (int ci = 0; ci < C_num_components; ++ci) {
+    components[ci] = block[ci];
+  }
+  int block_hits[block_size];
+
+  for (size_t begin = 0; begin < num_triangles; begin += block_size) {
+    size_t count = std::min(block_size, num_triangles - begin);
+    for (int ci = 0; ci < C_num_components; ++ci) {
+      const float *from = &_components[ci][0];
+      for (size_t i = 0; i < count; ++i) {
+        block[ci][i] = from[triangles[begin + i]];
+      }
+    }
+
+    size_t num_block_hits = 0;
+    (*kernel)(params, components, 0, count, block_hits, num_block_hits);
+    for (size_t hi = 0; hi < num_block_hits; ++hi) {
+      hits.push_back(triangles[begin + block_hits[hi]]);
+    }
+  }
+}
+
+/**
+ * Returns the fastest line test that the CPU supports.
+ */
+CollisionTriangleBatch::LineKernel *CollisionTriangleBatch::
+get_line_kernel() {
+  // The choice is made only once, by whichever thread gets here first; the
+  // initialization of a function-local static is thread-safe.
+  static LineKernel *const kernel = [] () {
+    LineKernel *best = &test_line_scalar;
+#ifdef COLLIDE_SSE2
+    best = &test_line_sse2;
+#endif
+#ifdef COLLIDE_AVX2
+    if (has_avx2()) {
+      best = &test_line_avx2;
+    }
+#endif
+
+    if (collide_cat.is_debug()) {
+      collide_cat.debug()
+        << "Using " << (best == &test_line_scalar ? "scalar" : "SIMD")
+        << " routines for batched triangle tests.\n";
+    }
+    return best;
+  } ();
+  return kernel;
+}
+
+/**
+ * Converts the line to the form expected by the kernels.
+ */
+void CollisionTriangleBatch::
+make_line_params(LineParams &params, const LPoint3 &origin,
+                 const LVector3 &direction,
+                 PN_stdfloat t_min, PN_stdfloat t_max) {
+  for (int i = 0; i < 3; ++i) {
+    params._origin[i] = (float)origin[i];
+    params._direction[i] = (float)direction[i];
+  }
+  params._t_min = (t_min <= -FLT_MAX) ? -FLT_MAX : (float)t_min - t_epsilon;
+  params._t_max = (t_max >= FLT_MAX) ? FLT_MAX : (float)t_max + t_epsilon;
+  params._det_epsilon = parallel_epsilon * (float)direction.length();
+}
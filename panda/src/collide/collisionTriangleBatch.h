@@ -0,0 +1,82 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file collisionTriangleBatch.h
+ * @author agent
+ * @date 2026-10-16
+ */
+
+#ifndef COLLISIONTRIANGLEBATCH_H
+#define COLLISIONTRIANGLEBATCH_H
+
+#include "pandabase.h"
+
+#include "luse.h"
+#include "pvector.h"
+
+/**
+ * A packed array of triangles, stored component by component, that can be
+ * tested against a line, ray or segment several triangles at a time using
+ * SSE2 or AVX2 instructions.  The instruction set is chosen at runtime,
+ * according to what the CPU supports.
+ *
+ * This is only meant to quickly rule out most of the triangles of a large
+ * mesh; the test is deliberately a little generous, and the triangles that
+ * pass it still need to be tested properly by a CollisionPolygon.
+ */
+class EXPCL_PANDA_COLLIDE CollisionTriangleBatch {
+public:
+  CollisionTriangleBatch() = default;
+
+  void reserve(size_t num_triangles);
+  void add_triangle(const LPoint3 &a, const LPoint3 &b, const LPoint3 &c);
+
+  INLINE size_t get_num_triangles() const;
+
+  void test_line(const LPoint3 &origin, const LVector3 &direction,
+                 PN_stdfloat t_min, PN_stdfloat t_max,
+                 const int *triangles, size_t num_triangles,
+                 pvector<int> &hits) const;
+
+public:
+  // The first vertex, the two edges leaving it, and the product of the
+  // lengths of the edges, each stored as a separate array.
+  enum Component {
+    C_v0_x, C_v0_y, C_v0_z,
+    C_e1_x, C_e1_y, C_e1_z,
+    C_e2_x, C_e2_y, C_e2_z,
+    C_scale,
+    C_num_components
+  };
+
+  class LineParams {
+  public:
+    float _origin[3];
+    float _direction[3];
+    float _t_min;
+    float _t_max;
+    float _det_epsilon;
+  };
+
+  typedef void LineKernel(const LineParams &params,
+                          const float *const *components,
+                          size_t begin, size_t end, int *hits,
+                          size_t &num_hits);
+
+private:
+  static LineKernel *get_line_kernel();
+  static void make_line_params(LineParams &params, const LPoint3 &origin,
+                               const LVector3 &direction,
+                               PN_stdfloat t_min, PN_stdfloat t_max);
+
+  pvector<float> _components[C_num_components];
+};
+
+#include "collisionTriangleBatch.I"
+
+#endif
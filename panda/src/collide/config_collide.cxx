@@ -78,6 +78,31 @@ ConfigVariableBool allow_collider_multiple
           "false, a one-word BitMask is always used instead, which is faster "
           "per pass, but may require more passes."));
 
+ConfigVariableInt collision_num_threads
+("collision-num-threads", 0,
+ PRC_DESC("The default number of worker threads that a CollisionTraverser may "
+          "use to help out with its traversal.  When this is greater than 0, "
+          "the colliders are divided into groups, which are traversed "
+          "in parallel by the calling thread and up to this many threads "
+          "of the task manager's \"parallel\" task chain (see "
+          "parallel-task-threads).  The detected collisions are handed to "
+          "the CollisionHandlers afterwards, on the calling thread, in an "
+          "order that does not depend on the timing of the threads.  This "
+          "may be changed for a particular traverser with "
+          "CollisionTraverser::set_num_threads().  Parallel traversal is not "
+          "used while a CollisionRecorder is attached."));
+
+ConfigVariableInt collision_bvh_min_solids
+("collision-bvh-min-solids", 16,
+ PRC_DESC("A CollisionNode with at least this many solids, or a Geom with at "
+          "least this many triangles that is collided with as visible "
+          "geometry, gets a bounding volume hierarchy the first time a "
+          "collider reaches it.  The CollisionTraverser then uses this to "
+          "find the few solids or triangles near each collider, instead of "
+          "testing all of them.  The hierarchy is rebuilt automatically "
+          "when the solids or the vertices change.  Set this to 0 to "
+          "disable this."));
+
 ConfigVariableBool flatten_collision_nodes
 ("flatten-collision-nodes", false,
  PRC_DESC("Set this true to allow NodePath::flatten_medium() and "
@@ -25,6 +25,8 @@ NotifyCategoryDecl(collide, EXPCL_PANDA_COLLIDE, EXPTP_PANDA_COLLIDE);
 extern EXPCL_PANDA_COLLIDE ConfigVariableBool respect_prev_transform;
 extern EXPCL_PANDA_COLLIDE ConfigVariableBool respect_effective_normal;
 extern EXPCL_PANDA_COLLIDE ConfigVariableBool allow_collider_multiple;
+extern EXPCL_PANDA_COLLIDE ConfigVariableInt collision_num_threads;
+extern EXPCL_PANDA_COLLIDE ConfigVariableInt collision_bvh_min_solids;
 extern EXPCL_PANDA_COLLIDE ConfigVariableBool flatten_collision_nodes;
 extern EXPCL_PANDA_COLLIDE ConfigVariableDouble collision_parabola_bounds_threshold;
 extern EXPCL_PANDA_COLLIDE ConfigVariableInt collision_parabola_bounds_sample;
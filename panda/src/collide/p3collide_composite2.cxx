@@ -12,4 +12,5 @@
 #include "collisionSolid.cxx"
 #include "collisionSphere.cxx"
 #include "collisionTraverser.cxx"
+#include "collisionTriangleBatch.cxx"
 #include "collisionVisualizer.cxx"
@@ -305,6 +305,18 @@ ConfigVariableBool allow_incomplete_render
           "geometry is always paged in immediately when needed, holding up "
           "the frame render if necessary."));
 
+ConfigVariableInt texture_stream_budget
+("texture-stream-budget", 0,
+ PRC_DESC("If this is nonzero, mipmapped textures are streamed into graphics "
+          "memory progressively, smallest mipmap level first, uploading no "
+          "more than this many bytes of texture images per frame.  A "
+          "texture is first rendered using only the smaller mipmap levels "
+          "that fit within the budget, and the larger levels follow on "
+          "subsequent frames in which the texture is rendered.  This only "
+          "applies when allow-incomplete-render is in effect, and only to "
+          "textures that have their mipmap levels in RAM.  Set this to 0 to "
+          "always upload the complete texture at once."));
+
 ConfigVariableBool old_alpha_blend
 ("old-alpha-blend", false,
  PRC_DESC("Set this to true to enable the old alpha blending behavior from "
@@ -101,6 +101,8 @@ PStatCollector GraphicsEngine::_vertex_data_resident_pcollector("Vertex Data:Res
 PStatCollector GraphicsEngine::_vertex_data_compressed_pcollector("Vertex Data:Compressed");
 PStatCollector GraphicsEngine::_vertex_data_unused_disk_pcollector("Vertex Data:Disk:Unused");
 PStatCollector GraphicsEngine::_vertex_data_used_disk_pcollector("Vertex Data:Disk:Used");
+PStatCollector GraphicsEngine::_texture_ram_resident_pcollector("Texture RAM:Resident");
+PStatCollector GraphicsEngine::_texture_ram_evicted_pcollector("Texture RAM:Evicted");
 
 // These are counted independently by the collision system; we redefine them
 // here so we can reset them at each frame.
@@ -863,6 +865,8 @@ render_frame() {
     GeomCacheManager::_geom_cache_record_pcollector.clear_level();
     GeomCacheManager::_geom_cache_erase_pcollector.clear_level();
     GeomCacheManager::_geom_cache_evict_pcollector.clear_level();
+    RenderState::clear_level();
+    TransformState::clear_level();
 
     GraphicsStateGuardian::init_frame_pstats();
 
@@ -918,11 +922,15 @@ render_frame() {
       _vertex_data_compressed_pcollector.set_level(compressed);
       _vertex_data_unused_disk_pcollector.set_level(total_disk - used_disk);
       _vertex_data_used_disk_pcollector.set_level(used_disk);
+
+      _texture_ram_resident_pcollector.set_level(Texture::get_ram_image_lru()->get_total_size());
+      _texture_ram_evicted_pcollector.set_level(Texture::get_ram_image_evicted_size());
     }
 
 #endif  // DO_PSTATS
 
     GeomVertexArrayData::lru_epoch();
+    Texture::lru_epoch();
 
     // Now signal all of our threads to begin their next frame.
     Threads::const_iterator ti;
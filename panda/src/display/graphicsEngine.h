@@ -387,6 +387,8 @@ private:
   static PStatCollector _vertex_data_compressed_pcollector;
   static PStatCollector _vertex_data_used_disk_pcollector;
   static PStatCollector _vertex_data_unused_disk_pcollector;
+  static PStatCollector _texture_ram_resident_pcollector;
+  static PStatCollector _texture_ram_evicted_pcollector;
 
   static PStatCollector _cnode_volume_pcollector;
   static PStatCollector _gnode_volume_pcollector;
@@ -15,5 +15,6 @@
 #ifdef IS_OSX
 #include "subprocessWindowBuffer.cxx"
 #endif
+#include "textureStreamBudget.cxx"
 #include "windowHandle.cxx"
 #include "windowProperties.cxx"
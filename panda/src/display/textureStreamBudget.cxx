@@ -0,0 +1,71 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file textureStreamBudget.cxx
+ * @author agent
+ * @date 2026-10-17
+ */
+
+#include "textureStreamBudget.h"
+#include "texture.h"
+
+/**
+ * Returns true if what is left of this frame's budget is enough to upload a
+ * texture that is currently resident from base_level again from a larger
+ * mipmap level.
+ */
+bool TextureStreamBudget::
+can_step(Texture *tex, int base_level) const {
+  return get_stream_level(tex, _bytes_left) < base_level;
+}
+
+/**
+ * Returns the mipmap level, but no lower than min_level, from which the
+ * texture should be uploaded now, and deducts the size of that level and of
+ * all the smaller levels from this frame's budget.
+ *
+ * The smallest level is always chosen when nothing larger fits, so that the
+ * texture is at least partially resident; in that case, the budget is used up.
+ */
+int TextureStreamBudget::
+reserve(Texture *tex, int min_level) {
+  int level = get_stream_level(tex, _bytes_left, min_level);
+
+  size_t bytes = 0;
+  for (int n = level; n < tex->get_num_ram_mipmap_images(); ++n) {
+    bytes += tex->get_ram_mipmap_image_size(n);
+  }
+  _bytes_left -= std::min(bytes, _bytes_left);
+  return level;
+}
+
+/**
+ * Returns the lowest mipmap level, but no lower than min_level, for which that
+ * level and all of the smaller levels of the texture's RAM image together fit
+ * within the indicated number of bytes.  If not even the smallest level fits,
+ * returns the smallest level.
+ */
+int TextureStreamBudget::
+get_stream_level(Texture *tex, size_t budget, int min_level) {
+  nassertr(tex != nullptr, min_level);
+  int level = tex->get_num_ram_mipmap_images() - 1;
+  if (level <= min_level) {
+    return min_level;
+  }
+
+  size_t size = tex->get_ram_mipmap_image_size(level);
+  while (level > min_level) {
+    size_t next_size = size + tex->get_ram_mipmap_image_size(level - 1);
+    if (next_size > budget) {
+      break;
+    }
+    size = next_size;
+    --level;
+  }
+  return level;
+}
@@ -0,0 +1,51 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file textureStreamBudget.h
+ * @author agent
+ * @date 2026-10-17
+ */
+
+#ifndef TEXTURESTREAMBUDGET_H
+#define TEXTURESTREAMBUDGET_H
+
+#include "pandabase.h"
+
+class Texture;
+
+/**
+ * Keeps track of how many bytes of texture images a GSG may still upload in
+ * the current frame while texture-stream-budget is in effect, and decides
+ * which mipmap levels of a texture to upload within that budget.
+ *
+ * A texture that is being streamed in is first uploaded from one of its
+ * smallest mipmap levels.  On each subsequent frame in which it is rendered,
+ * it is uploaded again from the largest level for which there is room, until
+ * it is complete.
+ *
+ * This class may only be used on the draw thread.
+ */
+class EXPCL_PANDA_DISPLAY TextureStreamBudget {
+public:
+  INLINE TextureStreamBudget();
+
+  INLINE void begin_frame(int budget);
+  INLINE size_t get_bytes_left() const;
+
+  bool can_step(Texture *tex, int base_level) const;
+  int reserve(Texture *tex, int min_level);
+
+  static int get_stream_level(Texture *tex, size_t budget, int min_level = 0);
+
+private:
+  size_t _bytes_left;
+};
+
+#include "textureStreamBudget.I"
+
+#endif
@@ -18,6 +18,10 @@
 #include "pset.h"
 #include "vector_string.h"
 #include "virtualFileSystem.h"
+#include "genericThread.h"
+#include "lightMutex.h"
+#include "lightMutexHolder.h"
+#include "patomic.h"
 #include <stdio.h>
 #include <time.h>
 
@@ -47,6 +51,8 @@ bool got_header_prefix = false;
 Filename chdir_to;             // -C
 bool got_chdir_to = false;
 size_t scale_factor = 0;       // -F
+int block_size = -1;           // -B
+int num_threads = 1;           // -j
 pset<string> dont_compress;    // -Z
 pset<string> text_ext;         // -X
 vector_string sign_params;     // -S
@@ -199,6 +205,21 @@ help() {
     "      size of the Multifile will be limited to 4GB * scale_factor.  The size\n"
     "      of individual subfiles may not exceed 4GB in any case.\n\n"
 
+    "  -B <block_size>\n"
+    "      Specify the uncompressed size of the blocks in which subfiles are\n"
+    "      compressed when -z is in effect.  Each block is compressed on its own,\n"
+    "      so that a compressed subfile can be read starting from any point\n"
+    "      without decompressing all of the data before it.  Such a Multifile\n"
+    "      can't be read by older versions of Panda.  Specify -B 0 to compress\n"
+    "      each subfile as a single stream.  The default is given by the\n"
+    "      Config.prc variable multifile-compression-block-size, which is 0\n"
+    "      unless otherwise configured.\n\n"
+
+    "  -j <num_threads>\n"
+    "      With -x, extract this many subfiles at once, each on its own thread,\n"
+    "      so that the decompression is spread across the available CPU cores.\n"
+    "      The default is 1.\n\n"
+
     "  -C <extract_dir>\n"
 
     "      Change to the named directory before working on files;\n"
@@ -409,6 +430,10 @@ add_files(const vector_string &params) {
     multifile->set_scale_factor(scale_factor);
   }
 
+  if (block_size >= 0) {
+    multifile->set_compression_block_size((size_t)block_size);
+  }
+
   pvector<Filename> filenames;
   filenames.reserve(params.size());
   vector_string::const_iterator si;
@@ -452,6 +477,62 @@ add_files(const vector_string &params) {
   return okflag;
 }
 
+bool
+extract_files_threaded(Multifile *multifile, const vector_string &params) {
+  // Extracts the named subfiles using num_threads threads, which take turns
+  // picking the next subfile off the list.  The Multifile reads each part of
+  // the file atomically, so the subfiles can all be read at the same time.
+  pvector<int> indices;
+  int num_subfiles = multifile->get_num_subfiles();
+  for (int i = 0; i < num_subfiles; i++) {
+    if (is_named(multifile->get_subfile_name(i), params)) {
+      indices.push_back(i);
+    }
+  }
+
+  patomic<size_t> next_index(0);
+  patomic<bool> okflag(true);
+  LightMutex output_lock("multify-output");
+
+  auto extract = [&] () {
+    size_t n;
+    while ((n = next_index.fetch_add(1)) < indices.size()) {
+      int i = indices[n];
+      string subfile_name = multifile->get_subfile_name(i);
+      Filename filename = subfile_name;
+      if (got_chdir_to) {
+        filename = Filename(chdir_to, subfile_name);
+      }
+      if (verbose) {
+        LightMutexHolder holder(output_lock);
+        cout << filename << "\n";
+      }
+      if (!multifile->extract_subfile(i, filename)) {
+        LightMutexHolder holder(output_lock);
+        cerr << "Unable to extract " << filename << ".\n";
+        okflag = false;
+      }
+    }
+  };
+
+  pvector<PT(GenericThread)> threads;
+  for (int t = 1; t < num_threads; ++t) {
+    PT(GenericThread) thread = new GenericThread("multify-extract", "multify-extract", extract);
+    if (thread->start(TP_normal, true)) {
+      threads.push_back(std::move(thread));
+    }
+  }
+
+  // This thread does its share of the work too.
+  extract();
+
+  for (GenericThread *thread : threads) {
+    thread->join();
+  }
+
+  return okflag;
+}
+
 bool
 extract_files(const vector_string &params) {
   if (!multifile_name.exists()) {
@@ -485,6 +566,12 @@ extract_files(const vector_string &params) {
   }
 
   // Now walk back through the list and this time do the extraction.
+  if (num_threads > 1 && !to_stdout && Thread::is_threading_supported()) {
+    return extract_files_threaded(multifile, params);
+  }
+
+  bool okflag = true;
+
   for (i = 0; i < num_subfiles; i++) {
     string subfile_name = multifile->get_subfile_name(i);
     if (is_named(subfile_name, params)) {
@@ -496,17 +583,23 @@ extract_files(const vector_string &params) {
         if (verbose) {
           cerr << filename << "\n";
         }
-        multifile->extract_subfile_to(i, cout);
+        if (!multifile->extract_subfile_to(i, cout)) {
+          cerr << "Unable to extract " << filename << ".\n";
+          okflag = false;
+        }
       } else {
         if (verbose) {
           cout << filename << "\n";
         }
-        multifile->extract_subfile(i, filename);
+        if (!multifile->extract_subfile(i, filename)) {
+          cerr << "Unable to extract " << filename << ".\n";
+          okflag = false;
+        }
       }
     }
   }
 
-  return true;
+  return okflag;
 }
 
 bool
@@ -808,7 +901,7 @@ main(int argc, char **argv) {
 
   extern char *optarg;
   extern int optind;
-  static const char *optflags = "crutxkvz123456789Z:T:X:S:f:OC:ep:P:F:h";
+  static const char *optflags = "crutxkvz123456789Z:T:X:S:f:OC:ep:P:F:B:j:h";
   int flag = getopt(argc, argv, optflags);
   Filename rel_path;
   while (flag != EOF) {
@@ -934,6 +1027,22 @@ main(int argc, char **argv) {
       }
       break;
 
+    case 'B':
+      if (!string_to_int(optarg, block_size) || block_size < 0) {
+        cerr << "Invalid block size: " << optarg << "\n";
+        usage();
+        return 1;
+      }
+      break;
+
+    case 'j':
+      if (!string_to_int(optarg, num_threads) || num_threads < 1) {
+        cerr << "Invalid number of threads: " << optarg << "\n";
+        usage();
+        return 1;
+      }
+      break;
+
     case 'h':
       help();
       return 1;
@@ -326,6 +326,7 @@ update_texture(TextureContext *tc, bool force) {
     }
   }
   dtc->enqueue_lru(&_prepared_objects->_graphics_memory_lru);
+  tc->get_texture()->mark_ram_image_used();
 
   return true;
 }
@@ -349,6 +349,14 @@ wake_task(AsyncTask *task) {
     // indirectly caused the awaiting future to be cancelled.  Do nothing.
     return;
 
+  case AsyncTask::S_servicing:
+    // The task has started waiting for this future, but it has not yet
+    // returned DS_await, or its chain has not yet processed that.  Let the
+    // chain reactivate it right away when it does.
+    nassertv(task->_manager == _manager);
+    task->_wake_pending = true;
+    return;
+
   case AsyncTask::S_inactive:
     // Schedule it immediately.
     nassertv(task->_manager == nullptr);
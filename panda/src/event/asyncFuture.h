@@ -136,6 +136,7 @@ protected:
 
   friend class AsyncGatheringFuture;
   friend class AsyncTaskChain;
+  friend class AsyncTaskManager;
   friend class PythonTask;
 
 public:
@@ -37,6 +37,7 @@ AsyncTask(const string &name) :
   _priority(0),
   _state(S_inactive),
   _servicing_thread(nullptr),
+  _wake_pending(false),
   _chain(nullptr),
   _start_time(0.0),
   _start_frame(0),
@@ -402,6 +403,27 @@ unlock_and_do_task() {
   nassertr(_manager != nullptr, DS_done);
   PT(ClockObject) clock = _manager->get_clock();
 
+  // It's important to release the lock while the task is being serviced.
+  _manager->_lock.unlock();
+
+  double dt = 0.0;
+  DoneStatus status = do_task_unlocked(clock, dt);
+
+  // Now reacquire the lock (so we can return with the lock held).
+  _manager->_lock.lock();
+
+  record_task_time(dt);
+  return status;
+}
+
+/**
+ * Runs the task on the current thread, measuring the time it took against the
+ * indicated clock and storing it in dt.  The caller must not be holding the
+ * manager lock, and should pass the measured time to record_task_time() once
+ * it has reacquired it.
+ */
+AsyncTask::DoneStatus AsyncTask::
+do_task_unlocked(ClockObject *clock, double &dt) {
   // Indicate that this task is now the current task running on the thread.
   Thread *current_thread = Thread::get_current_thread();
   nassertr(current_thread->_current_task == nullptr, DS_interrupt);
@@ -422,23 +444,12 @@ unlock_and_do_task() {
   nassertr(current_thread->_current_task == this, DS_interrupt);
 #endif  // __GNUC__
 
-  // It's important to release the lock while the task is being serviced.
-  _manager->_lock.unlock();
-
   double start = clock->get_real_time();
   _task_pcollector.start();
   DoneStatus status = do_task();
   _task_pcollector.stop();
   double end = clock->get_real_time();
-
-  // Now reacquire the lock (so we can return with the lock held).
-  _manager->_lock.lock();
-
-  _dt = end - start;
-  _max_dt = std::max(_dt, _max_dt);
-  _total_dt += _dt;
-
-  _chain->_time_in_frame += _dt;
+  dt = end - start;
 
   // Now indicate that this is no longer the current task.
   nassertr(current_thread->_current_task == this, status);
@@ -459,6 +470,21 @@ unlock_and_do_task() {
   return status;
 }
 
+/**
+ * Accumulates the time spent by one run of the task into its statistics, and
+ * into its chain's time-in-frame.  Assumes the lock is held.
+ */
+void AsyncTask::
+record_task_time(double dt) {
+  _dt = dt;
+  _max_dt = std::max(_dt, _max_dt);
+  _total_dt += _dt;
+
+  if (_chain != nullptr) {
+    _chain->_time_in_frame += _dt;
+  }
+}
+
 /**
  * Cancels this task.  This is equivalent to remove(), except for coroutines,
  * for which it will throw an exception into any currently pending await.
@@ -23,6 +23,7 @@
 
 class AsyncTaskManager;
 class AsyncTaskChain;
+class ClockObject;
 
 /**
  * This class represents a concrete task performed by an AsyncManager.
@@ -123,6 +124,8 @@ PUBLISHED:
 protected:
   void jump_to_task_chain(AsyncTaskManager *manager);
   DoneStatus unlock_and_do_task();
+  DoneStatus do_task_unlocked(ClockObject *clock, double &dt);
+  void record_task_time(double dt);
 
   virtual bool cancel();
   virtual bool is_task() const final {return true;}
@@ -144,6 +147,7 @@ protected:
 
   State _state;
   Thread *_servicing_thread;
+  bool _wake_pending;
   AsyncTaskChain *_chain;
 
   double _start_time;
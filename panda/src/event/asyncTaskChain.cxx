@@ -44,6 +44,7 @@ AsyncTaskChain(AsyncTaskManager *manager, const string &name, int num_threads,
   _cvar(manager->_lock),
   _tick_clock(false),
   _timeslice_priority(false),
+  _work_stealing(false),
   _num_threads(num_threads),
   _thread_priority(thread_priority),
   _frame_budget(-1.0),
@@ -262,6 +263,39 @@ get_timeslice_priority() const {
   return _timeslice_priority;
 }
 
+/**
+ * Sets the work_stealing flag.  This changes the way the threads of this
+ * chain pick up the tasks of each sort group.
+ *
+ * When this flag is false (the default), each thread takes one task at a time
+ * from the chain's shared queue, which requires acquiring the task manager's
+ * lock twice per task.  With many threads and many short tasks, the threads
+ * spend much of their time waiting on this lock.
+ *
+ * When this flag is true, each thread instead claims a batch of tasks from the
+ * current sort group at once, in priority order, and runs them without holding
+ * the lock.  A thread that runs out of work steals the lowest-priority half of
+ * another thread's remaining batch.  Tasks with different sort values are
+ * still never run in parallel, but the frame budget is only checked between
+ * batches.
+ *
+ * This only has an effect on task chains with more than one thread.
+ */
+void AsyncTaskChain::
+set_work_stealing(bool work_stealing) {
+  MutexHolder holder(_manager->_lock);
+  _work_stealing = work_stealing;
+}
+
+/**
+ * Returns the work_stealing flag.  See set_work_stealing().
+ */
+bool AsyncTaskChain::
+get_work_stealing() const {
+  MutexHolder holder(_manager->_lock);
+  return _work_stealing;
+}
+
 /**
  * Stops any threads that are currently running.  If any tasks are still
  * pending and have not yet been picked up by a thread, they will not be
@@ -499,6 +533,11 @@ do_remove(AsyncTask *task, bool upon_death) {
 
   switch (task->_state) {
   case AsyncTask::S_servicing:
+    if (remove_from_thread_queue(task)) {
+      // It was claimed by a thread, but hasn't been started yet.
+      cleanup_task(task, upon_death, false);
+      return true;
+    }
     // This task is being serviced.  upon_death will be called afterwards.
     task->_state = AsyncTask::S_servicing_removed;
     return true;
@@ -707,86 +746,257 @@ service_one_task(AsyncTaskChain::AsyncTaskChainThread *thread) {
     }
     task->_servicing_thread = nullptr;
 
-    if (task->_chain == this) {
-      if (task->_state == AsyncTask::S_servicing_removed) {
-        // This task wants to kill itself.
-        cleanup_task(task, true, false);
+    finish_task(task, ds);
+  }
+  thread_consider_yield();
+}
 
-      } else if (task->_chain_name != get_name()) {
-        // The task wants to jump to a different chain.
-        PT(AsyncTask) hold_task = task;
-        cleanup_task(task, false, false);
-        task->jump_to_task_chain(_manager);
+/**
+ * Claims a batch of tasks with the current sort value for the indicated
+ * thread, and services them (along with any tasks stolen from other threads
+ * once the batch runs out) without holding the lock.  This is called
+ * internally only within one of the task threads, when work stealing is
+ * enabled.  Assumes the lock is already held.
+ *
+ * Note that the lock is released while the tasks run.
+ */
+void AsyncTaskChain::
+service_task_batch(AsyncTaskChain::AsyncTaskChainThread *thread) {
+  // Take an even share of the active tasks, but not so many that the other
+  // threads have to steal most of them back.
+  static const size_t max_batch_size = 64;
+  size_t batch_size = _active.size() / _threads.size();
+  batch_size = std::min(std::max(batch_size, (size_t)1), max_batch_size);
+
+  {
+    MutexHolder queue_holder(thread->_queue_lock);
+    while (thread->_queue.size() < batch_size && !_active.empty() &&
+           _active.front()->get_sort() == _current_sort) {
+      PT(AsyncTask) task = _active.front();
+      pop_heap(_active.begin(), _active.end(), AsyncTaskSortPriority());
+      _active.pop_back();
+
+      nassertd(task->_state == AsyncTask::S_active) continue;
+      task->_state = AsyncTask::S_servicing;
+      task->_servicing_thread = thread;
+      thread->_queue.push_back(std::move(task));
+    }
+  }
 
-      } else {
-        switch (ds) {
-        case AsyncTask::DS_cont:
-          // The task is still alive; put it on the next frame's active queue.
-          task->_state = AsyncTask::S_active;
-          _next_active.push_back(task);
-          _cvar.notify_all();
-          break;
+  struct TaskResult {
+    PT(AsyncTask) _task;
+    AsyncTask::DoneStatus _status;
+    double _dt;
+  };
+  pvector<TaskResult> results;
+  results.reserve(batch_size);
 
-        case AsyncTask::DS_again:
-          // The task wants to sleep again.
-          {
-            double now = _manager->_clock->get_frame_time();
-            task->_wake_time = now + task->get_delay();
-            task->_start_time = task->_wake_time;
-            task->_state = AsyncTask::S_sleeping;
-            _sleeping.push_back(task);
-            push_heap(_sleeping.begin(), _sleeping.end(), AsyncTaskSortWakeTime());
-            if (task_cat.is_spam()) {
-              task_cat.spam()
-                << "Sleeping " << *task << ", wake time at "
-                << task->_wake_time - now << "\n";
-            }
-            _cvar.notify_all();
-          }
-          break;
+  PT(ClockObject) clock = _manager->_clock;
+  _manager->_lock.unlock();
 
-        case AsyncTask::DS_pickup:
-          // The task wants to run again this frame if possible.
-          task->_state = AsyncTask::S_active;
-          _this_active.push_back(task);
-          _cvar.notify_all();
-          break;
+  while (true) {
+    PT(AsyncTask) task;
+    {
+      MutexHolder queue_holder(thread->_queue_lock);
+      if (thread->_queue.empty()) {
+        thread->_servicing = nullptr;
+        break;
+      }
+      task = std::move(thread->_queue.front());
+      thread->_queue.pop_front();
+      thread->_servicing = task;
+    }
 
-        case AsyncTask::DS_interrupt:
-          // The task had an exception and wants to raise a big flag.
-          task->_state = AsyncTask::S_active;
-          _next_active.push_back(task);
-          if (_state == S_started) {
-            _state = S_interrupted;
-            _cvar.notify_all();
+    if (task_cat.is_spam()) {
+      task_cat.spam()
+        << "Servicing " << *task << " in "
+        << *Thread::get_current_thread() << "\n";
+    }
+
+    TaskResult result;
+    result._dt = 0.0;
+    result._status = task->do_task_unlocked(clock, result._dt);
+    result._task = std::move(task);
+    results.push_back(std::move(result));
+  }
+
+  _manager->_lock.lock();
+
+  // Now that we hold the lock again, post the results of the whole batch.
+  for (TaskResult &result : results) {
+    AsyncTask *task = result._task;
+    task->_servicing_thread = nullptr;
+    task->record_task_time(result._dt);
+    finish_task(task, result._status);
+  }
+  thread_consider_yield();
+}
+
+/**
+ * Moves the lowest-priority half of the unstarted tasks claimed by another
+ * thread into the indicated thread's queue.  Returns true if any tasks were
+ * stolen, false if all the other threads' queues are empty.  Assumes the lock
+ * is already held.
+ */
+bool AsyncTaskChain::
+steal_tasks(AsyncTaskChain::AsyncTaskChainThread *thread) {
+  for (AsyncTaskChainThread *victim : _threads) {
+    if (victim == thread) {
+      continue;
+    }
+
+    // Only one thread can be stealing at a time, since we hold the lock, so
+    // there is no risk of two threads taking these locks in opposite order.
+    MutexHolder victim_holder(victim->_queue_lock);
+    size_t num_tasks = victim->_queue.size();
+    if (num_tasks == 0) {
+      continue;
+    }
+    size_t num_steal = (num_tasks + 1) / 2;
+
+    MutexHolder queue_holder(thread->_queue_lock);
+    while (num_steal-- > 0) {
+      PT(AsyncTask) task = std::move(victim->_queue.back());
+      victim->_queue.pop_back();
+      task->_servicing_thread = thread;
+      thread->_queue.push_front(std::move(task));
+    }
+
+    if (task_cat.is_spam()) {
+      task_cat.spam()
+        << *thread << " stole " << thread->_queue.size()
+        << " tasks from " << *victim << "\n";
+    }
+    return true;
+  }
+  return false;
+}
+
+/**
+ * If the indicated task has been claimed by a thread as part of a batch, but
+ * has not yet been started, removes it from that thread's queue and returns
+ * true.  Returns false if the task is not in any queue, in which case it is
+ * presumably running.  Assumes the lock is already held.
+ */
+bool AsyncTaskChain::
+remove_from_thread_queue(AsyncTask *task) {
+  if (task->_servicing_thread == nullptr) {
+    return false;
+  }
+
+  // Only the threads of this chain set _servicing_thread.
+  AsyncTaskChainThread *thread = (AsyncTaskChainThread *)task->_servicing_thread;
+  MutexHolder queue_holder(thread->_queue_lock);
+  pdeque<PT(AsyncTask)>::iterator it =
+    std::find(thread->_queue.begin(), thread->_queue.end(), task);
+  if (it == thread->_queue.end()) {
+    return false;
+  }
+
+  PT(AsyncTask) hold_task = task;
+  thread->_queue.erase(it);
+  task->_servicing_thread = nullptr;
+  return true;
+}
+
+/**
+ * Called internally after a task has been serviced, to put it back on the
+ * appropriate queue (or remove it) according to the status it returned.
+ * Assumes the lock is already held.
+ *
+ * Note that the lock may be temporarily released by this method.
+ */
+void AsyncTaskChain::
+finish_task(AsyncTask *task, AsyncTask::DoneStatus ds) {
+  bool wake_pending = task->_wake_pending;
+  task->_wake_pending = false;
+
+  if (task->_chain == this) {
+    if (task->_state == AsyncTask::S_servicing_removed) {
+      // This task wants to kill itself.
+      cleanup_task(task, true, false);
+
+    } else if (task->_chain_name != get_name()) {
+      // The task wants to jump to a different chain.
+      PT(AsyncTask) hold_task = task;
+      cleanup_task(task, false, false);
+      task->jump_to_task_chain(_manager);
+
+    } else {
+      switch (ds) {
+      case AsyncTask::DS_cont:
+        // The task is still alive; put it on the next frame's active queue.
+        task->_state = AsyncTask::S_active;
+        _next_active.push_back(task);
+        _cvar.notify_all();
+        break;
+
+      case AsyncTask::DS_again:
+        // The task wants to sleep again.
+        {
+          double now = _manager->_clock->get_frame_time();
+          task->_wake_time = now + task->get_delay();
+          task->_start_time = task->_wake_time;
+          task->_state = AsyncTask::S_sleeping;
+          _sleeping.push_back(task);
+          push_heap(_sleeping.begin(), _sleeping.end(), AsyncTaskSortWakeTime());
+          if (task_cat.is_spam()) {
+            task_cat.spam()
+              << "Sleeping " << *task << ", wake time at "
+              << task->_wake_time - now << "\n";
           }
-          break;
+          _cvar.notify_all();
+        }
+        break;
+
+      case AsyncTask::DS_pickup:
+        // The task wants to run again this frame if possible.
+        task->_state = AsyncTask::S_active;
+        _this_active.push_back(task);
+        _cvar.notify_all();
+        break;
+
+      case AsyncTask::DS_interrupt:
+        // The task had an exception and wants to raise a big flag.
+        task->_state = AsyncTask::S_active;
+        _next_active.push_back(task);
+        if (_state == S_started) {
+          _state = S_interrupted;
+          _cvar.notify_all();
+        }
+        break;
 
-        case AsyncTask::DS_await:
-          // The task wants to wait for another one to finish.
-          task->_state = AsyncTask::S_awaiting;
+      case AsyncTask::DS_await:
+        if (wake_pending) {
+          // The future it is waiting for has already finished, while the
+          // task was still being serviced.  Run it again right away.
+          task->_state = AsyncTask::S_active;
+          _this_active.push_back(task);
           _cvar.notify_all();
-          ++_num_awaiting_tasks;
           break;
-
-        default:
-          // The task has finished.
-          cleanup_task(task, true, true);
         }
+        // The task wants to wait for another one to finish.
+        task->_state = AsyncTask::S_awaiting;
+        _cvar.notify_all();
+        ++_num_awaiting_tasks;
+        break;
+
+      default:
+        // The task has finished.
+        cleanup_task(task, true, true);
       }
-    } else {
-      task_cat.error()
-        << "Task is no longer on chain " << get_name()
-        << ": " << *task << "\n";
     }
+  } else {
+    task_cat.error()
+      << "Task is no longer on chain " << get_name()
+      << ": " << *task << "\n";
+  }
 
-    if (task_cat.is_spam()) {
-      task_cat.spam()
-        << "Done servicing " << *task << " in "
-        << *Thread::get_current_thread() << "\n";
-    }
+  if (task_cat.is_spam()) {
+    task_cat.spam()
+      << "Done servicing " << *task << " in "
+      << *Thread::get_current_thread() << "\n";
   }
-  thread_consider_yield();
 }
 
 /**
@@ -1138,10 +1348,14 @@ do_get_active_tasks() const {
 #ifdef HAVE_THREADS
   Threads::const_iterator thi;
   for (thi = _threads.begin(); thi != _threads.end(); ++thi) {
+    MutexHolder queue_holder((*thi)->_queue_lock);
     AsyncTask *task = (*thi)->_servicing;
     if (task != nullptr) {
       result.add_task(task);
     }
+    for (AsyncTask *queued : (*thi)->_queue) {
+      result.add_task(queued);
+    }
   }
 #endif
   TaskHeap::const_iterator ti;
@@ -1335,10 +1549,12 @@ do_write(ostream &out, int indent_level) const {
 #ifdef HAVE_THREADS
   Threads::const_iterator thi;
   for (thi = _threads.begin(); thi != _threads.end(); ++thi) {
+    MutexHolder queue_holder((*thi)->_queue_lock);
     AsyncTask *task = (*thi)->_servicing;
     if (task != nullptr) {
       tasks.push_back(task);
     }
+    tasks.insert(tasks.end(), (*thi)->_queue.begin(), (*thi)->_queue.end());
   }
 #endif
 
@@ -1472,7 +1688,11 @@ thread_main() {
 
       PStatTimer timer(_task_pcollector);
       _chain->_num_busy_threads++;
-      _chain->service_one_task(this);
+      if (_chain->_work_stealing && _chain->_threads.size() > 1) {
+        _chain->service_task_batch(this);
+      } else {
+        _chain->service_one_task(this);
+      }
       _chain->_num_busy_threads--;
       _chain->_cvar.notify_all();
 
@@ -1496,6 +1716,14 @@ thread_main() {
           }
         }
 
+      } else if (_chain->_work_stealing && _chain->steal_tasks(this)) {
+        // We took over some of the tasks another thread had claimed.
+        PStatTimer timer(_task_pcollector);
+        _chain->_num_busy_threads++;
+        _chain->service_task_batch(this);
+        _chain->_num_busy_threads--;
+        _chain->_cvar.notify_all();
+
       } else {
         // Wait for the other threads to finish their current task before we
         // continue.
@@ -20,6 +20,7 @@
 #include "asyncTaskCollection.h"
 #include "typedReferenceCount.h"
 #include "thread.h"
+#include "pmutex.h"
 #include "conditionVar.h"
 #include "pvector.h"
 #include "pdeque.h"
@@ -73,6 +74,9 @@ PUBLISHED:
   void set_timeslice_priority(bool timeslice_priority);
   bool get_timeslice_priority() const;
 
+  void set_work_stealing(bool work_stealing);
+  bool get_work_stealing() const;
+
   BLOCKING void stop_threads();
   void start_threads();
   INLINE bool is_started() const;
@@ -111,6 +115,10 @@ protected:
   int find_task_on_heap(const TaskHeap &heap, AsyncTask *task) const;
 
   void service_one_task(AsyncTaskChainThread *thread);
+  void service_task_batch(AsyncTaskChainThread *thread);
+  bool steal_tasks(AsyncTaskChainThread *thread);
+  bool remove_from_thread_queue(AsyncTask *task);
+  void finish_task(AsyncTask *task, AsyncTask::DoneStatus ds);
   void cleanup_task(AsyncTask *task, bool upon_death, bool clean_exit);
   bool finish_sort_group();
   void filter_timeslice_priority();
@@ -135,6 +143,12 @@ protected:
 
     AsyncTaskChain *_chain;
     AsyncTask *_servicing;
+
+    // The tasks this thread has claimed from the current sort group but not
+    // yet started.  The owning thread takes from the front; other threads
+    // steal from the back.
+    pdeque<PT(AsyncTask)> _queue;
+    Mutex _queue_lock;
   };
 
   class AsyncTaskSortWakeTime {
@@ -177,6 +191,7 @@ protected:
 
   bool _tick_clock;
   bool _timeslice_priority;
+  bool _work_stealing;
   int _num_threads;
   ThreadPriority _thread_priority;
   Threads _threads;
@@ -21,6 +21,7 @@
 #include "clockObject.h"
 #include "config_event.h"
 #include <algorithm>
+#include <thread>
 
 using std::string;
 
@@ -415,6 +416,95 @@ start_threads() {
   }
 }
 
+/**
+ * Returns the task chain that runs the work submitted with parallel_for().
+ * It is created the first time this is called, with the number of threads
+ * given by the parallel-task-threads config variable, and with work stealing
+ * enabled.
+ *
+ * Other tasks may be added to this chain as well, by setting their task chain
+ * to its name, "parallel".  This allows subsystems to share a single pool of
+ * threads, rather than each starting its own.
+ */
+AsyncTaskChain *AsyncTaskManager::
+get_parallel_chain() {
+  MutexHolder holder(_lock);
+
+  AsyncTaskChain *chain = do_find_task_chain("parallel");
+  if (chain == nullptr) {
+    int num_threads = parallel_task_threads;
+    if (num_threads < 0) {
+      num_threads = (int)std::thread::hardware_concurrency();
+    }
+    if (!Thread::is_threading_supported()) {
+      num_threads = 0;
+    }
+    chain = do_make_task_chain("parallel", num_threads, TP_normal);
+    chain->_work_stealing = true;
+  }
+  return chain;
+}
+
+/**
+ * Adds the indicated task to this task manager once the given future is done.
+ * If the future is already done, the task is added immediately.  The task
+ * should not already have been added to a task manager.
+ *
+ * This can be used to build graphs of dependent work: to wait for several
+ * futures, pass the result of AsyncFuture::gather().  Since a task is itself
+ * a future, the task may in turn be passed to another add_after() call.
+ */
+void AsyncTaskManager::
+add_after(AsyncFuture *future, AsyncTask *task) {
+  nassertv(future != nullptr && future != task);
+  nassertv(task->_manager == nullptr && task->_state == AsyncTask::S_inactive);
+
+  if (future->try_lock_pending()) {
+    // It will be added to the manager of the future when it is woken, so make
+    // sure that is us.  A task future gets its manager when it is added.
+    if (future->_manager == nullptr && !future->is_task()) {
+      future->_manager = this;
+    }
+    future->_waiting.push_back(task);
+    future->unlock();
+  } else {
+    add(task);
+  }
+}
+
+/**
+ * The non-template part of parallel_for().  Chooses the number of chunks,
+ * starts enough helper tasks on the parallel chain, and takes part in the
+ * work until the whole range has been completed.
+ */
+void AsyncTaskManager::
+do_parallel_for(ParallelRange *range) {
+  AsyncTaskChain *chain = get_parallel_chain();
+  size_t num_threads = (size_t)std::max(chain->get_num_threads(), 0);
+
+  size_t count = range->_end - range->_begin;
+  if (range->_grain_size == 0) {
+    // Give each thread (including this one) a few chunks, so that the work
+    // still balances out if some indices take longer than others.
+    range->_grain_size = std::max(count / ((num_threads + 1) * 4), (size_t)1);
+  }
+  range->_num_chunks = (count + range->_grain_size - 1) / range->_grain_size;
+
+  // We'll take a chunk ourselves, so there is no point in starting more
+  // helpers than there are remaining chunks.
+  size_t num_helpers = std::min(num_threads, range->_num_chunks - 1);
+  for (size_t i = 0; i < num_helpers; ++i) {
+    PT(ParallelRange) hold_range = range;
+    chain->add([hold_range] (AsyncTask *) {
+      hold_range->run_chunks();
+      return AsyncTask::DS_done;
+    }, std::string());
+  }
+
+  range->run_chunks();
+  range->wait();
+}
+
 /**
  * Returns the set of tasks that are active or sleeping on the task manager,
  * at the time of the call.
@@ -664,6 +754,42 @@ make_global_ptr() {
   _global_ptr->ref();
 }
 
+/**
+ * Claims and runs chunks of the range until there are none left.  This may be
+ * called by any number of threads at once.
+ */
+void AsyncTaskManager::ParallelRange::
+run_chunks() {
+  size_t chunk;
+  while ((chunk = _next_chunk.fetch_add(1, std::memory_order_relaxed)) < _num_chunks) {
+    size_t begin = _begin + chunk * _grain_size;
+    size_t end = std::min(begin + _grain_size, _end);
+    run_range(begin, end);
+
+    if (_num_done.fetch_add(1, std::memory_order_release) + 1 == _num_chunks) {
+      // That was the last one; wake up the thread waiting in wait().
+      MutexHolder holder(_lock);
+      _cvar.notify_all();
+    }
+  }
+}
+
+/**
+ * Blocks until all chunks of the range have been run.  Since this is only
+ * called after run_chunks() has returned, the remaining chunks are all being
+ * run by other threads at this point.
+ */
+void AsyncTaskManager::ParallelRange::
+wait() {
+  if (_num_done.load(std::memory_order_acquire) == _num_chunks) {
+    return;
+  }
+  MutexHolder holder(_lock);
+  while (_num_done.load(std::memory_order_acquire) < _num_chunks) {
+    _cvar.wait();
+  }
+}
+
 #ifdef __EMSCRIPTEN__
 
 extern "C" void task_manager_poll();
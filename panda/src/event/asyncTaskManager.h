@@ -30,6 +30,7 @@
 #include "clockObject.h"
 #include "ordered_vector.h"
 #include "indirectCompareNames.h"
+#include "patomic.h"
 
 /**
  * A class to manage a loose queue of isolated tasks, which can be performed
@@ -84,6 +85,9 @@ PUBLISHED:
   BLOCKING void stop_threads();
   void start_threads();
 
+  AsyncTaskChain *get_parallel_chain();
+  void add_after(AsyncFuture *future, AsyncTask *task);
+
   INLINE size_t get_num_tasks() const;
 
   AsyncTaskCollection get_tasks() const;
@@ -102,7 +106,39 @@ PUBLISHED:
 
   INLINE static AsyncTaskManager *get_global_ptr();
 
+public:
+#ifndef CPPPARSER
+  template<class Function>
+  INLINE void parallel_for(size_t begin, size_t end, Function function,
+                           size_t grain_size = 0);
+#endif
+
 protected:
+  // The shared state of one parallel_for() call.  The range is divided into
+  // chunks of grain_size indices, which are claimed one at a time by the
+  // calling thread and by any helper tasks that get to run in the meantime.
+  class ParallelRange : public ReferenceCount {
+  public:
+    INLINE ParallelRange(size_t begin, size_t end, size_t grain_size);
+    virtual ~ParallelRange() = default;
+
+    void run_chunks();
+    void wait();
+
+    virtual void run_range(size_t begin, size_t end)=0;
+
+    const size_t _begin;
+    const size_t _end;
+    size_t _grain_size;
+    size_t _num_chunks;
+    patomic<size_t> _next_chunk;
+    patomic<size_t> _num_done;
+    Mutex _lock;
+    ConditionVar _cvar;
+  };
+
+  void do_parallel_for(ParallelRange *range);
+
   AsyncTaskChain *do_make_task_chain(const std::string &name, int num_threads=0,
                                      ThreadPriority thread_priority=TP_normal);
   AsyncTaskChain *do_find_task_chain(const std::string &name);
@@ -19,9 +19,11 @@
 #include "asyncTaskPause.h"
 #include "asyncTaskSequence.h"
 #include "buttonEventList.h"
+#include "coroutineTask.h"
 #include "event.h"
 #include "eventHandler.h"
 #include "eventParameter.h"
+#include "eventQueue.h"
 #include "genericAsyncTask.h"
 #include "pointerEventList.h"
 
@@ -35,6 +37,13 @@ Configure(config_event);
 NotifyCategoryDef(event, "");
 NotifyCategoryDef(task, "");
 
+ConfigVariableInt parallel_task_threads
+("parallel-task-threads", -1,
+ PRC_DESC("The number of threads to create for the \"parallel\" task chain "
+          "of each AsyncTaskManager, which runs the work submitted with "
+          "parallel_for().  Set this to -1 to use one thread per hardware "
+          "thread, or 0 to run all such work on the calling thread."));
+
 ConfigureFn(config_event) {
   AsyncFuture::init_type();
   AsyncGatheringFuture::init_type();
@@ -44,9 +53,11 @@ ConfigureFn(config_event) {
   AsyncTaskPause::init_type();
   AsyncTaskSequence::init_type();
   ButtonEventList::init_type();
+  CoroutineTask::init_type();
   PointerEventList::init_type();
   Event::init_type();
   EventHandler::init_type();
+  EventQueue::Node::init_type();
   EventStoreInt::init_type("EventStoreInt");
   EventStoreDouble::init_type("EventStoreDouble");
   GenericAsyncTask::init_type();
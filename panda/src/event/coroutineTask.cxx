@@ -0,0 +1,117 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file coroutineTask.cxx
+ * @author agent
+ * @date 2026-10-16
+ */
+
+#include "coroutineTask.h"
+#include "config_event.h"
+
+TypeHandle CoroutineTask::_type_handle;
+
+/**
+ * Called by the coroutine's promise when the coroutine function is called.
+ * The frame pointer is the address of the coroutine's frame, which is resumed
+ * and destroyed using the indicated functions.
+ */
+CoroutineTask::
+CoroutineTask(void *frame, FrameFunc *resume, FrameFunc *destroy) :
+  _frame(frame),
+  _resume(resume),
+  _destroy(destroy),
+  _status(DS_cont),
+  _finished(false)
+{
+}
+
+/**
+ *
+ */
+CoroutineTask::
+~CoroutineTask() {
+  if (_frame != nullptr) {
+    (*_destroy)(_frame);
+  }
+}
+
+/**
+ * Cancels the future that the coroutine is awaiting, if any, and removes the
+ * task from its task manager.  The coroutine is not resumed again.
+ */
+bool CoroutineTask::
+cancel() {
+  PT(AsyncFuture) fut_waiter = _fut_waiter;
+  if (fut_waiter != nullptr && !fut_waiter->done()) {
+    if (task_cat.is_debug()) {
+      task_cat.debug()
+        << "Cancelling " << *fut_waiter << " awaited by " << *this << "\n";
+    }
+    fut_waiter->cancel();
+  }
+  return AsyncTask::cancel();
+}
+
+/**
+ * Called by the promise when the coroutine lets an exception escape, with the
+ * exception's message, if known.  The coroutine is finished, but the task
+ * returns DS_interrupt first.
+ */
+void CoroutineTask::
+report_exception(const char *what) {
+  task_cat.error()
+    << "Exception in " << *this << ": "
+    << (what != nullptr ? what : "unknown exception") << "\n";
+  _status = DS_interrupt;
+  _finished = true;
+}
+
+/**
+ * Resumes the coroutine until it next suspends, and returns the appropriate
+ * status for the reason it suspended.
+ *
+ * This function is called with the lock *not* held.
+ */
+AsyncTask::DoneStatus CoroutineTask::
+do_task() {
+  if (_frame == nullptr) {
+    // The coroutine has already finished, after raising an exception.
+    return DS_done;
+  }
+
+  while (true) {
+    _fut_waiter.clear();
+    _status = DS_cont;
+    (*_resume)(_frame);
+
+    if (_finished) {
+      // The coroutine is at its final suspend point, and may not be resumed
+      // again, so we may as well free the frame now.
+      (*_destroy)(_frame);
+      _frame = nullptr;
+      return _status;
+    }
+
+    if (_fut_waiter == nullptr) {
+      // It yielded with a particular status.
+      return _status;
+    }
+
+    // It is awaiting a future.  Have the future reactivate us when it is
+    // done, unless it has become done in the meantime, in which case we can
+    // simply resume the coroutine right away.
+    if (!_fut_waiter->done() && _fut_waiter->add_waiting_task(this)) {
+      if (task_cat.is_debug()) {
+        task_cat.debug()
+          << *this << " is now awaiting <" << *_fut_waiter << ">.\n";
+      }
+      return DS_await;
+    }
+  }
+}
@@ -0,0 +1,164 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file coroutineTask.h
+ * @author agent
+ * @date 2026-10-16
+ */
+
+#ifndef COROUTINETASK_H
+#define COROUTINETASK_H
+
+#include "pandabase.h"
+
+#include "asyncTask.h"
+
+#if !defined(CPPPARSER) && defined(__cpp_impl_coroutine) && __cpp_impl_coroutine >= 201902L && __has_include(<coroutine>)
+#include <coroutine>
+#include <exception>
+#define CPP_HAVE_COROUTINES 1
+#endif
+
+class CoroutineTaskPromise;
+
+/**
+ * An AsyncTask that runs a C++20 coroutine.  This allows a task to be written
+ * as a sequence of steps that co_await other futures, rather than as a
+ * do_task() callback that has to track its own state.  The task is suspended
+ * while the future is pending, without occupying a task thread, and resumed
+ * when it is done.
+ *
+ * A CoroutineTask is created by calling a function declared to return
+ * PT(CoroutineTask), which contains co_await or co_return.  The body does not
+ * start running until the returned task is added to a task manager:
+ *
+ *   PT(CoroutineTask) load_things(Loader *loader) {
+ *     PT(AsyncFuture) fut = ...;
+ *     TypedObject *result = co_await fut;
+ *     ...
+ *     co_return;
+ *   }
+ *
+ *   AsyncTaskManager::get_global_ptr()->add(load_things(loader));
+ *
+ * The awaited value is the future's result, or nullptr if it was cancelled.
+ * A coroutine may also co_await AsyncTask::DS_cont to yield until the next
+ * epoch.  An exception that escapes the coroutine is logged, and the task
+ * then returns DS_interrupt, after which it is done.
+ *
+ * This class itself does not require a C++20 compiler, but the coroutine
+ * support is only available to code that is compiled with one.
+ *
+ * @since 1.11.0
+ */
+class EXPCL_PANDA_EVENT CoroutineTask final : public AsyncTask {
+private:
+  typedef void FrameFunc(void *frame);
+
+  CoroutineTask(void *frame, FrameFunc *resume, FrameFunc *destroy);
+
+public:
+  virtual ~CoroutineTask();
+  ALLOC_DELETED_CHAIN(CoroutineTask);
+
+  INLINE AsyncFuture *get_fut_waiter() const;
+
+  virtual bool cancel() override;
+
+protected:
+  virtual DoneStatus do_task() override;
+
+private:
+  void report_exception(const char *what);
+
+private:
+  void *_frame;
+  FrameFunc *_resume;
+  FrameFunc *_destroy;
+
+  // Set by the coroutine before it suspends.
+  PT(AsyncFuture) _fut_waiter;
+  DoneStatus _status;
+  bool _finished;
+
+public:
+  static TypeHandle get_class_type() {
+    return _type_handle;
+  }
+  static void init_type() {
+    AsyncTask::init_type();
+    register_type(_type_handle, "CoroutineTask",
+                  AsyncTask::get_class_type());
+  }
+  virtual TypeHandle get_type() const override {
+    return get_class_type();
+  }
+  virtual TypeHandle force_init_type() override {init_type(); return get_class_type();}
+
+private:
+  static TypeHandle _type_handle;
+
+  friend class CoroutineTaskPromise;
+};
+
+#ifdef CPP_HAVE_COROUTINES
+/**
+ * The promise type of a coroutine returning PT(CoroutineTask).  This is not
+ * used directly; see CoroutineTask.
+ */
+class CoroutineTaskPromise {
+public:
+  typedef std::coroutine_handle<CoroutineTaskPromise> Handle;
+
+  INLINE PT(CoroutineTask) get_return_object();
+  INLINE std::suspend_always initial_suspend() const noexcept;
+  INLINE std::suspend_always final_suspend() const noexcept;
+  INLINE void return_void();
+  INLINE void unhandled_exception();
+
+  class FutureAwaiter {
+  public:
+    INLINE bool await_ready() const;
+    INLINE void await_suspend(Handle handle) const;
+    INLINE TypedObject *await_resume() const;
+
+    PT(AsyncFuture) _future;
+  };
+
+  class YieldAwaiter {
+  public:
+    INLINE bool await_ready() const noexcept;
+    INLINE void await_suspend(Handle handle) const noexcept;
+    INLINE void await_resume() const noexcept;
+
+    AsyncTask::DoneStatus _status;
+  };
+
+  INLINE FutureAwaiter await_transform(AsyncFuture *future) const;
+  template<class Type>
+  INLINE FutureAwaiter await_transform(const PointerTo<Type> &future) const;
+  INLINE YieldAwaiter await_transform(AsyncTask::DoneStatus status) const;
+
+private:
+  static INLINE void resume_frame(void *frame);
+  static INLINE void destroy_frame(void *frame);
+
+  CoroutineTask *_task = nullptr;
+};
+
+namespace std {
+  template<class... Args>
+  struct coroutine_traits<PT(CoroutineTask), Args...> {
+    typedef CoroutineTaskPromise promise_type;
+  };
+}
+#endif  // CPP_HAVE_COROUTINES
+
+#include "coroutineTask.I"
+
+#endif
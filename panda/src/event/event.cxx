@@ -21,9 +21,21 @@ TypeHandle Event::_type_handle;
  */
 Event::
 Event(const std::string &event_name, EventReceiver *receiver) :
+  _name(EventName::make(event_name))
+{
+  _receiver = receiver;
+}
+
+/**
+ * Constructs an Event with an already interned name, which saves looking up
+ * the name string.  The name may not be null.
+ */
+Event::
+Event(const EventName *event_name, EventReceiver *receiver) :
   _name(event_name)
 {
   _receiver = receiver;
+  nassertv(_name != nullptr);
 }
 
 /**
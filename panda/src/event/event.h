@@ -17,6 +17,7 @@
 
 #include "pandabase.h"
 #include "eventParameter.h"
+#include "eventName.h"
 #include "typedReferenceCount.h"
 #include "small_vector.h"
 
@@ -29,7 +30,8 @@ class EventReceiver;
  *
  * This function use to inherit from Namable, but that makes it too expensive
  * to get its name the Python code.  Now it just copies the Namable interface
- * in.
+ * in.  The name is stored as an interned EventName, so that the EventHandler
+ * can look up its hooks without comparing strings.
  */
 class EXPCL_PANDA_EVENT Event : public TypedReferenceCount {
 PUBLISHED:
@@ -56,6 +58,13 @@ PUBLISHED:
 
   void output(std::ostream &out) const;
 
+public:
+  Event(const EventName *event_name, EventReceiver *receiver = nullptr);
+
+  INLINE const EventName *get_event_name() const;
+  INLINE void set_event_name(const EventName *name);
+
+PUBLISHED:
   MAKE_PROPERTY(name, get_name, set_name);
   MAKE_SEQ_PROPERTY(parameters, get_num_parameters, get_parameter);
   MAKE_PROPERTY2(receiver, has_receiver, get_receiver, set_receiver, clear_receiver);
@@ -66,7 +75,7 @@ protected:
   EventReceiver *_receiver;
 
 private:
-  std::string _name;
+  CPT(EventName) _name;
 
 public:
   static TypeHandle get_class_type() {
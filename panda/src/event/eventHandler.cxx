@@ -35,6 +35,16 @@ EventHandler(EventQueue *ev_queue) : _queue(*ev_queue) {
  */
 AsyncFuture *EventHandler::
 get_future(const string &event_name) {
+  return get_future(EventName::make(event_name));
+}
+
+/**
+ * Returns a pending future that will be marked as done when the event is next
+ * fired.
+ */
+AsyncFuture *EventHandler::
+get_future(const EventName *event_name) {
+  nassertr(event_name != nullptr, nullptr);
   Futures::iterator fi;
   fi = _futures.find(event_name);
 
@@ -56,8 +66,14 @@ get_future(const string &event_name) {
  */
 void EventHandler::
 process_events() {
-  while (!_queue.is_queue_empty()) {
-    dispatch_event(_queue.dequeue_event());
+  // Take all of the pending events at once, rather than locking the queue for
+  // each one.  Any events thrown by the hooks are picked up in the next pass.
+  EventQueue::Events events;
+  while (_queue.dequeue_events(events) > 0) {
+    for (const CPT_Event &event : events) {
+      dispatch_event(event);
+    }
+    events.clear();
   }
 }
 
@@ -67,11 +83,12 @@ process_events() {
 void EventHandler::
 dispatch_event(const Event *event) {
   nassertv(event != nullptr);
+  CPT(EventName) name = event->get_event_name();
 
   // Is the event name defined in the hook table?  It will be if anyone has
   // ever assigned a hook to this particular event name.
   Hooks::const_iterator hi;
-  hi = _hooks.find(event->get_name());
+  hi = _hooks.find(name);
 
   if (hi != _hooks.end()) {
     // Yes, it is!  Now walk through all the functions assigned to that event
@@ -92,7 +109,7 @@ dispatch_event(const Event *event) {
 
   // now for callback hooks
   CallbackHooks::const_iterator chi;
-  chi = _cbhooks.find(event->get_name());
+  chi = _cbhooks.find(name);
 
   if (chi != _cbhooks.end()) {
     // found one
@@ -106,7 +123,7 @@ dispatch_event(const Event *event) {
 
   // now for lambda hooks
   LambdaHooks::const_iterator lhi;
-  lhi = _lambdahooks.find(event->get_name());
+  lhi = _lambdahooks.find(name);
 
   if (lhi != _lambdahooks.end()) {
     // found one
@@ -120,7 +137,7 @@ dispatch_event(const Event *event) {
 
   // Finally, check for futures that need to be triggered.
   Futures::iterator fi;
-  fi = _futures.find(event->get_name());
+  fi = _futures.find(name);
 
   if (fi != _futures.end()) {
     AsyncFuture *fut = (*fi).second;
@@ -177,13 +194,13 @@ write(std::ostream &out) const {
  * added, false if it was already defined on the indicated event name.
  */
 bool EventHandler::
-add_hook(const string &event_name, EventFunction *function) {
+add_hook(const EventName *event_name, EventFunction *function) {
   if (event_cat.is_debug()) {
     event_cat.debug()
-      << "adding hook for event '" << event_name
+      << "adding hook for event '" << *event_name
       << "' with function 0x" << (void*)function << std::endl;
   }
-  assert(!event_name.empty());
+  assert(event_name != nullptr && !event_name->empty());
   assert(function);
   return _hooks[event_name].insert(function).second;
 }
@@ -196,9 +213,9 @@ add_hook(const string &event_name, EventFunction *function) {
  * version records an untyped pointer to user callback data.
  */
 bool EventHandler::
-add_hook(const string &event_name, EventCallbackFunction *function,
+add_hook(const EventName *event_name, EventCallbackFunction *function,
          void *data) {
-  assert(!event_name.empty());
+  assert(event_name != nullptr && !event_name->empty());
   assert(function);
   return _cbhooks[event_name].insert(CallbackFunction(function, data)).second;
 }
@@ -210,8 +227,8 @@ add_hook(const string &event_name, EventCallbackFunction *function,
  * version stores an arbitrary C++ lambda.
  */
 void EventHandler::
-add_hook(const string &event_name, EventLambda function) {
-  assert(!event_name.empty());
+add_hook(const EventName *event_name, EventLambda function) {
+  assert(event_name != nullptr && !event_name->empty());
   assert(function);
   _lambdahooks[event_name].push_back(function);
 }
@@ -221,8 +238,8 @@ add_hook(const string &event_name, EventLambda function) {
  * otherwise.
  */
 bool EventHandler::
-has_hook(const string &event_name) const {
-  assert(!event_name.empty());
+has_hook(const EventName *event_name) const {
+  assert(event_name != nullptr && !event_name->empty());
   Hooks::const_iterator hi;
   hi = _hooks.find(event_name);
   if (hi != _hooks.end()) {
@@ -256,8 +273,8 @@ has_hook(const string &event_name) const {
  * function pointer, false otherwise.
  */
 bool EventHandler::
-has_hook(const string &event_name, EventFunction *function) const {
-  assert(!event_name.empty());
+has_hook(const EventName *event_name, EventFunction *function) const {
+  assert(event_name != nullptr && !event_name->empty());
   Hooks::const_iterator hi;
   hi = _hooks.find(event_name);
   if (hi != _hooks.end()) {
@@ -276,8 +293,8 @@ has_hook(const string &event_name, EventFunction *function) const {
  * function pointer and callback data, false otherwise.
  */
 bool EventHandler::
-has_hook(const string &event_name, EventCallbackFunction *function, void *data) const {
-  assert(!event_name.empty());
+has_hook(const EventName *event_name, EventCallbackFunction *function, void *data) const {
+  assert(event_name != nullptr && !event_name->empty());
   CallbackHooks::const_iterator chi;
   chi = _cbhooks.find(event_name);
   if (chi != _cbhooks.end()) {
@@ -296,8 +313,8 @@ has_hook(const string &event_name, EventCallbackFunction *function, void *data)
  * the hook was removed, false if it wasn't there in the first place.
  */
 bool EventHandler::
-remove_hook(const string &event_name, EventFunction *function) {
-  assert(!event_name.empty());
+remove_hook(const EventName *event_name, EventFunction *function) {
+  assert(event_name != nullptr && !event_name->empty());
   assert(function);
   return _hooks[event_name].erase(function) != 0;
 }
@@ -309,9 +326,9 @@ remove_hook(const string &event_name, EventFunction *function) {
  * version takes an untyped pointer to user callback data.
  */
 bool EventHandler::
-remove_hook(const string &event_name, EventCallbackFunction *function,
+remove_hook(const EventName *event_name, EventCallbackFunction *function,
             void *data) {
-  assert(!event_name.empty());
+  assert(event_name != nullptr && !event_name->empty());
   assert(function);
   return _cbhooks[event_name].erase(CallbackFunction(function, data)) != 0;
 }
@@ -321,8 +338,8 @@ remove_hook(const string &event_name, EventCallbackFunction *function,
  * functions were removed, false if there were no functions added to the hook.
  */
 bool EventHandler::
-remove_hooks(const string &event_name) {
-  assert(!event_name.empty());
+remove_hooks(const EventName *event_name) {
+  assert(event_name != nullptr && !event_name->empty());
   bool any_removed = false;
 
   Hooks::iterator hi = _hooks.find(event_name);
@@ -405,7 +422,7 @@ make_global_event_handler() {
 void EventHandler::
 write_hook(std::ostream &out, const EventHandler::Hooks::value_type &hook) const {
   if (!hook.second.empty()) {
-    out << hook.first << " has " << hook.second.size() << " functions.\n";
+    out << *hook.first << " has " << hook.second.size() << " functions.\n";
   }
 }
 
@@ -415,6 +432,6 @@ write_hook(std::ostream &out, const EventHandler::Hooks::value_type &hook) const
 void EventHandler::
 write_cbhook(std::ostream &out, const EventHandler::CallbackHooks::value_type &hook) const {
   if (!hook.second.empty()) {
-    out << hook.first << " has " << hook.second.size() << " callback functions.\n";
+    out << *hook.first << " has " << hook.second.size() << " callback functions.\n";
   }
 }
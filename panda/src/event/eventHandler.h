@@ -17,6 +17,7 @@
 #include "pandabase.h"
 
 #include "event.h"
+#include "eventName.h"
 #include "pt_Event.h"
 #include "asyncFuture.h"
 
@@ -33,7 +34,9 @@ class EventQueue;
 /**
  * A class to monitor events from the C++ side of things.  It maintains a set
  * of "hooks", function pointers assigned to event names, and calls the
- * appropriate hooks when the matching event is detected.
+ * appropriate hooks when the matching event is detected.  The hooks are keyed
+ * by the interned EventName; the methods that take a string are provided for
+ * convenience.
  *
  * This class is not necessary when the hooks are detected and processed
  * entirely by the scripting language, e.g.  via Scheme hooks or the messenger
@@ -66,19 +69,36 @@ PUBLISHED:
   INLINE static EventHandler *get_global_event_handler(EventQueue *queue = nullptr);
 
 public:
-  bool add_hook(const std::string &event_name, EventFunction *function);
-  bool add_hook(const std::string &event_name, EventCallbackFunction *function,
+  AsyncFuture *get_future(const EventName *event_name);
+
+  bool add_hook(const EventName *event_name, EventFunction *function);
+  bool add_hook(const EventName *event_name, EventCallbackFunction *function,
                 void *data);
-  void add_hook(const std::string &event_name, EventLambda function);
-  bool has_hook(const std::string &event_name) const;
-  bool has_hook(const std::string &event_name, EventFunction *function) const;
-  bool has_hook(const std::string &event_name, EventCallbackFunction *function,
+  void add_hook(const EventName *event_name, EventLambda function);
+  bool has_hook(const EventName *event_name) const;
+  bool has_hook(const EventName *event_name, EventFunction *function) const;
+  bool has_hook(const EventName *event_name, EventCallbackFunction *function,
                 void *data) const;
-  bool remove_hook(const std::string &event_name, EventFunction *function);
-  bool remove_hook(const std::string &event_name, EventCallbackFunction *function,
+  bool remove_hook(const EventName *event_name, EventFunction *function);
+  bool remove_hook(const EventName *event_name, EventCallbackFunction *function,
                    void *data);
+  bool remove_hooks(const EventName *event_name);
+
+  INLINE bool add_hook(const std::string &event_name, EventFunction *function);
+  INLINE bool add_hook(const std::string &event_name,
+                       EventCallbackFunction *function, void *data);
+  INLINE void add_hook(const std::string &event_name, EventLambda function);
+  INLINE bool has_hook(const std::string &event_name) const;
+  INLINE bool has_hook(const std::string &event_name,
+                       EventFunction *function) const;
+  INLINE bool has_hook(const std::string &event_name,
+                       EventCallbackFunction *function, void *data) const;
+  INLINE bool remove_hook(const std::string &event_name,
+                          EventFunction *function);
+  INLINE bool remove_hook(const std::string &event_name,
+                          EventCallbackFunction *function, void *data);
+  INLINE bool remove_hooks(const std::string &event_name);
 
-  bool remove_hooks(const std::string &event_name);
   bool remove_hooks_with(void *data);
 
   void remove_all_hooks();
@@ -86,13 +106,13 @@ public:
 protected:
 
   typedef pset<EventFunction *> Functions;
-  typedef pmap<std::string, Functions> Hooks;
+  typedef pmap<CPT(EventName), Functions> Hooks;
   typedef std::pair<EventCallbackFunction*, void*> CallbackFunction;
   typedef pset<CallbackFunction> CallbackFunctions;
-  typedef pmap<std::string, CallbackFunctions> CallbackHooks;
+  typedef pmap<CPT(EventName), CallbackFunctions> CallbackHooks;
   typedef pvector<EventLambda> LambdaFunctions;
-  typedef pmap<std::string, LambdaFunctions> LambdaHooks;
-  typedef pmap<std::string, PT(AsyncFuture)> Futures;
+  typedef pmap<CPT(EventName), LambdaFunctions> LambdaHooks;
+  typedef pmap<CPT(EventName), PT(AsyncFuture)> Futures;
 
   Hooks _hooks;
   CallbackHooks _cbhooks;
@@ -0,0 +1,92 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file eventName.cxx
+ * @author agent
+ * @date 2026-10-17
+ */
+
+#include "eventName.h"
+#include "lightMutexHolder.h"
+
+EventName::NameTable EventName::_name_table;
+LightMutex EventName::_name_table_lock;
+
+/**
+ *
+ */
+EventName::
+~EventName() {
+#ifndef NDEBUG
+  // unref() should have removed us from the table already.
+  LightMutexHolder holder(_name_table_lock);
+  NameTable::const_iterator ni = _name_table.find(_name);
+  nassertv(ni == _name_table.end() || (*ni).second != this);
+#endif
+}
+
+/**
+ * Returns the unique EventName for the indicated string, creating it if it
+ * does not already exist.
+ */
+CPT(EventName) EventName::
+make(const std::string &name) {
+  LightMutexHolder holder(_name_table_lock);
+
+  NameTable::iterator ni = _name_table.find(name);
+  if (ni != _name_table.end()) {
+    // The name may have just lost its last reference on another thread, which
+    // is waiting for the lock to remove it from the table.  In that case, we
+    // replace it with a new one.
+    const EventName *event_name = (*ni).second;
+    if (event_name->ref_if_nonzero()) {
+      CPT(EventName) result;
+      result.cheat() = event_name;
+      return result;
+    }
+    event_name = new EventName(name);
+    (*ni).second = event_name;
+    return event_name;
+  }
+
+  const EventName *event_name = new EventName(name);
+  _name_table[name] = event_name;
+  return event_name;
+}
+
+/**
+ * Returns the number of distinct names currently in existence.
+ */
+size_t EventName::
+get_num_names() {
+  LightMutexHolder holder(_name_table_lock);
+  return _name_table.size();
+}
+
+/**
+ * This method overrides ReferenceCount::unref() to remove the name from the
+ * table when its reference count goes to zero.  Unlike InternalName, the lock
+ * is only taken for the last reference, since events are created and
+ * destroyed at a high rate.
+ */
+bool EventName::
+unref() const {
+  if (ReferenceCount::unref()) {
+    return true;
+  }
+
+  // The reference count has just reached zero.  Nobody can get a new
+  // reference to us anymore, but make() may have already replaced us.
+  LightMutexHolder holder(_name_table_lock);
+  NameTable::iterator ni = _name_table.find(_name);
+  if (ni != _name_table.end() && (*ni).second == this) {
+    _name_table.erase(ni);
+  }
+
+  return false;
+}
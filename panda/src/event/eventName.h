@@ -0,0 +1,70 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file eventName.h
+ * @author agent
+ * @date 2026-10-17
+ */
+
+#ifndef EVENTNAME_H
+#define EVENTNAME_H
+
+#include "pandabase.h"
+
+#include "referenceCount.h"
+#include "pointerTo.h"
+#include "pmap.h"
+#include "stl_compares.h"
+#include "lightMutex.h"
+
+/**
+ * The interned name of an event.  There is only ever one EventName in
+ * existence for a given string, so two names may be compared, and used as a
+ * key in a map, by pointer alone.  This is used by Event and EventHandler, so
+ * that dispatching an event does not involve comparing or copying strings.
+ *
+ * Code that throws the same event many times may keep a CPT(EventName) around
+ * rather than passing the string each time, which avoids looking up the name
+ * altogether; see also EventNameCache.  An EventName is removed from the
+ * table when its last reference goes away.
+ *
+ * This is similar in concept to InternalName, which lives in a higher module.
+ *
+ * @since 1.11.0
+ */
+class EXPCL_PANDA_EVENT EventName final : public ReferenceCount {
+private:
+  INLINE explicit EventName(const std::string &name);
+
+public:
+  ~EventName();
+  ALLOC_DELETED_CHAIN(EventName);
+
+  static CPT(EventName) make(const std::string &name);
+  virtual bool unref() const override;
+
+  static size_t get_num_names();
+
+  INLINE const std::string &get_name() const;
+  INLINE bool empty() const;
+
+  INLINE void output(std::ostream &out) const;
+
+private:
+  const std::string _name;
+
+  typedef phash_map<std::string, const EventName *, string_hash> NameTable;
+  static NameTable _name_table;
+  static LightMutex _name_table_lock;
+};
+
+INLINE std::ostream &operator << (std::ostream &out, const EventName &name);
+
+#include "eventName.I"
+
+#endif
@@ -0,0 +1,47 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file eventNameCache.cxx
+ * @author agent
+ * @date 2026-10-17
+ */
+
+#include "eventNameCache.h"
+
+/**
+ * Returns the unique EventName for the indicated string, the same one that
+ * EventName::make() would return.  The pointer remains valid until the next
+ * call to get_name() or clear(), so the caller should store it in a
+ * CPT(EventName), or an Event, if it needs it for longer than that.
+ */
+const EventName *EventNameCache::
+get_name(const std::string &name) {
+  Names::const_iterator ni = _names.find(name);
+  if (ni != _names.end()) {
+    return (*ni).second;
+  }
+
+  CPT(EventName) event_name;
+  ni = _prev_names.find(name);
+  if (ni != _prev_names.end()) {
+    event_name = (*ni).second;
+  } else {
+    event_name = EventName::make(name);
+  }
+
+  if (_names.size() >= _max_size) {
+    // Start a new generation.  The names still in the old one are released
+    // the next time this happens, unless they are asked for again first.
+    _prev_names.swap(_names);
+    _names.clear();
+  }
+
+  const EventName *result = event_name;
+  _names[name] = std::move(event_name);
+  return result;
+}
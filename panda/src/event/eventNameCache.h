@@ -0,0 +1,54 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file eventNameCache.h
+ * @author agent
+ * @date 2026-10-17
+ */
+
+#ifndef EVENTNAMECACHE_H
+#define EVENTNAMECACHE_H
+
+#include "pandabase.h"
+
+#include "eventName.h"
+#include "pmap.h"
+#include "stl_compares.h"
+
+/**
+ * A small cache of EventNames, kept by an object that throws events whose
+ * names it builds from strings, such as from a pattern.  A name found in the
+ * cache is returned without consulting the global table of EventNames, and so
+ * without taking its lock.  The cache also holds a reference to each name, so
+ * that it is not removed from the table and made anew every time it is thrown.
+ *
+ * The cache holds at most twice the indicated number of names.  When it fills
+ * up, the names that have not been asked for since the last time it filled up
+ * are released.
+ *
+ * This class is not thread-safe; each thrower keeps its own cache.
+ */
+class EXPCL_PANDA_EVENT EventNameCache {
+public:
+  INLINE explicit EventNameCache(size_t max_size = 256);
+
+  const EventName *get_name(const std::string &name);
+
+  INLINE size_t get_num_names() const;
+  INLINE void clear();
+
+private:
+  typedef phash_map<std::string, CPT(EventName), string_hash> Names;
+  Names _names;
+  Names _prev_names;
+  size_t _max_size;
+};
+
+#include "eventNameCache.I"
+
+#endif
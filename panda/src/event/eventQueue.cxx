@@ -16,6 +16,7 @@
 #include "lightMutexHolder.h"
 
 EventQueue *EventQueue::_global_event_queue = nullptr;
+TypeHandle EventQueue::Node::_type_handle;
 
 
 /**
@@ -23,6 +24,8 @@ EventQueue *EventQueue::_global_event_queue = nullptr;
  */
 EventQueue::
 EventQueue() : _lock("EventQueue::_lock") {
+  _front = new Node;
+  _back.store(_front, std::memory_order_relaxed);
 }
 
 /**
@@ -30,10 +33,13 @@ EventQueue() : _lock("EventQueue::_lock") {
  */
 EventQueue::
 ~EventQueue() {
+  clear();
+  delete _front;
 }
 
 /**
- *
+ * Adds the indicated event to the end of the queue.  This may be called by
+ * any thread, and does not block.
  */
 void EventQueue::
 queue_event(CPT_Event event) {
@@ -43,9 +49,6 @@ queue_event(CPT_Event event) {
     return;
   }
 
-  LightMutexHolder holder(_lock);
-
-  _queue.push_back(event);
   if (event_cat.is_debug()) {
     if (event->get_name() == "NewFrame") {
       // Don't bother us with this particularly spammy event.
@@ -58,6 +61,13 @@ queue_event(CPT_Event event) {
         << "Throwing event " << *event << "\n";
     }
   }
+
+  // Claim the back of the queue, then link our node after the previous one.
+  // Until the second step is done, the consumer simply sees the queue end at
+  // the previous node.
+  Node *node = new Node(std::move(event));
+  Node *prev = _back.exchange(node, std::memory_order_acq_rel);
+  prev->_next.store(node, std::memory_order_release);
 }
 
 /**
@@ -67,7 +77,12 @@ void EventQueue::
 clear() {
   LightMutexHolder holder(_lock);
 
-  _queue.clear();
+  Node *next;
+  while ((next = _front->_next.load(std::memory_order_acquire)) != nullptr) {
+    delete _front;
+    _front = next;
+    _front->_event.clear();
+  }
 }
 
 
@@ -77,7 +92,7 @@ clear() {
 bool EventQueue::
 is_queue_empty() const {
   LightMutexHolder holder(_lock);
-  return _queue.empty();
+  return _front->_next.load(std::memory_order_acquire) == nullptr;
 }
 
 /**
@@ -90,19 +105,47 @@ is_queue_full() const {
 
 
 /**
- *
+ * Removes the first event from the queue and returns it.  It is an error to
+ * call this if the queue is empty.
  */
 CPT_Event EventQueue::
 dequeue_event() {
   LightMutexHolder holder(_lock);
 
-  CPT_Event result = _queue.front();
-  _queue.pop_front();
+  Node *next = _front->_next.load(std::memory_order_acquire);
+  nassertr(next != nullptr, nullptr);
 
+  delete _front;
+  _front = next;
+
+  CPT_Event result = std::move(next->_event);
   nassertr(!result.is_null(), result);
   return result;
 }
 
+/**
+ * Removes all of the events that are currently on the queue, and appends them
+ * to the indicated vector, in the order they were queued.  Returns the number
+ * of events that were added.
+ *
+ * This only acquires the lock once, so it is cheaper than calling
+ * dequeue_event() repeatedly.
+ */
+size_t EventQueue::
+dequeue_events(Events &events) {
+  LightMutexHolder holder(_lock);
+
+  size_t count = 0;
+  Node *next;
+  while ((next = _front->_next.load(std::memory_order_acquire)) != nullptr) {
+    delete _front;
+    _front = next;
+    events.push_back(std::move(next->_event));
+    ++count;
+  }
+  return count;
+}
+
 /**
  *
  */
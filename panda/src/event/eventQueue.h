@@ -19,12 +19,19 @@
 #include "event.h"
 #include "pt_Event.h"
 #include "lightMutex.h"
-#include "pdeque.h"
+#include "pvector.h"
+#include "patomic.h"
+#include "deletedChain.h"
 
 /**
  * A queue of pending events.  As events are thrown, they are added to this
  * queue; eventually, they will be extracted out again by an EventHandler and
  * processed.
+ *
+ * Any number of threads may queue events at the same time without taking a
+ * lock.  Removing events from the queue is serialized by a lock, but this is
+ * normally only done by one thread anyway.  There is no limit on the number
+ * of events that may be pending.
  */
 class EXPCL_PANDA_EVENT EventQueue {
 PUBLISHED:
@@ -40,13 +47,43 @@ PUBLISHED:
 
   INLINE static EventQueue *get_global_event_queue();
 
+public:
+  typedef pvector<CPT_Event> Events;
+  size_t dequeue_events(Events &events);
+
+  // The events are stored in a singly-linked list.  The node at the front has
+  // already been dequeued (or is the initial dummy node), so the first pending
+  // event is stored in the node after it.
+  class Node {
+  public:
+    INLINE Node(CPT_Event event = nullptr);
+    ALLOC_DELETED_CHAIN(Node);
+
+    patomic<Node *> _next;
+    CPT_Event _event;
+
+    // We need a TypeHandle just for ALLOC_DELETED_CHAIN.
+  public:
+    static TypeHandle get_class_type() {
+      return _type_handle;
+    }
+    static void init_type() {
+      register_type(_type_handle, "EventQueue::Node");
+    }
+
+  private:
+    static TypeHandle _type_handle;
+  };
+
 private:
   static void make_global_event_queue();
   static EventQueue *_global_event_queue;
 
-  typedef pdeque<CPT_Event> Events;
-  Events _queue;
+  // New events are appended after this node by atomically swapping it out.
+  patomic<Node *> _back;
 
+  // Protects _front, which is only accessed when removing events.
+  Node *_front;
   LightMutex _lock;
 };
 
@@ -7,6 +7,7 @@
 #include "asyncTaskSequence.cxx"
 #include "buttonEvent.cxx"
 #include "buttonEventList.cxx"
+#include "coroutineTask.cxx"
 #include "genericAsyncTask.cxx"
 #include "pointerEvent.cxx"
 #include "pointerEventList.cxx"
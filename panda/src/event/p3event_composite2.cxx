@@ -1,6 +1,8 @@
 #include "config_event.cxx"
 #include "event.cxx"
 #include "eventHandler.cxx"
+#include "eventName.cxx"
+#include "eventNameCache.cxx"
 #include "eventParameter.cxx"
 #include "eventQueue.cxx"
 #include "eventReceiver.cxx"
@@ -38,6 +38,24 @@ INLINE void throw_event(const std::string &event_name,
                         const EventParameter &p3,
                         const EventParameter &p4);
 
+// These versions take an already interned name, which is cheaper for events
+// that are thrown often.
+INLINE void throw_event(const EventName *event_name);
+INLINE void throw_event(const EventName *event_name,
+                        const EventParameter &p1);
+INLINE void throw_event(const EventName *event_name,
+                        const EventParameter &p1,
+                        const EventParameter &p2);
+INLINE void throw_event(const EventName *event_name,
+                        const EventParameter &p1,
+                        const EventParameter &p2,
+                        const EventParameter &p3);
+INLINE void throw_event(const EventName *event_name,
+                        const EventParameter &p1,
+                        const EventParameter &p2,
+                        const EventParameter &p3,
+                        const EventParameter &p4);
+
 #include "eventHandler.h"
 
 INLINE void throw_event_directly(EventHandler& handler,
@@ -57,6 +75,21 @@ INLINE void throw_event_directly(EventHandler& handler,
                                  const EventParameter &p2,
                                  const EventParameter &p3);
 
+INLINE void throw_event_directly(EventHandler& handler,
+                                 const EventName *event_name);
+INLINE void throw_event_directly(EventHandler& handler,
+                                 const EventName *event_name,
+                                 const EventParameter &p1);
+INLINE void throw_event_directly(EventHandler& handler,
+                                 const EventName *event_name,
+                                 const EventParameter &p1,
+                                 const EventParameter &p2);
+INLINE void throw_event_directly(EventHandler& handler,
+                                 const EventName *event_name,
+                                 const EventParameter &p1,
+                                 const EventParameter &p2,
+                                 const EventParameter &p3);
+
 #include "throw_event.I"
 
 #endif
@@ -26,15 +26,16 @@ using std::string;
 
 /**
  * Compress the indicated source string at the given compression level (1
- * through 9).  Returns the compressed string.
+ * through 9), using the indicated algorithm.  Returns the compressed string.
  */
 string
-compress_string(const string &source, int compression_level) {
+compress_string(const string &source, int compression_level,
+                CompressionAlgorithm algorithm) {
   ostringstream dest;
 
   {
     OCompressStream compress;
-    compress.open(&dest, false, compression_level);
+    compress.open(&dest, false, compression_level, true, algorithm);
     compress.write(source.data(), source.length());
 
     if (compress.fail()) {
@@ -47,7 +48,7 @@ compress_string(const string &source, int compression_level) {
 
 /**
  * Decompresss the previously-compressed string()).  The return value is the
- * decompressed string.
+ * decompressed string.  The compression algorithm is detected automatically.
  *
  * Note that a decompression error cannot easily be detected, and the return
  * value may simply be a garbage or truncated string.
@@ -71,7 +72,8 @@ decompress_string(const string &source) {
  * value is bool on success, or false on failure.
  */
 EXPCL_PANDA_EXPRESS bool
-compress_file(const Filename &source, const Filename &dest, int compression_level) {
+compress_file(const Filename &source, const Filename &dest, int compression_level,
+              CompressionAlgorithm algorithm) {
   VirtualFileSystem *vfs = VirtualFileSystem::get_global_ptr();
   Filename source_filename = source;
   if (!source_filename.is_binary_or_text()) {
@@ -92,7 +94,7 @@ compress_file(const Filename &source, const Filename &dest, int compression_leve
     return false;
   }
 
-  bool result = compress_stream(*source_stream, *dest_stream, compression_level);
+  bool result = compress_stream(*source_stream, *dest_stream, compression_level, algorithm);
   vfs->close_read_file(source_stream);
   vfs->close_write_file(dest_stream);
   return result;
@@ -142,9 +144,10 @@ decompress_file(const Filename &source, const Filename &dest) {
  * The return value is bool on success, or false on failure.
  */
 bool
-compress_stream(istream &source, ostream &dest, int compression_level) {
+compress_stream(istream &source, ostream &dest, int compression_level,
+                CompressionAlgorithm algorithm) {
   OCompressStream compress;
-  compress.open(&dest, false, compression_level);
+  compress.open(&dest, false, compression_level, true, algorithm);
 
   static const size_t buffer_size = 4096;
   char buffer[buffer_size];
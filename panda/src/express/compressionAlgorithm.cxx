@@ -0,0 +1,142 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file compressionAlgorithm.cxx
+ * @author agent
+ * @date 2026-10-16
+ */
+
+#include "compressionAlgorithm.h"
+#include "string_utils.h"
+#include "config_express.h"
+
+using std::istream;
+using std::ostream;
+using std::string;
+
+/**
+ * Returns true if this build of Panda is able to compress and decompress
+ * streams using the indicated algorithm.
+ */
+bool
+is_compression_algorithm_supported(CompressionAlgorithm algorithm) {
+  switch (algorithm) {
+  case CA_none:
+    return true;
+
+  case CA_zlib:
+#ifdef HAVE_ZLIB
+    return true;
+#else
+    return false;
+#endif
+
+  case CA_lz4:
+#if defined(HAVE_ZLIB) && defined(HAVE_LZ4)
+    return true;
+#else
+    return false;
+#endif
+
+  case CA_zstd:
+#if defined(HAVE_ZLIB) && defined(HAVE_ZSTD)
+    return true;
+#else
+    return false;
+#endif
+  }
+
+  return false;
+}
+
+/**
+ * Examines the first few bytes of a compressed stream and returns the
+ * algorithm that was used to compress it, or CA_none if it does not appear
+ * to be compressed with any of the known algorithms.  At least four bytes
+ * should be supplied, if the stream is that long.
+ */
+CompressionAlgorithm
+detect_compression_algorithm(const void *data, size_t size) {
+  const unsigned char *p = (const unsigned char *)data;
+
+  if (size >= 4) {
+    if (p[0] == 0x28 && p[1] == 0xb5 && p[2] == 0x2f && p[3] == 0xfd) {
+      // The magic number of a Zstandard frame.
+      return CA_zstd;
+    }
+    if (p[0] == 0x04 && p[1] == 0x22 && p[2] == 0x4d && p[3] == 0x18) {
+      // The magic number of an LZ4 frame.
+      return CA_lz4;
+    }
+  }
+
+  if (size >= 2) {
+    if (p[0] == 0x1f && p[1] == 0x8b) {
+      // A gzip header, which zlib also knows how to read.
+      return CA_zlib;
+    }
+    if ((p[0] & 0x0f) == 8 && ((p[0] << 8) | p[1]) % 31 == 0) {
+      // A zlib header.
+      return CA_zlib;
+    }
+  }
+
+  return CA_none;
+}
+
+/**
+ *
+ */
+ostream &
+operator << (ostream &out, CompressionAlgorithm algorithm) {
+  switch (algorithm) {
+  case CA_none:
+    return out << "none";
+
+  case CA_zlib:
+    return out << "zlib";
+
+  case CA_lz4:
+    return out << "lz4";
+
+  case CA_zstd:
+    return out << "zstd";
+  }
+
+  return out << "**invalid CompressionAlgorithm (" << (int)algorithm << ")**";
+}
+
+/**
+ *
+ */
+istream &
+operator >> (istream &in, CompressionAlgorithm &algorithm) {
+  string word;
+  in >> word;
+
+  if (cmp_nocase(word, "none") == 0) {
+    algorithm = CA_none;
+
+  } else if (cmp_nocase(word, "zlib") == 0 ||
+             cmp_nocase(word, "deflate") == 0) {
+    algorithm = CA_zlib;
+
+  } else if (cmp_nocase(word, "lz4") == 0) {
+    algorithm = CA_lz4;
+
+  } else if (cmp_nocase(word, "zstd") == 0 ||
+             cmp_nocase(word, "zstandard") == 0) {
+    algorithm = CA_zstd;
+
+  } else {
+    express_cat->error() << "Invalid CompressionAlgorithm value: " << word << "\n";
+    algorithm = CA_zlib;
+  }
+
+  return in;
+}
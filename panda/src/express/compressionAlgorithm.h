@@ -0,0 +1,47 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file compressionAlgorithm.h
+ * @author agent
+ * @date 2026-10-16
+ */
+
+#ifndef COMPRESSIONALGORITHM_H
+#define COMPRESSIONALGORITHM_H
+
+#include "pandabase.h"
+
+BEGIN_PUBLISH
+/**
+ * The algorithms that may be used to compress a stream.  zlib is always
+ * available if Panda was compiled with compression support at all; LZ4
+ * decompresses several times faster, and Zstandard compresses smaller, but
+ * these are only available if Panda was compiled with them.
+ *
+ * Compressed streams are always read back correctly regardless of the
+ * algorithm used to write them, since the algorithm is recognized from the
+ * first bytes of the stream.
+ */
+enum CompressionAlgorithm {
+  CA_none,
+  CA_zlib,
+  CA_lz4,
+  CA_zstd,
+};
+
+EXPCL_PANDA_EXPRESS bool
+is_compression_algorithm_supported(CompressionAlgorithm algorithm);
+END_PUBLISH
+
+EXPCL_PANDA_EXPRESS CompressionAlgorithm
+detect_compression_algorithm(const void *data, size_t size);
+
+EXPCL_PANDA_EXPRESS std::ostream &operator << (std::ostream &out, CompressionAlgorithm algorithm);
+EXPCL_PANDA_EXPRESS std::istream &operator >> (std::istream &in, CompressionAlgorithm &algorithm);
+
+#endif
@@ -77,6 +77,24 @@ ConfigVariableBool multifile_always_binary
           "or extracted in either binary or text mode, according to the "
           "set_binary() or set_text() flag on the Filename."));
 
+ConfigVariableBool zip_mmap
+("zip-mmap", false,
+ PRC_DESC("Set this true to map ZIP archives that are opened for reading "
+          "from a file on disk into memory, so that the central directory "
+          "and any subfiles that are stored without compression are read "
+          "directly from the mapped memory.  Set it false to read the "
+          "archive through ordinary file streams instead."));
+
+ConfigVariableEnum<CompressionAlgorithm> compression_algorithm
+("compression-algorithm", CA_zlib,
+ PRC_DESC("The algorithm used to compress files written with a .pz "
+          "extension, as well as the default for compressed subfiles in "
+          "new multifiles.  This may be zlib, lz4 or zstd, although the "
+          "latter two are only available if Panda was compiled with them.  "
+          "lz4 decompresses several times faster than zlib, at the cost of "
+          "a larger file; zstd is both fast and compact.  When reading, the "
+          "algorithm is recognized automatically."));
+
 ConfigVariableBool collect_tcp
 ("collect-tcp", false,
  PRC_DESC("Set this true to enable accumulation of several small consecutive "
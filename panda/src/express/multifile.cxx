@@ -18,6 +18,7 @@
 #include "streamReader.h"
 #include "datagram.h"
 #include "zStream.h"
+#include "zBlockStream.h"
 #include "encryptStream.h"
 #include "virtualFileSystem.h"
 #include "virtualFile.h"
@@ -50,8 +51,11 @@ const size_t Multifile::_header_size = 6;
 // version may still be read.
 const int Multifile::_current_major_ver = 1;
 
-const int Multifile::_current_minor_ver = 1;
+const int Multifile::_current_minor_ver = 2;
 // Bumped to version 1.1 on 6806 to add timestamps.
+// Bumped to version 1.2 to add block-compressed subfiles.  A Multifile is
+// only written as version 1.2 if it actually contains any of these; otherwise
+// it is still written as version 1.1.
 
 // To confirm that the supplied password matches, we write the Mutifile magic
 // header at the beginning of the encrypted stream.  I suppose this does
@@ -99,6 +103,14 @@ const size_t Multifile::_encrypt_header_size = 6;
  * just blocks of literal data.
  */
 
+/*
+ * A subfile with both SF_compressed and SF_block_compressed set is not one
+ * zlib stream, but a series of independently compressed blocks, followed by
+ * a uint32 for each block giving the offset within the data record at which
+ * that block ends, and then a uint32 uncompressed length and a uint32 block
+ * size.  See ZBlockStreamBuf.  These subfiles are never encrypted.
+ */
+
 /**
  *
  */
@@ -107,6 +119,16 @@ Multifile() :
   _read_filew(_read_file),
   _read_write_filew(_read_write_file)
 {
+  ConfigVariableInt multifile_compression_block_size
+    ("multifile-compression-block-size", 0,
+     PRC_DESC("If this is nonzero, it specifies the uncompressed size of the "
+              "blocks in which compressed subfiles are written to a multifile.  "
+              "Each block is compressed independently, so that a compressed "
+              "subfile may be seeked without first decompressing everything "
+              "before the new position.  A multifile that contains such "
+              "subfiles cannot be read by older versions of Panda.  The "
+              "default, 0, compresses each subfile as a single stream."));
+
   ConfigVariableInt multifile_encryption_iteration_count
     ("multifile-encryption-iteration-count", 0,
      PRC_DESC("This is a special value of encryption-iteration-count used to encrypt "
@@ -130,6 +152,8 @@ Multifile() :
   _new_scale_factor = 1;
   _encryption_flag = false;
   _encryption_iteration_count = multifile_encryption_iteration_count;
+  _compression_block_size = (size_t)max(0, multifile_compression_block_size.get_value());
+  _compression_algorithm = compression_algorithm;
   _file_major_ver = 0;
   _file_minor_ver = 0;
 
@@ -1138,11 +1162,24 @@ flush() {
     }
 
   } else {
-    if (_file_minor_ver != _current_minor_ver) {
+    if (_file_minor_ver < 1) {
       // If we *do* have an index already, but this is an old version
       // multifile, we have to completely rewrite it anyway.
       return repack();
     }
+
+    int minor_ver = get_required_minor_ver();
+    if (_file_minor_ver < minor_ver) {
+      // We are adding a block-compressed subfile to a version 1.1 Multifile.
+      // The format is otherwise unchanged, so we only need to update the
+      // version number in the header.
+      nassertr(_write != nullptr, false);
+      size_t minor_ver_pos = _header_prefix.size() + _header_size + 2;
+      _write->seekp(minor_ver_pos);
+      StreamWriter writer(*_write);
+      writer.add_int16(minor_ver);
+      _file_minor_ver = minor_ver;
+    }
   }
 
   nassertr(_write != nullptr, false);
@@ -1519,6 +1556,17 @@ is_subfile_compressed(int index) const {
   return (_subfiles[index]->_flags & SF_compressed) != 0;
 }
 
+/**
+ * Returns true if the indicated subfile has been compressed in independent
+ * blocks, so that a stream opened on it may be seeked efficiently.  See
+ * set_compression_block_size().
+ */
+bool Multifile::
+is_subfile_block_compressed(int index) const {
+  nassertr(index >= 0 && index < (int)_subfiles.size(), false);
+  return (_subfiles[index]->_flags & SF_block_compressed) != 0;
+}
+
 /**
  * Returns true if the indicated subfile has been encrypted when stored within
  * the archive, false otherwise.
@@ -1997,6 +2045,7 @@ add_new_subfile(Subfile *subfile, int compression_level) {
 #else  // HAVE_ZLIB
     subfile->_flags |= SF_compressed;
     subfile->_compression_level = compression_level;
+    subfile->_compression_algorithm = _compression_algorithm;
 #endif  // HAVE_ZLIB
   }
 
@@ -2006,6 +2055,14 @@ add_new_subfile(Subfile *subfile, int compression_level) {
   }
 #endif  // HAVE_OPENSSL
 
+  if ((subfile->_flags & (SF_compressed | SF_encrypted)) == SF_compressed &&
+      _compression_block_size != 0) {
+    // The encryption can't be seeked, so there would be no point in
+    // compressing an encrypted subfile in blocks.
+    subfile->_flags |= SF_block_compressed;
+    subfile->_compression_block_size = _compression_block_size;
+  }
+
   if (_next_index != (streampos)0) {
     // If we're adding a Subfile to an already-existing Multifile, we will
     // eventually need to repack the file.
@@ -2047,9 +2104,32 @@ open_read_subfile(Subfile *subfile) {
   nassertr(subfile->_source == nullptr &&
            subfile->_source_filename.empty(), nullptr);
 
+  nassertr(subfile->_data_start != (streampos)0, nullptr);
+
+  if ((subfile->_flags & SF_block_compressed) != 0) {
+#ifndef HAVE_ZLIB
+    express_cat.error()
+      << "zlib not compiled in; cannot read compressed multifiles.\n";
+    return nullptr;
+#else  // HAVE_ZLIB
+    // The blocks are read directly from the Multifile, which is how they can
+    // be seeked individually.
+    nassertr((subfile->_flags & SF_encrypted) == 0, nullptr);
+    istream *stream =
+      new IBlockDecompressStream(_read, _offset + subfile->_data_start,
+                                 (streamsize)subfile->_data_length);
+    if (stream->fail()) {
+      express_cat.error()
+        << "Unable to read compressed subfile " << subfile->_name << ".\n";
+      delete stream;
+      return nullptr;
+    }
+    return stream;
+#endif  // HAVE_ZLIB
+  }
+
   // Return an ISubStream object that references into the open Multifile
   // istream.
-  nassertr(subfile->_data_start != (streampos)0, nullptr);
   istream *stream =
     new ISubStream(_read, _offset + subfile->_data_start,
                    _offset + subfile->_data_start + (streampos)subfile->_data_length);
@@ -2333,13 +2413,28 @@ read_index() {
   return true;
 }
 
+/**
+ * Returns the lowest minor version number that can represent all of the
+ * subfiles in the Multifile.  We write the oldest version we can, so that the
+ * Multifile remains readable by older versions of Panda where possible.
+ */
+int Multifile::
+get_required_minor_ver() const {
+  for (const Subfile *subfile : _subfiles) {
+    if ((subfile->_flags & SF_block_compressed) != 0) {
+      return 2;
+    }
+  }
+  return 1;
+}
+
 /**
  * Writes just the header part of the Multifile, not the index.
  */
 bool Multifile::
 write_header() {
   _file_major_ver = _current_major_ver;
-  _file_minor_ver = _current_minor_ver;
+  _file_minor_ver = get_required_minor_ver();
 
   nassertr(_write != nullptr, false);
   nassertr(_write->tellp() == (streampos)0, false);
@@ -2347,7 +2442,7 @@ write_header() {
   _write->write(_header, _header_size);
   StreamWriter writer(_write, false);
   writer.add_int16(_current_major_ver);
-  writer.add_int16(_current_minor_ver);
+  writer.add_int16(_file_minor_ver);
   writer.add_uint32(_scale_factor);
 
   if (_record_timestamp) {
@@ -2686,9 +2781,18 @@ write_data(ostream &write, istream *read, streampos fpos,
     // set.
     nassertr((_flags & SF_compressed) == 0, fpos);
 #else  // HAVE_ZLIB
-    if ((_flags & SF_compressed) != 0) {
+    if ((_flags & SF_block_compressed) != 0) {
+      // Write it compressed, one block at a time.
+      nassertr((_flags & SF_encrypted) == 0, fpos);
+      putter = new OBlockCompressStream(putter, delete_putter, _compression_level,
+                                        _compression_block_size,
+                                        _compression_algorithm);
+      delete_putter = true;
+
+    } else if ((_flags & SF_compressed) != 0) {
       // Write it compressed.
-      putter = new OCompressStream(putter, delete_putter, _compression_level);
+      putter = new OCompressStream(putter, delete_putter, _compression_level,
+                                   true, _compression_algorithm);
       delete_putter = true;
     }
 #endif  // HAVE_ZLIB
@@ -67,6 +67,12 @@ PUBLISHED:
   void set_scale_factor(size_t scale_factor);
   INLINE size_t get_scale_factor() const;
 
+  INLINE void set_compression_block_size(size_t block_size);
+  INLINE size_t get_compression_block_size() const;
+
+  INLINE void set_compression_algorithm(CompressionAlgorithm algorithm);
+  INLINE CompressionAlgorithm get_compression_algorithm() const;
+
   INLINE void set_encryption_flag(bool flag);
   INLINE bool get_encryption_flag() const;
 
@@ -120,6 +126,7 @@ PUBLISHED:
   size_t get_subfile_length(int index) const;
   time_t get_subfile_timestamp(int index) const;
   bool is_subfile_compressed(int index) const;
+  bool is_subfile_block_compressed(int index) const;
   bool is_subfile_encrypted(int index) const;
   bool is_subfile_text(int index) const;
 
@@ -175,6 +182,7 @@ private:
     SF_encrypted      = 0x0010,
     SF_signature      = 0x0020,
     SF_text           = 0x0040,
+    SF_block_compressed = 0x0080,
   };
 
   class Subfile {
@@ -206,6 +214,8 @@ private:
     Filename _source_filename;
     int _flags;
     int _compression_level;  // Not preserved on disk.
+    size_t _compression_block_size;  // Not preserved on disk.
+    CompressionAlgorithm _compression_algorithm;  // Not preserved on disk.
 #ifdef HAVE_OPENSSL
     EVP_PKEY *_pkey;         // Not preserved on disk.
 #endif // HAVE_OPENSSL
@@ -222,6 +232,7 @@ private:
 
   void clear_subfiles();
   bool read_index();
+  int get_required_minor_ver() const;
   bool write_header();
 
   void check_signatures();
@@ -254,6 +265,8 @@ private:
   bool _record_timestamp;
   size_t _scale_factor;
   size_t _new_scale_factor;
+  size_t _compression_block_size;
+  CompressionAlgorithm _compression_algorithm;
 
   bool _encryption_flag;
   std::string _encryption_password;
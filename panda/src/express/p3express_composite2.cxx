@@ -29,6 +29,8 @@
 #include "weakPointerToVoid.cxx"
 #include "weakReferenceList.cxx"
 #include "windowsRegistry.cxx"
+#include "zBlockStream.cxx"
+#include "zBlockStreamBuf.cxx"
 #include "zStream.cxx"
 #include "zStreamBuf.cxx"
 #include "zipArchive.cxx"
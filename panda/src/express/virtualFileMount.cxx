@@ -15,6 +15,7 @@
 #include "virtualFileSimple.h"
 #include "virtualFileSystem.h"
 #include "zStream.h"
+#include "config_express.h"
 
 using std::iostream;
 using std::istream;
@@ -229,7 +230,8 @@ open_write_file(const Filename &file, bool truncate) {
  * (which you should eventually delete when you are done writing). Returns
  * NULL on failure.
  *
- * If do_compress is true, the file is also compressed on-the-fly using zlib.
+ * If do_compress is true, the file is also compressed on-the-fly, using the
+ * algorithm named by the compression-algorithm config variable.
  */
 ostream *VirtualFileMount::
 open_write_file(const Filename &file, bool do_compress, bool truncate) {
@@ -238,7 +240,8 @@ open_write_file(const Filename &file, bool do_compress, bool truncate) {
 #ifdef HAVE_ZLIB
   if (result != nullptr && do_compress) {
     // We have to slip in a layer to compress the file on the fly.
-    OCompressStream *wrapper = new OCompressStream(result, true);
+    OCompressStream *wrapper =
+      new OCompressStream(result, true, 6, true, compression_algorithm);
     result = wrapper;
   }
 #endif  // HAVE_ZLIB
@@ -343,3 +346,21 @@ void VirtualFileMount::
 write(ostream &out) const {
   out << *this << " on /" << get_mount_point() << "\n";
 }
+
+/**
+ * Records the indicated name, as returned by the underlying archive, in the
+ * index as a regular file, and each of the directories leading to it as a
+ * directory.
+ */
+void VirtualFileMount::
+add_to_index(const string &name) {
+  _index[name] |= IF_regular_file;
+
+  // Like Multifile::has_directory(), a directory only counts if there is
+  // something within it.
+  size_t slash = name.find('/');
+  while (slash != string::npos && slash + 1 < name.length()) {
+    _index[name.substr(0, slash)] |= IF_directory;
+    slash = name.find('/', slash + 1);
+  }
+}
@@ -20,6 +20,7 @@
 #include "filename.h"
 #include "pointerTo.h"
 #include "typedReferenceCount.h"
+#include "pmap.h"
 
 class VirtualFileSystem;
 
@@ -86,11 +87,25 @@ PUBLISHED:
   virtual void output(std::ostream &out) const;
   virtual void write(std::ostream &out) const;
 
+protected:
+  enum IndexFlags {
+    IF_regular_file = 0x0001,
+    IF_directory    = 0x0002,
+  };
+  void add_to_index(const std::string &name);
+  INLINE int find_in_index(const std::string &name) const;
+
 protected:
   VirtualFileSystem *_file_system;
   Filename _mount_point;
   int _mount_flags;
 
+  // A mount whose contents cannot change, such as a read-only Multifile, may
+  // fill this in with all of its files and directories when it is created,
+  // so that looking up a file costs a single probe.
+  typedef pmap<std::string, int> Index;
+  Index _index;
+
 
 public:
   virtual TypeHandle get_type() const {
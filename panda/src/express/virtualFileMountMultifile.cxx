@@ -30,6 +30,9 @@ VirtualFileMountMultifile::
  */
 bool VirtualFileMountMultifile::
 has_file(const Filename &file) const {
+  if (is_indexed()) {
+    return (file.empty() || find_in_index(file) != 0);
+  }
   return (file.empty() ||
           _multifile->find_subfile(file) >= 0 ||
           _multifile->has_directory(file));
@@ -41,6 +44,9 @@ has_file(const Filename &file) const {
  */
 bool VirtualFileMountMultifile::
 is_directory(const Filename &file) const {
+  if (is_indexed()) {
+    return (file.empty() || (find_in_index(file) & IF_directory) != 0);
+  }
   return (file.empty() || _multifile->has_directory(file));
 }
 
@@ -50,6 +56,9 @@ is_directory(const Filename &file) const {
  */
 bool VirtualFileMountMultifile::
 is_regular_file(const Filename &file) const {
+  if (is_indexed()) {
+    return (find_in_index(file) & IF_regular_file) != 0;
+  }
   return (_multifile->find_subfile(file) >= 0);
 }
 
@@ -192,3 +201,22 @@ void VirtualFileMountMultifile::
 output(std::ostream &out) const {
   out << _multifile->get_multifile_name();
 }
+
+/**
+ * If the Multifile is open for reading only, so that its contents cannot
+ * change, records all of its files and directories in the index.
+ */
+void VirtualFileMountMultifile::
+build_index() {
+  _index.clear();
+  _indexed_subfiles = -1;
+  if (!_multifile->is_read_valid() || _multifile->is_write_valid()) {
+    return;
+  }
+
+  int num_subfiles = _multifile->get_num_subfiles();
+  for (int i = 0; i < num_subfiles; ++i) {
+    add_to_index(_multifile->get_subfile_name(i));
+  }
+  _indexed_subfiles = num_subfiles;
+}
@@ -50,8 +50,11 @@ public:
   virtual void output(std::ostream &out) const;
 
 private:
-  PT(Multifile) _multifile;
+  void build_index();
+  INLINE bool is_indexed() const;
 
+  PT(Multifile) _multifile;
+  int _indexed_subfiles;
 
 public:
   virtual TypeHandle get_type() const {
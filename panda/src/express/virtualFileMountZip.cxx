@@ -31,6 +31,9 @@ VirtualFileMountZip::
 bool VirtualFileMountZip::
 has_file(const Filename &file) const {
   Filename path(_directory, file);
+  if (is_indexed()) {
+    return (path.empty() || find_in_index(path) != 0);
+  }
   return (path.empty() ||
           _archive->find_subfile(path) >= 0 ||
           _archive->has_directory(path));
@@ -43,7 +46,10 @@ has_file(const Filename &file) const {
 bool VirtualFileMountZip::
 is_directory(const Filename &file) const {
   Filename path(_directory, file);
-  return (path.empty() || _archive->has_directory(file));
+  if (is_indexed()) {
+    return (path.empty() || (find_in_index(path) & IF_directory) != 0);
+  }
+  return (path.empty() || _archive->has_directory(path));
 }
 
 /**
@@ -53,6 +59,9 @@ is_directory(const Filename &file) const {
 bool VirtualFileMountZip::
 is_regular_file(const Filename &file) const {
   Filename path(_directory, file);
+  if (is_indexed()) {
+    return (find_in_index(path) & IF_regular_file) != 0;
+  }
   return (_archive->find_subfile(path) >= 0);
 }
 
@@ -202,3 +211,22 @@ void VirtualFileMountZip::
 output(std::ostream &out) const {
   out << _archive->get_filename();
 }
+
+/**
+ * If the archive is open for reading only, so that its contents cannot
+ * change, records all of its files and directories in the index.
+ */
+void VirtualFileMountZip::
+build_index() {
+  _index.clear();
+  _indexed_subfiles = -1;
+  if (!_archive->is_read_valid() || _archive->is_write_valid()) {
+    return;
+  }
+
+  int num_subfiles = _archive->get_num_subfiles();
+  for (int i = 0; i < num_subfiles; ++i) {
+    add_to_index(_archive->get_subfile_name(i));
+  }
+  _indexed_subfiles = num_subfiles;
+}
@@ -51,8 +51,12 @@ public:
   virtual void output(std::ostream &out) const;
 
 private:
+  void build_index();
+  INLINE bool is_indexed() const;
+
   PT(ZipArchive) _archive;
   Filename _directory;
+  int _indexed_subfiles;
 
 public:
   virtual TypeHandle get_type() const {
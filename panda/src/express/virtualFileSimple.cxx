@@ -13,6 +13,7 @@
 
 #include "virtualFileSimple.h"
 #include "virtualFileMount.h"
+#include "virtualFileSystem.h"
 #include "virtualFileList.h"
 #include "dcast.h"
 
@@ -96,6 +97,7 @@ is_writable() const {
  */
 bool VirtualFileSimple::
 delete_file() {
+  invalidate_lookup_cache();
   return _mount->delete_file(_local_filename);
 }
 
@@ -116,6 +118,7 @@ rename_file(VirtualFile *new_file) {
     VirtualFileSimple *new_file_simple = DCAST(VirtualFileSimple, new_file);
     if (new_file_simple->_mount == _mount) {
       // Same mount pount.
+      invalidate_lookup_cache();
       if (_mount->rename_file(_local_filename, new_file_simple->_local_filename)) {
         return true;
       }
@@ -146,6 +149,7 @@ copy_file(VirtualFile *new_file) {
     VirtualFileSimple *new_file_simple = DCAST(VirtualFileSimple, new_file);
     if (new_file_simple->_mount == _mount) {
       // Same mount pount.
+      invalidate_lookup_cache();
       if (_mount->copy_file(_local_filename, new_file_simple->_local_filename)) {
         return true;
       }
@@ -253,6 +257,7 @@ open_write_file(bool auto_wrap, bool truncate) {
     local_filename.set_binary();
   }
 
+  invalidate_lookup_cache();
   return _mount->open_write_file(local_filename, do_compress, truncate);
 }
 
@@ -263,6 +268,7 @@ open_write_file(bool auto_wrap, bool truncate) {
  */
 ostream *VirtualFileSimple::
 open_append_file() {
+  invalidate_lookup_cache();
   return _mount->open_append_file(_local_filename);
 }
 
@@ -284,6 +290,7 @@ close_write_file(ostream *stream) {
  */
 iostream *VirtualFileSimple::
 open_read_write_file(bool truncate) {
+  invalidate_lookup_cache();
   return _mount->open_read_write_file(_local_filename, truncate);
 }
 
@@ -294,6 +301,7 @@ open_read_write_file(bool truncate) {
  */
 iostream *VirtualFileSimple::
 open_read_append_file() {
+  invalidate_lookup_cache();
   return _mount->open_read_append_file(_local_filename);
 }
 
@@ -361,6 +369,7 @@ bool VirtualFileSimple::
 atomic_compare_and_exchange_contents(string &orig_contents,
                                      const string &old_contents,
                                      const string &new_contents) {
+  invalidate_lookup_cache();
   return _mount->atomic_compare_and_exchange_contents(_local_filename, orig_contents, old_contents, new_contents);
 }
 
@@ -408,9 +417,22 @@ write_file(const unsigned char *data, size_t data_size, bool auto_wrap) {
     local_filename.set_binary();
   }
 
+  invalidate_lookup_cache();
   return _mount->write_file(local_filename, do_compress, data, data_size);
 }
 
+/**
+ * Called before any operation that might create or remove this file, so that
+ * the file system will not go on answering lookups from its cache.
+ */
+void VirtualFileSimple::
+invalidate_lookup_cache() {
+  VirtualFileSystem *file_system = _mount->get_file_system();
+  if (file_system != nullptr) {
+    file_system->invalidate_lookup_cache();
+  }
+}
+
 /**
  * Fills file_list up with the list of files that are within this directory,
  * excluding those whose basenames are listed in mount_points.  Returns true
@@ -71,6 +71,8 @@ protected:
                                     const ov_set<std::string> &mount_points) const;
 
 private:
+  void invalidate_lookup_cache();
+
   VirtualFileMount *_mount;
   Filename _local_filename;
   bool _implicit_pz_file;
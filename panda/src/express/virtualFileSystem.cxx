@@ -74,10 +74,28 @@ VirtualFileSystem() :
             "will implicitly retrieve a file named 'dirname/mytex.jpg' "
             "within the multifile /c/files/foo.mf, even if the multifile "
             "has not already been mounted.  This makes all of your multifiles "
-            "act like directories."))
+            "act like directories.")),
+  vfs_lookup_cache
+  ("vfs-lookup-cache", false,
+   PRC_DESC("When this is true, the VirtualFileSystem remembers the result "
+            "of each lookup, including the failure to find a file, so that "
+            "searching for the same file again does not need to consult each "
+            "of the mounts.  The cache is cleared whenever a mount is added "
+            "or removed, or a file is created, deleted or renamed through the "
+            "VirtualFileSystem.  Changes made to the disk by other processes "
+            "are not noticed while this is in effect, so this is best used "
+            "with read-only assets.")),
+  vfs_lookup_cache_size
+  ("vfs-lookup-cache-size", 16384,
+   PRC_DESC("The number of lookups that are remembered when "
+            "vfs-lookup-cache is true.  When this is exceeded, the cache is "
+            "cleared and starts over."))
 {
   _cwd = "/";
   _mount_seq = 0;
+  _lookup_cache_mount_seq = 0;
+  _lookup_cache_invalidate_seq = 0;
+  _invalidate_seq = 0;
 }
 
 /**
@@ -549,6 +567,9 @@ chdir(const Filename &new_directory) {
   if (file != nullptr && file->is_directory()) {
     _cwd = file->get_filename();
     _lock.unlock();
+
+    // Relative filenames now refer to different files.
+    invalidate_lookup_cache();
     return true;
   }
   _lock.unlock();
@@ -839,6 +860,19 @@ write(ostream &out) const {
 }
 
 
+/**
+ * Discards the results of previous lookups, if vfs-lookup-cache is in
+ * effect.  This must be called when files have been added to or removed from
+ * the disk by some means other than this VirtualFileSystem, such as another
+ * process, in order for the VirtualFileSystem to notice the change.
+ *
+ * This is safe to call from any thread at any time.
+ */
+void VirtualFileSystem::
+invalidate_lookup_cache() {
+  _invalidate_seq.fetch_add(1, std::memory_order_relaxed);
+}
+
 /**
  * Returns the default global VirtualFileSystem.  You may create your own
  * personal VirtualFileSystem objects and use them for whatever you like, but
@@ -1291,9 +1325,64 @@ do_mount(VirtualFileMount *mount, const Filename &mount_point, int flags) {
 /**
  * The private implementation of get_file(), create_file(), and
  * make_directory().  Assumes the lock is already held.
+ *
+ * Plain lookups are answered from the lookup cache if vfs-lookup-cache is in
+ * effect; anything else is passed on to do_lookup_file().
  */
 PT(VirtualFile) VirtualFileSystem::
 do_get_file(const Filename &filename, int open_flags) const {
+  if ((open_flags & ~OF_status_only) != 0) {
+    if ((open_flags & (OF_create_file | OF_make_directory)) != 0) {
+      // This may create a file that we have previously failed to find.
+      ((VirtualFileSystem *)this)->invalidate_lookup_cache();
+    }
+    return do_lookup_file(filename, open_flags);
+  }
+
+  if (!vfs_lookup_cache || filename.empty()) {
+    return do_lookup_file(filename, open_flags);
+  }
+
+  unsigned int invalidate_seq = _invalidate_seq.load(std::memory_order_relaxed);
+  if (_lookup_cache_mount_seq != _mount_seq ||
+      _lookup_cache_invalidate_seq != invalidate_seq) {
+    _lookup_cache.clear();
+    _lookup_cache_mount_seq = _mount_seq;
+    _lookup_cache_invalidate_seq = invalidate_seq;
+  }
+
+  // Whether the file is opened in text mode is part of the result.
+  string key;
+  key.reserve(filename.length() + 1);
+  key += (char)('0' + (open_flags & OF_status_only) + (filename.is_text() ? 2 : 0));
+  key += filename.get_fullpath();
+
+  LookupCache::const_iterator ci = _lookup_cache.find(key);
+  if (ci != _lookup_cache.end()) {
+    return (*ci).second;
+  }
+
+  PT(VirtualFile) result = do_lookup_file(filename, open_flags);
+
+  if (_lookup_cache_mount_seq != _mount_seq) {
+    // A multifile was implicitly mounted during the lookup, which makes
+    // anything else we have cached suspect.
+    _lookup_cache.clear();
+    _lookup_cache_mount_seq = _mount_seq;
+  }
+  if (_lookup_cache.size() >= (size_t)vfs_lookup_cache_size.get_value()) {
+    _lookup_cache.clear();
+  }
+  _lookup_cache[std::move(key)] = result;
+  return result;
+}
+
+/**
+ * Searches the mounts for the indicated file.  This is the uncached part of
+ * do_get_file().  Assumes the lock is already held.
+ */
+PT(VirtualFile) VirtualFileSystem::
+do_lookup_file(const Filename &filename, int open_flags) const {
   if (filename.empty()) {
     return nullptr;
   }
@@ -1383,7 +1472,7 @@ do_get_file(const Filename &filename, int open_flags) const {
     if (start_seq != _mount_seq) {
       // Yes, it was, or some nested file was.  Now that we've implicitly
       // mounted the .mf file, go back and look again.
-      return do_get_file(filename, open_flags);
+      return do_lookup_file(filename, open_flags);
     }
   }
 
@@ -25,6 +25,8 @@
 #include "config_express.h"
 #include "mutexImpl.h"
 #include "pvector.h"
+#include "pmap.h"
+#include "patomic.h"
 #include "zipArchive.h"
 
 class Multifile;
@@ -37,6 +39,13 @@ class VirtualFileComposite;
  *
  * For instance, a VirtualFileSystem can transparently mount one or more
  * Multifiles as their own subdirectory hierarchies.
+ *
+ * If vfs-lookup-cache is enabled, the results of looking up a file, including
+ * the failure to find one, are remembered until the set of mounts changes or
+ * a file is created or removed through the VirtualFileSystem.  This saves a
+ * great many operating system calls when searching long model paths over
+ * many mounts, but changes made to the disk by other means will not be
+ * noticed until invalidate_lookup_cache() is called.
  */
 class EXPCL_PANDA_EXPRESS VirtualFileSystem {
 PUBLISHED:
@@ -96,6 +105,8 @@ PUBLISHED:
 
   void write(std::ostream &out) const;
 
+  void invalidate_lookup_cache();
+
   static VirtualFileSystem *get_global_ptr();
 
   PY_EXTENSION(PyObject *read_file(const Filename &filename, bool auto_unwrap) const);
@@ -148,11 +159,14 @@ public:
   ConfigVariableBool vfs_case_sensitive;
   ConfigVariableBool vfs_implicit_pz;
   ConfigVariableBool vfs_implicit_mf;
+  ConfigVariableBool vfs_lookup_cache;
+  ConfigVariableInt vfs_lookup_cache_size;
 
 private:
   Filename normalize_mount_point(const Filename &mount_point) const;
   bool do_mount(VirtualFileMount *mount, const Filename &mount_point, int flags);
   PT(VirtualFile) do_get_file(const Filename &filename, int open_flags) const;
+  PT(VirtualFile) do_lookup_file(const Filename &filename, int open_flags) const;
 
   bool consider_match(PT(VirtualFile) &found_file, VirtualFileComposite *&composite_file,
                       VirtualFileMount *mount, const Filename &local_filename,
@@ -165,6 +179,15 @@ private:
   Mounts _mounts;
   unsigned int _mount_seq;
 
+  // The results of previous lookups, keyed by the open flags and the
+  // filename, and valid only as long as _mount_seq and _invalidate_seq have
+  // not changed.  A nullptr records that the file was not found.
+  typedef pmap<std::string, PT(VirtualFile)> LookupCache;
+  mutable LookupCache _lookup_cache;
+  mutable unsigned int _lookup_cache_mount_seq;
+  mutable unsigned int _lookup_cache_invalidate_seq;
+  patomic<unsigned int> _invalidate_seq;
+
   Filename _cwd;
 
   static VirtualFileSystem *_global_ptr;
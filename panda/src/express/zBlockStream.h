@@ -0,0 +1,90 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file zBlockStream.h
+ * @author agent
+ * @date 2026-10-16
+ */
+
+#ifndef ZBLOCKSTREAM_H
+#define ZBLOCKSTREAM_H
+
+#include "pandabase.h"
+
+// This module is not compiled if zlib is not available.
+#ifdef HAVE_ZLIB
+
+#include "zBlockStreamBuf.h"
+
+/**
+ * An input stream object that decompresses data written by an
+ * OBlockCompressStream.
+ *
+ * Since each block of the data is compressed independently, this stream may
+ * be seeked freely; seeking only costs the decompression of the block that
+ * contains the new position.  The source is read through an IStreamWrapper,
+ * so that several of these streams may be reading from different parts of
+ * the same file at once.
+ */
+class EXPCL_PANDA_EXPRESS IBlockDecompressStream : public std::istream {
+PUBLISHED:
+  INLINE IBlockDecompressStream();
+  INLINE explicit IBlockDecompressStream(IStreamWrapper *source,
+                                         std::streampos start,
+                                         std::streamsize source_length);
+
+#if _MSC_VER >= 1800
+  INLINE IBlockDecompressStream(const IBlockDecompressStream &copy) = delete;
+#endif
+
+  INLINE IBlockDecompressStream &open(IStreamWrapper *source,
+                                      std::streampos start,
+                                      std::streamsize source_length);
+  INLINE IBlockDecompressStream &close();
+
+private:
+  ZBlockStreamBuf _buf;
+};
+
+/**
+ * An output stream object that compresses data to another destination
+ * stream in independently-compressed blocks of a fixed size,
+ * followed by a table of the blocks.  The result may be read back with an
+ * IBlockDecompressStream.
+ *
+ * The stream is not complete until close() is called or the stream is
+ * destructed.  Seeking is not supported.
+ */
+class EXPCL_PANDA_EXPRESS OBlockCompressStream : public std::ostream {
+PUBLISHED:
+  INLINE OBlockCompressStream();
+  INLINE explicit OBlockCompressStream(std::ostream *dest, bool owns_dest,
+                                       int compression_level = 6,
+                                       size_t block_size = 65536,
+                                       CompressionAlgorithm algorithm = CA_zlib);
+
+#if _MSC_VER >= 1800
+  INLINE OBlockCompressStream(const OBlockCompressStream &copy) = delete;
+#endif
+
+  INLINE OBlockCompressStream &open(std::ostream *dest, bool owns_dest,
+                                    int compression_level = 6,
+                                    size_t block_size = 65536,
+                                    CompressionAlgorithm algorithm = CA_zlib);
+  INLINE OBlockCompressStream &close();
+
+private:
+  ZBlockStreamBuf _buf;
+};
+
+#include "zBlockStream.I"
+
+#endif  // HAVE_ZLIB
+
+
+#endif
@@ -0,0 +1,572 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file zBlockStreamBuf.cxx
+ * @author agent
+ * @date 2026-10-16
+ */
+
+#include "zBlockStreamBuf.h"
+
+#ifdef HAVE_ZLIB
+
+#include "pnotify.h"
+#include "config_express.h"
+#include "datagram.h"
+#include "datagramIterator.h"
+
+#include <zlib.h>
+
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+#ifdef HAVE_LZ4
+#include <lz4frame.h>
+#endif
+
+using std::ios;
+using std::min;
+using std::streamoff;
+using std::streampos;
+using std::streamsize;
+
+// The size in bytes of the uncompressed length and block size that end the
+// stream.
+static const size_t footer_size = 8;
+
+/**
+ *
+ */
+ZBlockStreamBuf::
+ZBlockStreamBuf() {
+  _source = nullptr;
+  _source_start = 0;
+  _length = 0;
+  _buffer_start = 0;
+  _block = (size_t)-1;
+
+  _dest = nullptr;
+  _owns_dest = false;
+  _compression_level = 6;
+  _algorithm = CA_zlib;
+
+  _block_size = 0;
+  _buffer = nullptr;
+  setg(nullptr, nullptr, nullptr);
+  setp(nullptr, nullptr);
+}
+
+/**
+ *
+ */
+ZBlockStreamBuf::
+~ZBlockStreamBuf() {
+  close_read();
+  close_write();
+  if (_buffer != nullptr) {
+    PANDA_FREE_ARRAY(_buffer);
+  }
+}
+
+/**
+ * Prepares to read the block-compressed data that occupies source_length
+ * bytes of the source stream, beginning at start.  Returns true if the table
+ * of blocks could be read, false otherwise.
+ */
+bool ZBlockStreamBuf::
+open_read(IStreamWrapper *source, streampos start, streamsize source_length) {
+  close_read();
+
+  size_t block_size;
+  if (!read_block_table(source, start, source_length, _length, block_size,
+                        _block_ends)) {
+    return false;
+  }
+
+  if (_buffer == nullptr || block_size > _block_size) {
+    if (_buffer != nullptr) {
+      PANDA_FREE_ARRAY(_buffer);
+    }
+    _buffer = (char *)PANDA_MALLOC_ARRAY(block_size);
+  }
+  _block_size = block_size;
+
+  _source = source;
+  _source_start = start;
+  _buffer_start = 0;
+  _block = (size_t)-1;
+  setg(_buffer, _buffer, _buffer);
+  return true;
+}
+
+/**
+ *
+ */
+void ZBlockStreamBuf::
+close_read() {
+  if (_source != nullptr) {
+    _source = nullptr;
+    _block_ends.clear();
+    _compressed.clear();
+    _length = 0;
+    _buffer_start = 0;
+    _block = (size_t)-1;
+  }
+  setg(nullptr, nullptr, nullptr);
+}
+
+/**
+ * Prepares to write compressed data to the indicated stream, block_size
+ * uncompressed bytes at a time.
+ */
+void ZBlockStreamBuf::
+open_write(std::ostream *dest, bool owns_dest, int compression_level,
+           size_t block_size, CompressionAlgorithm algorithm) {
+  close_write();
+  nassertv(block_size > 0);
+
+  if (algorithm == CA_none || !is_compression_algorithm_supported(algorithm)) {
+    if (algorithm != CA_none) {
+      express_cat.warning()
+        << algorithm << " not compiled in; using zlib compression instead.\n";
+    }
+    algorithm = CA_zlib;
+  }
+  _algorithm = algorithm;
+
+  if (_buffer == nullptr || block_size > _block_size) {
+    if (_buffer != nullptr) {
+      PANDA_FREE_ARRAY(_buffer);
+    }
+    _buffer = (char *)PANDA_MALLOC_ARRAY(block_size);
+  }
+  _block_size = block_size;
+
+  _dest = dest;
+  _owns_dest = owns_dest;
+  _compression_level = compression_level;
+  _length = 0;
+  _block_ends.clear();
+  setp(_buffer, _buffer + _block_size);
+}
+
+/**
+ * Writes out the last block and the block table.  This must be called to
+ * complete the stream.
+ */
+void ZBlockStreamBuf::
+close_write() {
+  if (_dest != nullptr) {
+    write_block();
+
+    Datagram dg;
+    for (uint32_t block_end : _block_ends) {
+      dg.add_uint32(block_end);
+    }
+    dg.add_uint32((uint32_t)_length);
+    dg.add_uint32((uint32_t)_block_size);
+    _dest->write((const char *)dg.get_data(), dg.get_length());
+
+    if (_owns_dest) {
+      delete _dest;
+      _owns_dest = false;
+    }
+    _dest = nullptr;
+    _block_ends.clear();
+    _compressed.clear();
+    _length = 0;
+  }
+  setp(nullptr, nullptr);
+}
+
+/**
+ * Implements seeking within the stream.  Only the read pointer may be moved;
+ * doing so costs no more than decompressing the one block that contains the
+ * new position.
+ */
+streampos ZBlockStreamBuf::
+seekoff(streamoff off, ios_seekdir dir, ios_openmode which) {
+  if (_source == nullptr || (which & ios::in) == 0) {
+    return -1;
+  }
+
+  streamsize cur_pos = _buffer_start + (gptr() - eback());
+  streamsize new_pos;
+  switch (dir) {
+  case ios::beg:
+    new_pos = (streamsize)off;
+    break;
+
+  case ios::cur:
+    new_pos = cur_pos + (streamsize)off;
+    break;
+
+  case ios::end:
+    new_pos = _length + (streamsize)off;
+    break;
+
+  default:
+    return -1;
+  }
+
+  if (new_pos < 0 || new_pos > _length) {
+    return -1;
+  }
+
+  if (new_pos >= _buffer_start && new_pos < _buffer_start + (egptr() - eback())) {
+    // The new position is within the block we already have.
+    setg(eback(), eback() + (size_t)(new_pos - _buffer_start), egptr());
+  } else {
+    // Otherwise, the appropriate block will be read by the next underflow().
+    _buffer_start = new_pos;
+    setg(_buffer, _buffer, _buffer);
+  }
+
+  return new_pos;
+}
+
+/**
+ * A variant on seekoff() to implement seeking within a stream.
+ */
+streampos ZBlockStreamBuf::
+seekpos(streampos pos, ios_openmode which) {
+  return seekoff(pos, ios::beg, which);
+}
+
+/**
+ * Reads the table of blocks from the end of the block-compressed data that
+ * occupies source_length bytes of the source stream, beginning at start.
+ * Fills in the total uncompressed length, the uncompressed size of each
+ * block, and the compressed offset at which each block ends, relative to
+ * start.  Returns true on success, false if the table is malformed.
+ */
+bool ZBlockStreamBuf::
+read_block_table(IStreamWrapper *source, streampos start,
+                 streamsize source_length, streamsize &length,
+                 size_t &block_size, pvector<uint32_t> &block_ends) {
+  nassertr(source != nullptr, false);
+  block_ends.clear();
+
+  if (source_length < (streamsize)footer_size) {
+    express_cat.error()
+      << "Block-compressed stream is truncated.\n";
+    return false;
+  }
+
+  char footer[footer_size];
+  streamsize count;
+  bool eof;
+  source->seek_read((streamsize)start + source_length - footer_size,
+                    footer, footer_size, count, eof);
+  if (count != (streamsize)footer_size) {
+    express_cat.error()
+      << "Unable to read block-compressed stream.\n";
+    return false;
+  }
+
+  {
+    Datagram dg(footer, footer_size);
+    DatagramIterator scan(dg);
+    length = scan.get_uint32();
+    block_size = scan.get_uint32();
+  }
+
+  if (block_size == 0) {
+    express_cat.error()
+      << "Block-compressed stream has an invalid block size.\n";
+    return false;
+  }
+
+  size_t num_blocks = (size_t)((length + block_size - 1) / block_size);
+  size_t table_size = num_blocks * 4;
+  if ((streamsize)(table_size + footer_size) > source_length) {
+    express_cat.error()
+      << "Block-compressed stream has an invalid block table.\n";
+    return false;
+  }
+
+  streamsize data_length = source_length - table_size - footer_size;
+  if (num_blocks != 0) {
+    vector_uchar table(table_size);
+    source->seek_read((streamsize)start + data_length,
+                      (char *)&table[0], table_size, count, eof);
+    if (count != (streamsize)table_size) {
+      express_cat.error()
+        << "Unable to read block-compressed stream.\n";
+      return false;
+    }
+
+    Datagram dg(std::move(table));
+    DatagramIterator scan(dg);
+    block_ends.reserve(num_blocks);
+    uint32_t prev_end = 0;
+    for (size_t n = 0; n < num_blocks; ++n) {
+      uint32_t block_end = scan.get_uint32();
+      if (block_end < prev_end) {
+        break;
+      }
+      block_ends.push_back(block_end);
+      prev_end = block_end;
+    }
+  }
+
+  if (block_ends.size() != num_blocks ||
+      (num_blocks != 0 && (streamsize)block_ends.back() != data_length)) {
+    express_cat.error()
+      << "Block-compressed stream has an invalid block table.\n";
+    block_ends.clear();
+    return false;
+  }
+
+  return true;
+}
+
+/**
+ * Decompresses a single block into dest, which must be exactly dest_length
+ * bytes, the uncompressed size of the block.  Returns true on success.
+ */
+bool ZBlockStreamBuf::
+decompress_block(const unsigned char *source, size_t source_length,
+                 char *dest, size_t dest_length) {
+  if (source_length == dest_length) {
+    // This block was stored uncompressed.
+    memcpy(dest, source, dest_length);
+    return true;
+  }
+
+  switch (detect_compression_algorithm(source, source_length)) {
+#ifdef HAVE_ZSTD
+  case CA_zstd:
+    {
+      size_t result = ZSTD_decompress(dest, dest_length, source, source_length);
+      if (ZSTD_isError(result) || result != dest_length) {
+        express_cat.error()
+          << "zstd error in ZSTD_decompress: "
+          << (ZSTD_isError(result) ? ZSTD_getErrorName(result) : "wrong length")
+          << "\n";
+        return false;
+      }
+      return true;
+    }
+#endif  // HAVE_ZSTD
+
+#ifdef HAVE_LZ4
+  case CA_lz4:
+    {
+      LZ4F_dctx *dctx;
+      if (LZ4F_isError(LZ4F_createDecompressionContext(&dctx, LZ4F_VERSION))) {
+        return false;
+      }
+      size_t dest_size = dest_length;
+      size_t source_size = source_length;
+      size_t result = LZ4F_decompress(dctx, dest, &dest_size, source, &source_size, nullptr);
+      LZ4F_freeDecompressionContext(dctx);
+      if (LZ4F_isError(result) || result != 0 || dest_size != dest_length) {
+        express_cat.error()
+          << "LZ4 error in LZ4F_decompress: "
+          << (LZ4F_isError(result) ? LZ4F_getErrorName(result) : "wrong length")
+          << "\n";
+        return false;
+      }
+      return true;
+    }
+#endif  // HAVE_LZ4
+
+#if !defined(HAVE_ZSTD) || !defined(HAVE_LZ4)
+#ifndef HAVE_ZSTD
+  case CA_zstd:
+#endif
+#ifndef HAVE_LZ4
+  case CA_lz4:
+#endif
+    express_cat.error()
+      << "Block is compressed with an algorithm that is not compiled in.\n";
+    return false;
+#endif
+
+  default:
+    break;
+  }
+
+  uLongf result_length = (uLongf)dest_length;
+  int result = uncompress((Bytef *)dest, &result_length,
+                          (const Bytef *)source, (uLong)source_length);
+  if (result != Z_OK || result_length != (uLongf)dest_length) {
+    express_cat.error()
+      << "zlib error in uncompress: " << result << "\n";
+    return false;
+  }
+  return true;
+}
+
+/**
+ * Called by the system ostream implementation when its internal buffer is
+ * filled, plus one character.
+ */
+int ZBlockStreamBuf::
+overflow(int ch) {
+  if (_dest == nullptr) {
+    return EOF;
+  }
+
+  // The buffer holds exactly one block, so it is full now.
+  write_block();
+
+  if (ch != EOF) {
+    // Write one more character.
+    *pptr() = ch;
+    pbump(1);
+  }
+
+  return 0;
+}
+
+/**
+ * Called by the system iostream implementation to implement a flush
+ * operation.  Since only whole blocks may be written, except at the very end,
+ * this has no effect; the last block is written by close_write().
+ */
+int ZBlockStreamBuf::
+sync() {
+  return 0;
+}
+
+/**
+ * Called by the system istream implementation when its internal buffer needs
+ * more characters.
+ */
+int ZBlockStreamBuf::
+underflow() {
+  // Sometimes underflow() is called even if the buffer is not empty.
+  if (gptr() < egptr()) {
+    return (unsigned char)*gptr();
+  }
+
+  if (_source == nullptr) {
+    return EOF;
+  }
+
+  streamsize pos = _buffer_start + (gptr() - eback());
+  if (pos >= _length) {
+    return EOF;
+  }
+
+  size_t n = (size_t)(pos / (streamsize)_block_size);
+  if (n != _block) {
+    if (!read_block(n)) {
+      _block = (size_t)-1;
+      _buffer_start = pos;
+      setg(_buffer, _buffer, _buffer);
+      return EOF;
+    }
+    _block = n;
+  }
+
+  _buffer_start = (streamsize)n * (streamsize)_block_size;
+  size_t block_length = (size_t)min((streamsize)_block_size, _length - _buffer_start);
+  setg(_buffer, _buffer + (size_t)(pos - _buffer_start), _buffer + block_length);
+  return (unsigned char)*gptr();
+}
+
+/**
+ * Reads and decompresses the nth block into the buffer.  Returns true on
+ * success.
+ */
+bool ZBlockStreamBuf::
+read_block(size_t n) {
+  nassertr(n < _block_ends.size(), false);
+  uint32_t begin = (n == 0) ? 0 : _block_ends[n - 1];
+  size_t compressed_length = _block_ends[n] - begin;
+  size_t block_length = (size_t)min((streamsize)_block_size,
+                                    _length - (streamsize)n * (streamsize)_block_size);
+
+  _compressed.resize(compressed_length);
+  if (compressed_length != 0) {
+    streamsize count;
+    bool eof;
+    _source->seek_read((streamsize)_source_start + begin,
+                       (char *)&_compressed[0], compressed_length, count, eof);
+    if (count != (streamsize)compressed_length) {
+      express_cat.error()
+        << "Unexpected end of block-compressed stream.\n";
+      return false;
+    }
+  }
+
+  thread_consider_yield();
+  return decompress_block(_compressed.data(), compressed_length,
+                          _buffer, block_length);
+}
+
+/**
+ * Compresses and writes out whatever has been written to the buffer so far,
+ * as one block.
+ */
+void ZBlockStreamBuf::
+write_block() {
+  size_t n = pptr() - pbase();
+  if (n == 0) {
+    return;
+  }
+
+  size_t compressed_length = compress_block(pbase(), n);
+
+  uint32_t prev_end = _block_ends.empty() ? 0 : _block_ends.back();
+  if (compressed_length != 0 && compressed_length < n) {
+    _dest->write((const char *)&_compressed[0], compressed_length);
+    _block_ends.push_back(prev_end + (uint32_t)compressed_length);
+  } else {
+    // Compression didn't help; store the block as it is.
+    _dest->write(pbase(), n);
+    _block_ends.push_back(prev_end + (uint32_t)n);
+  }
+  _length += n;
+
+  thread_consider_yield();
+  setp(_buffer, _buffer + _block_size);
+}
+
+/**
+ * Compresses the indicated data into _compressed, using the algorithm given
+ * to open_write().  Returns the compressed length, or 0 on failure.
+ */
+size_t ZBlockStreamBuf::
+compress_block(const char *source, size_t source_length) {
+#ifdef HAVE_ZSTD
+  if (_algorithm == CA_zstd) {
+    _compressed.resize(ZSTD_compressBound(source_length));
+    size_t result = ZSTD_compress(&_compressed[0], _compressed.size(),
+                                  source, source_length, _compression_level);
+    return ZSTD_isError(result) ? 0 : result;
+  }
+#endif  // HAVE_ZSTD
+
+#ifdef HAVE_LZ4
+  if (_algorithm == CA_lz4) {
+    LZ4F_preferences_t prefs;
+    memset(&prefs, 0, sizeof(prefs));
+    prefs.compressionLevel = _compression_level;
+    prefs.frameInfo.contentSize = source_length;
+
+    _compressed.resize(LZ4F_compressFrameBound(source_length, &prefs));
+    size_t result = LZ4F_compressFrame(&_compressed[0], _compressed.size(),
+                                       source, source_length, &prefs);
+    return LZ4F_isError(result) ? 0 : result;
+  }
+#endif  // HAVE_LZ4
+
+  uLongf compressed_length = compressBound((uLong)source_length);
+  _compressed.resize(compressed_length);
+  int result = compress2((Bytef *)&_compressed[0], &compressed_length,
+                         (const Bytef *)source, (uLong)source_length,
+                         _compression_level);
+  return (result == Z_OK) ? (size_t)compressed_length : 0;
+}
+
+#endif  // HAVE_ZLIB
@@ -0,0 +1,94 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file zBlockStreamBuf.h
+ * @author agent
+ * @date 2026-10-16
+ */
+
+#ifndef ZBLOCKSTREAMBUF_H
+#define ZBLOCKSTREAMBUF_H
+
+#include "pandabase.h"
+
+// This module is not compiled if zlib is not available.
+#ifdef HAVE_ZLIB
+
+#include "streamWrapper.h"
+#include "compressionAlgorithm.h"
+#include "pvector.h"
+#include "vector_uchar.h"
+
+/**
+ * The streambuf object that implements IBlockDecompressStream and
+ * OBlockCompressStream.
+ *
+ * The data is divided into blocks of a fixed uncompressed size, each of
+ * which is compressed independently of the others.  The blocks are followed
+ * by a table of the compressed offsets at which each block ends, so that any
+ * block may be located and decompressed without reading the ones before it.
+ * The table is followed by the total uncompressed length and the block size,
+ * as two little-endian uint32 values.  A block whose compressed length
+ * equals its uncompressed length was stored without compression; otherwise,
+ * the algorithm of each block is recognized from its first bytes.
+ */
+class EXPCL_PANDA_EXPRESS ZBlockStreamBuf : public std::streambuf {
+public:
+  ZBlockStreamBuf();
+  ZBlockStreamBuf(const ZBlockStreamBuf &copy) = delete;
+  virtual ~ZBlockStreamBuf();
+
+  bool open_read(IStreamWrapper *source, std::streampos start,
+                 std::streamsize source_length);
+  void close_read();
+
+  void open_write(std::ostream *dest, bool owns_dest, int compression_level,
+                  size_t block_size, CompressionAlgorithm algorithm = CA_zlib);
+  void close_write();
+
+  virtual std::streampos seekoff(std::streamoff off, ios_seekdir dir, ios_openmode which);
+  virtual std::streampos seekpos(std::streampos pos, ios_openmode which);
+
+  static bool read_block_table(IStreamWrapper *source, std::streampos start,
+                               std::streamsize source_length,
+                               std::streamsize &length, size_t &block_size,
+                               pvector<uint32_t> &block_ends);
+  static bool decompress_block(const unsigned char *source, size_t source_length,
+                               char *dest, size_t dest_length);
+
+protected:
+  virtual int overflow(int c);
+  virtual int sync();
+  virtual int underflow();
+
+private:
+  bool read_block(size_t n);
+  void write_block();
+  size_t compress_block(const char *source, size_t source_length);
+
+private:
+  IStreamWrapper *_source;
+  std::streampos _source_start;
+  pvector<uint32_t> _block_ends;
+  std::streamsize _length;
+  std::streamsize _buffer_start;
+  size_t _block;
+  vector_uchar _compressed;
+
+  std::ostream *_dest;
+  bool _owns_dest;
+  int _compression_level;
+  CompressionAlgorithm _algorithm;
+
+  size_t _block_size;
+  char *_buffer;
+};
+
+#endif  // HAVE_ZLIB
+
+#endif
@@ -59,6 +59,9 @@ private:
  * compressed data, and write your uncompressed source data to the
  * OCompressStream.
  *
+ * If Panda was compiled with LZ4 or Zstandard, either of these may be
+ * requested in place of zlib; IDecompressStream recognizes all of them.
+ *
  * Seeking is not supported.
  */
 class EXPCL_PANDA_EXPRESS OCompressStream : public std::ostream {
@@ -66,7 +69,8 @@ PUBLISHED:
   INLINE OCompressStream();
   INLINE explicit OCompressStream(std::ostream *dest, bool owns_dest,
                                   int compression_level = 6,
-                                  bool header=true);
+                                  bool header=true,
+                                  CompressionAlgorithm algorithm=CA_zlib);
 
 #if _MSC_VER >= 1800
   INLINE OCompressStream(const OCompressStream &copy) = delete;
@@ -74,7 +78,8 @@ PUBLISHED:
 
   INLINE OCompressStream &open(std::ostream *dest, bool owns_dest,
                                int compression_level = 6,
-                               bool header=true);
+                               bool header=true,
+                               CompressionAlgorithm algorithm=CA_zlib);
   INLINE OCompressStream &close();
 
 private:
@@ -18,6 +18,14 @@
 #include "pnotify.h"
 #include "config_express.h"
 
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+#ifdef HAVE_LZ4
+#include <lz4frame.h>
+#endif
+
 using std::ios;
 using std::streamoff;
 using std::streampos;
@@ -34,6 +42,9 @@ do_zlib_free(voidpf opaque, voidpf address) {
 }
 #endif  //  !USE_MEMORY_NOWRAPPERS
 
+// The size of the chunks in which compressed data is written out.
+static const size_t compress_buffer_size = 4096;
+
 /**
  *
  */
@@ -78,6 +89,12 @@ open_read(std::istream *source, bool owns_source, std::streamsize source_length,
   _source_bytes_left = source_length;
   _owns_source = owns_source;
 
+  // If the stream has a header, we will determine the algorithm from it when
+  // we first read from the stream.  A raw stream can only be deflate.
+  _source_header = header;
+  _read_algorithm = header ? CA_none : CA_zlib;
+  _total_out = 0;
+
   _z_source.next_in = Z_NULL;
   _z_source.avail_in = 0;
   _z_source.next_out = Z_NULL;
@@ -115,6 +132,19 @@ close_read() {
     }
     thread_consider_yield();
 
+#ifdef HAVE_ZSTD
+    if (_zstd_source != nullptr) {
+      ZSTD_freeDCtx(_zstd_source);
+      _zstd_source = nullptr;
+    }
+#endif
+#ifdef HAVE_LZ4
+    if (_lz4_source != nullptr) {
+      LZ4F_freeDecompressionContext(_lz4_source);
+      _lz4_source = nullptr;
+    }
+#endif
+
     if (_owns_source) {
       delete _source;
       _owns_source = false;
@@ -124,13 +154,64 @@ close_read() {
 }
 
 /**
- *
+ * Prepares to write compressed data to the indicated stream.  If header is
+ * false, a raw deflate stream is written, which is only possible with zlib.
  */
 void ZStreamBuf::
-open_write(std::ostream *dest, bool owns_dest, int compression_level, bool header) {
+open_write(std::ostream *dest, bool owns_dest, int compression_level, bool header,
+           CompressionAlgorithm algorithm) {
   _dest = dest;
   _owns_dest = owns_dest;
 
+  if (!header || algorithm == CA_none) {
+    algorithm = CA_zlib;
+  }
+  if (!is_compression_algorithm_supported(algorithm)) {
+    express_cat.warning()
+      << algorithm << " not compiled in; using zlib compression instead.\n";
+    algorithm = CA_zlib;
+  }
+  _write_algorithm = algorithm;
+
+#ifdef HAVE_ZSTD
+  if (algorithm == CA_zstd) {
+    _zstd_dest = ZSTD_createCCtx();
+    nassertv(_zstd_dest != nullptr);
+    ZSTD_CCtx_setParameter(_zstd_dest, ZSTD_c_compressionLevel, compression_level);
+    return;
+  }
+#endif  // HAVE_ZSTD
+
+#ifdef HAVE_LZ4
+  if (algorithm == CA_lz4) {
+    size_t result = LZ4F_createCompressionContext(&_lz4_dest, LZ4F_VERSION);
+    if (LZ4F_isError(result)) {
+      express_cat.warning()
+        << "LZ4 error in LZ4F_createCompressionContext: "
+        << LZ4F_getErrorName(result) << "\n";
+      _lz4_dest = nullptr;
+      return;
+    }
+
+    LZ4F_preferences_t prefs;
+    memset(&prefs, 0, sizeof(prefs));
+    prefs.compressionLevel = compression_level;
+
+    // This is large enough for any one call to LZ4F_compressUpdate() with no
+    // more than compress_buffer_size bytes, as well as for the header.
+    _lz4_buffer.resize(LZ4F_compressBound(compress_buffer_size, &prefs));
+
+    result = LZ4F_compressBegin(_lz4_dest, &_lz4_buffer[0], _lz4_buffer.size(), &prefs);
+    if (LZ4F_isError(result)) {
+      express_cat.warning()
+        << "LZ4 error in LZ4F_compressBegin: " << LZ4F_getErrorName(result) << "\n";
+    } else {
+      _dest->write((const char *)&_lz4_buffer[0], result);
+    }
+    return;
+  }
+#endif  // HAVE_LZ4
+
   _z_dest.next_in = Z_NULL;
   _z_dest.avail_in = 0;
   _z_dest.next_out = Z_NULL;
@@ -164,10 +245,25 @@ close_write() {
     write_chars(pbase(), n, Z_FINISH);
     pbump(-(int)n);
 
-    int result = deflateEnd(&_z_dest);
-    if (result < 0) {
-      show_zlib_error("deflateEnd", result, _z_dest);
+    if (_write_algorithm == CA_zlib) {
+      int result = deflateEnd(&_z_dest);
+      if (result < 0) {
+        show_zlib_error("deflateEnd", result, _z_dest);
+      }
+    }
+#ifdef HAVE_ZSTD
+    if (_zstd_dest != nullptr) {
+      ZSTD_freeCCtx(_zstd_dest);
+      _zstd_dest = nullptr;
     }
+#endif
+#ifdef HAVE_LZ4
+    if (_lz4_dest != nullptr) {
+      LZ4F_freeCompressionContext(_lz4_dest);
+      _lz4_dest = nullptr;
+    }
+#endif
+    _lz4_buffer.clear();
     thread_consider_yield();
 
     if (_owns_dest) {
@@ -191,7 +287,7 @@ seekoff(streamoff off, ios_seekdir dir, ios_openmode which) {
 
   // Determine the current position.
   size_t n = egptr() - gptr();
-  streampos gpos = _z_source.total_out - n;
+  streampos gpos = _total_out - n;
 
   // Implement tellg() and seeks to current position.
   if ((dir == ios::cur && off == 0) ||
@@ -216,6 +312,18 @@ seekoff(streamoff off, ios_seekdir dir, ios_openmode which) {
     if (result < 0) {
       show_zlib_error("inflateReset", result, _z_source);
     }
+#ifdef HAVE_ZSTD
+    if (_zstd_source != nullptr) {
+      ZSTD_DCtx_reset(_zstd_source, ZSTD_reset_session_only);
+    }
+#endif
+#ifdef HAVE_LZ4
+    if (_lz4_source != nullptr) {
+      LZ4F_resetDecompressionContext(_lz4_source);
+    }
+#endif
+    _read_algorithm = _source_header ? CA_none : CA_zlib;
+    _total_out = 0;
     return 0;
   }
 
@@ -305,12 +413,106 @@ underflow() {
   return (unsigned char)*gptr();
 }
 
+/**
+ * Reads up to length bytes of compressed data from the source stream,
+ * without reading past the limit given to open_read().  Returns the number
+ * of bytes read.
+ */
+size_t ZStreamBuf::
+read_source(char *start, size_t length) {
+  if (_source_bytes_left >= 0) {
+    // Don't read more than the specified limit.
+    _source->read(start, std::min(_source_bytes_left, (std::streamsize)length));
+    size_t read_count = _source->gcount();
+    _source_bytes_left -= read_count;
+    return read_count;
+  } else {
+    _source->read(start, length);
+    return _source->gcount();
+  }
+}
+
+/**
+ * Reads the first few bytes of the source stream to determine the algorithm
+ * with which it was compressed.  The bytes are left in the decompress buffer,
+ * to be consumed by the decompressor.
+ */
+void ZStreamBuf::
+detect_read_algorithm() {
+  size_t read_count = read_source(decompress_buffer, 4);
+  _z_source.next_in = (Bytef *)decompress_buffer;
+  _z_source.avail_in = read_count;
+
+  _read_algorithm = detect_compression_algorithm(decompress_buffer, read_count);
+  if (_read_algorithm != CA_zlib && _read_algorithm != CA_none &&
+      !is_compression_algorithm_supported(_read_algorithm)) {
+    express_cat.error()
+      << "Stream is compressed with " << _read_algorithm
+      << ", which is not compiled in.\n";
+  }
+
+#ifdef HAVE_ZSTD
+  if (_read_algorithm == CA_zstd) {
+    if (_zstd_source == nullptr) {
+      _zstd_source = ZSTD_createDCtx();
+    }
+    return;
+  }
+#endif
+
+#ifdef HAVE_LZ4
+  if (_read_algorithm == CA_lz4) {
+    if (_lz4_source == nullptr) {
+      size_t result = LZ4F_createDecompressionContext(&_lz4_source, LZ4F_VERSION);
+      if (LZ4F_isError(result)) {
+        express_cat.warning()
+          << "LZ4 error in LZ4F_createDecompressionContext: "
+          << LZ4F_getErrorName(result) << "\n";
+        _lz4_source = nullptr;
+      }
+    }
+    return;
+  }
+#endif
+
+  // Anything else goes to zlib, which will report an error if it isn't
+  // really a zlib stream.
+  _read_algorithm = CA_zlib;
+}
 
 /**
  * Gets some characters from the source stream.
  */
 size_t ZStreamBuf::
 read_chars(char *start, size_t length) {
+  if (_read_algorithm == CA_none) {
+    detect_read_algorithm();
+  }
+
+  size_t count;
+  switch (_read_algorithm) {
+  case CA_lz4:
+    count = read_chars_lz4(start, length);
+    break;
+
+  case CA_zstd:
+    count = read_chars_zstd(start, length);
+    break;
+
+  default:
+    count = read_chars_zlib(start, length);
+    break;
+  }
+
+  _total_out += count;
+  return count;
+}
+
+/**
+ * Gets some characters from a zlib-compressed source stream.
+ */
+size_t ZStreamBuf::
+read_chars_zlib(char *start, size_t length) {
   _z_source.next_out = (Bytef *)start;
   _z_source.avail_out = length;
 
@@ -319,17 +521,7 @@ read_chars(char *start, size_t length) {
 
   while (_z_source.avail_out > 0) {
     if (_z_source.avail_in == 0 && !eof) {
-      size_t read_count = 0;
-      if (_source_bytes_left >= 0) {
-        // Don't read more than the specified limit.
-        _source->read(decompress_buffer,
-          std::min(_source_bytes_left, (std::streamsize)decompress_buffer_size));
-        read_count = _source->gcount();
-        _source_bytes_left -= read_count;
-      } else {
-        _source->read(decompress_buffer, decompress_buffer_size);
-        read_count = _source->gcount();
-      }
+      size_t read_count = read_source(decompress_buffer, decompress_buffer_size);
       eof = (read_count == 0 || _source->eof() || _source->fail());
 
       _z_source.next_in = (Bytef *)decompress_buffer;
@@ -358,13 +550,127 @@ read_chars(char *start, size_t length) {
   return length;
 }
 
+/**
+ * Gets some characters from an LZ4-compressed source stream.
+ */
+size_t ZStreamBuf::
+read_chars_lz4(char *start, size_t length) {
+#ifdef HAVE_LZ4
+  if (_lz4_source == nullptr) {
+    return 0;
+  }
+
+  size_t bytes_read = 0;
+  bool eof = (_source_bytes_left == 0 || _source->eof() || _source->fail());
+
+  while (bytes_read < length) {
+    if (_z_source.avail_in == 0 && !eof) {
+      size_t read_count = read_source(decompress_buffer, decompress_buffer_size);
+      eof = (read_count == 0 || _source->eof() || _source->fail());
+
+      _z_source.next_in = (Bytef *)decompress_buffer;
+      _z_source.avail_in = read_count;
+    }
+
+    size_t dest_size = length - bytes_read;
+    size_t source_size = _z_source.avail_in;
+    size_t result = LZ4F_decompress(_lz4_source, start + bytes_read, &dest_size,
+                                    _z_source.next_in, &source_size, nullptr);
+    thread_consider_yield();
+    _z_source.next_in += source_size;
+    _z_source.avail_in -= source_size;
+    bytes_read += dest_size;
+
+    if (LZ4F_isError(result)) {
+      express_cat.warning()
+        << "LZ4 error in LZ4F_decompress: " << LZ4F_getErrorName(result) << "\n";
+      break;
+    }
+    if (eof && source_size == 0 && dest_size == 0) {
+      // No more progress is possible.
+      break;
+    }
+  }
+
+  return bytes_read;
+#else
+  return 0;
+#endif  // HAVE_LZ4
+}
+
+/**
+ * Gets some characters from a Zstandard-compressed source stream.
+ */
+size_t ZStreamBuf::
+read_chars_zstd(char *start, size_t length) {
+#ifdef HAVE_ZSTD
+  if (_zstd_source == nullptr) {
+    return 0;
+  }
+
+  ZSTD_outBuffer output = { start, length, 0 };
+  bool eof = (_source_bytes_left == 0 || _source->eof() || _source->fail());
+
+  while (output.pos < output.size) {
+    if (_z_source.avail_in == 0 && !eof) {
+      size_t read_count = read_source(decompress_buffer, decompress_buffer_size);
+      eof = (read_count == 0 || _source->eof() || _source->fail());
+
+      _z_source.next_in = (Bytef *)decompress_buffer;
+      _z_source.avail_in = read_count;
+    }
+
+    ZSTD_inBuffer input = { _z_source.next_in, _z_source.avail_in, 0 };
+    size_t prev_pos = output.pos;
+    size_t result = ZSTD_decompressStream(_zstd_source, &output, &input);
+    thread_consider_yield();
+    _z_source.next_in += input.pos;
+    _z_source.avail_in -= input.pos;
+
+    if (ZSTD_isError(result)) {
+      express_cat.warning()
+        << "zstd error in ZSTD_decompressStream: " << ZSTD_getErrorName(result) << "\n";
+      break;
+    }
+    if (eof && input.pos == 0 && output.pos == prev_pos) {
+      // No more progress is possible.
+      break;
+    }
+  }
+
+  return output.pos;
+#else
+  return 0;
+#endif  // HAVE_ZSTD
+}
+
+/**
+ * Sends some characters to the dest stream.  The flush parameter is one of
+ * the zlib flush modes: 0, Z_SYNC_FLUSH or Z_FINISH.
+ */
+void ZStreamBuf::
+write_chars(const char *start, size_t length, int flush) {
+  switch (_write_algorithm) {
+  case CA_lz4:
+    write_chars_lz4(start, length, flush);
+    break;
+
+  case CA_zstd:
+    write_chars_zstd(start, length, flush);
+    break;
+
+  default:
+    write_chars_zlib(start, length, flush);
+    break;
+  }
+}
+
 /**
  * Sends some characters to the dest stream.  The flush parameter is passed to
  * deflate().
  */
 void ZStreamBuf::
-write_chars(const char *start, size_t length, int flush) {
-  static const size_t compress_buffer_size = 4096;
+write_chars_zlib(const char *start, size_t length, int flush) {
   char compress_buffer[compress_buffer_size];
 
   _z_dest.next_in = (Bytef *)(char *)start;
@@ -404,6 +710,83 @@ write_chars(const char *start, size_t length, int flush) {
   }
 }
 
+/**
+ * Sends some characters to the dest stream, compressed with LZ4.
+ */
+void ZStreamBuf::
+write_chars_lz4(const char *start, size_t length, int flush) {
+#ifdef HAVE_LZ4
+  if (_lz4_dest == nullptr) {
+    return;
+  }
+
+  // The buffer is only large enough for compress_buffer_size bytes at a time.
+  while (length > 0) {
+    size_t count = std::min(length, compress_buffer_size);
+    size_t result = LZ4F_compressUpdate(_lz4_dest, &_lz4_buffer[0], _lz4_buffer.size(),
+                                        start, count, nullptr);
+    thread_consider_yield();
+    if (LZ4F_isError(result)) {
+      express_cat.warning()
+        << "LZ4 error in LZ4F_compressUpdate: " << LZ4F_getErrorName(result) << "\n";
+      return;
+    }
+    _dest->write((const char *)&_lz4_buffer[0], result);
+    start += count;
+    length -= count;
+  }
+
+  if (flush != 0) {
+    size_t result;
+    if (flush == Z_FINISH) {
+      result = LZ4F_compressEnd(_lz4_dest, &_lz4_buffer[0], _lz4_buffer.size(), nullptr);
+    } else {
+      result = LZ4F_flush(_lz4_dest, &_lz4_buffer[0], _lz4_buffer.size(), nullptr);
+    }
+    if (LZ4F_isError(result)) {
+      express_cat.warning()
+        << "LZ4 error in LZ4F_flush: " << LZ4F_getErrorName(result) << "\n";
+      return;
+    }
+    _dest->write((const char *)&_lz4_buffer[0], result);
+  }
+#endif  // HAVE_LZ4
+}
+
+/**
+ * Sends some characters to the dest stream, compressed with Zstandard.
+ */
+void ZStreamBuf::
+write_chars_zstd(const char *start, size_t length, int flush) {
+#ifdef HAVE_ZSTD
+  if (_zstd_dest == nullptr) {
+    return;
+  }
+
+  ZSTD_EndDirective mode = ZSTD_e_continue;
+  if (flush == Z_FINISH) {
+    mode = ZSTD_e_end;
+  } else if (flush != 0) {
+    mode = ZSTD_e_flush;
+  }
+
+  char compress_buffer[compress_buffer_size];
+  ZSTD_inBuffer input = { start, length, 0 };
+  size_t remaining;
+  do {
+    ZSTD_outBuffer output = { compress_buffer, compress_buffer_size, 0 };
+    remaining = ZSTD_compressStream2(_zstd_dest, &output, &input, mode);
+    thread_consider_yield();
+    if (ZSTD_isError(remaining)) {
+      express_cat.warning()
+        << "zstd error in ZSTD_compressStream2: " << ZSTD_getErrorName(remaining) << "\n";
+      return;
+    }
+    _dest->write(compress_buffer, output.pos);
+  } while (input.pos < input.size || (mode != ZSTD_e_continue && remaining != 0));
+#endif  // HAVE_ZSTD
+}
+
 /**
  * Reports a recent error code returned by zlib.
  */
@@ -19,10 +19,22 @@
 // This module is not compiled if zlib is not available.
 #ifdef HAVE_ZLIB
 
+#include "compressionAlgorithm.h"
+#include "vector_uchar.h"
+
 #include <zlib.h>
 
+struct ZSTD_CCtx_s;
+struct ZSTD_DCtx_s;
+struct LZ4F_cctx_s;
+struct LZ4F_dctx_s;
+
 /**
  * The streambuf object that implements IDecompressStream and OCompressStream.
+ *
+ * Despite the name, this may also write LZ4 or Zstandard streams, if Panda
+ * was compiled with those libraries.  When reading, the algorithm is
+ * recognized from the first bytes of the stream.
  */
 class EXPCL_PANDA_EXPRESS ZStreamBuf : public std::streambuf {
 public:
@@ -32,7 +44,8 @@ public:
   void open_read(std::istream *source, bool owns_source, std::streamsize source_length=-1, bool header=true);
   void close_read();
 
-  void open_write(std::ostream *dest, bool owns_dest, int compression_level, bool header=true);
+  void open_write(std::ostream *dest, bool owns_dest, int compression_level, bool header=true,
+                  CompressionAlgorithm algorithm=CA_zlib);
   void close_write();
 
   virtual std::streampos seekoff(std::streamoff off, ios_seekdir dir, ios_openmode which);
@@ -44,21 +57,41 @@ protected:
   virtual int underflow();
 
 private:
+  size_t read_source(char *start, size_t length);
+  void detect_read_algorithm();
   size_t read_chars(char *start, size_t length);
+  size_t read_chars_zlib(char *start, size_t length);
+  size_t read_chars_lz4(char *start, size_t length);
+  size_t read_chars_zstd(char *start, size_t length);
   void write_chars(const char *start, size_t length, int flush);
+  void write_chars_zlib(const char *start, size_t length, int flush);
+  void write_chars_lz4(const char *start, size_t length, int flush);
+  void write_chars_zstd(const char *start, size_t length, int flush);
   void show_zlib_error(const char *function, int error_code, z_stream &z);
 
 private:
   std::istream *_source;
   std::streamsize _source_bytes_left = -1;
   bool _owns_source;
+  bool _source_header = true;
+  CompressionAlgorithm _read_algorithm = CA_none;
+  size_t _total_out = 0;
 
   std::ostream *_dest;
   bool _owns_dest;
+  CompressionAlgorithm _write_algorithm = CA_zlib;
 
+  // The next_in and avail_in members of _z_source track the unconsumed input
+  // for all of the algorithms, not just for zlib.
   z_stream _z_source;
   z_stream _z_dest;
 
+  ZSTD_DCtx_s *_zstd_source = nullptr;
+  ZSTD_CCtx_s *_zstd_dest = nullptr;
+  LZ4F_dctx_s *_lz4_source = nullptr;
+  LZ4F_cctx_s *_lz4_dest = nullptr;
+  vector_uchar _lz4_buffer;
+
   char *_buffer;
 
   // We need to store the decompression buffer on the class object, because
@@ -24,8 +24,20 @@
 
 #include <algorithm>
 #include <iterator>
+#include <string.h>
 #include <time.h>
 
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN 1
+#endif
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 #include "openSSLWrapper.h"
 
 using std::streamoff;
@@ -37,6 +49,243 @@ using std::string;
 // 1980-01-01 00:00:00
 static const time_t dos_epoch = 315532800;
 
+// The same moment, as a DOS/FAT date (high word) and time (low word).
+static const uint32_t dos_epoch_packed = 33u << 16;
+
+/**
+ * Decodes a little-endian 16-bit integer from the indicated memory.
+ */
+static inline uint16_t
+get_uint16_le(const unsigned char *p) {
+  return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+/**
+ * Decodes a little-endian 32-bit integer from the indicated memory.
+ */
+static inline uint32_t
+get_uint32_le(const unsigned char *p) {
+  return (uint32_t)p[0] | ((uint32_t)p[1] << 8) |
+         ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/**
+ * Decodes a little-endian 64-bit integer from the indicated memory.
+ */
+static inline uint64_t
+get_uint64_le(const unsigned char *p) {
+  return (uint64_t)get_uint32_le(p) | ((uint64_t)get_uint32_le(p + 4) << 32);
+}
+
+/**
+ * Returns true if the indicated string consists only of 7-bit characters, in
+ * which case it is the same in CP437 as in UTF-8.
+ */
+static inline bool
+is_ascii(const unsigned char *p, size_t length) {
+  for (size_t i = 0; i < length; ++i) {
+    if (p[i] & 0x80) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * A read-only memory mapping of (part of) a file on disk, shared between the
+ * ZipArchive and any subfile streams that read from it, so that the mapping
+ * stays valid as long as any of them are still open.
+ */
+class ZipArchive::MappedFile : public ReferenceCount {
+public:
+  MappedFile() = default;
+  ~MappedFile();
+
+  bool open(const Filename &filename, std::streampos start, size_t length);
+
+  const unsigned char *_data = nullptr;
+  size_t _size = 0;
+
+private:
+  void *_base = nullptr;
+  size_t _base_size = 0;
+};
+
+/**
+ * An istream that reads directly out of a MappedFile, without copying the
+ * data into an intermediate buffer and without locking the archive stream.
+ */
+class ZipArchive::MappedStream : public std::istream {
+public:
+  MappedStream(MappedFile *mapping, const unsigned char *data, size_t length);
+
+private:
+  class Buf : public std::streambuf {
+  public:
+    Buf(const unsigned char *data, size_t length);
+
+  protected:
+    virtual std::streampos seekoff(std::streamoff off, ios_seekdir dir,
+                                   ios_openmode which);
+    virtual std::streampos seekpos(std::streampos pos, ios_openmode which);
+    virtual std::streamsize showmanyc();
+  };
+
+  Buf _buf;
+  PT(MappedFile) _mapping;
+};
+
+/**
+ *
+ */
+ZipArchive::MappedFile::
+~MappedFile() {
+  if (_base != nullptr) {
+#ifdef _WIN32
+    UnmapViewOfFile(_base);
+#else
+    munmap(_base, _base_size);
+#endif
+  }
+}
+
+/**
+ * Maps the indicated byte range of the named file into memory.  Returns true
+ * on success, false if the file could not be mapped.
+ */
+bool ZipArchive::MappedFile::
+open(const Filename &filename, std::streampos start, size_t length) {
+  nassertr(_base == nullptr, false);
+  if (length == 0 || start < 0) {
+    return false;
+  }
+
+  // The offset of a mapping must be aligned to the allocation granularity.
+  uint64_t offset = (uint64_t)(std::streamoff)start;
+#ifdef _WIN32
+  SYSTEM_INFO sysinfo;
+  GetSystemInfo(&sysinfo);
+  uint64_t granularity = sysinfo.dwAllocationGranularity;
+#else
+  uint64_t granularity = (uint64_t)sysconf(_SC_PAGESIZE);
+#endif
+  uint64_t aligned_offset = offset - (offset % granularity);
+  size_t skip = (size_t)(offset - aligned_offset);
+
+#ifdef _WIN32
+  std::wstring os_specific = filename.to_os_specific_w();
+  HANDLE handle = CreateFileW(os_specific.c_str(), GENERIC_READ,
+                              FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (handle == INVALID_HANDLE_VALUE) {
+    return false;
+  }
+  HANDLE mapping = CreateFileMappingW(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  CloseHandle(handle);
+  if (mapping == nullptr) {
+    return false;
+  }
+  void *base = MapViewOfFile(mapping, FILE_MAP_READ,
+                             (DWORD)(aligned_offset >> 32),
+                             (DWORD)(aligned_offset & 0xffffffffu),
+                             skip + length);
+  CloseHandle(mapping);
+  if (base == nullptr) {
+    return false;
+  }
+#else
+  std::string os_specific = filename.to_os_specific();
+  int fd = ::open(os_specific.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return false;
+  }
+  void *base = mmap(nullptr, skip + length, PROT_READ, MAP_SHARED, fd,
+                    (off_t)aligned_offset);
+  ::close(fd);
+  if (base == MAP_FAILED) {
+    return false;
+  }
+#endif
+
+  _base = base;
+  _base_size = skip + length;
+  _data = (const unsigned char *)base + skip;
+  _size = length;
+  return true;
+}
+
+/**
+ *
+ */
+ZipArchive::MappedStream::
+MappedStream(MappedFile *mapping, const unsigned char *data, size_t length) :
+  std::istream(&_buf),
+  _buf(data, length),
+  _mapping(mapping)
+{
+}
+
+/**
+ *
+ */
+ZipArchive::MappedStream::Buf::
+Buf(const unsigned char *data, size_t length) {
+  char *begin = (char *)data;
+  setg(begin, begin, begin + length);
+}
+
+/**
+ * Implements seeking within the mapped memory.
+ */
+std::streampos ZipArchive::MappedStream::Buf::
+seekoff(std::streamoff off, ios_seekdir dir, ios_openmode which) {
+  if ((which & std::ios::in) == 0) {
+    return -1;
+  }
+
+  std::streamoff pos;
+  switch (dir) {
+  case std::ios::beg:
+    pos = off;
+    break;
+
+  case std::ios::cur:
+    pos = (gptr() - eback()) + off;
+    break;
+
+  case std::ios::end:
+    pos = (egptr() - eback()) + off;
+    break;
+
+  default:
+    return -1;
+  }
+
+  if (pos < 0 || pos > (egptr() - eback())) {
+    return -1;
+  }
+
+  setg(eback(), eback() + pos, egptr());
+  return pos;
+}
+
+/**
+ * Implements seeking within the mapped memory.
+ */
+std::streampos ZipArchive::MappedStream::Buf::
+seekpos(std::streampos pos, ios_openmode which) {
+  return seekoff(pos, std::ios::beg, which);
+}
+
+/**
+ * Returns the number of bytes left to read.
+ */
+std::streamsize ZipArchive::MappedStream::Buf::
+showmanyc() {
+  std::streamsize avail = egptr() - gptr();
+  return (avail > 0) ? avail : -1;
+}
+
 #ifdef HAVE_OPENSSL
 /**
  * Encodes the given string using base64 encoding.
@@ -106,6 +355,22 @@ open_read(const Filename &filename) {
     return false;
   }
 
+  // If the archive resides in a file on disk (directly, or stored without
+  // compression inside a multifile), map it into memory as well.  The stream
+  // is still kept open for the operations that don't use the mapping.
+  SubfileInfo info;
+  if (zip_mmap && vfile->get_system_info(info) &&
+      !info.get_filename().empty()) {
+    PT(MappedFile) mapping = new MappedFile;
+    if (mapping->open(info.get_filename(), info.get_start(),
+                      (size_t)info.get_size())) {
+      _mapping = std::move(mapping);
+    } else if (express_cat.is_debug()) {
+      express_cat.debug()
+        << "Unable to map ZIP archive " << filename << " into memory.\n";
+    }
+  }
+
   _read = new IStreamWrapper(stream, true);
   _owns_stream = true;
   _filename = filename;
@@ -296,6 +561,7 @@ close() {
   _write_file.close();
   _read_write_file.close();
   _filename = Filename();
+  _mapping.clear();
 
   clear_subfiles();
 }
@@ -968,7 +1234,7 @@ get_subfile_length(int index) const {
 time_t ZipArchive::
 get_subfile_timestamp(int index) const {
   nassertr(index >= 0 && index < (int)_subfiles.size(), 0);
-  return _subfiles[index]->_timestamp;
+  return _subfiles[index]->get_timestamp();
 }
 
 /**
@@ -1001,6 +1267,11 @@ is_subfile_encrypted(int index) const {
 streampos ZipArchive::
 get_subfile_internal_start(int index) const {
   nassertr(index >= 0 && index < (int)_subfiles.size(), 0);
+  const unsigned char *data = get_mapped_data(_subfiles[index]);
+  if (data != nullptr) {
+    return (std::streampos)(data - _mapping->_data);
+  }
+
   _read->acquire();
   _subfiles[index]->read_header(*_read->get_istream());
   std::streampos data_start = _read->get_istream()->tellg();
@@ -1277,6 +1548,18 @@ read_subfile(int index, vector_uchar &result) {
     success = VirtualFile::simple_read_file(in, result);
     close_read_subfile(in);
 
+  } else if (subfile->_data_length != subfile->_uncompressed_length) {
+    // A stored subfile must be just as long as it is in the archive.
+    express_cat.error()
+      << "Stored subfile " << _filename << "/" << subfile->_name
+      << " has inconsistent lengths in central directory\n";
+    return false;
+
+  } else if (const unsigned char *data = get_mapped_data(subfile)) {
+    // If the archive is mapped into memory, the data can be copied straight
+    // out of the mapping.
+    result.assign(data, data + subfile->_data_length);
+
   } else {
     // But if the subfile is just a plain file, we can just read the data
     // directly from the ZipArchive, without paying the cost of an ISubStream.
@@ -1353,24 +1636,33 @@ add_new_subfile(Subfile *subfile, int compression_level) {
  */
 std::istream *ZipArchive::
 open_read_subfile(Subfile *subfile) {
-  // Read the header first.
-  _read->acquire();
-  if (!subfile->read_header(*_read->get_istream())) {
+  std::istream *stream;
+
+  const unsigned char *data = get_mapped_data(subfile);
+  if (data != nullptr) {
+    // The archive is mapped into memory, so we can read the data from there
+    // without going through the shared archive stream.
+    stream = new MappedStream(_mapping, data, subfile->_data_length);
+
+  } else {
+    // Read the header first.
+    _read->acquire();
+    if (!subfile->read_header(*_read->get_istream())) {
+      _read->release();
+      express_cat.error()
+        << "Failed to read local header of "
+        << _filename << "/" << subfile->_name << "\n";
+      return nullptr;
+    }
+    std::streampos data_start = _read->get_istream()->tellg();
     _read->release();
-    express_cat.error()
-      << "Failed to read local header of "
-      << _filename << "/" << subfile->_name << "\n";
-    return nullptr;
-  }
-  std::streampos data_start = _read->get_istream()->tellg();
-  _read->release();
 
-  // Return an ISubStream object that references into the open ZipArchive
-  // istream.
-  nassertr(data_start != (streampos)0, nullptr);
-  std::istream *stream =
-    new ISubStream(_read, data_start,
-                   data_start + (streampos)subfile->_data_length);
+    // Return an ISubStream object that references into the open ZipArchive
+    // istream.
+    nassertr(data_start != (streampos)0, nullptr);
+    stream = new ISubStream(_read, data_start,
+                            data_start + (streampos)subfile->_data_length);
+  }
 
   if (subfile->is_compressed()) {
 #ifndef HAVE_ZLIB
@@ -1394,6 +1686,68 @@ open_read_subfile(Subfile *subfile) {
   return stream;
 }
 
+/**
+ * If the archive is mapped into memory, returns a pointer to the start of the
+ * data of the indicated subfile within the mapping, after checking its local
+ * file header.  Returns NULL if the archive is not mapped, or the header is
+ * not valid, in which case the subfile must be read through the stream.
+ */
+const unsigned char *ZipArchive::
+get_mapped_data(const Subfile *subfile) const {
+  if (_mapping == nullptr) {
+    return nullptr;
+  }
+
+  const unsigned char *begin = _mapping->_data;
+  size_t size = _mapping->_size;
+  uint64_t header_start = (uint64_t)(std::streamoff)subfile->_header_start;
+  if (header_start > size || size - header_start < 30) {
+    return nullptr;
+  }
+
+  const unsigned char *header = begin + header_start;
+  if (get_uint32_le(header) != 0x04034b50 ||
+      get_uint16_le(header + 8) != (uint16_t)subfile->_compression_method) {
+    return nullptr;
+  }
+
+  uint64_t data_start = header_start + 30
+    + get_uint16_le(header + 26) + get_uint16_le(header + 28);
+  if (data_start > size || size - data_start < subfile->_data_length) {
+    return nullptr;
+  }
+  return begin + data_start;
+}
+
+/**
+ * Returns a pointer to the indicated range of bytes of the archive.  If the
+ * archive is mapped into memory, this points into the mapping; otherwise, the
+ * bytes are read from the given stream into the buffer.  Returns NULL if the
+ * range could not be read.
+ *
+ * Assumes the stream lock is held.
+ */
+const unsigned char *ZipArchive::
+read_bytes(std::istream &read, std::streampos start, size_t length,
+           vector_uchar &buffer) const {
+  if (start < 0 || start + (std::streamoff)length > _file_end) {
+    return nullptr;
+  }
+
+  if (_mapping != nullptr && (uint64_t)(std::streamoff)start + length <= _mapping->_size) {
+    return _mapping->_data + (std::streamoff)start;
+  }
+
+  buffer.resize(length);
+  read.clear();
+  read.seekg(start);
+  read.read((char *)buffer.data(), length);
+  if (read.fail() || (size_t)read.gcount() != length) {
+    return nullptr;
+  }
+  return buffer.data();
+}
+
 /**
  * Returns the standard form of the subfile name.
  */
@@ -1436,7 +1790,8 @@ clear_subfiles() {
  * Reads the ZipArchive header and index.  Returns true if successful, false if
  * the ZipArchive is not valid.
  *
- * Assumes that the get pointer is at the end of the file.
+ * The central directory is read in one piece (or used in place, if the
+ * archive is mapped into memory) and parsed from memory.
  */
 bool ZipArchive::
 read_index() {
@@ -1447,7 +1802,7 @@ read_index() {
   std::istream *read = _read->get_istream();
 
   // ZIP files need to be read from the end.
-  read->seekg(-2, std::ios::end);
+  read->seekg(0, std::ios::end);
   if (read->fail()) {
     express_cat.info()
       << "Unable to seek ZIP archive " << _filename << ".\n";
@@ -1455,53 +1810,38 @@ read_index() {
     close();
     return false;
   }
+  _file_end = read->tellg();
 
-  std::streampos fpos = read->tellg();
-  _file_end = fpos + (std::streamoff)2;
+  // The end-of-directory record is at the end of the file, followed only by
+  // a comment of at most 65535 bytes.  Fetch that whole range at once, and
+  // search it backwards for the record's signature.
+  std::streamoff tail_size = std::min((std::streamoff)_file_end, (std::streamoff)(22 + 0xffff));
+  vector_uchar buffer;
+  const unsigned char *tail = nullptr;
+  if (tail_size >= 22) {
+    tail = read_bytes(*read, _file_end - tail_size, (size_t)tail_size, buffer);
+  }
 
   uint64_t cdir_entries = 0;
+  uint64_t cdir_size = 0;
   uint64_t cdir_offset = 0;
-  uint32_t comment_length = 0;
   std::streampos eocd_offset = 0;
   bool found = false;
 
-  // Seek backwards until we have found the the end-of-directory record.
-  StreamReader reader(read, false);
-  while (comment_length <= 0xffff && fpos >= 20) {
-    //nassertr(fpos == read->tellg(), false);
-
-    if (reader.get_uint16() == comment_length) {
-      // This field references the distance to the end of the .zip file, so it
-      // could be the comment length field at the end of the record.  Skip to the
-      // beginning of the record to see if the signature matches.
-      read->seekg(-22, std::ios::cur);
-
-      if (reader.get_uint32() == 0x06054b50) {
-        // Yes, got it.
-        eocd_offset = read->tellg() - (std::streamoff)4;
-        reader.skip_bytes(6);
-        cdir_entries = reader.get_uint16();
-        /*cdir_size = */reader.get_uint32();
-        cdir_offset = reader.get_uint32();
-        if (comment_length > 0) {
-          _comment = reader.get_fixed_string(comment_length);
-        } else {
-          _comment.clear();
-        }
+  if (tail != nullptr) {
+    for (std::streamoff pos = tail_size - 22; pos >= 0; --pos) {
+      const unsigned char *record = tail + pos;
+      if (get_uint32_le(record) == 0x06054b50 &&
+          get_uint16_le(record + 20) == tail_size - pos - 22) {
+        eocd_offset = _file_end - tail_size + pos;
+        cdir_entries = get_uint16_le(record + 10);
+        cdir_size = get_uint32_le(record + 12);
+        cdir_offset = get_uint32_le(record + 16);
+        _comment.assign((const char *)record + 22, (size_t)(tail_size - pos - 22));
         found = true;
         break;
       }
-
-      // No, skip back to where we were and continue scanning for comments.
-      comment_length += 2;
-      read->seekg(22 - 4 - 4, std::ios::cur);
-      fpos -= 2;
-      continue;
     }
-
-    comment_length += 2;
-    read->seekg(-4, std::ios::cur);
-    fpos -= 2;
   }
 
   if (!found) {
@@ -1514,19 +1854,17 @@ read_index() {
 
   // Now look for a ZIP64 end-of-central-directory locator.
   if (eocd_offset >= 20) {
-    uint64_t eocd64_offset = 0;
-    read->seekg(eocd_offset - (std::streamoff)20);
-    if (reader.get_uint32() == 0x07064b50) {
-      reader.skip_bytes(4); // disk no
-      eocd64_offset = reader.get_uint64();
-      reader.skip_bytes(4); // disk count
-
-      read->seekg(eocd64_offset);
-      if (reader.get_uint32() == 0x06064b50) {
-        reader.skip_bytes(20);
-        cdir_entries = reader.get_uint64();
-        /*cdir_size = */reader.get_uint64();
-        cdir_offset = reader.get_uint64();
+    const unsigned char *locator =
+      read_bytes(*read, eocd_offset - (std::streamoff)20, 20, buffer);
+    if (locator != nullptr && get_uint32_le(locator) == 0x07064b50) {
+      uint64_t eocd64_offset = get_uint64_le(locator + 8);
+
+      const unsigned char *record =
+        read_bytes(*read, (std::streampos)eocd64_offset, 56, buffer);
+      if (record != nullptr && get_uint32_le(record) == 0x06064b50) {
+        cdir_entries = get_uint64_le(record + 32);
+        cdir_size = get_uint64_le(record + 40);
+        cdir_offset = get_uint64_le(record + 48);
       } else {
         express_cat.info()
           << "Unable to read ZIP64 end-of-directory record in ZIP archive "
@@ -1537,21 +1875,31 @@ read_index() {
 
   _index_start = cdir_offset;
 
-  // Find the central directory.
-  read->seekg((std::streampos)cdir_offset);
-  if (read->fail()) {
-    express_cat.info()
-      << "Unable to locate central directory in ZIP archive " << _filename << ".\n";
-    _read->release();
-    close();
-    return false;
+  // Find the central directory.  Each entry takes up at least 46 bytes, which
+  // also guards against a corrupt entry count.
+  const unsigned char *cdir = nullptr;
+  const unsigned char *cdir_end = nullptr;
+  if (cdir_entries > 0) {
+    if (cdir_entries <= cdir_size / 46) {
+      cdir = read_bytes(*read, (std::streampos)cdir_offset, (size_t)cdir_size, buffer);
+    }
+    if (cdir == nullptr) {
+      express_cat.info()
+        << "Unable to locate central directory in ZIP archive " << _filename << ".\n";
+      _read->release();
+      close();
+      return false;
+    }
+    cdir_end = cdir + cdir_size;
   }
 
   _record_timestamp = false;
+  _subfiles.reserve(cdir_entries);
 
   for (size_t i = 0; i < cdir_entries; ++i) {
     Subfile *subfile = new Subfile;
-    if (!subfile->read_index(*read)) {
+    if (!subfile->read_index(cdir, cdir_end)) {
+      delete subfile;
       express_cat.info()
         << "Failed to read central directory for " << _filename << ".\n";
       _read->release();
@@ -1559,9 +1907,13 @@ read_index() {
       return false;
     }
 
-    if (subfile->_timestamp != dos_epoch) {
-      // If all subfiles have the timestamp set to the DOS epoch, we apparently
-      // don't care about preserving timestamps.
+    // If all subfiles have the timestamp set to the DOS epoch, we apparently
+    // don't care about preserving timestamps.
+    if (subfile->_timestamp != 0) {
+      if (subfile->_timestamp != dos_epoch) {
+        _record_timestamp = true;
+      }
+    } else if (subfile->_dos_timestamp != dos_epoch_packed) {
       _record_timestamp = true;
     }
     _subfiles.push_back(subfile);
@@ -1689,98 +2041,123 @@ Subfile(const std::string &name, int compression_level) :
 }
 
 /**
- * Reads the index record for the Subfile from the indicated istream.  Assumes
- * the istream has already been positioned to the indicated stream position,
- * fpos, the start of the index record.  Returns true on success.
+ * Reads the index record for the Subfile from the indicated memory, which
+ * holds the central directory up to end.  On success, advances ptr past the
+ * record and returns true.
  */
 bool ZipArchive::Subfile::
-read_index(std::istream &read) {
-  StreamReader reader(read);
+read_index(const unsigned char *&ptr, const unsigned char *end) {
+  if (end - ptr < 46 || get_uint32_le(ptr) != 0x02014b50) {
+    return false;
+  }
 
-  if (reader.get_uint32() != 0x02014b50) {
+  size_t name_length = get_uint16_le(ptr + 28);
+  size_t extra_length = get_uint16_le(ptr + 30);
+  size_t comment_length = get_uint16_le(ptr + 32);
+  if ((size_t)(end - ptr) < 46 + name_length + extra_length + comment_length) {
     return false;
   }
 
-  /*uint16_t version = */reader.get_uint8();
-  _system = reader.get_uint8();
-  /*uint16_t min_version = */reader.get_uint16();
-  _flags = reader.get_uint16();
-  _compression_method = (CompressionMethod)reader.get_uint16();
-  {
-    // Convert from DOS/FAT timestamp to UNIX timestamp.
-    uint16_t mtime = reader.get_uint16();
-    uint16_t mdate = reader.get_uint16();
-
-    struct tm time = {};
-    time.tm_sec  =  (mtime & 0b0000000000011111u) << 1;
-    time.tm_min  =  (mtime & 0b0000011111100000u) >> 5;
-    time.tm_hour =  (mtime & 0b1111100000000000u) >> 11;
-    time.tm_mday =  (mdate & 0b0000000000011111u);
-    time.tm_mon  = ((mdate & 0b0000000111100000u) >> 5) - 1;
-    time.tm_year = ((mdate & 0b1111111000000000u) >> 9) + 80;
-    time.tm_isdst = -1;
-    _timestamp = mktime(&time);
-  }
-  _checksum = reader.get_uint32();
-  _data_length = reader.get_uint32();
-  _uncompressed_length = reader.get_uint32();
-  size_t name_length = reader.get_uint16();
-  size_t extra_length = reader.get_uint16();
-  size_t comment_length = reader.get_uint16();
-  /*size_t disk_number =*/ reader.get_uint16();
-  _internal_attribs = reader.get_uint16();
-  _external_attribs = reader.get_uint32();
-  _header_start = (std::streampos)reader.get_uint32();
+  _system = ptr[5];
+  _flags = get_uint16_le(ptr + 8);
+  _compression_method = (CompressionMethod)get_uint16_le(ptr + 10);
 
-  std::string name = reader.get_fixed_string(name_length);
+  // The DOS/FAT date and time are kept as they are, and only converted to a
+  // UNIX timestamp on request, since mktime() is slow.
+  _dos_timestamp = get_uint32_le(ptr + 12);
+  _timestamp = 0;
+
+  _checksum = get_uint32_le(ptr + 16);
+  _data_length = get_uint32_le(ptr + 20);
+  _uncompressed_length = get_uint32_le(ptr + 24);
+  _internal_attribs = get_uint16_le(ptr + 36);
+  _external_attribs = get_uint32_le(ptr + 38);
+  _header_start = (std::streampos)get_uint32_le(ptr + 42);
+
+  const unsigned char *name = ptr + 46;
+  const unsigned char *extra = name + name_length;
+  const unsigned char *comment = extra + extra_length;
 
   // Read the extra fields, which may include a UNIX timestamp, which can be
-  // specified with greater precision than a DOS timestamp.
+  // specified with greater precision than a DOS timestamp.  Leftover bytes in
+  // the extra field not large enough to contain a proper extra tag are
+  // ignored.  This may be the case for Android .apk files processed with
+  // zipalign, which uses this for alignment.
   while (extra_length >= 4) {
-    uint16_t const tag = reader.get_uint16();
-    uint16_t const size = reader.get_uint16();
+    uint16_t const tag = get_uint16_le(extra);
+    uint16_t const size = get_uint16_le(extra + 2);
+    extra += 4;
+    extra_length -= 4;
+    if (size > extra_length) {
+      break;
+    }
     if (tag == 0x0001) {
       // ZIP64 extended info.
+      const unsigned char *field = extra;
       int size_left = size;
       if (_uncompressed_length == 0xffffffffu && size_left >= 8) {
-        _uncompressed_length = reader.get_uint64();
+        _uncompressed_length = get_uint64_le(field);
+        field += 8;
         size_left -= 8;
       }
       if (_data_length == 0xffffffffu && size_left >= 8) {
-        _data_length = reader.get_uint64();
+        _data_length = get_uint64_le(field);
+        field += 8;
         size_left -= 8;
       }
       if ((uint64_t)_header_start == 0xffffffffu && size_left >= 8) {
-        _header_start = reader.get_uint64();
-        size_left -= 8;
+        _header_start = get_uint64_le(field);
       }
-      reader.skip_bytes(size_left);
     } else if (tag == 0x5455 && size == 5) {
-      reader.skip_bytes(1);
-      _timestamp = reader.get_uint32();
-    } else {
-      reader.skip_bytes(size);
+      _timestamp = get_uint32_le(extra + 1);
     }
-    extra_length -= 4 + size;
+    extra += size;
+    extra_length -= size;
   }
-  // Skip leftover bytes in the extra field not large enough to contain a proper
-  // extra tag.  This may be the case for Android .apk files processed with
-  // zipalign, which uses this for alignment.
-  reader.skip_bytes(extra_length);
-
-  std::string comment = reader.get_fixed_string(comment_length);
 
-  if (_flags & SF_utf8_encoding) {
-    _name = std::move(name);
-    _comment = std::move(comment);
+  // Names are nearly always plain ASCII, which is the same in either
+  // encoding, so we only need to reencode the rest.
+  if ((_flags & SF_utf8_encoding) != 0 || is_ascii(name, name_length)) {
+    _name.assign((const char *)name, name_length);
   } else {
-    _name = TextEncoder::reencode_text(name, TextEncoder::E_cp437, TextEncoder::E_utf8);
-    _comment = TextEncoder::reencode_text(comment, TextEncoder::E_cp437, TextEncoder::E_utf8);
+    _name = TextEncoder::reencode_text(std::string((const char *)name, name_length),
+                                       TextEncoder::E_cp437, TextEncoder::E_utf8);
+  }
+  if ((_flags & SF_utf8_encoding) != 0 || is_ascii(comment, comment_length)) {
+    _comment.assign((const char *)comment, comment_length);
+  } else {
+    _comment = TextEncoder::reencode_text(std::string((const char *)comment, comment_length),
+                                          TextEncoder::E_cp437, TextEncoder::E_utf8);
   }
 
+  ptr = comment + comment_length;
   return true;
 }
 
+/**
+ * Returns the modification time of the Subfile as a UNIX timestamp.
+ */
+time_t ZipArchive::Subfile::
+get_timestamp() const {
+  if (_timestamp != 0 || _dos_timestamp == 0) {
+    return _timestamp;
+  }
+
+  // Convert from DOS/FAT timestamp to UNIX timestamp.
+  uint16_t mtime = _dos_timestamp & 0xffffu;
+  uint16_t mdate = _dos_timestamp >> 16;
+
+  struct tm time = {};
+  time.tm_sec  =  (mtime & 0b0000000000011111u) << 1;
+  time.tm_min  =  (mtime & 0b0000011111100000u) >> 5;
+  time.tm_hour =  (mtime & 0b1111100000000000u) >> 11;
+  time.tm_mday =  (mdate & 0b0000000000011111u);
+  time.tm_mon  = ((mdate & 0b0000000111100000u) >> 5) - 1;
+  time.tm_year = ((mdate & 0b1111111000000000u) >> 9) + 80;
+  time.tm_isdst = -1;
+  return mktime(&time);
+}
+
 /**
  * Reads the header record for the Subfile from the indicated istream.
  */
@@ -2015,14 +2392,15 @@ write_index(std::ostream &write, streampos &fpos) {
   writer.add_uint16(_flags);
   writer.add_uint16((uint16_t)_compression_method);
 
-  if (_timestamp > dos_epoch) {
+  time_t timestamp = get_timestamp();
+  if (timestamp > dos_epoch) {
     // Convert from UNIX timestamp to DOS/FAT timestamp.
 #ifdef _MSC_VER
     struct tm time_data;
     struct tm *time = &time_data;
-    localtime_s(time, &_timestamp);
+    localtime_s(time, &timestamp);
 #else
-    struct tm *time = localtime(&_timestamp);
+    struct tm *time = localtime(&timestamp);
 #endif
     writer.add_uint16((time->tm_sec >> 1)
                     | (time->tm_min << 5)
@@ -2123,14 +2501,15 @@ write_header(std::ostream &write, std::streampos &fpos) {
   writer.add_uint16(_flags);
   writer.add_uint16((uint16_t)_compression_method);
 
-  if (_timestamp > 315532800) {
+  time_t timestamp = get_timestamp();
+  if (timestamp > 315532800) {
     // Convert from UNIX timestamp to DOS/FAT timestamp.
 #ifdef _MSC_VER
     struct tm time_data;
     struct tm *time = &time_data;
-    localtime_s(time, &_timestamp);
+    localtime_s(time, &timestamp);
 #else
-    struct tm *time = localtime(&_timestamp);
+    struct tm *time = localtime(&timestamp);
 #endif
     writer.add_uint16((time->tm_sec >> 1)
                     | (time->tm_min << 5)
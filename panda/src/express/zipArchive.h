@@ -23,6 +23,7 @@
 #include "ordered_vector.h"
 #include "indirectLess.h"
 #include "referenceCount.h"
+#include "pointerTo.h"
 #include "pvector.h"
 #include "vector_uchar.h"
 
@@ -156,7 +157,7 @@ private:
 
     INLINE bool operator < (const Subfile &other) const;
 
-    bool read_index(std::istream &read);
+    bool read_index(const unsigned char *&ptr, const unsigned char *end);
     bool read_header(std::istream &read);
     bool verify_data(std::istream &read);
     bool write_index(std::ostream &write, std::streampos &fpos);
@@ -166,6 +167,7 @@ private:
     INLINE bool is_compressed() const;
     INLINE bool is_encrypted() const;
     INLINE std::streampos get_last_byte_pos() const;
+    time_t get_timestamp() const;
 
     std::string _name;
     uint8_t _system = 0;
@@ -174,6 +176,7 @@ private:
     uint64_t _data_length = 0;
     uint64_t _uncompressed_length = 0;
     time_t _timestamp = 0;
+    uint32_t _dos_timestamp = 0;
     std::streampos _header_start = 0;
     uint16_t _internal_attribs = 0;
     uint32_t _external_attribs = 0;
@@ -182,8 +185,14 @@ private:
     CompressionMethod _compression_method = CM_store;
   };
 
+  class MappedFile;
+  class MappedStream;
+
   void add_new_subfile(Subfile *subfile, int compression_level);
   std::istream *open_read_subfile(Subfile *subfile);
+  const unsigned char *get_mapped_data(const Subfile *subfile) const;
+  const unsigned char *read_bytes(std::istream &read, std::streampos start,
+                                  size_t length, vector_uchar &buffer) const;
   std::string standardize_subfile_name(const std::string &subfile_name) const;
 
   void clear_subfiles();
@@ -215,6 +224,10 @@ private:
   std::string _header_prefix;
   std::string _comment;
 
+  // If the archive was opened for reading from a file on disk, this maps the
+  // file into memory.
+  PT(MappedFile) _mapping;
+
   friend class Subfile;
 };
 
@@ -4273,6 +4273,7 @@ begin_frame(Thread *current_thread) {
     return false;
   }
   _renderbuffer_residency.begin_frame(current_thread);
+  _texture_stream_budget.begin_frame(texture_stream_budget);
 
   report_my_gl_errors();
 
@@ -6367,6 +6368,16 @@ update_texture(TextureContext *tc, bool force) {
     gtc->reset_data(target, tex->get_num_views());
   }
 
+  // If the texture is still being streamed in, see whether we can afford to
+  // upload the next larger mipmap level this frame.
+  bool stream_step = false;
+  if (gtc->_streaming && !gtc->was_image_modified() && gtc->_has_storage) {
+    if (force || _texture_stream_budget.can_step(tex, gtc->_base_level)) {
+      gtc->mark_needs_reload();
+      stream_step = true;
+    }
+  }
+
   if (gtc->was_image_modified() || !gtc->_has_storage) {
     PStatGPUTimer timer(this, _texture_update_pcollector);
 
@@ -6378,7 +6389,7 @@ update_texture(TextureContext *tc, bool force) {
       return false;
     }
 
-    if (gtc->was_properties_modified()) {
+    if (stream_step || gtc->was_properties_modified()) {
       for (int view = 0; view < gtc->_num_views; ++view) {
         apply_texture(gtc, view);
         specify_texture(gtc, tex->get_default_sampler());
@@ -6416,6 +6427,7 @@ update_texture(TextureContext *tc, bool force) {
   }
 
   gtc->enqueue_lru(&_prepared_objects->_graphics_memory_lru);
+  tex->mark_ram_image_used();
 
   report_my_gl_errors();
   return true;
@@ -13968,6 +13980,31 @@ upload_texture(CLP(TextureContext) *gtc, bool force, bool uses_mipmaps) {
       << width << " x " << height << " x " << depth << "\n";
   }
 
+  // If we are streaming textures in, we start by uploading only as many of
+  // the smallest mipmap levels as fit in what is left of this frame's budget.
+  // update_texture() takes care of uploading the larger levels on subsequent
+  // frames.
+  bool streaming = false;
+  if (texture_stream_budget > 0 && _effective_incomplete_render && !force &&
+      uses_mipmaps && !image.is_null() &&
+      texture_type != Texture::TT_buffer_texture &&
+      tex->get_num_ram_mipmap_images() > mipmap_bias + 1) {
+    int stream_level = _texture_stream_budget.reserve(tex, mipmap_bias);
+    if (stream_level > mipmap_bias) {
+      streaming = true;
+      mipmap_bias = stream_level;
+      width = tex->get_expected_mipmap_x_size(mipmap_bias);
+      height = tex->get_expected_mipmap_y_size(mipmap_bias);
+      depth = tex->get_expected_mipmap_z_size(mipmap_bias);
+
+      if (GLCAT.is_debug()) {
+        GLCAT.debug()
+          << "Streaming in " << tex->get_name() << ", now at "
+          << width << " x " << height << " x " << depth << "\n";
+      }
+    }
+  }
+
   if (image_compression != Texture::CM_off) {
 #ifndef OPENGLES
     switch (tex->get_effective_quality_level()) {
@@ -14096,8 +14133,10 @@ upload_texture(CLP(TextureContext) *gtc, bool force, bool uses_mipmaps) {
   int num_views = tex->get_num_views();
   if (needs_reload) {
     if (gtc->_immutable) {
-      GLCAT.info()
-        << "Attempt to modify texture with immutable storage, recreating texture.\n";
+      if (!gtc->_streaming) {
+        GLCAT.info()
+          << "Attempt to modify texture with immutable storage, recreating texture.\n";
+      }
       gtc->reset_data(gtc->_target, num_views);
     }
     else if (_supports_tex_storage && gl_immutable_texture_storage &&
@@ -14126,8 +14165,9 @@ upload_texture(CLP(TextureContext) *gtc, bool force, bool uses_mipmaps) {
     nassertr(gtc->_buffers != nullptr, false);
   }
 
+  // Don't store the texture in the cache until we have all of it.
   bool extract_success = false;
-  if (tex->get_post_load_store_cache()) {
+  if (tex->get_post_load_store_cache() && !streaming) {
     extract_success = true;
   }
 
@@ -14143,6 +14183,8 @@ upload_texture(CLP(TextureContext) *gtc, bool force, bool uses_mipmaps) {
       gtc->_height = height;
       gtc->_depth = depth;
       gtc->_num_levels = num_levels;
+      gtc->_base_level = mipmap_bias;
+      gtc->_streaming = streaming;
 
       if (extract_success) {
         // The next call assumes the texture is still bound.
@@ -14178,9 +14220,13 @@ upload_texture(CLP(TextureContext) *gtc, bool force, bool uses_mipmaps) {
       }
     }
 
-    GraphicsEngine *engine = get_engine();
-    nassertr(engine != nullptr, false);
-    engine->texture_uploaded(tex);
+    if (!streaming) {
+      // We're done with the RAM image now, unless we still need it to upload
+      // the remaining mipmap levels.
+      GraphicsEngine *engine = get_engine();
+      nassertr(engine != nullptr, false);
+      engine->texture_uploaded(tex);
+    }
     gtc->mark_loaded();
 
     return true;
@@ -39,6 +39,7 @@
 #include "geomVertexArrayData.h"
 #include "lightMutex.h"
 #include "pStatGPUTimer.h"
+#include "textureStreamBudget.h"
 
 class PlaneNode;
 class Light;
@@ -1229,6 +1230,9 @@ public:
 
   BufferResidencyTracker _renderbuffer_residency;
 
+  // How many more bytes of streamed texture images we may upload this frame.
+  TextureStreamBudget _texture_stream_budget;
+
   PStatCollector _active_ppbuffer_memory_pcollector;
   PStatCollector _inactive_ppbuffer_memory_pcollector;
 
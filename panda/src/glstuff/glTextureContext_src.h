@@ -74,6 +74,12 @@ public:
   GLsizei _depth;
   int _num_levels;
   GLenum _target;
+
+  // The RAM mipmap level that was uploaded as the base level of the texture.
+  // This is normally 0, unless the texture was too large for the GL, or is
+  // still being streamed in, in which case _streaming is also true.
+  int _base_level;
+  bool _streaming;
   SamplerState _active_sampler;
 
   CLP(GraphicsStateGuardian) *_glgsg;
@@ -187,6 +187,24 @@ ConfigVariableBool hardware_animated_vertices
           "necessary on your computer's bus.  However, in some cases it "
           "may actually reduce performance."));
 
+ConfigVariableInt skinning_num_threads
+("skinning-num-threads", 0,
+ PRC_DESC("The number of threads that may be used to help out with "
+          "transforming soft-skinned vertices in software, when "
+          "hardware-animated-vertices is not in effect.  When this is "
+          "greater than 0, the vertices of a large GeomVertexData are "
+          "divided up between the animating thread and up to this many "
+          "threads of the task manager's \"parallel\" task chain (see "
+          "parallel-task-threads).  Set this to 0 to animate each "
+          "GeomVertexData on a single thread."));
+
+ConfigVariableInt skinning_parallel_min_vertices
+("skinning-parallel-min-vertices", 2048,
+ PRC_DESC("The minimum number of skinned vertices that a GeomVertexData must "
+          "have before the work of animating it is divided up between "
+          "threads, when skinning-num-threads is nonzero.  Smaller "
+          "GeomVertexDatas are not worth the overhead."));
+
 ConfigVariableBool hardware_point_sprites
 ("hardware-point-sprites", true,
  PRC_DESC("Set this true to allow the use of hardware extensions when "
@@ -471,6 +489,15 @@ ConfigVariableInt vertex_data_small_size
           "is deemed too small to pay the overhead of paging it in and out, "
           "and it is permanently retained resident."));
 
+ConfigVariableInt vertex_data_share_min_size
+("vertex-data-share-min-size", 4096,
+ PRC_DESC("When a GeomVertexArrayData of at least this number of bytes is read "
+          "from a bam file, it refers directly to the memory of the datagram "
+          "it was read from, rather than making a copy of it.  The data is "
+          "only copied if it is subsequently modified.  This requires a bam "
+          "file written with bam-version 6 46 or later, in which the vertex "
+          "data is suitably aligned.  Set this to -1 to always copy."));
+
 ConfigVariableInt vertex_data_page_threads
 ("vertex-data-page-threads", 1,
  PRC_DESC("When this is nonzero (and Panda has been compiled with thread "
@@ -513,6 +513,15 @@ write_datagram(BamWriter *manager, Datagram &dg, void *extra_data) const {
 
   dg.add_uint32(_buffer.get_size());
 
+  if (manager->get_file_minor_ver() >= 46) {
+    // Pad the data so that it is aligned within the datagram, which allows
+    // the reader to use it in place.
+    size_t pos = dg.get_length() + 1;
+    size_t padding = (MEMORY_HOOK_ALIGNMENT - pos % MEMORY_HOOK_ALIGNMENT) % MEMORY_HOOK_ALIGNMENT;
+    dg.add_uint8(padding);
+    dg.pad_bytes(padding);
+  }
+
   if (manager->get_file_endian() == BamWriter::BE_native) {
     // For native endianness, we only have to write the data directly.
     dg.append_data(_buffer.get_read_pointer(true), _buffer.get_size());
@@ -545,12 +554,29 @@ fillin(DatagramIterator &scan, BamReader *manager, void *extra_data) {
   } else {
     // Now, the array data is just stored directly.
     size_t size = scan.get_uint32();
-    _buffer.unclean_realloc(size);
-    _buffer.set_size(size);
+    if (manager->get_file_minor_ver() >= 46) {
+      size_t padding = scan.get_uint8();
+      scan.skip_bytes(padding);
+    }
 
+    const Datagram &datagram = scan.get_datagram();
     const unsigned char *source_data =
-      (const unsigned char *)scan.get_datagram().get_data();
-    memcpy(_buffer.get_write_pointer(), source_data + scan.get_current_index(), size);
+      (const unsigned char *)datagram.get_data() + scan.get_current_index();
+
+    CPTA_uchar array = datagram.get_array();
+    if (vertex_data_share_min_size >= 0 &&
+        size >= (size_t)vertex_data_share_min_size &&
+        ((uintptr_t)source_data % MEMORY_HOOK_ALIGNMENT) == 0 &&
+        array.capacity() - size <= size / 4 &&
+        manager->get_file_endian() == BamReader::BE_native) {
+      // The data is suitably aligned, and the datagram holds little else, so
+      // we can just keep a reference to it instead of copying it.
+      _buffer.share(array, scan.get_current_index(), size);
+    } else {
+      _buffer.unclean_realloc(size);
+      _buffer.set_size(size);
+      memcpy(_buffer.get_write_pointer(), source_data, size);
+    }
     scan.skip_bytes(size);
   }
 
@@ -21,6 +21,13 @@
 #include "bamWriter.h"
 #include "pset.h"
 #include "indent.h"
+#include "asyncTaskManager.h"
+#include "patomic.h"
+
+#if defined(__SSE2__) || (_M_IX86_FP >= 2) || defined(_M_X64) || defined(_M_AMD64)
+#define GOBJ_SKINNING_SSE2 1
+#include <emmintrin.h>
+#endif
 
 using std::ostream;
 
@@ -1426,6 +1433,134 @@ uint8_rgba_to_packed_argb(unsigned char *to, int to_stride,
   }
 }
 
+/**
+ * The work of applying the transforms to the vertices of a GeomVertexData,
+ * which may be shared between several threads.  This is reference-counted,
+ * since a worker task may not get around to starting until after the
+ * animating thread has already finished all of the work by itself.
+ */
+class GeomVertexData::SkinningJob : public ReferenceCount {
+public:
+  // A series of consecutive vertices that share the same blend.
+  class Run {
+  public:
+    int _begin;
+    int _end;
+    int _blend;
+  };
+
+  // A column of 32-bit floats to transform.
+  class Column {
+  public:
+    unsigned char *_data;
+    size_t _stride;
+    int _num_values;
+    bool _is_point;
+    bool _is_normal;
+  };
+
+  class Blend {
+  public:
+    LMatrix4 _mat;
+    LMatrix4f _matf;
+
+    // Only filled in if there is a column of normals.
+    LMatrix4f _normal_matf;
+    bool _normalize;
+  };
+
+  void split_runs(size_t num_chunks, size_t num_rows);
+
+  pvector<Run> _runs;
+  pvector<Column> _columns;
+  pvector<Blend> _blends;
+
+  // The index into _runs just past the end of each chunk.
+  pvector<size_t> _chunk_ends;
+
+  patomic<size_t> _next_chunk {0};
+  patomic_unsigned_lock_free _num_done {0};
+};
+
+/**
+ * Divides the runs, which cover num_rows vertices in total, into the
+ * indicated number of chunks of about the same size, splitting up runs where
+ * necessary.
+ */
+void GeomVertexData::SkinningJob::
+split_runs(size_t num_chunks, size_t num_rows) {
+  _chunk_ends.clear();
+  if (num_chunks <= 1) {
+    _chunk_ends.push_back(_runs.size());
+    return;
+  }
+
+  size_t chunk_size = (num_rows + num_chunks - 1) / num_chunks;
+  pvector<Run> runs;
+  runs.reserve(_runs.size() + num_chunks);
+
+  size_t chunk_left = chunk_size;
+  for (Run run : _runs) {
+    while ((size_t)(run._end - run._begin) > chunk_left) {
+      if (chunk_left > 0) {
+        Run piece = run;
+        piece._end = run._begin + (int)chunk_left;
+        runs.push_back(piece);
+        run._begin = piece._end;
+      }
+      _chunk_ends.push_back(runs.size());
+      chunk_left = chunk_size;
+    }
+    runs.push_back(run);
+    chunk_left -= run._end - run._begin;
+  }
+  if (_chunk_ends.empty() || _chunk_ends.back() != runs.size()) {
+    _chunk_ends.push_back(runs.size());
+  }
+  _runs.swap(runs);
+}
+
+/**
+ * Computes the matrix that should be used to transform a column of vectors by
+ * the indicated matrix.  If is_normal is true, the vectors are normals, which
+ * must be kept perpendicular to the surface.  Returns true if the vectors
+ * need to be normalized afterwards.
+ */
+static bool
+compute_vector_xform(const LMatrix4 &mat, bool is_normal, LMatrix4 &xform) {
+  if (!is_normal) {
+    xform = mat;
+    return false;
+  }
+
+  // This is to preserve perpendicularity to the surface.
+  LVecBase3 scale_sq(mat.get_row3(0).length_squared(),
+                     mat.get_row3(1).length_squared(),
+                     mat.get_row3(2).length_squared());
+  if (IS_THRESHOLD_EQUAL(scale_sq[0], scale_sq[1], 2.0e-3f) &&
+      IS_THRESHOLD_EQUAL(scale_sq[0], scale_sq[2], 2.0e-3f)) {
+    // There is a uniform scale.
+    LVecBase3 scale, shear, hpr;
+    if (IS_THRESHOLD_EQUAL(scale_sq[0], 1, 2.0e-3f)) {
+      // No scale to worry about.
+      xform = mat;
+    } else if (decompose_matrix(mat.get_upper_3(), scale, shear, hpr)) {
+      // Make a new matrix with scale/translate taken out of the equation.
+      compose_matrix(xform, LVecBase3(1, 1, 1), shear, hpr, LVecBase3::zero());
+    } else {
+      xform = mat;
+      return true;
+    }
+  } else {
+    // There is a non-uniform scale, so we need to do all this to preserve
+    // orthogonality to the surface.
+    xform.invert_from(mat);
+    xform.transpose_in_place();
+    return true;
+  }
+  return false;
+}
+
 /**
  * Recomputes the results of computing the vertex animation on the CPU, and
  * applies them to the existing animated_vertices object.
@@ -1545,13 +1680,18 @@ update_animated_vertices(GeomVertexData::CData *cdata, Thread *current_thread) {
   // Then apply the transforms.
   CPT(TransformBlendTable) tb_table = cdata->_transform_blend_table.get_read_pointer(current_thread);
   if (tb_table != nullptr) {
+    PT(SkinningJob) job = new SkinningJob;
+
     // Recompute all the blends up front, so we don't have to test each one
     // for staleness at each vertex.
+    int num_blends = tb_table->get_num_blends();
     {
       PStatTimer timer4(_blends_pcollector);
-      int num_blends = tb_table->get_num_blends();
+      job->_blends.resize(num_blends);
       for (int bi = 0; bi < num_blends; bi++) {
-        tb_table->get_blend(bi).update_blend(current_thread);
+        const TransformBlend &blend = tb_table->get_blend(bi);
+        blend.update_blend(current_thread);
+        blend.get_blend(job->_blends[bi]._mat, current_thread);
       }
     }
 
@@ -1571,6 +1711,9 @@ update_animated_vertices(GeomVertexData::CData *cdata, Thread *current_thread) {
 
     CPT(GeomVertexArrayFormat) blend_array_format = orig_format->get_array(blend_array_index);
 
+    // First, find the series of consecutive vertices that share the same
+    // blend index, so that we can transform each of them as a block.
+    size_t num_skinned_rows = 0;
     if (blend_array_format->get_stride() == 2 &&
         blend_array_format->get_column(0)->get_component_bytes() == 2) {
       // The blend indices are a table of ushorts.  Optimize this common case.
@@ -1578,180 +1721,217 @@ update_animated_vertices(GeomVertexData::CData *cdata, Thread *current_thread) {
         new GeomVertexArrayDataHandle(cdata->_arrays[blend_array_index].get_read_pointer(current_thread), current_thread);
       const unsigned short *blendt = (const unsigned short *)blend_array_handle->get_read_pointer(true);
 
-      size_t ci;
-      for (ci = 0; ci < new_format->get_num_points(); ci++) {
-        GeomVertexRewriter data(new_data, new_format->get_point(ci));
-
-        for (int i = 0; i < num_subranges; ++i) {
-          int begin = rows.get_subrange_begin(i);
-          int end = rows.get_subrange_end(i);
-          nassertv(begin < end);
-
-          int first_vertex = begin;
-          int first_bi = blendt[first_vertex];
-
-          while (first_vertex < end) {
-            // At this point, first_vertex is the first of a series of
-            // vertices that shares the blend index first_bi.
-
-            // Scan for the end of this series of vertices--we're looking for
-            // the next vertex with a different blend index.
-            int next_vertex = first_vertex;
-            int next_bi = first_bi;
-            ++next_vertex;
-            while (next_vertex < end) {
-              next_bi = blendt[next_vertex];
-              if (next_bi != first_bi) {
-                break;
-              }
-              ++next_vertex;
-            }
-
-            // We've just reached the end of the vertices with a matching
-            // blend index.  Transform all those vertices as a block.
-            LMatrix4 mat;
-            tb_table->get_blend(first_bi).get_blend(mat, current_thread);
-            new_data->do_transform_point_column(new_format, data, mat, first_vertex, next_vertex);
-
-            first_vertex = next_vertex;
+      for (int i = 0; i < num_subranges; ++i) {
+        int begin = rows.get_subrange_begin(i);
+        int end = rows.get_subrange_end(i);
+        nassertv(begin < end);
+
+        int first_vertex = begin;
+        int first_bi = blendt[first_vertex];
+        for (int vi = begin + 1; vi < end; ++vi) {
+          int next_bi = blendt[vi];
+          if (next_bi != first_bi) {
+            nassertv(first_bi < num_blends);
+            job->_runs.push_back({first_vertex, vi, first_bi});
+            first_vertex = vi;
             first_bi = next_bi;
           }
         }
+        nassertv(first_bi < num_blends);
+        job->_runs.push_back({first_vertex, end, first_bi});
+        num_skinned_rows += end - begin;
       }
 
-      for (ci = 0; ci < new_format->get_num_vectors(); ci++) {
-        GeomVertexRewriter data(new_data, new_format->get_vector(ci));
-
-        for (int i = 0; i < num_subranges; ++i) {
-          int begin = rows.get_subrange_begin(i);
-          int end = rows.get_subrange_end(i);
-          nassertv(begin < end);
-
-          int first_vertex = begin;
-          int first_bi = blendt[first_vertex];
-
-          while (first_vertex < end) {
-            // At this point, first_vertex is the first of a series of
-            // vertices that shares the blend index first_bi.
-
-            // Scan for the end of this series of vertices--we're looking for
-            // the next vertex with a different blend index.
-            int next_vertex = first_vertex;
-            int next_bi = first_bi;
-            ++next_vertex;
-            while (next_vertex < end) {
-              next_bi = blendt[next_vertex];
-              if (next_bi != first_bi) {
-                break;
-              }
-              ++next_vertex;
-            }
-
-            // We've just reached the end of the vertices with a matching
-            // blend index.  Transform all those vertices as a block.
-            LMatrix4 mat;
-            tb_table->get_blend(first_bi).get_blend(mat, current_thread);
-            new_data->do_transform_vector_column(new_format, data, mat, first_vertex, next_vertex);
+    } else {
+      // The blend indices are anything else.  Use the GeomVertexReader to
+      // iterate through them.
+      GeomVertexReader blendi(this, InternalName::get_transform_blend());
+      nassertv(blendi.has_column());
 
-            first_vertex = next_vertex;
+      for (int i = 0; i < num_subranges; ++i) {
+        int begin = rows.get_subrange_begin(i);
+        int end = rows.get_subrange_end(i);
+        nassertv(begin < end);
+        blendi.set_row_unsafe(begin);
+
+        int first_vertex = begin;
+        int first_bi = blendi.get_data1i();
+        for (int vi = begin + 1; vi < end; ++vi) {
+          int next_bi = blendi.get_data1i();
+          if (next_bi != first_bi) {
+            nassertv(first_bi >= 0 && first_bi < num_blends);
+            job->_runs.push_back({first_vertex, vi, first_bi});
+            first_vertex = vi;
             first_bi = next_bi;
           }
         }
+        nassertv(first_bi >= 0 && first_bi < num_blends);
+        job->_runs.push_back({first_vertex, end, first_bi});
+        num_skinned_rows += end - begin;
       }
+    }
 
-    } else {
-      // The blend indices are anything else.  Use the GeomVertexReader to
-      // iterate through them.
-      GeomVertexReader blendi(this, InternalName::get_transform_blend());
-      nassertv(blendi.has_column());
+    if (job->_runs.empty()) {
+      return;
+    }
 
-      size_t ci;
-      for (ci = 0; ci < new_format->get_num_points(); ci++) {
-        GeomVertexRewriter data(new_data, new_format->get_point(ci));
-
-        for (int i = 0; i < num_subranges; ++i) {
-          int begin = rows.get_subrange_begin(i);
-          int end = rows.get_subrange_end(i);
-          nassertv(begin < end);
-          blendi.set_row_unsafe(begin);
-
-          int first_vertex = begin;
-          int first_bi = blendi.get_data1i();
-
-          while (first_vertex < end) {
-            // At this point, first_vertex is the first of a series of
-            // vertices that shares the blend index first_bi.
-
-            // Scan for the end of this series of vertices--we're looking for
-            // the next vertex with a different blend index.
-            int next_vertex = first_vertex;
-            int next_bi = first_bi;
-            ++next_vertex;
-            while (next_vertex < end) {
-              next_bi = blendi.get_data1i();
-              if (next_bi != first_bi) {
-                break;
-              }
-              ++next_vertex;
-            }
+    // Columns of 32-bit floats are transformed directly in memory, possibly
+    // by several threads at once.  Anything else goes through a
+    // GeomVertexRewriter, right here.
+    pvector<PT(GeomVertexArrayDataHandle)> handles(new_format->get_num_arrays());
+    bool any_normals = false;
+
+    size_t num_points = new_format->get_num_points();
+    size_t num_vectors = new_format->get_num_vectors();
+    for (size_t ci = 0; ci < num_points + num_vectors; ++ci) {
+      bool is_point = (ci < num_points);
+      const InternalName *name = is_point
+        ? new_format->get_point(ci)
+        : new_format->get_vector(ci - num_points);
+
+      int array_index;
+      const GeomVertexColumn *column;
+      if (!new_format->get_array_info(name, array_index, column)) {
+        continue;
+      }
 
-            // We've just reached the end of the vertices with a matching
-            // blend index.  Transform all those vertices as a block.
-            LMatrix4 mat;
-            tb_table->get_blend(first_bi).get_blend(mat, current_thread);
-            new_data->do_transform_point_column(new_format, data, mat, first_vertex, next_vertex);
+      int num_values = column->get_num_values();
+      if ((num_values == 3 || num_values == 4) &&
+          column->get_numeric_type() == NT_float32) {
+        if (handles[array_index] == nullptr) {
+          handles[array_index] = new_data->modify_array_handle(array_index);
+        }
+        GeomVertexArrayDataHandle *handle = handles[array_index];
 
-            first_vertex = next_vertex;
-            first_bi = next_bi;
+        SkinningJob::Column job_column;
+        job_column._data = handle->get_write_pointer() + column->get_start();
+        job_column._stride = handle->get_array_format()->get_stride();
+        job_column._num_values = num_values;
+        job_column._is_point = is_point;
+        job_column._is_normal = !is_point && column->get_contents() == C_normal;
+        job->_columns.push_back(job_column);
+        any_normals = any_normals || job_column._is_normal;
+
+      } else {
+        GeomVertexRewriter data(new_data, name);
+        for (const SkinningJob::Run &run : job->_runs) {
+          const LMatrix4 &mat = job->_blends[run._blend]._mat;
+          if (is_point) {
+            new_data->do_transform_point_column(new_format, data, mat, run._begin, run._end);
+          } else {
+            new_data->do_transform_vector_column(new_format, data, mat, run._begin, run._end);
           }
         }
       }
+    }
 
-      for (ci = 0; ci < new_format->get_num_vectors(); ci++) {
-        GeomVertexRewriter data(new_data, new_format->get_vector(ci));
-
-        for (int i = 0; i < num_subranges; ++i) {
-          int begin = rows.get_subrange_begin(i);
-          int end = rows.get_subrange_end(i);
-          nassertv(begin != end);
-          blendi.set_row_unsafe(begin);
-
-          int first_vertex = begin;
-          int first_bi = blendi.get_data1i();
-
-          while (first_vertex < end) {
-            // At this point, first_vertex is the first of a series of
-            // vertices that shares the blend index first_bi.
-
-            // Scan for the end of this series of vertices--we're looking for
-            // the next vertex with a different blend index.
-            int next_vertex = first_vertex;
-            int next_bi = first_bi;
-            ++next_vertex;
-            while (next_vertex < end) {
-              next_bi = blendi.get_data1i();
-              if (next_bi != first_bi) {
-                break;
-              }
-              ++next_vertex;
-            }
+    if (job->_columns.empty()) {
+      return;
+    }
 
-            // We've just reached the end of the vertices with a matching
-            // blend index.  Transform all those vertices as a block.
-            LMatrix4 mat;
-            tb_table->get_blend(first_bi).get_blend(mat, current_thread);
-            new_data->do_transform_vector_column(new_format, data, mat, first_vertex, next_vertex);
+    for (SkinningJob::Blend &blend : job->_blends) {
+      blend._matf = LCAST(float, blend._mat);
+      if (any_normals) {
+        LMatrix4 xform;
+        blend._normalize = compute_vector_xform(blend._mat, true, xform);
+        blend._normal_matf = LCAST(float, xform);
+      }
+    }
 
-            first_vertex = next_vertex;
-            first_bi = next_bi;
+    // The worker threads are borrowed from the task manager's shared parallel
+    // chain, which is configured once when it is first created.
+    AsyncTaskChain *chain = nullptr;
+    int num_threads = 0;
+    if (skinning_num_threads > 0 && Thread::is_threading_supported() &&
+        num_skinned_rows >= (size_t)std::max((int)skinning_parallel_min_vertices, 1)) {
+      chain = AsyncTaskManager::get_global_ptr()->get_parallel_chain();
+      num_threads = std::min((int)skinning_num_threads, chain->get_num_threads());
+    }
+
+    if (num_threads == 0) {
+      job->split_runs(1, num_skinned_rows);
+      do_skinning_job(job);
+      return;
+    }
+
+    // Hand out a few pieces to each thread, so that a thread that falls
+    // behind doesn't hold up everyone else.
+    size_t num_chunks = (size_t)(num_threads + 1) * 4;
+    job->split_runs(num_chunks, num_skinned_rows);
+    num_chunks = job->_chunk_ends.size();
+
+    // The current thread pitches in too, so we need one task fewer than we
+    // have chunks.
+    size_t num_tasks = std::min((size_t)num_threads, num_chunks - 1);
+    for (size_t ti = 0; ti < num_tasks; ++ti) {
+      chain->add([job](AsyncTask *task) {
+        do_skinning_job(job);
+        return AsyncTask::DS_done;
+      }, "skinning");
+    }
+
+    do_skinning_job(job);
+
+    // Wait for the other threads to finish the chunks they have claimed.
+    uint32_t num_done = job->_num_done.load(std::memory_order_acquire);
+    while (num_done < num_chunks) {
+      job->_num_done.wait(num_done, std::memory_order_acquire);
+      num_done = job->_num_done.load(std::memory_order_acquire);
+    }
+  }
+}
+
+/**
+ * Transforms the vertices in the chunks of the indicated job, claiming one
+ * chunk at a time until none are left.  Runs on any of the threads taking
+ * part in animating a GeomVertexData.
+ */
+void GeomVertexData::
+do_skinning_job(SkinningJob *job) {
+  size_t num_chunks = job->_chunk_ends.size();
+
+  size_t ci;
+  while ((ci = job->_next_chunk.fetch_add(1)) < num_chunks) {
+    size_t begin = (ci > 0) ? job->_chunk_ends[ci - 1] : 0;
+    size_t end = job->_chunk_ends[ci];
+
+    for (const SkinningJob::Column &column : job->_columns) {
+      for (size_t ri = begin; ri < end; ++ri) {
+        const SkinningJob::Run &run = job->_runs[ri];
+        const SkinningJob::Blend &blend = job->_blends[run._blend];
+        unsigned char *datat = column._data + run._begin * column._stride;
+        size_t num_rows = run._end - run._begin;
+
+        if (column._is_point) {
+          if (column._num_values == 3) {
+            table_xform_point3f(datat, num_rows, column._stride, blend._matf);
+          } else {
+            table_xform_vecbase4f(datat, num_rows, column._stride, blend._matf);
+          }
+        } else if (column._is_normal) {
+          if (blend._normalize) {
+            table_xform_normal3f(datat, num_rows, column._stride, blend._normal_matf);
+          } else if (column._num_values == 3) {
+            table_xform_vector3f(datat, num_rows, column._stride, blend._normal_matf);
+          } else {
+            table_xform_vecbase4f(datat, num_rows, column._stride, blend._normal_matf);
+          }
+        } else {
+          if (column._num_values == 3) {
+            table_xform_vector3f(datat, num_rows, column._stride, blend._matf);
+          } else {
+            table_xform_vecbase4f(datat, num_rows, column._stride, blend._matf);
           }
         }
       }
     }
+
+    if (job->_num_done.fetch_add(1, std::memory_order_release) + 1 == num_chunks) {
+      job->_num_done.notify_all();
+    }
   }
 }
 
-
 /**
  * Transforms a range of vertices for one particular column, as a point.
  */
@@ -1809,35 +1989,7 @@ do_transform_vector_column(const GeomVertexFormat *format, GeomVertexRewriter &d
   int num_values = data_column->get_num_values();
 
   LMatrix4 xform;
-  bool normalize = false;
-  if (data_column->get_contents() == C_normal) {
-    // This is to preserve perpendicularity to the surface.
-    LVecBase3 scale_sq(mat.get_row3(0).length_squared(),
-                       mat.get_row3(1).length_squared(),
-                       mat.get_row3(2).length_squared());
-    if (IS_THRESHOLD_EQUAL(scale_sq[0], scale_sq[1], 2.0e-3f) &&
-        IS_THRESHOLD_EQUAL(scale_sq[0], scale_sq[2], 2.0e-3f)) {
-      // There is a uniform scale.
-      LVecBase3 scale, shear, hpr;
-      if (IS_THRESHOLD_EQUAL(scale_sq[0], 1, 2.0e-3f)) {
-        // No scale to worry about.
-        xform = mat;
-      } else if (decompose_matrix(mat.get_upper_3(), scale, shear, hpr)) {
-        // Make a new matrix with scale/translate taken out of the equation.
-        compose_matrix(xform, LVecBase3(1, 1, 1), shear, hpr, LVecBase3::zero());
-      } else {
-        normalize = true;
-      }
-    } else {
-      // There is a non-uniform scale, so we need to do all this to preserve
-      // orthogonality to the surface.
-      xform.invert_from(mat);
-      xform.transpose_in_place();
-      normalize = true;
-    }
-  } else {
-    xform = mat;
-  }
+  bool normalize = compute_vector_xform(mat, data_column->get_contents() == C_normal, xform);
 
   if ((num_values == 3 || num_values == 4) &&
       data_column->get_numeric_type() == NT_float32) {
@@ -1879,6 +2031,73 @@ do_transform_vector_column(const GeomVertexFormat *format, GeomVertexRewriter &d
   }
 }
 
+#ifdef GOBJ_SKINNING_SSE2
+/**
+ * Transforms the 3-component float vectors in the indicated table four at a
+ * time, using SSE2 instructions, and returns the number of rows that were
+ * transformed, which is num_rows rounded down to a multiple of four.  The
+ * remaining rows must be transformed by the caller.  If is_point is true,
+ * the translation component of the matrix is applied.
+ */
+static ALWAYS_INLINE size_t
+table_xform_3f_sse2(unsigned char *datat, size_t num_rows, size_t stride,
+                    const LMatrix4f &matf, bool is_point, bool normalize) {
+  const __m128 m00 = _mm_set1_ps(matf(0, 0));
+  const __m128 m01 = _mm_set1_ps(matf(0, 1));
+  const __m128 m02 = _mm_set1_ps(matf(0, 2));
+  const __m128 m10 = _mm_set1_ps(matf(1, 0));
+  const __m128 m11 = _mm_set1_ps(matf(1, 1));
+  const __m128 m12 = _mm_set1_ps(matf(1, 2));
+  const __m128 m20 = _mm_set1_ps(matf(2, 0));
+  const __m128 m21 = _mm_set1_ps(matf(2, 1));
+  const __m128 m22 = _mm_set1_ps(matf(2, 2));
+  const __m128 m30 = _mm_set1_ps(is_point ? matf(3, 0) : 0.0f);
+  const __m128 m31 = _mm_set1_ps(is_point ? matf(3, 1) : 0.0f);
+  const __m128 m32 = _mm_set1_ps(is_point ? matf(3, 2) : 0.0f);
+
+  size_t num_simd_rows = num_rows & ~(size_t)3;
+  for (size_t i = 0; i < num_simd_rows; i += 4) {
+    float *v0 = (float *)(datat + i * stride);
+    float *v1 = (float *)(datat + (i + 1) * stride);
+    float *v2 = (float *)(datat + (i + 2) * stride);
+    float *v3 = (float *)(datat + (i + 3) * stride);
+
+    // Rearrange the rows so that we transform four vectors at once.
+    __m128 x = _mm_setr_ps(v0[0], v1[0], v2[0], v3[0]);
+    __m128 y = _mm_setr_ps(v0[1], v1[1], v2[1], v3[1]);
+    __m128 z = _mm_setr_ps(v0[2], v1[2], v2[2], v3[2]);
+
+    __m128 rx = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, m00), _mm_mul_ps(y, m10)),
+                           _mm_add_ps(_mm_mul_ps(z, m20), m30));
+    __m128 ry = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, m01), _mm_mul_ps(y, m11)),
+                           _mm_add_ps(_mm_mul_ps(z, m21), m31));
+    __m128 rz = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, m02), _mm_mul_ps(y, m12)),
+                           _mm_add_ps(_mm_mul_ps(z, m22), m32));
+
+    if (normalize) {
+      // Zero-length vectors are left at zero, as LVector3f::normalize() does.
+      __m128 length_sq = _mm_add_ps(_mm_add_ps(_mm_mul_ps(rx, rx), _mm_mul_ps(ry, ry)),
+                                    _mm_mul_ps(rz, rz));
+      __m128 nonzero = _mm_cmpgt_ps(length_sq, _mm_setzero_ps());
+      __m128 scale = _mm_and_ps(_mm_div_ps(_mm_set1_ps(1.0f), _mm_sqrt_ps(length_sq)), nonzero);
+      rx = _mm_mul_ps(rx, scale);
+      ry = _mm_mul_ps(ry, scale);
+      rz = _mm_mul_ps(rz, scale);
+    }
+
+    float ox[4], oy[4], oz[4];
+    _mm_storeu_ps(ox, rx);
+    _mm_storeu_ps(oy, ry);
+    _mm_storeu_ps(oz, rz);
+    v0[0] = ox[0]; v0[1] = oy[0]; v0[2] = oz[0];
+    v1[0] = ox[1]; v1[1] = oy[1]; v1[2] = oz[1];
+    v2[0] = ox[2]; v2[1] = oy[2]; v2[2] = oz[2];
+    v3[0] = ox[3]; v3[1] = oy[3]; v3[2] = oz[3];
+  }
+  return num_simd_rows;
+}
+#endif  // GOBJ_SKINNING_SSE2
+
 /**
  * Transforms each of the LPoint3f objects in the indicated table by the
  * indicated matrix.
@@ -1888,7 +2107,11 @@ table_xform_point3f(unsigned char *datat, size_t num_rows, size_t stride,
                     const LMatrix4f &matf) {
   // We don't bother checking for the unaligned case here, because in practice
   // it doesn't matter with a 3-component point.
-  for (size_t i = 0; i < num_rows; ++i) {
+  size_t i = 0;
+#ifdef GOBJ_SKINNING_SSE2
+  i = table_xform_3f_sse2(datat, num_rows, stride, matf, true, false);
+#endif
+  for (; i < num_rows; ++i) {
     LPoint3f &vertex = *(LPoint3f *)(&datat[i * stride]);
     vertex *= matf;
   }
@@ -1903,7 +2126,11 @@ table_xform_normal3f(unsigned char *datat, size_t num_rows, size_t stride,
                      const LMatrix4f &matf) {
   // We don't bother checking for the unaligned case here, because in practice
   // it doesn't matter with a 3-component vector.
-  for (size_t i = 0; i < num_rows; ++i) {
+  size_t i = 0;
+#ifdef GOBJ_SKINNING_SSE2
+  i = table_xform_3f_sse2(datat, num_rows, stride, matf, false, true);
+#endif
+  for (; i < num_rows; ++i) {
     LNormalf &vertex = *(LNormalf *)(&datat[i * stride]);
     vertex *= matf;
     vertex.normalize();
@@ -1919,7 +2146,11 @@ table_xform_vector3f(unsigned char *datat, size_t num_rows, size_t stride,
                      const LMatrix4f &matf) {
   // We don't bother checking for the unaligned case here, because in practice
   // it doesn't matter with a 3-component vector.
-  for (size_t i = 0; i < num_rows; ++i) {
+  size_t i = 0;
+#ifdef GOBJ_SKINNING_SSE2
+  i = table_xform_3f_sse2(datat, num_rows, stride, matf, false, false);
+#endif
+  for (; i < num_rows; ++i) {
     LVector3f &vertex = *(LVector3f *)(&datat[i * stride]);
     vertex *= matf;
   }
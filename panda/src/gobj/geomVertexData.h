@@ -337,7 +337,10 @@ private:
   LightMutex _cache_lock;
 
 private:
+  class SkinningJob;
+
   void update_animated_vertices(CData *cdata, Thread *current_thread);
+  static void do_skinning_job(SkinningJob *job);
   void do_transform_point_column(const GeomVertexFormat *format, GeomVertexRewriter &data,
                                  const LMatrix4 &mat, int begin_row, int end_row);
   void do_transform_vector_column(const GeomVertexFormat *format, GeomVertexRewriter &data,
@@ -35,6 +35,9 @@ using std::string;
 TypeHandle Shader::_type_handle;
 Shader::ShaderTable Shader::_load_table;
 Shader::ShaderTable Shader::_make_table;
+Shader::LoadingFiles Shader::_loading_files;
+Mutex Shader::_table_lock("Shader::_table_lock");
+ConditionVar Shader::_table_cvar(Shader::_table_lock);
 Shader::ShaderCaps Shader::_default_caps;
 int Shader::_shaders_generated;
 
@@ -3484,29 +3487,64 @@ get_filename_from_index(int index, ShaderType type) const {
   return Filename(str);
 }
 
+/**
+ * If another thread is currently reading the indicated shader file, waits for
+ * it to finish, so that the caller can find the result in the table.
+ *
+ * Assumes _table_lock is held.
+ */
+void Shader::
+wait_for_load(const ShaderFile &sfile) {
+  while (_loading_files.count(sfile) != 0) {
+    _table_cvar.wait();
+  }
+}
+
+/**
+ * Indicates that this thread is done reading the indicated shader file, and
+ * wakes up any threads waiting for it in wait_for_load().
+ *
+ * Assumes _table_lock is held.
+ */
+void Shader::
+finish_load(const ShaderFile &sfile) {
+  _loading_files.erase(sfile);
+  _table_cvar.notify_all();
+}
+
 /**
  * Loads the shader with the given filename.
  */
 PT(Shader) Shader::
 load(const Filename &file, ShaderLanguage lang) {
   ShaderFile sfile(file);
-  ShaderTable::const_iterator i = _load_table.find(sfile);
-  if (i != _load_table.end() && (lang == SL_none || lang == i->second->_language)) {
-    // But check that someone hasn't modified it in the meantime.
-    if (i->second->check_modified()) {
-      shader_cat.info()
-        << "Shader " << file << " was modified on disk, reloading.\n";
-    } else {
-      if (shader_cat.is_debug()) {
-        shader_cat.debug()
-          << "Shader " << file << " was found in shader cache.\n";
+  {
+    MutexHolder holder(_table_lock);
+    wait_for_load(sfile);
+
+    ShaderTable::const_iterator i = _load_table.find(sfile);
+    if (i != _load_table.end() && (lang == SL_none || lang == i->second->_language)) {
+      // But check that someone hasn't modified it in the meantime.
+      if (i->second->check_modified()) {
+        shader_cat.info()
+          << "Shader " << file << " was modified on disk, reloading.\n";
+      } else {
+        if (shader_cat.is_debug()) {
+          shader_cat.debug()
+            << "Shader " << file << " was found in shader cache.\n";
+        }
+        return i->second;
       }
-      return i->second;
     }
+    _loading_files.insert(sfile);
   }
 
   PT(Shader) shader = new Shader(lang);
-  if (!shader->read(sfile)) {
+  bool success = shader->read(sfile);
+
+  MutexHolder holder(_table_lock);
+  finish_load(sfile);
+  if (!success) {
     return nullptr;
   }
 
@@ -3530,23 +3568,33 @@ load(ShaderLanguage lang, const Filename &vertex,
      const Filename &fragment, const Filename &geometry,
      const Filename &tess_control, const Filename &tess_evaluation) {
   ShaderFile sfile(vertex, fragment, geometry, tess_control, tess_evaluation);
-  ShaderTable::const_iterator i = _load_table.find(sfile);
-  if (i != _load_table.end() && (lang == SL_none || lang == i->second->_language)) {
-    // But check that someone hasn't modified it in the meantime.
-    if (i->second->check_modified()) {
-      shader_cat.info()
-        << "Shader was modified on disk, reloading.\n";
-    } else {
-      if (shader_cat.is_debug()) {
-        shader_cat.debug()
-          << "Shader was found in shader cache.\n";
+  {
+    MutexHolder holder(_table_lock);
+    wait_for_load(sfile);
+
+    ShaderTable::const_iterator i = _load_table.find(sfile);
+    if (i != _load_table.end() && (lang == SL_none || lang == i->second->_language)) {
+      // But check that someone hasn't modified it in the meantime.
+      if (i->second->check_modified()) {
+        shader_cat.info()
+          << "Shader was modified on disk, reloading.\n";
+      } else {
+        if (shader_cat.is_debug()) {
+          shader_cat.debug()
+            << "Shader was found in shader cache.\n";
+        }
+        return i->second;
       }
-      return i->second;
     }
+    _loading_files.insert(sfile);
   }
 
   PT(Shader) shader = new Shader(lang);
-  if (!shader->read(sfile)) {
+  bool success = shader->read(sfile);
+
+  MutexHolder holder(_table_lock);
+  finish_load(sfile);
+  if (!success) {
     return nullptr;
   }
 
@@ -3585,19 +3633,25 @@ load_compute(ShaderLanguage lang, const Filename &fn) {
   sfile._separate = true;
   sfile._compute = fn;
 
-  ShaderTable::const_iterator i = _load_table.find(sfile);
-  if (i != _load_table.end() && (lang == SL_none || lang == i->second->_language)) {
-    // But check that someone hasn't modified it in the meantime.
-    if (i->second->check_modified()) {
-      shader_cat.info()
-        << "Compute shader " << fn << " was modified on disk, reloading.\n";
-    } else {
-      if (shader_cat.is_debug()) {
-        shader_cat.debug()
-          << "Compute shader " << fn << " was found in shader cache.\n";
+  {
+    MutexHolder holder(_table_lock);
+    wait_for_load(sfile);
+
+    ShaderTable::const_iterator i = _load_table.find(sfile);
+    if (i != _load_table.end() && (lang == SL_none || lang == i->second->_language)) {
+      // But check that someone hasn't modified it in the meantime.
+      if (i->second->check_modified()) {
+        shader_cat.info()
+          << "Compute shader " << fn << " was modified on disk, reloading.\n";
+      } else {
+        if (shader_cat.is_debug()) {
+          shader_cat.debug()
+            << "Compute shader " << fn << " was found in shader cache.\n";
+        }
+        return i->second;
       }
-      return i->second;
     }
+    _loading_files.insert(sfile);
   }
 
   BamCache *cache = BamCache::get_global_ptr();
@@ -3607,13 +3661,18 @@ load_compute(ShaderLanguage lang, const Filename &fn) {
       shader_cat.info()
         << "Compute shader " << fn << " was found in disk cache.\n";
 
+      MutexHolder holder(_table_lock);
+      finish_load(sfile);
       return DCAST(Shader, record->get_data());
     }
   }
 
   PT(Shader) shader = new Shader(lang);
+  bool success = shader->read(sfile, record);
 
-  if (!shader->read(sfile, record)) {
+  MutexHolder holder(_table_lock);
+  finish_load(sfile);
+  if (!success) {
     return nullptr;
   }
   _load_table[sfile] = shader;
@@ -3659,6 +3718,7 @@ make(string body, ShaderLanguage lang) {
   ShaderFile sbody(std::move(body));
 
   if (cache_generated_shaders) {
+    MutexHolder holder(_table_lock);
     ShaderTable::const_iterator i = _make_table.find(sbody);
     if (i != _make_table.end() && (lang == SL_none || lang == i->second->_language)) {
       // But check that someone hasn't modified its includes in the meantime.
@@ -3674,6 +3734,7 @@ make(string body, ShaderLanguage lang) {
   }
 
   if (cache_generated_shaders) {
+    MutexHolder holder(_table_lock);
     ShaderTable::const_iterator i = _make_table.find(shader->_text);
     if (i != _make_table.end() && (lang == SL_none || lang == i->second->_language)) {
       shader = i->second;
@@ -3720,6 +3781,7 @@ make(ShaderLanguage lang, string vertex, string fragment, string geometry,
                    std::move(tess_control), std::move(tess_evaluation));
 
   if (cache_generated_shaders) {
+    MutexHolder holder(_table_lock);
     ShaderTable::const_iterator i = _make_table.find(sbody);
     if (i != _make_table.end() && (lang == SL_none || lang == i->second->_language)) {
       // But check that someone hasn't modified its includes in the meantime.
@@ -3736,6 +3798,7 @@ make(ShaderLanguage lang, string vertex, string fragment, string geometry,
   }
 
   if (cache_generated_shaders) {
+    MutexHolder holder(_table_lock);
     ShaderTable::const_iterator i = _make_table.find(shader->_text);
     if (i != _make_table.end() && (lang == SL_none || lang == i->second->_language)) {
       shader = i->second;
@@ -3764,6 +3827,7 @@ make_compute(ShaderLanguage lang, string body) {
   sbody._compute = std::move(body);
 
   if (cache_generated_shaders) {
+    MutexHolder holder(_table_lock);
     ShaderTable::const_iterator i = _make_table.find(sbody);
     if (i != _make_table.end() && (lang == SL_none || lang == i->second->_language)) {
       // But check that someone hasn't modified its includes in the meantime.
@@ -3780,6 +3844,7 @@ make_compute(ShaderLanguage lang, string body) {
   }
 
   if (cache_generated_shaders) {
+    MutexHolder holder(_table_lock);
     ShaderTable::const_iterator i = _make_table.find(shader->_text);
     if (i != _make_table.end() && (lang == SL_none || lang == i->second->_language)) {
       shader = i->second;
@@ -34,6 +34,9 @@
 #include "pta_LVecBase2.h"
 #include "pStatCollector.h"
 #include "pvector.h"
+#include "pset.h"
+#include "pmutex.h"
+#include "conditionVar.h"
 #include "asyncFuture.h"
 #include "bamCacheRecord.h"
 
@@ -85,14 +88,14 @@ PUBLISHED:
     bit_AutoShaderShadow = 4, // bit for AS_shadow
   };
 
-  static PT(Shader) load(const Filename &file, ShaderLanguage lang = SL_none);
+  BLOCKING static PT(Shader) load(const Filename &file, ShaderLanguage lang = SL_none);
   static PT(Shader) make(std::string body, ShaderLanguage lang = SL_none);
-  static PT(Shader) load(ShaderLanguage lang,
-                         const Filename &vertex, const Filename &fragment,
-                         const Filename &geometry = "",
-                         const Filename &tess_control = "",
-                         const Filename &tess_evaluation = "");
-  static PT(Shader) load_compute(ShaderLanguage lang, const Filename &fn);
+  BLOCKING static PT(Shader) load(ShaderLanguage lang,
+                                  const Filename &vertex, const Filename &fragment,
+                                  const Filename &geometry = "",
+                                  const Filename &tess_control = "",
+                                  const Filename &tess_evaluation = "");
+  BLOCKING static PT(Shader) load_compute(ShaderLanguage lang, const Filename &fn);
   static PT(Shader) make(ShaderLanguage lang,
                          std::string vertex, std::string fragment,
                          std::string geometry = "",
@@ -680,6 +683,17 @@ protected:
   static ShaderTable _load_table;
   static ShaderTable _make_table;
 
+  // Protects the above tables.  _loading_files holds the shader files that
+  // are currently being read by some thread; other threads that want the same
+  // shader wait on _table_cvar for it, rather than reading it a second time.
+  typedef pset<ShaderFile> LoadingFiles;
+  static LoadingFiles _loading_files;
+  static Mutex _table_lock;
+  static ConditionVar _table_cvar;
+
+  static void wait_for_load(const ShaderFile &sfile);
+  static void finish_load(const ShaderFile &sfile);
+
   friend class ShaderContext;
   friend class PreparedGraphicsObjects;
 
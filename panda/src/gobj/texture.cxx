@@ -69,6 +69,19 @@ ConfigVariableEnum<Texture::QualityLevel> texture_quality_level
           "it has little or no effect on normal, hardware-accelerated "
           "renderers.  See Texture::set_quality_level()."));
 
+ConfigVariableInt64 max_resident_texture_ram
+("max-resident-texture-ram", -1,
+ PRC_DESC("Specifies the maximum number of bytes of texture images that are "
+          "allowed to remain resident in system RAM at one time.  If more "
+          "than this are loaded, the RAM images of the least-recently-used "
+          "textures are released, to be reloaded from disk (or from the "
+          "model cache) when they are needed again.  This only applies to "
+          "textures that were loaded from disk, that have not been modified "
+          "since, and that do not have keep_ram_image set.  Set it to -1 "
+          "for no limit, in which case the images are not tracked at all."));
+
+SimpleLru Texture::_ram_image_lru("ram-image", (size_t)max_resident_texture_ram.get_value());
+patomic<size_t> Texture::_ram_image_evicted_size(0);
 PStatCollector Texture::_texture_read_pcollector("*:Texture:Read");
 PStatCollector Texture::_texture_write_pcollector("*:Texture:Write");
 TypeHandle Texture::_type_handle;
@@ -377,7 +390,8 @@ Texture::
 Texture(const string &name) :
   Namable(name),
   _lock(name),
-  _cvar(_lock)
+  _cvar(_lock),
+  _ram_image_page(this)
 {
   _reloading = false;
 
@@ -393,7 +407,8 @@ Texture(const Texture &copy) :
   Namable(copy),
   _cycler(copy._cycler),
   _lock(copy.get_name()),
-  _cvar(_lock)
+  _cvar(_lock),
+  _ram_image_page(this)
 {
   _reloading = false;
 }
@@ -414,6 +429,8 @@ Texture::
 ~Texture() {
   release_all();
   nassertv(!_reloading);
+
+  _ram_image_evicted_size -= _ram_image_page._evicted_size.exchange(0);
 }
 
 /**
@@ -2655,7 +2672,36 @@ texture_uploaded() {
         << "Dumping RAM for texture " << get_name() << "\n";
     }
     do_clear_ram_image(cdataw);
+    do_update_ram_image_lru(cdataw);
+  }
+}
+
+/**
+ * Puts the texture's RAM image on the LRU that enforces the
+ * max-resident-texture-ram limit, or updates its size there, if it is
+ * eligible.  This is called by the TexturePool after it has loaded a texture.
+ */
+void Texture::
+update_ram_image_lru() {
+  CDReader cdata(_cycler);
+  do_update_ram_image_lru(cdata);
+}
+
+/**
+ * Marks that an epoch has passed in the RAM image LRU, releasing RAM images
+ * as needed to bring it back under max-resident-texture-ram.  This is called
+ * by the GraphicsEngine once per frame.
+ *
+ * This also applies any change that has been made to the value of
+ * max-resident-texture-ram since the last epoch.
+ */
+void Texture::
+lru_epoch() {
+  size_t max_size = (size_t)max_resident_texture_ram.get_value();
+  if (_ram_image_lru.get_max_size() != max_size) {
+    _ram_image_lru.set_max_size(max_size);
   }
+  _ram_image_lru.begin_epoch();
 }
 
 /**
@@ -3504,6 +3550,7 @@ do_load_one(CData *cdata, const PNMImage &pnmimage, const string &name, int z, i
 
     do_modify_ram_image(cdata);
     cdata->_loaded_from_image = true;
+    cdata->_modified_since_load = false;
   }
 
   do_modify_ram_mipmap_image(cdata, n);
@@ -3573,6 +3620,7 @@ do_load_one(CData *cdata, const PfmFile &pfm, const string &name, int z, int n,
 
     do_modify_ram_image(cdata);
     cdata->_loaded_from_image = true;
+    cdata->_modified_since_load = false;
   }
 
   do_modify_ram_mipmap_image(cdata, n);
@@ -3698,6 +3746,7 @@ do_read_txo(CData *cdata, istream &in, const string &filename) {
   do_assign(cdata, other, cdata_other);
 
   cdata->_loaded_from_image = true;
+  cdata->_modified_since_load = false;
   cdata->_loaded_from_txo = true;
   cdata->_has_read_pages = false;
   cdata->_has_read_mipmaps = false;
@@ -4386,6 +4435,7 @@ do_read_dds(CData *cdata, istream &in, const string &filename, bool header_only)
   }
 
   cdata->_loaded_from_image = true;
+  cdata->_modified_since_load = false;
   cdata->_loaded_from_txo = true;
 
   return true;
@@ -5170,6 +5220,7 @@ do_read_ktx(CData *cdata, istream &in, const string &filename, bool header_only)
   }
 
   cdata->_loaded_from_image = true;
+  cdata->_modified_since_load = false;
   cdata->_loaded_from_txo = true;
 
   return true;
@@ -5620,6 +5671,7 @@ do_reload_ram_image(CData *cdata, bool allow_compression) {
           cdata->_ram_image_compression = cdata_tex->_ram_image_compression;
           cdata->_ram_images = cdata_tex->_ram_images;
           cdata->_loaded_from_image = true;
+          cdata->_modified_since_load = false;
 
           bool was_compressed = (cdata->_ram_image_compression != CM_off);
           if (do_consider_auto_process_ram_image(cdata, uses_mipmaps(), allow_compression)) {
@@ -5695,6 +5747,9 @@ do_reload_ram_image(CData *cdata, bool allow_compression) {
 /**
  * This is called internally to uniquify the ram image pointer without
  * updating cdata->_image_modified.
+ *
+ * Since the image may now differ from the file it was loaded from, it is no
+ * longer evicted from RAM by max-resident-texture-ram.
  */
 PTA_uchar Texture::
 do_modify_ram_image(CData *cdata) {
@@ -5704,6 +5759,8 @@ do_modify_ram_image(CData *cdata) {
   } else {
     do_clear_ram_mipmap_images(cdata);
   }
+  cdata->_modified_since_load = true;
+  do_update_ram_image_lru(cdata);
   return cdata->_ram_images[0]._image;
 }
 
@@ -5741,7 +5798,8 @@ do_make_ram_image(CData *cdata) {
  * not CM_off, it indicates that the new data is already pre-compressed in the
  * indicated format.
  *
- * This does *not* affect keep_ram_image.
+ * This does *not* affect keep_ram_image.  It does mean that the image is no
+ * longer evicted from RAM by max-resident-texture-ram.
  */
 void Texture::
 do_set_ram_image(CData *cdata, CPTA_uchar image, Texture::CompressionMode compression,
@@ -5765,6 +5823,8 @@ do_set_ram_image(CData *cdata, CPTA_uchar image, Texture::CompressionMode compre
     cdata->_ram_image_compression = compression;
     cdata->inc_image_modified();
   }
+  cdata->_modified_since_load = true;
+  do_update_ram_image_lru(cdata);
 }
 
 /**
@@ -7426,6 +7486,7 @@ do_get_ram_image(CData *cdata) {
     return CPTA_uchar(get_class_type());
   }
 
+  do_update_ram_image_lru(cdata);
   return cdata->_ram_images[0]._image;
 }
 
@@ -7464,6 +7525,7 @@ do_get_uncompressed_ram_image(CData *cdata) {
     return CPTA_uchar(get_class_type());
   }
 
+  do_update_ram_image_lru(cdata);
   return cdata->_ram_images[0]._image;
 }
 
@@ -7968,6 +8030,78 @@ do_reload(CData *cdata) {
   return false;
 }
 
+/**
+ * Places the RAM image on the RAM image LRU and marks it as recently used,
+ * or removes it from the LRU if it is no longer there, or can no longer be
+ * reloaded, or has been modified since it was loaded, or if keep-texture-ram
+ * is set.  Nothing is placed on the LRU while max-resident-texture-ram is -1,
+ * so that its lock is not needed.  Assumes the lock is already held.
+ */
+void Texture::
+do_update_ram_image_lru(const CData *cdata) const {
+  bool has_ram_image = do_has_ram_image(cdata);
+  if (has_ram_image &&
+      _ram_image_page._evicted_size.load(std::memory_order_relaxed) != 0) {
+    // It has been reloaded since it was evicted.
+    _ram_image_evicted_size -= _ram_image_page._evicted_size.exchange(0);
+  }
+
+  if (has_ram_image && max_resident_texture_ram >= 0 && !keep_texture_ram &&
+      !cdata->_keep_ram_image && !cdata->_modified_since_load &&
+      do_can_reload(cdata)) {
+    size_t size = 0;
+    for (const RamImage &ram_image : cdata->_ram_images) {
+      size += ram_image._image.size();
+    }
+    _ram_image_page.set_lru_size(size);
+    _ram_image_page.mark_used_lru(&_ram_image_lru);
+
+  } else if (_ram_image_page.get_lru() != nullptr) {
+    _ram_image_page.dequeue_lru();
+  }
+}
+
+/**
+ * Called by the RAM image LRU to release the RAM image, which can be
+ * reloaded later when it is needed.
+ */
+void Texture::
+evict_ram_image() {
+  MutexHolder holder(_lock);
+  if (_reloading) {
+    // Never mind; it's being reloaded right now.  Put it back on the LRU, so
+    // that it will be considered again later.
+    _ram_image_page.mark_used_lru(&_ram_image_lru);
+    return;
+  }
+
+  CDWriter cdata(_cycler, false);
+  if (!do_has_ram_image(cdata) || keep_texture_ram ||
+      cdata->_keep_ram_image || cdata->_modified_since_load ||
+      !do_can_reload(cdata)) {
+    return;
+  }
+
+  if (gobj_cat.is_debug()) {
+    gobj_cat.debug()
+      << "Evicting RAM image for texture " << get_name() << "\n";
+  }
+
+  size_t size = _ram_image_page.get_lru_size();
+  do_clear_ram_image(cdata);
+  _ram_image_page._evicted_size += size;
+  _ram_image_evicted_size += size;
+}
+
+/**
+ * Called by the LRU when the RAM image should be released.
+ */
+void Texture::RamImagePage::
+evict_lru() {
+  dequeue_lru();
+  _texture->evict_ram_image();
+}
+
 /**
  * Returns true if there is a rawdata image that we have available to write to
  * the bam stream.  For a normal Texture, this is the same thing as
@@ -10494,6 +10628,7 @@ make_this_from_bam(const FactoryParams &params) {
               cdata_me->_alpha_file_channel = alpha_file_channel;
               cdata_me->_texture_type = texture_type;
               cdata_me->_loaded_from_image = true;
+              cdata_me->_modified_since_load = false;
               cdata_me->_has_read_mipmaps = has_read_mipmaps;
             }
 
@@ -10673,6 +10808,7 @@ do_fillin_rawdata(CData *cdata, DatagramIterator &scan, BamReader *manager) {
     cdata->_ram_images[n]._image = image;
   }
   cdata->_loaded_from_image = true;
+  cdata->_modified_since_load = false;
   cdata->inc_image_modified();
 }
 
@@ -10774,6 +10910,7 @@ CData() {
 
   _loaded_from_image = false;
   _loaded_from_txo = false;
+  _modified_since_load = false;
   _has_read_pages = false;
   _has_read_mipmaps = false;
   _num_mipmap_levels_read = 0;
@@ -10844,6 +10981,7 @@ do_assign(const Texture::CData *copy) {
   _component_type = copy->_component_type;
   _loaded_from_image = copy->_loaded_from_image;
   _loaded_from_txo = copy->_loaded_from_txo;
+  _modified_since_load = copy->_modified_since_load;
   _has_read_pages = copy->_has_read_pages;
   _has_read_mipmaps = copy->_has_read_mipmaps;
   _num_mipmap_levels_read = copy->_num_mipmap_levels_read;
@@ -47,6 +47,9 @@
 #include "pfmFile.h"
 #include "asyncTask.h"
 #include "extension.h"
+#include "simpleLru.h"
+#include "configVariableInt64.h"
+#include "patomic.h"
 
 class TextureContext;
 class FactoryParams;
@@ -560,6 +563,10 @@ PUBLISHED:
   INLINE static AutoTextureScale get_textures_power_2();
   INLINE static bool has_textures_power_2();
 
+  INLINE static SimpleLru *get_ram_image_lru();
+  INLINE static size_t get_ram_image_evicted_size();
+  static void lru_epoch();
+
 PUBLISHED:
 
   INLINE int get_pad_x_size() const;
@@ -628,6 +635,8 @@ PUBLISHED:
 
 public:
   void texture_uploaded();
+  INLINE void mark_ram_image_used() const;
+  void update_ram_image_lru();
 
   virtual bool has_cull_callback() const;
   virtual bool cull_callback(CullTraverser *trav, const CullTraverserData &data) const;
@@ -789,6 +798,8 @@ protected:
   void do_set_pad_size(CData *cdata, int x, int y, int z);
   virtual bool do_can_reload(const CData *cdata) const;
   bool do_reload(CData *cdata);
+  void do_update_ram_image_lru(const CData *cdata) const;
+  void evict_ram_image();
   AsyncFuture *do_async_ensure_ram_image(const CData *cdata, bool allow_compression, int priority);
 
   INLINE AutoTextureScale do_get_auto_texture_scale(const CData *cdata) const;
@@ -992,6 +1003,11 @@ protected:
 
     bool _loaded_from_image;
     bool _loaded_from_txo;
+
+    // Set when the RAM image has been modified or replaced since it was
+    // loaded from its file, which keeps it off the RAM image LRU.
+    bool _modified_since_load;
+
     bool _has_read_pages;
     bool _has_read_mipmaps;
     int _num_mipmap_levels_read;
@@ -1083,12 +1099,30 @@ protected:
   // The TexturePool finds this useful.
   Filename _texture_pool_key;
 
+  // This page represents the RAM image in the LRU that enforces
+  // max-resident-texture-ram.  Only RAM images that can be reloaded from disk
+  // are placed on it.
+  class RamImagePage : public SimpleLruPage {
+  public:
+    INLINE explicit RamImagePage(Texture *texture);
+    virtual void evict_lru();
+
+    Texture *_texture;
+
+    // The size of the RAM image when it was last evicted, if it has not
+    // been reloaded since.
+    patomic<size_t> _evicted_size;
+  };
+  mutable RamImagePage _ram_image_page;
+
 private:
   // The auxiliary data is not recorded to a bam file.
   typedef pmap<std::string, PT(TypedReferenceCount) > AuxData;
   AuxData _aux_data;
 
   static AutoTextureScale _textures_power_2;
+  static SimpleLru _ram_image_lru;
+  static patomic<size_t> _ram_image_evicted_size;
   static PStatCollector _texture_read_pcollector;
   static PStatCollector _texture_write_pcollector;
 
@@ -1136,6 +1170,7 @@ private:
 };
 
 extern EXPCL_PANDA_GOBJ ConfigVariableEnum<Texture::QualityLevel> texture_quality_level;
+extern EXPCL_PANDA_GOBJ ConfigVariableInt64 max_resident_texture_ram;
 
 EXPCL_PANDA_GOBJ std::ostream &operator << (std::ostream &out, Texture::TextureType tt);
 EXPCL_PANDA_GOBJ std::ostream &operator << (std::ostream &out, Texture::ComponentType ct);
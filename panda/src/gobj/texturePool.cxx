@@ -239,7 +239,9 @@ get_global_ptr() {
  * supposed to be one TexturePool in the universe and it constructs itself.
  */
 TexturePool::
-TexturePool() {
+TexturePool() :
+  _loading_cvar(_lock)
+{
   ConfigVariableFilename fake_texture_image
     ("fake-texture-image", "",
      PRC_DESC("Set this to enable a speedy-load mode in which you don't care "
@@ -345,11 +347,9 @@ ns_load_texture(const Filename &orig_filename, int primary_file_num_channels,
     MutexHolder holder(_lock);
     resolve_filename(key._fullpath, orig_filename, read_mipmaps, options);
 
-    Textures::const_iterator ti;
-    ti = _textures.find(key);
-    if (ti != _textures.end()) {
+    Texture *tex = find_or_claim(key);
+    if (tex != nullptr) {
       // This texture was previously loaded.
-      Texture *tex = (*ti).second;
       nassertr(!tex->get_fullpath().empty(), tex);
       return tex;
     }
@@ -391,6 +391,8 @@ ns_load_texture(const Filename &orig_filename, int primary_file_num_channels,
         // No such file.
         gobj_cat.error()
           << "Could not find " << key._fullpath << "\n";
+        MutexHolder holder(_lock);
+        release_claim(key);
         return nullptr;
       }
 
@@ -404,6 +406,8 @@ ns_load_texture(const Filename &orig_filename, int primary_file_num_channels,
       vfs->close_read_file(in);
 
       if (tex == nullptr) {
+        MutexHolder holder(_lock);
+        release_claim(key);
         return nullptr;
       }
       tex->set_fullpath(key._fullpath);
@@ -417,6 +421,8 @@ ns_load_texture(const Filename &orig_filename, int primary_file_num_channels,
                      0, 0, false, read_mipmaps, record, options)) {
         // This texture was not found or could not be read.
         report_texture_unreadable(key._fullpath);
+        MutexHolder holder(_lock);
+        release_claim(key);
         return nullptr;
       }
     }
@@ -456,9 +462,10 @@ ns_load_texture(const Filename &orig_filename, int primary_file_num_channels,
 
   {
     MutexHolder holder(_lock);
+    release_claim(key);
 
-    // Now look again--someone may have just loaded this texture in another
-    // thread.
+    // Now look again--someone may have just added this texture with
+    // add_texture() in another thread.
     Textures::const_iterator ti;
     ti = _textures.find(key);
     if (ti != _textures.end()) {
@@ -482,6 +489,10 @@ ns_load_texture(const Filename &orig_filename, int primary_file_num_channels,
     tex->clear_ram_image();
   }
 
+  // If we're keeping the RAM image, it counts against
+  // max-resident-texture-ram.
+  tex->update_ram_image_lru();
+
   nassertr(!tex->get_fullpath().empty(), tex);
 
   // Finally, apply any post-loading texture filters.
@@ -512,11 +523,9 @@ ns_load_texture(const Filename &orig_filename,
     resolve_filename(key._fullpath, orig_filename, read_mipmaps, options);
     resolve_filename(key._alpha_fullpath, orig_alpha_filename, read_mipmaps, options);
 
-    Textures::const_iterator ti;
-    ti = _textures.find(key);
-    if (ti != _textures.end()) {
+    Texture *tex = find_or_claim(key);
+    if (tex != nullptr) {
       // This texture was previously loaded.
-      Texture *tex = (*ti).second;
       nassertr(!tex->get_fullpath().empty(), tex);
       return tex;
     }
@@ -550,6 +559,8 @@ ns_load_texture(const Filename &orig_filename,
                    options)) {
       // This texture was not found or could not be read.
       report_texture_unreadable(key._fullpath);
+      MutexHolder holder(_lock);
+      release_claim(key);
       return nullptr;
     }
 
@@ -590,6 +601,7 @@ ns_load_texture(const Filename &orig_filename,
 
   {
     MutexHolder holder(_lock);
+    release_claim(key);
 
     // Now look again.
     Textures::const_iterator ti;
@@ -615,6 +627,10 @@ ns_load_texture(const Filename &orig_filename,
     tex->clear_ram_image();
   }
 
+  // If we're keeping the RAM image, it counts against
+  // max-resident-texture-ram.
+  tex->update_ram_image_lru();
+
   nassertr(!tex->get_fullpath().empty(), tex);
 
   // Finally, apply any post-loading texture filters.
@@ -722,6 +738,10 @@ ns_load_3d_texture(const Filename &filename_pattern,
     cache->store(record);
   }
 
+  // If we're keeping the RAM image, it counts against
+  // max-resident-texture-ram.
+  tex->update_ram_image_lru();
+
   nassertr(!tex->get_fullpath().empty(), tex);
   apply_texture_attributes(tex, options, sampler);
   return tex;
@@ -824,6 +844,10 @@ ns_load_2d_texture_array(const Filename &filename_pattern,
     cache->store(record);
   }
 
+  // If we're keeping the RAM image, it counts against
+  // max-resident-texture-ram.
+  tex->update_ram_image_lru();
+
   nassertr(!tex->get_fullpath().empty(), tex);
   apply_texture_attributes(tex, options, sampler);
   return tex;
@@ -926,6 +950,10 @@ ns_load_cube_map(const Filename &filename_pattern, bool read_mipmaps,
     cache->store(record);
   }
 
+  // If we're keeping the RAM image, it counts against
+  // max-resident-texture-ram.
+  tex->update_ram_image_lru();
+
   nassertr(!tex->get_fullpath().empty(), tex);
   apply_texture_attributes(tex, options, sampler);
   return tex;
@@ -1216,6 +1244,50 @@ ns_make_texture(const string &extension) const {
   return new Texture;
 }
 
+/**
+ * Looks up the texture with the indicated key in the pool.  If it is not
+ * there, but another thread is already loading it, waits for that load to
+ * finish and looks again.  Returns the texture if it was found.  Otherwise,
+ * marks the key as being loaded by this thread and returns NULL; the caller
+ * must then call release_claim() when it is done loading.
+ *
+ * Assumes _lock is held.
+ */
+Texture *TexturePool::
+find_or_claim(const LookupKey &key) {
+  while (true) {
+    Textures::const_iterator ti;
+    ti = _textures.find(key);
+    if (ti != _textures.end()) {
+      return (*ti).second;
+    }
+
+    if (_loading.insert(key).second) {
+      return nullptr;
+    }
+
+    // Someone else is loading this texture.  Wait for them to finish.
+    if (gobj_cat.is_debug()) {
+      gobj_cat.debug()
+        << "Waiting for another thread to load " << key._fullpath << "\n";
+    }
+    _loading_cvar.wait();
+  }
+}
+
+/**
+ * Indicates that this thread is done loading the texture with the indicated
+ * key, which was claimed by an earlier call to find_or_claim(), and wakes up
+ * any threads waiting for it.
+ *
+ * Assumes _lock is held.
+ */
+void TexturePool::
+release_claim(const LookupKey &key) {
+  _loading.erase(key);
+  _loading_cvar.notify_all();
+}
+
 /**
  * Searches for the indicated filename along the model path.  If the filename
  * was previously searched for, doesn't search again, as an optimization.
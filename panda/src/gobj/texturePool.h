@@ -22,7 +22,9 @@
 #include "config_gobj.h"
 #include "loaderOptions.h"
 #include "pmutex.h"
+#include "conditionVar.h"
 #include "pmap.h"
+#include "pset.h"
 #include "textureCollection.h"
 
 class TexturePoolFilter;
@@ -220,8 +222,18 @@ private:
     INLINE bool operator < (const LookupKey &other) const;
   };
 
+  Texture *find_or_claim(const LookupKey &key);
+  void release_claim(const LookupKey &key);
+
   typedef pmap<LookupKey, PT(Texture)> Textures;
   Textures _textures;
+
+  // The keys of the textures that are currently being loaded by some thread.
+  // Other threads that want the same texture wait on _loading_cvar for the
+  // load to finish, instead of loading it a second time.
+  typedef pset<LookupKey> LoadingKeys;
+  LoadingKeys _loading;
+  ConditionVar _loading_cvar;
   typedef pmap<Filename, Filename> RelpathLookup;
   RelpathLookup _relpath_lookup;
 
@@ -39,6 +39,8 @@ operator = (const VertexDataBuffer &copy) {
   _size = copy._size;
   _reserved_size = copy._size;
   _block = copy._block;
+  _shared_data = copy._shared_data;
+  _shared_pointer = copy._shared_pointer;
   nassertv(_reserved_size >= _size);
 }
 
@@ -55,6 +57,8 @@ swap(VertexDataBuffer &other) {
   size_t reserved_size = _reserved_size;
 
   _block.swap(other._block);
+  _shared_data.swap(other._shared_data);
+  std::swap(_shared_pointer, other._shared_pointer);
 
   _resident_data = other._resident_data;
   _size = other._size;
@@ -119,8 +123,10 @@ do_unclean_realloc(size_t reserved_size) {
         << this << ".unclean_realloc(" << reserved_size << ")\n";
     }
 
-    // If we're paged out, discard the page.
+    // If we're paged out or shared, discard the page or the shared array.
     _block = nullptr;
+    _shared_data.clear();
+    _shared_pointer = nullptr;
 
     if (_resident_data != nullptr) {
       nassertv(_reserved_size != 0);
@@ -141,6 +147,31 @@ do_unclean_realloc(size_t reserved_size) {
   _size = 0;
 }
 
+/**
+ * Makes the buffer a read-only view of size bytes of the indicated array,
+ * starting at the indicated offset, rather than copying the data.  The
+ * array will not be copied until the buffer is modified, and it must not be
+ * modified by anyone else in the meantime.
+ *
+ * The data must be aligned to MEMORY_HOOK_ALIGNMENT.
+ */
+void VertexDataBuffer::
+share(const CPTA_uchar &source, size_t offset, size_t size) {
+  LightMutexHolder holder(_lock);
+  nassertv(offset + size <= source.size());
+
+  do_unclean_realloc(0);
+  if (size != 0) {
+    const unsigned char *pointer = source.p() + offset;
+    nassertv(((uintptr_t)pointer % MEMORY_HOOK_ALIGNMENT) == 0);
+
+    _shared_data = source;
+    _shared_pointer = pointer;
+    _size = size;
+    _reserved_size = size;
+  }
+}
+
 /**
  * Moves the buffer out of independent memory and puts it on a page in the
  * indicated book.  The buffer may still be directly accessible as long as its
@@ -155,6 +186,20 @@ do_page_out(VertexDataBook &book) {
     // We're already paged out.
     return;
   }
+
+  if (_shared_pointer != nullptr) {
+    // Move the shared data onto a page, so that we may let go of the array
+    // it came from.
+    _block = book.alloc(_size);
+    nassertv(_block != nullptr);
+    unsigned char *pointer = _block->get_pointer(true);
+    nassertv(pointer != nullptr);
+    memcpy(pointer, _shared_pointer, _size);
+
+    _shared_data.clear();
+    _shared_pointer = nullptr;
+    return;
+  }
   nassertv(_resident_data != nullptr);
 
   if (_size == 0) {
@@ -194,9 +239,21 @@ do_page_in() {
     return;
   }
 
-  nassertv(_block != nullptr);
   nassertv(_reserved_size == _size);
 
+  if (_shared_pointer != nullptr) {
+    // Copy on write.
+    _resident_data = (unsigned char *)get_class_type().allocate_array(_size);
+    nassertv(_resident_data != nullptr);
+
+    memcpy(_resident_data, _shared_pointer, _size);
+    _shared_data.clear();
+    _shared_pointer = nullptr;
+    return;
+  }
+
+  nassertv(_block != nullptr);
+
   _resident_data = (unsigned char *)get_class_type().allocate_array(_size);
   nassertv(_resident_data != nullptr);
 
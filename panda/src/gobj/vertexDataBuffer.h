@@ -18,6 +18,7 @@
 #include "vertexDataBook.h"
 #include "vertexDataBlock.h"
 #include "pointerTo.h"
+#include "pta_uchar.h"
 #include "virtualFile.h"
 #include "pStatCollector.h"
 #include "lightMutex.h"
@@ -27,7 +28,7 @@
  * A block of bytes that stores the actual raw vertex data referenced by a
  * GeomVertexArrayData object.
  *
- * At any point, a buffer may be in any of two states:
+ * At any point, a buffer may be in any of three states:
  *
  * independent - the buffer's memory is resident, and owned by the
  * VertexDataBuffer object itself (in _resident_data).  In this state,
@@ -39,6 +40,12 @@
  * memory is considered read-only.  In this state, _reserved_size will always
  * equal _size.
  *
+ * shared - the buffer's memory is a read-only view into some other array,
+ * typically the datagram that it was read from, which it keeps a reference
+ * to (in _shared_data).  In this state, _reserved_size will always equal
+ * _size.  Like a paged buffer, it is copied into independent memory as soon
+ * as it is modified.
+ *
  * VertexDataBuffers start out in independent state.  They get moved to paged
  * state when their owning GeomVertexArrayData objects get evicted from the
  * _independent_lru.  They can get moved back to independent state if they are
@@ -69,6 +76,8 @@ public:
 
   INLINE void page_out(VertexDataBook &book);
 
+  void share(const CPTA_uchar &source, size_t offset, size_t size);
+
   void swap(VertexDataBuffer &other);
 
 private:
@@ -82,6 +91,8 @@ private:
   size_t _size;
   size_t _reserved_size;
   PT(VertexDataBlock) _block;
+  CPTA_uchar _shared_data;
+  const unsigned char *_shared_pointer;
   LightMutex _lock;
 
 public:
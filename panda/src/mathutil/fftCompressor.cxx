@@ -19,6 +19,8 @@
 #include "datagramIterator.h"
 #include "compose_matrix.h"
 #include "pmap.h"
+#include "lightMutex.h"
+#include "lightMutexHolder.h"
 #include <math.h>
 
 #ifdef HAVE_FFTW
@@ -40,6 +42,9 @@ typedef pmap<int, fftw_plan> RealPlans;
 static RealPlans _real_compress_plans;
 static RealPlans _real_decompress_plans;
 
+// FFTW's planner is not thread-safe, but executing a plan is.
+static LightMutex _plans_lock("FFTCompressor::_plans_lock");
+
 #endif
 
 /**
@@ -1053,6 +1058,7 @@ get_compressability(const PN_stdfloat *data, int length) const {
  */
 static fftw_plan
 get_real_compress_plan(int length) {
+  LightMutexHolder holder(_plans_lock);
   RealPlans::iterator pi;
   pi = _real_compress_plans.find(length);
   if (pi != _real_compress_plans.end()) {
@@ -1072,6 +1078,7 @@ get_real_compress_plan(int length) {
  */
 static fftw_plan
 get_real_decompress_plan(int length) {
+  LightMutexHolder holder(_plans_lock);
   RealPlans::iterator pi;
   pi = _real_decompress_plans.find(length);
   if (pi != _real_decompress_plans.end()) {
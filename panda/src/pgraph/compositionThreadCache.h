@@ -0,0 +1,74 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file compositionThreadCache.h
+ * @author agent
+ * @date 2026-10-16
+ */
+
+#ifndef COMPOSITIONTHREADCACHE_H
+#define COMPOSITIONTHREADCACHE_H
+
+#include "pandabase.h"
+#include "pointerTo.h"
+#include "stl_compares.h"
+#include "patomic.h"
+
+// There is only any point to this when there are real threads that can
+// contend for the states lock.  With simple threads, all of the threads would
+// end up sharing the same cache, which is not safe.
+#if defined(HAVE_THREADS) && !defined(SIMPLE_THREADS)
+#define HAVE_COMPOSITION_THREAD_CACHE 1
+#endif
+
+/**
+ * A small, fixed-size cache of recent compose() and invert_compose() results,
+ * of which each thread keeps its own copy.  TransformState and RenderState
+ * consult it before grabbing the global states lock, so that a thread that
+ * keeps repeating the same compositions (as the cull traversal tends to do)
+ * need not wait for the other threads at all.
+ *
+ * Each entry holds a reference to both operands as well as to the result, so
+ * that a pointer in the cache can never be recycled for a different state
+ * while it is still in the cache.  This does mean that up to three states per
+ * entry may be kept alive longer than they would otherwise be.  To bound
+ * this, flush_all() marks the caches of all threads stale; each thread drops
+ * its cached states the next time it consults its cache.
+ */
+template<class State>
+class CompositionThreadCache {
+public:
+  INLINE const State *lookup(const State *a, const State *b, bool invert);
+  INLINE void store(const State *a, const State *b, bool invert,
+                    const State *result);
+  INLINE void clear();
+
+  INLINE static void flush_all();
+
+private:
+  INLINE static size_t get_index(const State *a, const State *b, bool invert);
+
+  static const size_t num_entries = 256;
+
+  class Entry {
+  public:
+    CPT(State) _a;
+    CPT(State) _b;
+    CPT(State) _result;
+    bool _invert = false;
+  };
+  Entry _entries[num_entries];
+
+  // The value of _global_epoch when this cache was last cleared.
+  unsigned int _epoch = 0;
+  static patomic<unsigned int> _global_epoch;
+};
+
+#include "compositionThreadCache.I"
+
+#endif
@@ -133,6 +133,25 @@ ConfigVariableBool debug_portal_cull
           "(You first need to enable portal culling, using the allow-portal-cull"
           "variable.)"));
 
+ConfigVariableInt cull_num_threads
+("cull-num-threads", 0,
+ PRC_DESC("The number of threads that may be used to help out the cull "
+          "thread with its traversal of the scene graph.  When this is "
+          "greater than 0, the subtrees found at cull-parallel-depth are "
+          "divided up between the cull thread and up to this many threads "
+          "of the task manager's \"parallel\" task chain (see "
+          "parallel-task-threads), and the results are merged back in scene graph order before they "
+          "are added to the bins.  Set this to 0 to cull everything on the "
+          "cull thread alone.  This is experimental; any cull callbacks in "
+          "the scene graph must be safe to call from multiple threads."));
+
+ConfigVariableInt cull_parallel_depth
+("cull-parallel-depth", 1,
+ PRC_DESC("The depth in the scene graph, counting from the scene root, at "
+          "which the cull traversal is split up between threads when "
+          "cull-num-threads is nonzero.  The children of each node found at "
+          "this depth are handed out to the available threads."));
+
 ConfigVariableBool show_occluder_volumes
 ("show-occluder-volumes", false,
  PRC_DESC("Set this true to enable debug visualization of the volumes used "
@@ -207,6 +226,18 @@ ConfigVariableDouble garbage_collect_states_rate
           "performance if states accumulate faster than they can be "
           "cleaned up."));
 
+ConfigVariableDouble garbage_collect_states_budget
+("garbage-collect-states-budget", 0.0,
+ PRC_DESC("If this is nonzero, it specifies the maximum amount of time, in "
+          "seconds, that each garbage collection step of the TransformState "
+          "or RenderState cache may take.  When the time runs out, the step "
+          "ends early, and the next step continues where it left off.  The "
+          "states that were created since the previous step are visited "
+          "first, since most short-lived states are found there, but they "
+          "may use up only half of the budget, so that the sweep through the "
+          "older states always makes progress as well.  Set this to 0 to "
+          "place no limit on the collection time."));
+
 ConfigVariableBool transform_cache
 ("transform-cache", true,
  PRC_DESC("Set this true to enable the cache of TransformState objects.  "
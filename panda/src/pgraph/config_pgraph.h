@@ -34,6 +34,8 @@ extern EXPCL_PANDA_PGRAPH ConfigVariableBool fake_view_frustum_cull;
 extern ConfigVariableBool clip_plane_cull;
 extern ConfigVariableBool allow_portal_cull;
 extern ConfigVariableBool debug_portal_cull;
+extern ConfigVariableInt cull_num_threads;
+extern ConfigVariableInt cull_parallel_depth;
 extern ConfigVariableBool show_occluder_volumes;
 extern ConfigVariableBool unambiguous_graph;
 extern ConfigVariableBool detect_graph_cycles;
@@ -45,6 +47,7 @@ extern ConfigVariableBool paranoid_const;
 extern ConfigVariableBool auto_break_cycles;
 extern EXPCL_PANDA_PGRAPH ConfigVariableBool garbage_collect_states;
 extern ConfigVariableDouble garbage_collect_states_rate;
+extern ConfigVariableDouble garbage_collect_states_budget;
 extern ConfigVariableBool transform_cache;
 extern ALIGN_16BYTE EXPCL_PANDA_PGRAPH ConfigVariableBool state_cache;
 extern ConfigVariableBool uniquify_transforms;
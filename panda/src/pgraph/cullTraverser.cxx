@@ -35,6 +35,8 @@
 #include "geomLinestrips.h"
 #include "geomLines.h"
 #include "geomVertexWriter.h"
+#include "asyncTaskManager.h"
+#include "patomic.h"
 
 PStatCollector CullTraverser::_nodes_pcollector("Nodes");
 PStatCollector CullTraverser::_geom_nodes_pcollector("Nodes:GeomNodes");
@@ -44,6 +46,52 @@ PStatCollector CullTraverser::_geoms_occluded_pcollector("Geoms:Occluded");
 
 TypeHandle CullTraverser::_type_handle;
 
+/**
+ * The state shared between the threads cooperating on a single call to
+ * parallel_traverse_below().  This is reference-counted, since a worker task
+ * may not get around to starting until after the cull thread has already
+ * finished all of the work by itself and moved on.
+ */
+class CullTraverser::ParallelJob : public ReferenceCount {
+public:
+  explicit ParallelJob(size_t num_children) :
+    _results(num_children), _levels(num_children) {}
+
+  // These may only be accessed by a thread that has claimed a child.
+  const CullTraverser *_trav;
+  const CullTraverserData *_data;
+  PandaNode::Children _children;
+  int _pipeline_stage;
+
+  // The objects recorded for each child, in the order they were found.
+  pvector<pvector<CullableObject *> > _results;
+
+  // The PStats levels counted while traversing each child.
+  pvector<LevelCounts> _levels;
+
+  patomic<size_t> _next_child {0};
+  patomic_unsigned_lock_free _num_done {0};
+};
+
+/**
+ * A CullHandler that just holds on to the objects recorded for one child of a
+ * parallel traversal, so that they can be passed on to the real CullHandler
+ * later, in scene graph order.
+ */
+class DeferredCullHandler final : public CullHandler {
+public:
+  explicit DeferredCullHandler(pvector<CullableObject *> &objects) :
+    _objects(objects) {}
+
+  virtual void record_object(CullableObject *object,
+                             const CullTraverser *traverser) override {
+    _objects.push_back(object);
+  }
+
+private:
+  pvector<CullableObject *> &_objects;
+};
+
 /**
  *
  */
@@ -57,7 +105,9 @@ CullTraverser() :
   _initial_state(RenderState::make_empty()),
   _cull_handler(nullptr),
   _portal_clipper(nullptr),
-  _effective_incomplete_render(false)
+  _effective_incomplete_render(false),
+  _parallel_depth(-1),
+  _deferred_levels(nullptr)
 {
 }
 
@@ -77,7 +127,9 @@ CullTraverser(const CullTraverser &copy) :
   _view_frustum(copy._view_frustum),
   _cull_handler(copy._cull_handler),
   _portal_clipper(copy._portal_clipper),
-  _effective_incomplete_render(copy._effective_incomplete_render)
+  _effective_incomplete_render(copy._effective_incomplete_render),
+  _parallel_depth(-1),
+  _deferred_levels(nullptr)
 {
 }
 
@@ -107,6 +159,15 @@ set_scene(SceneSetup *scene_setup, GraphicsStateGuardianBase *gsg,
 #ifndef NDEBUG
   _fake_view_frustum_cull = fake_view_frustum_cull;
 #endif
+
+  // Only a plain CullTraverser may split its traversal up between threads;
+  // specialized traversers keep additional state that we can't copy.
+  _parallel_depth = -1;
+  if (cull_num_threads > 0 && Thread::is_threading_supported() &&
+      !allow_portal_cull && !_fake_view_frustum_cull &&
+      get_type() == CullTraverser::get_class_type()) {
+    _parallel_depth = cull_parallel_depth;
+  }
 }
 
 /**
@@ -228,16 +289,23 @@ do_traverse(CullTraverserData &data) {
     }
   }
 
-  _nodes_pcollector.add_level(1);
+  add_level(_nodes_pcollector, 1);
 
   // Now visit all the node's children.
   PandaNode::Children children = node_reader->get_children();
   node_reader->release();
   int num_children = children.get_num_children();
+  if (_parallel_depth == 0 && num_children > 1) {
+    parallel_traverse_below(data, children);
+    return;
+  }
+
+  --_parallel_depth;
   for (int i = 0; i < num_children; ++i) {
     const PandaNode::DownConnection &child = children.get_child_connection(i);
     traverse_down(data, child, data._state);
   }
+  ++_parallel_depth;
 }
 
 /**
@@ -258,7 +326,7 @@ draw_bounding_volume(const BoundingVolume *vol,
   PT(Geom) bounds_viz = make_bounds_viz(vol);
 
   if (bounds_viz != nullptr) {
-    _geoms_pcollector.add_level(2);
+    add_level(_geoms_pcollector, 2);
     CullableObject *outer_viz =
       new CullableObject(bounds_viz, get_bounds_outer_viz_state(),
                          internal_transform);
@@ -296,6 +364,140 @@ do_fake_cull(const CullTraverserData &data, PandaNode *child,
 #endif
 }
 
+/**
+ * Traverses all of the given children of the node, as do_traverse() would,
+ * but divides them up between the current thread and the threads of the task
+ * manager's "parallel" task chain.  The objects found in each child's subtree
+ * are passed to the cull handler in the same order as they would have been by
+ * a serial traversal, after all of the children have been traversed.
+ */
+void CullTraverser::
+parallel_traverse_below(CullTraverserData &data,
+                        const PandaNode::Children &children) {
+  size_t num_children = children.get_num_children();
+
+  PT(ParallelJob) job = new ParallelJob(num_children);
+  job->_trav = this;
+  job->_data = &data;
+  job->_children = children;
+  job->_pipeline_stage = _current_thread->get_pipeline_stage();
+
+  AsyncTaskChain *chain = AsyncTaskManager::get_global_ptr()->get_parallel_chain();
+  int num_threads = std::min((int)cull_num_threads, chain->get_num_threads());
+
+  // The current thread pitches in too, so we need one task fewer than we
+  // have children.
+  size_t num_tasks = std::min((size_t)std::max(num_threads, 0), num_children - 1);
+  for (size_t ti = 0; ti < num_tasks; ++ti) {
+    chain->add([job](AsyncTask *task) {
+      do_parallel_job(job);
+      return AsyncTask::DS_done;
+    }, "cull");
+  }
+
+  do_parallel_job(job);
+
+  // Wait for the other threads to finish the children they have claimed.
+  uint32_t num_done = job->_num_done.load(std::memory_order_acquire);
+  while (num_done < num_children) {
+    job->_num_done.wait(num_done, std::memory_order_acquire);
+    num_done = job->_num_done.load(std::memory_order_acquire);
+  }
+
+  for (pvector<CullableObject *> &objects : job->_results) {
+    for (CullableObject *object : objects) {
+      _cull_handler->record_object(object, this);
+    }
+  }
+
+  for (const LevelCounts &levels : job->_levels) {
+    for (const LevelCounts::value_type &level : levels) {
+      add_level(*level.first, level.second);
+    }
+  }
+}
+
+/**
+ * Claims and traverses children of the given job until none are left.  Runs
+ * on any of the threads taking part in a parallel traversal.
+ */
+void CullTraverser::
+do_parallel_job(ParallelJob *job) {
+  size_t num_children = job->_results.size();
+  size_t i = job->_next_child.fetch_add(1);
+  if (i >= num_children) {
+    // Someone else has already taken care of everything.
+    return;
+  }
+
+  // The worker threads must look at the same pipeline stage as the cull
+  // thread that started the job.
+  Thread *current_thread = Thread::get_current_thread();
+  int pipeline_stage = current_thread->get_pipeline_stage();
+  if (pipeline_stage != job->_pipeline_stage) {
+    current_thread->set_pipeline_stage(job->_pipeline_stage);
+  }
+
+  // Each thread gets its own copy of the traverser.  The copy will not try
+  // to split up the traversal further.
+  CullTraverser trav(*job->_trav);
+  trav._current_thread = current_thread;
+  const CullTraverserData &data = *job->_data;
+
+  do {
+    DeferredCullHandler cull_handler(job->_results[i]);
+    trav._cull_handler = &cull_handler;
+    trav._deferred_levels = &job->_levels[i];
+
+    // This is equivalent to traverse_down(), except that the new node reader
+    // is created for this thread rather than the one that made the parent.
+    const PandaNode::DownConnection &child = job->_children.get_child_connection(i);
+    int result = data.is_child_in_view(child, trav._camera_mask);
+    if (result != BoundingVolume::IF_no_intersection) {
+      PandaNodePipelineReader node_reader(child.get_child(), current_thread);
+
+      GeometricBoundingVolume *view_frustum = nullptr;
+      if ((result & BoundingVolume::IF_all) == 0 && !node_reader.is_final()) {
+        view_frustum = data._view_frustum;
+      }
+
+      CullTraverserData next_data(data, std::move(node_reader),
+                                  data._net_transform, data._state,
+                                  view_frustum);
+
+      if (data._cull_planes == nullptr ||
+          next_data.apply_cull_planes(data._cull_planes, child.get_bounds())) {
+        trav.do_traverse(next_data);
+      }
+    }
+
+    if (job->_num_done.fetch_add(1, std::memory_order_release) + 1 == num_children) {
+      job->_num_done.notify_all();
+    }
+
+    i = job->_next_child.fetch_add(1);
+  } while (i < num_children);
+
+  if (pipeline_stage != job->_pipeline_stage) {
+    current_thread->set_pipeline_stage(pipeline_stage);
+  }
+}
+
+/**
+ * Called by add_level() on the helper traversers of a parallel traversal to
+ * record the increment, to be added to the collector by the cull thread.
+ */
+void CullTraverser::
+defer_level(PStatCollector &collector, double increment) const {
+  for (LevelCounts::value_type &level : *_deferred_levels) {
+    if (level.first == &collector) {
+      level.second += increment;
+      return;
+    }
+  }
+  _deferred_levels->push_back(LevelCounts::value_type(&collector, increment));
+}
+
 /**
  * Draws an appropriate visualization of the node's external bounding volume.
  */
@@ -308,7 +510,7 @@ show_bounds(CullTraverserData &data, bool tight) {
     PT(Geom) bounds_viz = make_tight_bounds_viz(node);
 
     if (bounds_viz != nullptr) {
-      _geoms_pcollector.add_level(1);
+      add_level(_geoms_pcollector, 1);
       CullableObject *outer_viz =
         new CullableObject(std::move(bounds_viz), get_bounds_outer_viz_state(),
                            internal_transform);
@@ -112,7 +112,16 @@ public:
   static PStatCollector _geoms_pcollector;
   static PStatCollector _geoms_occluded_pcollector;
 
+  INLINE void add_level(PStatCollector &collector, double increment) const;
+
 private:
+  class ParallelJob;
+  typedef pvector<std::pair<PStatCollector *, double> > LevelCounts;
+
+  void parallel_traverse_below(CullTraverserData &data,
+                               const PandaNode::Children &children);
+  static void do_parallel_job(ParallelJob *job);
+  void defer_level(PStatCollector &collector, double increment) const;
   void show_bounds(CullTraverserData &data, bool tight);
   static PT(Geom) make_bounds_viz(const BoundingVolume *vol);
   PT(Geom) make_tight_bounds_viz(PandaNode *node) const;
@@ -134,6 +143,8 @@ private:
   CullHandler *_cull_handler;
   PortalClipper *_portal_clipper;
   bool _effective_incomplete_render;
+  int _parallel_depth;
+  LevelCounts *_deferred_levels;
 
 public:
   static TypeHandle get_class_type() {
@@ -514,7 +514,7 @@ calc_tight_bounds(LPoint3 &min_point, LPoint3 &max_point, bool &found_any,
  */
 void GeomNode::
 add_for_draw(CullTraverser *trav, CullTraverserData &data) {
-  trav->_geom_nodes_pcollector.add_level(1);
+  trav->add_level(trav->_geom_nodes_pcollector, 1);
 
   if (pgraph_cat.is_spam()) {
     pgraph_cat.spam()
@@ -527,7 +527,7 @@ add_for_draw(CullTraverser *trav, CullTraverserData &data) {
   // Get all the Geoms, with no decalling.
   Geoms geoms = get_geoms(current_thread);
   int num_geoms = geoms.get_num_geoms();
-  trav->_geoms_pcollector.add_level(num_geoms);
+  trav->add_level(trav->_geoms_pcollector, num_geoms);
   CPT(TransformState) internal_transform = data.get_internal_transform(trav);
 
   if (num_geoms == 1) {
@@ -36,6 +36,9 @@ using std::string;
 
 bool Loader::_file_types_loaded = false;
 PT(Loader) Loader::_global_ptr;
+Loader::LoadingFiles Loader::_loading_files;
+Mutex Loader::_loading_lock("Loader::_loading_lock");
+ConditionVar Loader::_loading_cvar(Loader::_loading_lock);
 TypeHandle Loader::_type_handle;
 
 /**
@@ -277,13 +280,16 @@ load_file(const Filename &filename, const LoaderOptions &options) const {
 PT(PandaNode) Loader::
 try_load_file(const Filename &pathname, const LoaderOptions &options,
               LoaderFileType *requested_type) const {
-  BamCache *cache = BamCache::get_global_ptr();
-
   bool allow_ram_cache =
     ((options.get_flags() & LoaderOptions::LF_no_ram_cache) == 0);
 
-  if (allow_ram_cache) {
-    // If we're allowing a RAM cache, use the ModelPool to load the file.
+  if (!allow_ram_cache) {
+    return do_load_file(pathname, options, requested_type);
+  }
+
+  // If we're allowing a RAM cache, use the ModelPool to load the file.
+  LoadingKey key(pathname, options);
+  while (true) {
     PT(PandaNode) node = ModelPool::get_model(pathname, true);
     if (node != nullptr) {
       if ((options.get_flags() & LoaderOptions::LF_allow_instance) == 0) {
@@ -296,8 +302,43 @@ try_load_file(const Filename &pathname, const LoaderOptions &options,
       }
       return node;
     }
+
+    MutexHolder holder(_loading_lock);
+    if (_loading_files.insert(key).second) {
+      break;
+    }
+
+    // Another thread is loading this file with the same options right now.
+    // Wait for it to finish, and then look in the ModelPool again.
+    if (loader_cat.is_debug()) {
+      loader_cat.debug()
+        << "Waiting for another thread to load " << pathname << "\n";
+    }
+    while (_loading_files.count(key) != 0) {
+      _loading_cvar.wait();
+    }
   }
 
+  PT(PandaNode) result = do_load_file(pathname, options, requested_type);
+
+  MutexHolder holder(_loading_lock);
+  _loading_files.erase(key);
+  _loading_cvar.notify_all();
+  return result;
+}
+
+/**
+ * The implementation of try_load_file(), after the ModelPool has been
+ * checked.  This loads the file from the on-disk cache or from disk.
+ */
+PT(PandaNode) Loader::
+do_load_file(const Filename &pathname, const LoaderOptions &options,
+             LoaderFileType *requested_type) const {
+  BamCache *cache = BamCache::get_global_ptr();
+
+  bool allow_ram_cache =
+    ((options.get_flags() & LoaderOptions::LF_no_ram_cache) == 0);
+
   bool report_errors = ((options.get_flags() & LoaderOptions::LF_report_errors) != 0 || loader_cat.is_debug());
 
   PT(BamCacheRecord) record;
@@ -23,6 +23,9 @@
 #include "filename.h"
 #include "dSearchPath.h"
 #include "pvector.h"
+#include "pset.h"
+#include "pmutex.h"
+#include "conditionVar.h"
 #include "asyncTaskManager.h"
 #include "asyncTask.h"
 
@@ -104,6 +107,8 @@ private:
   PT(PandaNode) load_file(const Filename &filename, const LoaderOptions &options) const;
   PT(PandaNode) try_load_file(const Filename &pathname, const LoaderOptions &options,
                               LoaderFileType *requested_type) const;
+  PT(PandaNode) do_load_file(const Filename &pathname, const LoaderOptions &options,
+                             LoaderFileType *requested_type) const;
 
   bool save_file(const Filename &filename, const LoaderOptions &options,
                  PandaNode *node) const;
@@ -120,6 +125,30 @@ private:
 
   static PT(Loader) _global_ptr;
 
+  // Identifies a file being loaded with a particular set of LoaderOptions.
+  struct LoadingKey {
+    INLINE LoadingKey(const Filename &pathname, const LoaderOptions &options);
+    INLINE bool operator < (const LoadingKey &other) const;
+
+    Filename _pathname;
+    int _flags;
+    int _texture_flags;
+    int _texture_format;
+    int _texture_compression;
+    int _texture_quality;
+    int _texture_num_views;
+    AutoTextureScale _auto_texture_scale;
+  };
+
+  // The files that are currently being loaded into the ModelPool by some
+  // thread.  Other threads that want the same file with the same options wait
+  // for that load to finish and take the result from the ModelPool, instead
+  // of loading the same file again at the same time.
+  typedef pset<LoadingKey> LoadingFiles;
+  static LoadingFiles _loading_files;
+  static Mutex _loading_lock;
+  static ConditionVar _loading_cvar;
+
 public:
   static TypeHandle get_class_type() {
     return _type_handle;
@@ -32,8 +32,11 @@
 #include "indent.h"
 #include "compareTo.h"
 #include "lightReMutexHolder.h"
+#include "statesLockHolder.h"
+#include "compositionThreadCache.h"
 #include "lightMutexHolder.h"
 #include "thread.h"
+#include "trueClock.h"
 #include "renderAttribRegistry.h"
 
 using std::ostream;
@@ -43,11 +46,16 @@ RenderState::States RenderState::_states;
 const RenderState *RenderState::_empty_state = nullptr;
 UpdateSeq RenderState::_last_cycle_detect;
 size_t RenderState::_garbage_index = 0;
+size_t RenderState::_young_index = 0;
 
 PStatCollector RenderState::_cache_update_pcollector("*:State Cache:Update");
 PStatCollector RenderState::_garbage_collect_pcollector("*:State Cache:Garbage Collect");
 PStatCollector RenderState::_state_compose_pcollector("*:State Cache:Compose State");
 PStatCollector RenderState::_state_invert_pcollector("*:State Cache:Invert State");
+PStatCollector RenderState::_garbage_young_pcollector("Collected states:RenderState:New");
+PStatCollector RenderState::_garbage_old_pcollector("Collected states:RenderState:Old");
+PStatCollector RenderState::_states_contended_pcollector("State cache contention:RenderState");
+patomic<int> RenderState::_states_contended(0);
 PStatCollector RenderState::_node_counter("RenderStates:On nodes");
 PStatCollector RenderState::_cache_counter("RenderStates:Cached");
 PStatCollector RenderState::_state_break_cycles_pcollector("*:State Cache:Break Cycles");
@@ -55,6 +63,10 @@ PStatCollector RenderState::_state_validate_pcollector("*:State Cache:Validate")
 
 CacheStats RenderState::_cache_stats;
 
+#ifdef HAVE_COMPOSITION_THREAD_CACHE
+static thread_local CompositionThreadCache<RenderState> _thread_state_cache;
+#endif
+
 TypeHandle RenderState::_type_handle;
 
 
@@ -356,17 +368,50 @@ compose(const RenderState *other) const {
     return do_compose(other);
   }
 
-  LightReMutexHolder holder(*_states_lock);
+#ifdef HAVE_COMPOSITION_THREAD_CACHE
+  // First check this thread's own cache, which doesn't require the lock.
+  const RenderState *cached = _thread_state_cache.lookup(this, other, false);
+  if (cached != nullptr) {
+    return cached;
+  }
+#endif
 
-  // Is this composition already cached?
+  {
+    StatesLockHolder holder(*_states_lock, _states_contended);
+
+    // Is this composition already cached?
+    int index = _composition_cache.find(other);
+    if (index != -1) {
+      const Composition &comp = _composition_cache.get_data(index);
+      if (comp._result != nullptr) {
+        // Here's the cache!
+        _cache_stats.inc_hits();
+#ifdef HAVE_COMPOSITION_THREAD_CACHE
+        _thread_state_cache.store(this, other, false, comp._result);
+#endif
+        return comp._result;
+      }
+    }
+  }
+
+  // Not in the cache.  Compute a new result without holding the lock, so
+  // that other threads may continue to use the cache in the meantime.
+  CPT(RenderState) result = do_compose(other);
+
+  StatesLockHolder holder(*_states_lock, _states_contended);
+
+  // We have to look again, since another thread may have added an entry
+  // while we weren't holding the lock.
   int index = _composition_cache.find(other);
   if (index != -1) {
     Composition &comp = ((RenderState *)this)->_composition_cache.modify_data(index);
-    if (comp._result == nullptr) {
-      // Well, it wasn't cached already, but we already had an entry (probably
-      // created for the reverse direction), so use the same entry to store
-      // the new result.
-      CPT(RenderState) result = do_compose(other);
+    if (comp._result != nullptr) {
+      // Another thread beat us to it; use its result instead.
+      result = comp._result;
+    } else {
+      // Well, it wasn't cached already, but we already had an entry
+      // (probably created for the reverse direction), so use the same entry
+      // to store the new result.
       comp._result = result;
 
       if (result != (const RenderState *)this) {
@@ -375,9 +420,11 @@ compose(const RenderState *other) const {
         result->cache_ref();
       }
     }
-    // Here's the cache!
     _cache_stats.inc_hits();
-    return comp._result;
+#ifdef HAVE_COMPOSITION_THREAD_CACHE
+    _thread_state_cache.store(this, other, false, result);
+#endif
+    return result;
   }
   _cache_stats.inc_misses();
 
@@ -387,8 +434,6 @@ compose(const RenderState *other) const {
 
   // The cache entry in this object is the only one that indicates the result;
   // the other will be NULL for now.
-  CPT(RenderState) result = do_compose(other);
-
   _cache_stats.add_total_size(1);
   _cache_stats.inc_adds(_composition_cache.is_empty());
 
@@ -411,6 +456,10 @@ compose(const RenderState *other) const {
     // referential leak.)
   }
 
+#ifdef HAVE_COMPOSITION_THREAD_CACHE
+  _thread_state_cache.store(this, other, false, result);
+#endif
+
   _cache_stats.maybe_report("RenderState");
 
   return result;
@@ -445,17 +494,50 @@ invert_compose(const RenderState *other) const {
     return do_invert_compose(other);
   }
 
-  LightReMutexHolder holder(*_states_lock);
+#ifdef HAVE_COMPOSITION_THREAD_CACHE
+  // First check this thread's own cache, which doesn't require the lock.
+  const RenderState *cached = _thread_state_cache.lookup(this, other, true);
+  if (cached != nullptr) {
+    return cached;
+  }
+#endif
+
+  {
+    StatesLockHolder holder(*_states_lock, _states_contended);
+
+    // Is this composition already cached?
+    int index = _invert_composition_cache.find(other);
+    if (index != -1) {
+      const Composition &comp = _invert_composition_cache.get_data(index);
+      if (comp._result != nullptr) {
+        // Here's the cache!
+        _cache_stats.inc_hits();
+#ifdef HAVE_COMPOSITION_THREAD_CACHE
+        _thread_state_cache.store(this, other, true, comp._result);
+#endif
+        return comp._result;
+      }
+    }
+  }
 
-  // Is this composition already cached?
+  // Not in the cache.  Compute a new result without holding the lock, so
+  // that other threads may continue to use the cache in the meantime.
+  CPT(RenderState) result = do_invert_compose(other);
+
+  StatesLockHolder holder(*_states_lock, _states_contended);
+
+  // We have to look again, since another thread may have added an entry
+  // while we weren't holding the lock.
   int index = _invert_composition_cache.find(other);
   if (index != -1) {
     Composition &comp = ((RenderState *)this)->_invert_composition_cache.modify_data(index);
-    if (comp._result == nullptr) {
-      // Well, it wasn't cached already, but we already had an entry (probably
-      // created for the reverse direction), so use the same entry to store
-      // the new result.
-      CPT(RenderState) result = do_invert_compose(other);
+    if (comp._result != nullptr) {
+      // Another thread beat us to it; use its result instead.
+      result = comp._result;
+    } else {
+      // Well, it wasn't cached already, but we already had an entry
+      // (probably created for the reverse direction), so use the same entry
+      // to store the new result.
       comp._result = result;
 
       if (result != (const RenderState *)this) {
@@ -464,9 +546,11 @@ invert_compose(const RenderState *other) const {
         result->cache_ref();
       }
     }
-    // Here's the cache!
     _cache_stats.inc_hits();
-    return comp._result;
+#ifdef HAVE_COMPOSITION_THREAD_CACHE
+    _thread_state_cache.store(this, other, true, result);
+#endif
+    return result;
   }
   _cache_stats.inc_misses();
 
@@ -476,10 +560,9 @@ invert_compose(const RenderState *other) const {
 
   // The cache entry in this object is the only one that indicates the result;
   // the other will be NULL for now.
-  CPT(RenderState) result = do_invert_compose(other);
-
   _cache_stats.add_total_size(1);
   _cache_stats.inc_adds(_invert_composition_cache.is_empty());
+
   ((RenderState *)this)->_invert_composition_cache[other]._result = result;
 
   if (other != this) {
@@ -499,6 +582,10 @@ invert_compose(const RenderState *other) const {
     // referential leak.)
   }
 
+#ifdef HAVE_COMPOSITION_THREAD_CACHE
+  _thread_state_cache.store(this, other, true, result);
+#endif
+
   return result;
 }
 
@@ -821,6 +908,14 @@ get_num_unused_states() {
  */
 int RenderState::
 clear_cache() {
+#ifdef HAVE_COMPOSITION_THREAD_CACHE
+  // The per-thread caches hold references to states as well.  This thread's
+  // cache is emptied right away; the other threads empty theirs the next time
+  // they use them.
+  CompositionThreadCache<RenderState>::flush_all();
+  _thread_state_cache.clear();
+#endif
+
   LightReMutexHolder holder(*_states_lock);
 
   PStatTimer timer(_cache_update_pcollector);
@@ -900,9 +995,9 @@ garbage_collect() {
 
   PStatTimer timer(_garbage_collect_pcollector);
   size_t orig_size = _states.get_num_entries();
+  size_t size = orig_size;
 
   // How many elements to process this pass?
-  size_t size = orig_size;
   size_t num_this_pass = std::max(0, int(size * garbage_collect_states_rate));
   if (num_this_pass <= 0) {
     return num_attribs;
@@ -910,53 +1005,98 @@ garbage_collect() {
 
   bool break_and_uniquify = (auto_break_cycles && uniquify_transforms);
 
-  size_t si = _garbage_index;
-  if (si >= size) {
-    si = 0;
+  // If there is a time budget, we stop as soon as it has been used up, and
+  // continue where we left off at the next call.  We don't look at the clock
+  // after every single state, since that isn't free either.
+  TrueClock *clock = TrueClock::get_global_ptr();
+  double budget = garbage_collect_states_budget;
+  double start_time = (budget > 0.0) ? clock->get_short_time() : 0.0;
+  double stop_time = 0.0;
+  int clock_countdown = 0;
+  auto out_of_time = [&] () {
+    if (stop_time == 0.0 || --clock_countdown > 0) {
+      return false;
+    }
+    clock_countdown = 32;
+    return clock->get_short_time() >= stop_time;
+  };
+
+  // First, visit the states that have been added since the previous pass.
+  // States that are only needed briefly are usually found among these, so
+  // they can be reclaimed right away without scanning through the entire
+  // table, which may take a good many passes if the rate is low.  These may
+  // only use up half of the budget, so that the sweep through the older
+  // states below always gets to make progress too.
+  if (budget > 0.0) {
+    stop_time = start_time + budget * 0.5;
+  }
+  size_t num_young = 0;
+  size_t young_index = std::min(_young_index, size);
+  while (young_index < size && !out_of_time()) {
+    RenderState *state = (RenderState *)_states.get_key(young_index);
+    if (garbage_collect_state(state, break_and_uniquify)) {
+      // The last element was moved into this slot; visit it next.
+      --size;
+      ++num_young;
+    } else {
+      ++young_index;
+    }
   }
 
+  // Then continue the sweep through the entire table, which is what
+  // eventually catches the states that have been around for longer.
+  if (budget > 0.0) {
+    stop_time = start_time + budget;
+    clock_countdown = 0;
+  }
+  size_t num_old = 0;
   num_this_pass = std::min(num_this_pass, size);
-  size_t stop_at_element = (si + num_this_pass) % size;
-
-  do {
-    RenderState *state = (RenderState *)_states.get_key(si);
-    if (break_and_uniquify) {
-      if (state->get_cache_ref_count() > 0 &&
-          state->get_ref_count() == state->get_cache_ref_count()) {
-        // If we have removed all the references to this state not in the
-        // cache, leaving only references in the cache, then we need to
-        // check for a cycle involving this RenderState and break it if it
-        // exists.
-        state->detect_and_break_cycles();
-      }
+  if (num_this_pass > 0) {
+    size_t si = _garbage_index;
+    if (si >= size) {
+      si = 0;
     }
 
-    if (!state->unref_if_one()) {
-      // This state has recently been unreffed to 1 (the one we added when
-      // we stored it in the cache).  Now it's time to delete it.  This is
-      // safe, because we're holding the _states_lock, so it's not possible
-      // for some other thread to find the state in the cache and ref it
-      // while we're doing this.  Also, we've just made sure to unref it to 0,
-      // to ensure that another thread can't get it via a weak pointer.
-
-      state->release_new();
-      state->remove_cache_pointers();
-      state->cache_unref_only();
-      delete state;
+    size_t stop_at_element = (si + num_this_pass) % size;
 
-      // When we removed it from the hash map, it swapped the last element
-      // with the one we just removed.  So the current index contains one we
-      // still need to visit.
-      --size;
-      --si;
-      if (stop_at_element > 0) {
-        --stop_at_element;
+    do {
+      RenderState *state = (RenderState *)_states.get_key(si);
+      if (garbage_collect_state(state, break_and_uniquify)) {
+        ++num_old;
+        if (--size == 0) {
+          si = 0;
+          break;
+        }
+
+        // When we removed it from the hash map, it swapped the last element
+        // with the one we just removed.  So the current index contains one we
+        // still need to visit.
+        --si;
+        if (stop_at_element > 0) {
+          --stop_at_element;
+        }
       }
-    }
 
-    si = (si + 1) % size;
-  } while (si != stop_at_element);
-  _garbage_index = si;
+      si = (si + 1) % size;
+#ifdef HAVE_COMPOSITION_THREAD_CACHE
+      if (si == 0) {
+        // We have swept through the whole table.  States that are only kept
+        // alive by the per-thread caches can be collected in the next sweep,
+        // if the threads let go of them.
+        CompositionThreadCache<RenderState>::flush_all();
+      }
+#endif
+    } while (si != stop_at_element && !out_of_time());
+    _garbage_index = si;
+  }
+
+  // If we ran out of time before we got through all the new states, the rest
+  // of them are left for the next pass.  Any states that were moved out of
+  // that range by the sweep are still found by the sweep later on.
+  _young_index = std::min(young_index, size);
+
+  _garbage_young_pcollector.add_level(num_young);
+  _garbage_old_pcollector.add_level(num_old);
 
   nassertr(_states.get_num_entries() == size, 0);
 
@@ -971,6 +1111,44 @@ garbage_collect() {
   return (int)orig_size - (int)size + num_attribs;
 }
 
+/**
+ * Called by garbage_collect() to delete the indicated state if it is no
+ * longer referenced by anything other than the cache.  Returns true if the
+ * state was deleted, in which case the last element of the _states table has
+ * been moved into its place.
+ *
+ * You must already be holding _states_lock before you call this method.
+ */
+bool RenderState::
+garbage_collect_state(RenderState *state, bool break_and_uniquify) {
+  if (break_and_uniquify) {
+    if (state->get_cache_ref_count() > 0 &&
+        state->get_ref_count() == state->get_cache_ref_count()) {
+      // If we have removed all the references to this state not in the
+      // cache, leaving only references in the cache, then we need to check
+      // for a cycle involving this RenderState and break it if it exists.
+      state->detect_and_break_cycles();
+    }
+  }
+
+  if (state->unref_if_one()) {
+    // It's still in use.
+    return false;
+  }
+
+  // This state has recently been unreffed to 1 (the one we added when we
+  // stored it in the cache).  Now it's time to delete it.  This is safe,
+  // because we're holding the _states_lock, so it's not possible for some
+  // other thread to find the state in the cache and ref it while we're doing
+  // this.  Also, we've just made sure to unref it to 0, to ensure that
+  // another thread can't get it via a weak pointer.
+  state->release_new();
+  state->remove_cache_pointers();
+  state->cache_unref_only();
+  delete state;
+  return true;
+}
+
 /**
  * Completely empties the cache of state + gsg -> munger, for all states and
  * all gsg's.  Normally there is no need to empty this cache.
@@ -1284,7 +1462,7 @@ return_unique(RenderState *state) {
   }
 #endif
 
-  LightReMutexHolder holder(*_states_lock);
+  StatesLockHolder holder(*_states_lock, _states_contended);
 
   if (state->_saved_entry != -1) {
     // This state is already in the cache.
@@ -27,6 +27,7 @@
 #include "geomMunger.h"
 #include "weakPointerTo.h"
 #include "lightReMutex.h"
+#include "patomic.h"
 #include "lightMutex.h"
 #include "deletedChain.h"
 #include "simpleHashMap.h"
@@ -162,6 +163,7 @@ public:
   static void bin_removed(int bin_index);
 
   INLINE static void flush_level();
+  INLINE static void clear_level();
 
 #ifndef CPPPARSER
   template<class AttribType>
@@ -215,6 +217,7 @@ private:
 
   void release_new();
   void remove_cache_pointers();
+  static bool garbage_collect_state(RenderState *state, bool break_and_uniquify);
 
   void determine_bin_index();
   void determine_cull_callback();
@@ -292,6 +295,10 @@ private:
   // cycle.
   static size_t _garbage_index;
 
+  // The states at this index and beyond in _states have been added since the
+  // last garbage collection pass.
+  static size_t _young_index;
+
   static PStatCollector _cache_update_pcollector;
   static PStatCollector _garbage_collect_pcollector;
   static PStatCollector _state_compose_pcollector;
@@ -299,6 +306,14 @@ private:
   static PStatCollector _state_break_cycles_pcollector;
   static PStatCollector _state_validate_pcollector;
 
+  static PStatCollector _garbage_young_pcollector;
+  static PStatCollector _garbage_old_pcollector;
+  static PStatCollector _states_contended_pcollector;
+
+  // Counts the contentions on _states_lock since the last flush_level().  It
+  // is only added to the above collector by the thread that flushes it.
+  static patomic<int> _states_contended;
+
   static PStatCollector _node_counter;
   static PStatCollector _cache_counter;
 
@@ -0,0 +1,46 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file statesLockHolder.h
+ * @author agent
+ * @date 2026-10-16
+ */
+
+#ifndef STATESLOCKHOLDER_H
+#define STATESLOCKHOLDER_H
+
+#include "pandabase.h"
+#include "lightReMutex.h"
+#include "patomic.h"
+
+/**
+ * Similar to LightReMutexHolder, for use with the lock that protects the
+ * global TransformState or RenderState cache.  In addition, when PStats is
+ * compiled in, this counts the number of times that the lock was found to be
+ * held by another thread, as a measure of the contention on the cache.  The
+ * count is kept in an atomic integer, since any thread may take the lock; it
+ * is passed on to PStats by the thread that flushes the collectors.
+ */
+class EXPCL_PANDA_PGRAPH StatesLockHolder {
+public:
+  INLINE StatesLockHolder(LightReMutex &mutex,
+                          patomic<int> &contended_count);
+  StatesLockHolder(const StatesLockHolder &copy) = delete;
+  INLINE ~StatesLockHolder();
+
+  StatesLockHolder &operator = (const StatesLockHolder &copy) = delete;
+
+private:
+#if defined(HAVE_THREADS) || defined(DEBUG_THREADS)
+  LightReMutex *_mutex;
+#endif
+};
+
+#include "statesLockHolder.I"
+
+#endif
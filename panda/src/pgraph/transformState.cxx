@@ -21,8 +21,11 @@
 #include "pStatTimer.h"
 #include "config_pgraph.h"
 #include "lightReMutexHolder.h"
+#include "statesLockHolder.h"
+#include "compositionThreadCache.h"
 #include "lightMutexHolder.h"
 #include "thread.h"
+#include "trueClock.h"
 
 using std::ostream;
 
@@ -32,6 +35,7 @@ CPT(TransformState) TransformState::_identity_state;
 CPT(TransformState) TransformState::_invalid_state;
 UpdateSeq TransformState::_last_cycle_detect;
 size_t TransformState::_garbage_index = 0;
+size_t TransformState::_young_index = 0;
 bool TransformState::_uniquify_matrix = true;
 
 PStatCollector TransformState::_cache_update_pcollector("*:State Cache:Update");
@@ -43,11 +47,19 @@ PStatCollector TransformState::_transform_break_cycles_pcollector("*:State Cache
 PStatCollector TransformState::_transform_new_pcollector("*:State Cache:New");
 PStatCollector TransformState::_transform_validate_pcollector("*:State Cache:Validate");
 PStatCollector TransformState::_transform_hash_pcollector("*:State Cache:Calc Hash");
+PStatCollector TransformState::_garbage_young_pcollector("Collected states:TransformState:New");
+PStatCollector TransformState::_garbage_old_pcollector("Collected states:TransformState:Old");
+PStatCollector TransformState::_states_contended_pcollector("State cache contention:TransformState");
+patomic<int> TransformState::_states_contended(0);
 PStatCollector TransformState::_node_counter("TransformStates:On nodes");
 PStatCollector TransformState::_cache_counter("TransformStates:Cached");
 
 CacheStats TransformState::_cache_stats;
 
+#ifdef HAVE_COMPOSITION_THREAD_CACHE
+static thread_local CompositionThreadCache<TransformState> _thread_transform_cache;
+#endif
+
 TypeHandle TransformState::_type_handle;
 
 /**
@@ -569,16 +581,29 @@ compose(const TransformState *other) const {
     return do_compose(other);
   }
 
-  LightReMutexHolder holder(*_states_lock);
+#ifdef HAVE_COMPOSITION_THREAD_CACHE
+  // First check this thread's own cache, which doesn't require the lock.
+  const TransformState *cached = _thread_transform_cache.lookup(this, other, false);
+  if (cached != nullptr) {
+    return cached;
+  }
+#endif
 
-  // Is this composition already cached?
-  int index = _composition_cache.find(other);
-  if (index != -1) {
-    const Composition &comp = _composition_cache.get_data(index);
-    if (comp._result != nullptr) {
-      // Success!
-      _cache_stats.inc_hits();
-      return comp._result;
+  {
+    StatesLockHolder holder(*_states_lock, _states_contended);
+
+    // Is this composition already cached?
+    int index = _composition_cache.find(other);
+    if (index != -1) {
+      const Composition &comp = _composition_cache.get_data(index);
+      if (comp._result != nullptr) {
+        // Success!
+        _cache_stats.inc_hits();
+#ifdef HAVE_COMPOSITION_THREAD_CACHE
+        _thread_transform_cache.store(this, other, false, comp._result);
+#endif
+        return comp._result;
+      }
     }
   }
 
@@ -587,20 +612,33 @@ compose(const TransformState *other) const {
   // parallelization.
   CPT(TransformState) result = do_compose(other);
 
+  StatesLockHolder holder(*_states_lock, _states_contended);
+
+  // We have to look again, since another thread may have added an entry
+  // while we weren't holding the lock.
+  int index = _composition_cache.find(other);
   if (index != -1) {
     Composition &comp = _composition_cache.modify_data(index);
-    // Well, it wasn't cached already, but we already had an entry (probably
-    // created for the reverse direction), so use the same entry to store
-    // the new result.
-    comp._result = result;
-
-    if (result != (const TransformState *)this) {
-      // See the comments below about the need to up the reference count
-      // only when the result is not the same as this.
-      result->cache_ref();
+    if (comp._result != nullptr) {
+      // Another thread beat us to it; use its result instead.
+      result = comp._result;
+    } else {
+      // Well, it wasn't cached already, but we already had an entry
+      // (probably created for the reverse direction), so use the same entry
+      // to store the new result.
+      comp._result = result;
+
+      if (result != (const TransformState *)this) {
+        // See the comments below about the need to up the reference count
+        // only when the result is not the same as this.
+        result->cache_ref();
+      }
     }
     // Here's the cache!
     _cache_stats.inc_hits();
+#ifdef HAVE_COMPOSITION_THREAD_CACHE
+    _thread_transform_cache.store(this, other, false, result);
+#endif
     return result;
   }
   _cache_stats.inc_misses();
@@ -634,6 +672,10 @@ compose(const TransformState *other) const {
     // referential leak.)
   }
 
+#ifdef HAVE_COMPOSITION_THREAD_CACHE
+  _thread_transform_cache.store(this, other, false, result);
+#endif
+
   _cache_stats.maybe_report("TransformState");
 
   return result;
@@ -676,15 +718,28 @@ invert_compose(const TransformState *other) const {
     return do_invert_compose(other);
   }
 
-  LightReMutexHolder holder(*_states_lock);
+#ifdef HAVE_COMPOSITION_THREAD_CACHE
+  // First check this thread's own cache, which doesn't require the lock.
+  const TransformState *cached = _thread_transform_cache.lookup(this, other, true);
+  if (cached != nullptr) {
+    return cached;
+  }
+#endif
 
-  int index = _invert_composition_cache.find(other);
-  if (index != -1) {
-    const Composition &comp = _invert_composition_cache.get_data(index);
-    if (comp._result != nullptr) {
-      // Success!
-      _cache_stats.inc_hits();
-      return comp._result;
+  {
+    StatesLockHolder holder(*_states_lock, _states_contended);
+
+    int index = _invert_composition_cache.find(other);
+    if (index != -1) {
+      const Composition &comp = _invert_composition_cache.get_data(index);
+      if (comp._result != nullptr) {
+        // Success!
+        _cache_stats.inc_hits();
+#ifdef HAVE_COMPOSITION_THREAD_CACHE
+        _thread_transform_cache.store(this, other, true, comp._result);
+#endif
+        return comp._result;
+      }
     }
   }
 
@@ -693,21 +748,33 @@ invert_compose(const TransformState *other) const {
   // parallelization.
   CPT(TransformState) result = do_invert_compose(other);
 
-  // Is this composition already cached?
+  StatesLockHolder holder(*_states_lock, _states_contended);
+
+  // Is this composition already cached?  We have to look again, since
+  // another thread may have added an entry while we weren't holding the lock.
+  int index = _invert_composition_cache.find(other);
   if (index != -1) {
     Composition &comp = _invert_composition_cache.modify_data(index);
-    // Well, it wasn't cached already, but we already had an entry (probably
-    // created for the reverse direction), so use the same entry to store
-    // the new result.
-    comp._result = result;
-
-    if (result != (const TransformState *)this) {
-      // See the comments below about the need to up the reference count
-      // only when the result is not the same as this.
-      result->cache_ref();
+    if (comp._result != nullptr) {
+      // Another thread beat us to it; use its result instead.
+      result = comp._result;
+    } else {
+      // Well, it wasn't cached already, but we already had an entry
+      // (probably created for the reverse direction), so use the same entry
+      // to store the new result.
+      comp._result = result;
+
+      if (result != (const TransformState *)this) {
+        // See the comments below about the need to up the reference count
+        // only when the result is not the same as this.
+        result->cache_ref();
+      }
     }
     // Here's the cache!
     _cache_stats.inc_hits();
+#ifdef HAVE_COMPOSITION_THREAD_CACHE
+    _thread_transform_cache.store(this, other, true, result);
+#endif
     return result;
   }
   _cache_stats.inc_misses();
@@ -740,6 +807,10 @@ invert_compose(const TransformState *other) const {
     // referential leak.)
   }
 
+#ifdef HAVE_COMPOSITION_THREAD_CACHE
+  _thread_transform_cache.store(this, other, true, result);
+#endif
+
   return result;
 }
 
@@ -1064,6 +1135,14 @@ get_num_unused_states() {
  */
 int TransformState::
 clear_cache() {
+#ifdef HAVE_COMPOSITION_THREAD_CACHE
+  // The per-thread caches hold references to states as well.  This thread's
+  // cache is emptied right away; the other threads empty theirs the next time
+  // they use them.
+  CompositionThreadCache<TransformState>::flush_all();
+  _thread_transform_cache.clear();
+#endif
+
   LightReMutexHolder holder(*_states_lock);
 
   PStatTimer timer(_cache_update_pcollector);
@@ -1139,9 +1218,9 @@ garbage_collect() {
 
   PStatTimer timer(_garbage_collect_pcollector);
   size_t orig_size = _states.get_num_entries();
+  size_t size = orig_size;
 
   // How many elements to process this pass?
-  size_t size = orig_size;
   size_t num_this_pass = std::max(0, int(size * garbage_collect_states_rate));
   if (num_this_pass <= 0) {
     return 0;
@@ -1149,52 +1228,98 @@ garbage_collect() {
 
   bool break_and_uniquify = (auto_break_cycles && uniquify_transforms);
 
-  size_t si = _garbage_index;
-  if (si >= size) {
-    si = 0;
+  // If there is a time budget, we stop as soon as it has been used up, and
+  // continue where we left off at the next call.  We don't look at the clock
+  // after every single state, since that isn't free either.
+  TrueClock *clock = TrueClock::get_global_ptr();
+  double budget = garbage_collect_states_budget;
+  double start_time = (budget > 0.0) ? clock->get_short_time() : 0.0;
+  double stop_time = 0.0;
+  int clock_countdown = 0;
+  auto out_of_time = [&] () {
+    if (stop_time == 0.0 || --clock_countdown > 0) {
+      return false;
+    }
+    clock_countdown = 32;
+    return clock->get_short_time() >= stop_time;
+  };
+
+  // First, visit the states that have been added since the previous pass.
+  // States that are only needed briefly are usually found among these, so
+  // they can be reclaimed right away without scanning through the entire
+  // table, which may take a good many passes if the rate is low.  These may
+  // only use up half of the budget, so that the sweep through the older
+  // states below always gets to make progress too.
+  if (budget > 0.0) {
+    stop_time = start_time + budget * 0.5;
+  }
+  size_t num_young = 0;
+  size_t young_index = std::min(_young_index, size);
+  while (young_index < size && !out_of_time()) {
+    TransformState *state = (TransformState *)_states.get_key(young_index);
+    if (garbage_collect_state(state, break_and_uniquify)) {
+      // The last element was moved into this slot; visit it next.
+      --size;
+      ++num_young;
+    } else {
+      ++young_index;
+    }
   }
 
+  // Then continue the sweep through the entire table, which is what
+  // eventually catches the states that have been around for longer.
+  if (budget > 0.0) {
+    stop_time = start_time + budget;
+    clock_countdown = 0;
+  }
+  size_t num_old = 0;
   num_this_pass = std::min(num_this_pass, size);
-  size_t stop_at_element = (si + num_this_pass) % size;
-
-  do {
-    TransformState *state = (TransformState *)_states.get_key(si);
-    if (break_and_uniquify) {
-      if (state->get_cache_ref_count() > 0 &&
-          state->get_ref_count() == state->get_cache_ref_count()) {
-        // If we have removed all the references to this state not in the
-        // cache, leaving only references in the cache, then we need to
-        // check for a cycle involving this TransformState and break it if
-        // it exists.
-        state->detect_and_break_cycles();
-      }
+  if (num_this_pass > 0) {
+    size_t si = _garbage_index;
+    if (si >= size) {
+      si = 0;
     }
 
-    if (!state->unref_if_one()) {
-      // This state has recently been unreffed to 1 (the one we added when
-      // we stored it in the cache).  Now it's time to delete it.  This is
-      // safe, because we're holding the _states_lock, so it's not possible
-      // for some other thread to find the state in the cache and ref it
-      // while we're doing this.  Also, we've just made sure to unref it to 0,
-      // to ensure that another thread can't get it via a weak pointer.
-      state->release_new();
-      state->remove_cache_pointers();
-      state->cache_unref_only();
-      delete state;
-
-      // When we removed it from the hash map, it swapped the last element
-      // with the one we just removed.  So the current index contains one we
-      // still need to visit.
-      --size;
-      --si;
-      if (stop_at_element > 0) {
-        --stop_at_element;
+    size_t stop_at_element = (si + num_this_pass) % size;
+
+    do {
+      TransformState *state = (TransformState *)_states.get_key(si);
+      if (garbage_collect_state(state, break_and_uniquify)) {
+        ++num_old;
+        if (--size == 0) {
+          si = 0;
+          break;
+        }
+
+        // When we removed it from the hash map, it swapped the last element
+        // with the one we just removed.  So the current index contains one we
+        // still need to visit.
+        --si;
+        if (stop_at_element > 0) {
+          --stop_at_element;
+        }
       }
-    }
 
-    si = (si + 1) % size;
-  } while (si != stop_at_element);
-  _garbage_index = si;
+      si = (si + 1) % size;
+#ifdef HAVE_COMPOSITION_THREAD_CACHE
+      if (si == 0) {
+        // We have swept through the whole table.  States that are only kept
+        // alive by the per-thread caches can be collected in the next sweep,
+        // if the threads let go of them.
+        CompositionThreadCache<TransformState>::flush_all();
+      }
+#endif
+    } while (si != stop_at_element && !out_of_time());
+    _garbage_index = si;
+  }
+
+  // If we ran out of time before we got through all the new states, the rest
+  // of them are left for the next pass.  Any states that were moved out of
+  // that range by the sweep are still found by the sweep later on.
+  _young_index = std::min(young_index, size);
+
+  _garbage_young_pcollector.add_level(num_young);
+  _garbage_old_pcollector.add_level(num_old);
 
   nassertr(_states.get_num_entries() == size, 0);
 
@@ -1209,6 +1334,44 @@ garbage_collect() {
   return (int)orig_size - (int)size;
 }
 
+/**
+ * Called by garbage_collect() to delete the indicated state if it is no
+ * longer referenced by anything other than the cache.  Returns true if the
+ * state was deleted, in which case the last element of the _states table has
+ * been moved into its place.
+ *
+ * You must already be holding _states_lock before you call this method.
+ */
+bool TransformState::
+garbage_collect_state(TransformState *state, bool break_and_uniquify) {
+  if (break_and_uniquify) {
+    if (state->get_cache_ref_count() > 0 &&
+        state->get_ref_count() == state->get_cache_ref_count()) {
+      // If we have removed all the references to this state not in the
+      // cache, leaving only references in the cache, then we need to check
+      // for a cycle involving this TransformState and break it if it exists.
+      state->detect_and_break_cycles();
+    }
+  }
+
+  if (state->unref_if_one()) {
+    // It's still in use.
+    return false;
+  }
+
+  // This state has recently been unreffed to 1 (the one we added when we
+  // stored it in the cache).  Now it's time to delete it.  This is safe,
+  // because we're holding the _states_lock, so it's not possible for some
+  // other thread to find the state in the cache and ref it while we're doing
+  // this.  Also, we've just made sure to unref it to 0, to ensure that
+  // another thread can't get it via a weak pointer.
+  state->release_new();
+  state->remove_cache_pointers();
+  state->cache_unref_only();
+  delete state;
+  return true;
+}
+
 /**
  * Detects all of the reference-count cycles in the cache and reports them to
  * standard output.
@@ -1468,7 +1631,7 @@ return_unique(TransformState *state) {
 
   PStatTimer timer(_transform_new_pcollector);
 
-  LightReMutexHolder holder(*_states_lock);
+  StatesLockHolder holder(*_states_lock, _states_contended);
 
   if (state->_saved_entry != -1) {
     // This state is already in the cache.  nassertr(_states.find(state) ==
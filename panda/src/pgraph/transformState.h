@@ -24,6 +24,7 @@
 #include "pStatCollector.h"
 #include "geomEnums.h"
 #include "lightReMutex.h"
+#include "patomic.h"
 #include "lightReMutexHolder.h"
 #include "lightMutex.h"
 #include "lightMutexHolder.h"
@@ -227,6 +228,7 @@ public:
   static void init_states();
 
   INLINE static void flush_level();
+  INLINE static void clear_level();
 
   INLINE void cache_ref_only() const;
 
@@ -266,6 +268,7 @@ private:
 
   void release_new();
   void remove_cache_pointers();
+  static bool garbage_collect_state(TransformState *state, bool break_and_uniquify);
 
 private:
   // This mutex protects _states.  It also protects any modification to the
@@ -311,6 +314,10 @@ private:
   // cycle.
   static size_t _garbage_index;
 
+  // The states at this index and beyond in _states have been added since the
+  // last garbage collection pass.
+  static size_t _young_index;
+
   static bool _uniquify_matrix;
 
   static PStatCollector _cache_update_pcollector;
@@ -323,6 +330,14 @@ private:
   static PStatCollector _transform_validate_pcollector;
   static PStatCollector _transform_hash_pcollector;
 
+  static PStatCollector _garbage_young_pcollector;
+  static PStatCollector _garbage_old_pcollector;
+  static PStatCollector _states_contended_pcollector;
+
+  // Counts the contentions on _states_lock since the last flush_level().  It
+  // is only added to the above collector by the thread that flushes it.
+  static patomic<int> _states_contended;
+
   static PStatCollector _node_counter;
   static PStatCollector _cache_counter;
 
@@ -195,7 +195,7 @@ draw_mask_changed() {
  */
 bool PGItem::
 cull_callback(CullTraverser *trav, CullTraverserData &data) {
-  CullTraverser::_pgui_nodes_pcollector.add_level(1);
+  trav->add_level(CullTraverser::_pgui_nodes_pcollector, 1);
 
   // We try not to hold the lock for longer than necessary.
   PT(PandaNode) state_def_root;
@@ -202,6 +202,9 @@ static LevelCollectorProperties level_properties[] = {
   { 1, "Vertex Data:Disk",                 { 0.6, 0.9, 0.1 } },
   { 1, "Vertex Data:Disk:Unused",          { 0.8, 0.4, 0.5 } },
   { 1, "Vertex Data:Disk:Used",            { 0.2, 0.1, 0.6 } },
+  { 1, "Texture RAM",                      { 0.4, 0.8, 0.2 },  "MB", 64, 1048576 },
+  { 1, "Texture RAM:Resident",             { 0.9, 1.0, 0.7 } },
+  { 1, "Texture RAM:Evicted",              { 0.5, 0.1, 0.4 } },
   { 1, "TransformStates",                  { 1.0, 0.5, 0.5 },  "", 5000 },
   { 1, "TransformStates:On nodes",         { 0.2, 0.8, 1.0 } },
   { 1, "TransformStates:Cached",           { 1.0, 0.0, 0.2 } },
@@ -26,6 +26,22 @@
 #include "configVariableString.h"
 #include "configVariableFilename.h"
 #include "virtualFileSystem.h"
+#include "configVariableEnum.h"
+#include "zStream.h"
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN 1
+#endif
+#include <windows.h>
+#else
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#ifndef PHAVE_LOCKF
+#include <sys/file.h>
+#endif
+#endif
 
 using std::istream;
 using std::ostream;
@@ -34,6 +50,102 @@ using std::string;
 
 BamCache *BamCache::_global_ptr = nullptr;
 
+/**
+ * Holds an exclusive lock on the index.lock file in the cache directory for
+ * as long as it exists, so that no other process may append to the journal
+ * while this one is folding it into a new index, which would otherwise lose
+ * the appended entries when the old journal is deleted.
+ *
+ * Only the outermost JournalLock on a BamCache takes the lock, since these
+ * may be nested.  If the lock file can't be opened, for instance because the
+ * cache lives on a virtual file system, the cache proceeds without it.
+ */
+class BamCache::JournalLock {
+public:
+  JournalLock(BamCache *cache);
+  ~JournalLock();
+
+private:
+  BamCache *_cache;
+#ifdef _WIN32
+  HANDLE _handle;
+#else
+  int _fd;
+#endif
+};
+
+/**
+ *
+ */
+BamCache::JournalLock::
+JournalLock(BamCache *cache) :
+  _cache(cache),
+#ifdef _WIN32
+  _handle(INVALID_HANDLE_VALUE)
+#else
+  _fd(-1)
+#endif
+{
+  if (_cache->_journal_lock_count++ > 0) {
+    return;
+  }
+
+  Filename lock_pathname(_cache->_root, Filename("index.lock"));
+
+#ifdef _WIN32
+  // A file opened without sharing can't be opened by anyone else until we
+  // close it again.
+  std::wstring os_specific = lock_pathname.to_os_specific_w();
+  _handle = CreateFileW(os_specific.c_str(), GENERIC_READ | GENERIC_WRITE,
+                        0, nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL,
+                        nullptr);
+  while (_handle == INVALID_HANDLE_VALUE &&
+         GetLastError() == ERROR_SHARING_VIOLATION) {
+    Sleep(0);
+    _handle = CreateFileW(os_specific.c_str(), GENERIC_READ | GENERIC_WRITE,
+                          0, nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL,
+                          nullptr);
+  }
+
+#else
+  string os_specific = lock_pathname.to_os_specific();
+  _fd = open(os_specific.c_str(), O_RDWR | O_CREAT, 0666);
+  if (_fd < 0) {
+    return;
+  }
+#ifdef PHAVE_LOCKF
+  while (lockf(_fd, F_LOCK, 0) != 0) {
+#else
+  while (flock(_fd, LOCK_EX) != 0) {
+#endif
+    if (errno != EINTR) {
+      close(_fd);
+      _fd = -1;
+      return;
+    }
+  }
+#endif
+}
+
+/**
+ *
+ */
+BamCache::JournalLock::
+~JournalLock() {
+  --_cache->_journal_lock_count;
+
+  // Closing the file releases the lock.
+#ifdef _WIN32
+  if (_handle != INVALID_HANDLE_VALUE) {
+    CloseHandle(_handle);
+  }
+#else
+  if (_fd >= 0) {
+    close(_fd);
+  }
+#endif
+}
+
 /**
  *
  */
@@ -42,7 +154,11 @@ BamCache() :
   _active(true),
   _read_only(false),
   _index(new BamCacheIndex),
-  _index_stale_since(0)
+  _index_stale_since(0),
+  _num_journal_pending(0),
+  _journal_pos(0),
+  _num_journal_entries(0),
+  _journal_lock_count(0)
 {
   ConfigVariableFilename model_cache_dir
     ("model-cache-dir", Filename(),
@@ -82,17 +198,34 @@ BamCache() :
               "in the model cache, in their binary form as downloaded "
               "by the GSG."));
 
+  ConfigVariableEnum<CompressionAlgorithm> model_cache_compression
+    ("model-cache-compression", CA_none,
+     PRC_DESC("The algorithm with which files written to the model cache are "
+              "compressed: none, zlib, lz4 or zstd.  The cache files are "
+              "read back correctly regardless of this setting."));
+
   ConfigVariableInt model_cache_max_kbytes
     ("model-cache-max-kbytes", 10485760,
      PRC_DESC("This is the maximum size of the model cache, in kilobytes."));
 
+  ConfigVariableInt model_cache_journal_size
+    ("model-cache-journal-size", 1000,
+     PRC_DESC("This is the number of changes to the model-cache index that "
+              "may be appended to the index journal before the whole index "
+              "is rewritten.  Appending to the journal is much cheaper than "
+              "rewriting the index, especially when the cache is large and "
+              "shared by several processes.  Set this to 0 to rewrite the "
+              "index on every flush, without keeping a journal."));
+
   _cache_models = model_cache_models;
   _cache_textures = model_cache_textures;
   _cache_compressed_textures = model_cache_compressed_textures;
   _cache_compiled_shaders = model_cache_compiled_shaders;
+  _compression = model_cache_compression;
 
   _flush_time = model_cache_flush;
   _max_kbytes = model_cache_max_kbytes;
+  _journal_size = model_cache_journal_size;
 
   if (!model_cache_dir.empty()) {
     set_root(model_cache_dir);
@@ -133,6 +266,8 @@ set_root(const Filename &root) {
   delete _index;
   _index = new BamCacheIndex;
   _index_stale_since = 0;
+  _journal_pending.clear();
+  _num_journal_pending = 0;
 
   if (!vfs->is_directory(_root)) {
     util_cat.error()
@@ -223,8 +358,27 @@ store(BamCacheRecord *record) {
   temp_pathname.set_extension(extension);
   temp_pathname.set_binary();
 
+#ifdef HAVE_ZLIB
+  // If the cache is to be compressed, the compressor must outlive the
+  // DatagramOutputFile that writes to it.
+  OCompressStream compress;
+  bool compressed = (_compression != CA_none);
+#else
+  bool compressed = false;
+#endif
+
   DatagramOutputFile dout;
-  if (!dout.open(temp_pathname)) {
+  bool opened = false;
+  if (compressed) {
+#ifdef HAVE_ZLIB
+    ostream *out = vfs->open_write_file(temp_pathname, false, true);
+    opened = (out != nullptr) &&
+      dout.open(compress.open(out, true, 6, true, _compression), temp_pathname);
+#endif
+  } else {
+    opened = dout.open(temp_pathname);
+  }
+  if (!opened) {
     util_cat.error()
       << "Could not write cache file: " << temp_pathname << "\n";
     vfs->delete_file(temp_pathname);
@@ -285,6 +439,16 @@ store(BamCacheRecord *record) {
 
   record->_record_size = dout.get_file_pos();
   dout.close();
+#ifdef HAVE_ZLIB
+  if (compressed) {
+    // The size that counts toward the cache limit is the compressed size.
+    compress.close();
+    PT(VirtualFile) vfile = vfs->get_file(temp_pathname);
+    if (vfile != nullptr) {
+      record->_record_size = vfile->get_file_size();
+    }
+  }
+#endif
 
   // Now move the file into place.
   if (!vfs->rename_file(temp_pathname, cache_pathname) && vfs->exists(temp_pathname)) {
@@ -352,11 +516,41 @@ flush_index() {
     return;
   }
 
+  if (_read_only) {
+    return;
+  }
+
+  if (flush_journal()) {
+    // That was enough; we don't need to rewrite the index this time.
+    _index_stale_since = 0;
+    check_cache_size();
+    return;
+  }
+
+  // Keep the other processes from appending to the journal until we have
+  // replaced the index, or their entries would be lost with the old journal.
+  JournalLock lock(this);
+
   while (true) {
     if (_read_only) {
       return;
     }
 
+    // Our own unwritten changes go into the new index, after whatever the
+    // other processes have journaled in the meantime.
+    if (_journal_size > 0 && !_index_pathname.empty()) {
+      read_journal();
+    }
+    if (_num_journal_pending != 0) {
+      size_t p = 0;
+      size_t q = _journal_pending.find('\n');
+      while (q != string::npos) {
+        apply_journal_line(_journal_pending.substr(p, q - p));
+        p = q + 1;
+        q = _journal_pending.find('\n', p);
+      }
+    }
+
     Filename temp_pathname = Filename::temporary(_root, "index-", ".boo");
 
     if (!do_write_index(temp_pathname, _index)) {
@@ -375,11 +569,18 @@ flush_index() {
     if (vfs->atomic_compare_and_exchange_contents(index_ref_pathname, orig_index, old_index, new_index)) {
       // We successfully wrote our version of the index, and no other process
       // beat us to it.  Our index is now the official one.  Remove the old
-      // index.
+      // index, along with its journal.
+      if (!_index_pathname.empty()) {
+        vfs->delete_file(get_journal_pathname());
+      }
       vfs->delete_file(_index_pathname);
       _index_pathname = temp_pathname;
       _index_ref_contents = new_index;
       _index_stale_since = 0;
+      _journal_pending.clear();
+      _num_journal_pending = 0;
+      _journal_pos = 0;
+      _num_journal_entries = 0;
       return;
     }
 
@@ -417,6 +618,14 @@ read_index() {
     BamCacheIndex *new_index = do_read_index(_index_pathname);
     if (new_index != nullptr) {
       merge_index(new_index);
+
+      // Now bring it up-to-date with whatever has been journaled since it
+      // was written.
+      _journal_pos = 0;
+      _num_journal_entries = 0;
+      if (_journal_size > 0) {
+        read_journal();
+      }
       return;
     }
 
@@ -432,7 +641,9 @@ read_index() {
     if (old_index_pathname == _index_pathname) {
       // Nope, we just couldn't read it.  Delete it and build a new one.
       VirtualFileSystem *vfs = VirtualFileSystem::get_global_ptr();
+      vfs->delete_file(get_journal_pathname());
       vfs->delete_file(_index_pathname);
+      _index_pathname = Filename();
       rebuild_index();
       flush_index();
       return;
@@ -624,6 +835,7 @@ add_to_index(const BamCacheRecord *record) {
   PT(BamCacheRecord) new_record = record->make_copy();
 
   if (_index->add_record(new_record)) {
+    journal_record(new_record);
     mark_index_stale();
     check_cache_size();
   }
@@ -635,10 +847,190 @@ add_to_index(const BamCacheRecord *record) {
 void BamCache::
 remove_from_index(const Filename &source_pathname) {
   if (_index->remove_record(source_pathname)) {
+    journal_removal(source_pathname);
     mark_index_stale();
   }
 }
 
+/**
+ * Returns the name of the journal file that accompanies the current index
+ * file, or the empty filename if there is no current index file.
+ */
+Filename BamCache::
+get_journal_pathname() const {
+  if (_index_pathname.empty()) {
+    return Filename();
+  }
+  Filename journal_pathname = Filename::binary_filename(_index_pathname);
+  journal_pathname.set_extension("log");
+  return journal_pathname;
+}
+
+/**
+ * Queues up a journal entry recording that the indicated record has been
+ * added to the index.  It is written out by the next call to
+ * flush_index().
+ */
+void BamCache::
+journal_record(const BamCacheRecord *record) {
+  if (_journal_size <= 0) {
+    return;
+  }
+
+  ostringstream strm;
+  strm << "a " << record->_record_size << " " << record->_recorded_time
+       << " " << record->_record_access_time
+       << " " << record->get_cache_filename()
+       << " " << record->get_source_pathname() << "\n";
+  _journal_pending += strm.str();
+  ++_num_journal_pending;
+}
+
+/**
+ * Queues up a journal entry recording that the indicated record has been
+ * removed from the index.  It is written out by the next call to
+ * flush_index().
+ */
+void BamCache::
+journal_removal(const Filename &source_pathname) {
+  if (_journal_size <= 0) {
+    return;
+  }
+
+  _journal_pending += "r " + source_pathname.get_fullpath() + "\n";
+  ++_num_journal_pending;
+}
+
+/**
+ * Attempts to write out our pending changes by appending them to the journal
+ * of the current index, and replays the changes that other processes have
+ * appended since we last looked.  Returns true on success, or false if the
+ * index needs to be rewritten instead, either because the journal has grown
+ * too large or because it could not be written.
+ */
+bool BamCache::
+flush_journal() {
+  if (_journal_size <= 0 || _index_pathname.empty()) {
+    return false;
+  }
+
+  // Another process may not replace the index while we are appending to its
+  // journal.
+  JournalLock lock(this);
+
+  // If some other process has rewritten the index in the meantime, we have to
+  // merge with the new one, and append to its journal instead.
+  Filename index_pathname;
+  string index_ref_contents;
+  if (!read_index_pathname(index_pathname, index_ref_contents)) {
+    return false;
+  }
+  if (index_ref_contents != _index_ref_contents) {
+    read_index();
+    if (_index_pathname.empty()) {
+      return false;
+    }
+  }
+
+  if (_num_journal_entries + _num_journal_pending > _journal_size) {
+    // Time to rewrite the index.
+    return false;
+  }
+
+  if (_num_journal_pending != 0) {
+    // The whole lot is written with a single append, so that it doesn't get
+    // interleaved with the entries of another process appending at the same
+    // time.
+    VirtualFileSystem *vfs = VirtualFileSystem::get_global_ptr();
+    ostream *out = vfs->open_append_file(get_journal_pathname());
+    if (out == nullptr) {
+      return false;
+    }
+    out->write(_journal_pending.data(), _journal_pending.size());
+    out->flush();
+    bool success = !out->fail();
+    vfs->close_write_file(out);
+    if (!success) {
+      return false;
+    }
+
+    _journal_pending.clear();
+    _num_journal_pending = 0;
+  }
+
+  // Now read back everything that has been appended since we last looked,
+  // which includes our own entries.  Replaying our own entries again is
+  // harmless, and keeps the index consistent with the order in which the
+  // entries ended up in the journal.
+  read_journal();
+  return true;
+}
+
+/**
+ * Reads the entries that have been appended to the journal of the current
+ * index since the last call, and applies them to the index.
+ */
+void BamCache::
+read_journal() {
+  Filename journal_pathname = get_journal_pathname();
+  if (journal_pathname.empty()) {
+    return;
+  }
+
+  VirtualFileSystem *vfs = VirtualFileSystem::get_global_ptr();
+  istream *in = vfs->open_read_file(journal_pathname, false);
+  if (in == nullptr) {
+    // Nothing has been journaled yet.
+    return;
+  }
+
+  in->seekg(_journal_pos);
+
+  string line;
+  while (std::getline(*in, line) && !in->eof()) {
+    // A line that is not terminated by a newline may still be in the process
+    // of being written; we'll pick it up next time.
+    _journal_pos += line.size() + 1;
+    ++_num_journal_entries;
+    apply_journal_line(line);
+  }
+
+  vfs->close_read_file(in);
+}
+
+/**
+ * Applies a single line of the journal to the index.
+ */
+void BamCache::
+apply_journal_line(const string &line) {
+  if (line.size() < 3 || line[1] != ' ') {
+    return;
+  }
+
+  if (line[0] == 'r') {
+    _index->remove_record(Filename(line.substr(2)));
+
+  } else if (line[0] == 'a') {
+    std::istringstream strm(line.substr(2));
+    uint64_t record_size;
+    time_t recorded_time, record_access_time;
+    string cache_filename, source_pathname;
+    strm >> record_size >> recorded_time >> record_access_time
+         >> cache_filename;
+    if (strm.fail() || strm.get() != ' ' ||
+        !std::getline(strm, source_pathname)) {
+      return;
+    }
+
+    PT(BamCacheRecord) record =
+      new BamCacheRecord(Filename(source_pathname), Filename(cache_filename));
+    record->_record_size = record_size;
+    record->_recorded_time = recorded_time;
+    record->_record_access_time = record_access_time;
+    _index->add_record(record);
+  }
+}
+
 /**
  * If the cache size has exceeded its specified size limit, removes an old
  * file.
@@ -665,6 +1057,7 @@ check_cache_size() {
           << " to keep cache size below " << _max_kbytes << "K\n";
       }
       vfs->delete_file(cache_pathname);
+      journal_removal(record->get_source_pathname());
     }
     mark_index_stale();
   }
@@ -866,6 +1259,12 @@ read_record(const Filename &source_pathname,
  */
 PT(BamCacheRecord) BamCache::
 do_read_record(const Filename &cache_pathname, bool read_data) {
+#ifdef HAVE_ZLIB
+  // This must outlive the DatagramInputFile, if the file is compressed.
+  IDecompressStream decompress;
+#endif
+  bool compressed = false;
+
   DatagramInputFile din;
   if (!din.open(cache_pathname)) {
     if (util_cat.is_debug()) {
@@ -884,6 +1283,27 @@ do_read_record(const Filename &cache_pathname, bool read_data) {
     return nullptr;
   }
 
+#ifdef HAVE_ZLIB
+  if (head != _bam_header &&
+      detect_compression_algorithm(head.data(), head.size()) != CA_none) {
+    // The file was written with model-cache-compression.  Start over,
+    // reading it through a decompressor.
+    din.close();
+    VirtualFileSystem *vfs = VirtualFileSystem::get_global_ptr();
+    istream *in = vfs->open_read_file(cache_pathname, false);
+    if (in == nullptr ||
+        !din.open(decompress.open(in, true), cache_pathname) ||
+        !din.read_header(head, _bam_header.size())) {
+      if (util_cat.is_debug()) {
+        util_cat.debug()
+          << "Could not decompress cache file: " << cache_pathname << "\n";
+      }
+      return nullptr;
+    }
+    compressed = true;
+  }
+#endif  // HAVE_ZLIB
+
   if (head != _bam_header) {
     if (util_cat.is_debug()) {
       util_cat.debug()
@@ -948,10 +1368,18 @@ do_read_record(const Filename &cache_pathname, bool read_data) {
   }
 
   // Also get the total file size.
-  PT(VirtualFile) vfile = din.get_vfile();
-  istream &in = din.get_stream();
-  in.clear();
-  record->_record_size = vfile->get_file_size(&in);
+  if (compressed) {
+    VirtualFileSystem *vfs = VirtualFileSystem::get_global_ptr();
+    PT(VirtualFile) vfile = vfs->get_file(cache_pathname);
+    if (vfile != nullptr) {
+      record->_record_size = vfile->get_file_size();
+    }
+  } else {
+    PT(VirtualFile) vfile = din.get_vfile();
+    istream &in = din.get_stream();
+    in.clear();
+    record->_record_size = vfile->get_file_size(&in);
+  }
 
   // And the last access time is now, duh.
   record->_record_access_time = time(nullptr);
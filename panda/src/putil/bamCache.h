@@ -22,6 +22,7 @@
 #include "pvector.h"
 #include "reMutex.h"
 #include "reMutexHolder.h"
+#include "compressionAlgorithm.h"
 
 #include <time.h>
 
@@ -38,6 +39,13 @@ class BamCacheIndex;
  * multiple different processes writing to the same index, and without relying
  * too heavily on low-level os-provided file locks (which work poorly with C++
  * iostreams).
+ *
+ * Changes to the index are not written out by rewriting the whole index each
+ * time; instead, they are appended to a journal file that accompanies the
+ * index file, and which every process replays when it flushes.  The index
+ * itself is only rewritten once the journal has grown large enough (see
+ * model-cache-journal-size).  Appending to the journal and rewriting the index
+ * are serialized between processes by a lock on the index.lock file.
  */
 class EXPCL_PANDA_PUTIL BamCache {
 PUBLISHED:
@@ -59,6 +67,9 @@ PUBLISHED:
   INLINE void set_cache_compiled_shaders(bool flag);
   INLINE bool get_cache_compiled_shaders() const;
 
+  INLINE void set_compression(CompressionAlgorithm algorithm);
+  INLINE CompressionAlgorithm get_compression() const;
+
   void set_root(const Filename &root);
   INLINE Filename get_root() const;
 
@@ -92,6 +103,7 @@ PUBLISHED:
                                            set_cache_compressed_textures);
   MAKE_PROPERTY(cache_compiled_shaders, get_cache_compiled_shaders,
                                         set_cache_compiled_shaders);
+  MAKE_PROPERTY(compression, get_compression, set_compression);
   MAKE_PROPERTY(root, get_root, set_root);
   MAKE_PROPERTY(flush_time, get_flush_time, set_flush_time);
   MAKE_PROPERTY(cache_max_kbytes, get_cache_max_kbytes, set_cache_max_kbytes);
@@ -108,6 +120,13 @@ private:
   void add_to_index(const BamCacheRecord *record);
   void remove_from_index(const Filename &source_filename);
 
+  Filename get_journal_pathname() const;
+  void journal_record(const BamCacheRecord *record);
+  void journal_removal(const Filename &source_pathname);
+  bool flush_journal();
+  void read_journal();
+  void apply_journal_line(const std::string &line);
+
   void check_cache_size();
 
   void emergency_read_only();
@@ -131,6 +150,7 @@ private:
   bool _cache_textures;
   bool _cache_compressed_textures;
   bool _cache_compiled_shaders;
+  CompressionAlgorithm _compression;
   bool _read_only;
   Filename _root;
   int _flush_time;
@@ -143,6 +163,18 @@ private:
   Filename _index_pathname;
   std::string _index_ref_contents;
 
+  // The journal entries that we have not yet appended to the journal file,
+  // and how far we have read the journal file so far.
+  int _journal_size;
+  std::string _journal_pending;
+  int _num_journal_pending;
+  std::streamoff _journal_pos;
+  int _num_journal_entries;
+
+  // Held while appending to the journal or folding it into a new index.
+  class JournalLock;
+  int _journal_lock_count;
+
   ReMutex _lock;
 };
 
@@ -19,6 +19,8 @@
 #include "datagramIterator.h"
 #include "config_putil.h"
 #include "pipelineCyclerBase.h"
+#include "genericThread.h"
+#include "patomic.h"
 
 using std::string;
 
@@ -57,6 +59,9 @@ BamReader(DatagramGenerator *source)
  */
 BamReader::
 ~BamReader() {
+  // In case resolve() was never called, don't leave the objects undecoded.
+  decode_deferred();
+
   nassertv(_num_extra_objects == 0);
   nassertv(_nesting_level == 0);
 }
@@ -323,6 +328,9 @@ read_object(TypedWritable *&ptr, ReferenceCount *&ref_ptr) {
  */
 bool BamReader::
 resolve() {
+  // Objects may not be completed before they have been fully decoded.
+  decode_deferred();
+
   bool all_completed;
   bool any_completed_this_pass;
 
@@ -796,6 +804,39 @@ get_aux_tag(const string &tag) const {
   return (*ati).second;
 }
 
+/**
+ * May be called by an object reading itself from the Bam file, to request
+ * that the remainder of its datagram be decoded later by the indicated
+ * function, which may happen on another thread.  This is intended for
+ * objects that spend a long time decoding large amounts of data, which does
+ * not depend on any other object.
+ *
+ * The function is called before the object's pointers are completed, the
+ * next time resolve() is called.  It may not call back into the BamReader,
+ * and it may not touch any object other than the one being read.
+ *
+ * If this returns true, the rest of the datagram has been consumed and the
+ * object should consider itself read.  If it returns false, because
+ * bam-decode-threads is 0, the object should decode the data immediately.
+ */
+bool BamReader::
+defer_decode(TypedWritable *whom, DatagramIterator &scan, DecodeFunc func) {
+  nassertr(whom != nullptr, false);
+  if (bam_decode_threads <= 0 || !Thread::is_threading_supported()) {
+    return false;
+  }
+
+  DecodeJob job;
+  job._ref_ptr = whom->as_reference_count();
+  job._datagram = scan.get_datagram();
+  job._index = scan.get_current_index();
+  job._func = std::move(func);
+  _decode_jobs.push_back(std::move(job));
+
+  scan.skip_bytes(scan.get_remaining_size());
+  return true;
+}
+
 /**
  * Should be called by an object reading itself from the Bam file to indicate
  * that this particular object would like to receive the finalize() callback
@@ -1502,6 +1543,54 @@ resolve_cycler_pointers(PipelineCyclerBase *cycler,
   return false;
 }
 
+/**
+ * Runs all of the functions that were passed to defer_decode(), spreading
+ * them over up to bam-decode-threads threads in addition to the current one.
+ */
+void BamReader::
+decode_deferred() {
+  if (_decode_jobs.empty()) {
+    return;
+  }
+
+  DecodeJobs jobs;
+  jobs.swap(_decode_jobs);
+
+  patomic<size_t> next_job(0);
+  auto decode = [&jobs, &next_job] () {
+    size_t i;
+    while ((i = next_job.fetch_add(1, std::memory_order_relaxed)) < jobs.size()) {
+      DecodeJob &job = jobs[i];
+      DatagramIterator scan(job._datagram, job._index);
+      job._func(scan);
+    }
+  };
+
+  // It's not worth starting a thread for just a few objects.
+  size_t num_threads = std::min((size_t)std::max((int)bam_decode_threads, 0),
+                                jobs.size() / 8);
+  pvector<PT(GenericThread)> threads;
+  threads.reserve(num_threads);
+  for (size_t i = 0; i < num_threads; ++i) {
+    PT(GenericThread) thread = new GenericThread("bam-decode", "bam-decode", decode);
+    if (thread->start(TP_normal, true)) {
+      threads.push_back(std::move(thread));
+    }
+  }
+
+  decode();
+
+  for (GenericThread *thread : threads) {
+    thread->join();
+  }
+
+  if (bam_cat.is_debug()) {
+    bam_cat.debug()
+      << "Decoded " << jobs.size() << " deferred objects on "
+      << threads.size() + 1 << " threads\n";
+  }
+}
+
 /**
  * Should be called after all objects have been read, this will finalize all
  * the objects that registered themselves for the finalize callback.
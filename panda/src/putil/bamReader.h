@@ -34,9 +34,14 @@
 #include "dcast.h"
 #include "pipelineCyclerBase.h"
 #include "referenceCount.h"
+#include "pvector.h"
 
 #include <algorithm>
 
+#ifndef CPPPARSER
+#include <functional>
+#endif
+
 
 // A handy macro for reading PointerToArrays.
 #define READ_PTA(Manager, source, Read_func, array)   \
@@ -200,6 +205,12 @@ public:
   INLINE VirtualFile *get_vfile();
   INLINE std::streampos get_file_pos();
 
+#ifndef CPPPARSER
+  typedef std::function<void(DatagramIterator &scan)> DecodeFunc;
+  bool defer_decode(TypedWritable *whom, DatagramIterator &scan,
+                    DecodeFunc func);
+#endif
+
 public:
   INLINE static void register_factory(TypeHandle type, WritableFactory::CreateFunc *func,
                                       void *user_data = nullptr);
@@ -222,6 +233,7 @@ private:
   bool resolve_cycler_pointers(PipelineCyclerBase *cycler, const vector_int &pointer_ids,
                                bool require_fully_complete);
   void finalize();
+  void decode_deferred();
 
   INLINE bool get_datagram(Datagram &datagram);
 
@@ -336,6 +348,20 @@ private:
   typedef phash_map<TypedWritable *, AuxDataNames, pointer_hash> AuxDataTable;
   AuxDataTable _aux_data;
 
+#ifndef CPPPARSER
+  // The objects that have asked to decode the rest of their datagram later,
+  // on one of several threads, via defer_decode().
+  class DecodeJob {
+  public:
+    PT(ReferenceCount) _ref_ptr;
+    Datagram _datagram;
+    size_t _index;
+    DecodeFunc _func;
+  };
+  typedef pvector<DecodeJob> DecodeJobs;
+  DecodeJobs _decode_jobs;
+#endif
+
   int _file_major, _file_minor;
   BamEndian _file_endian;
   bool _file_stdfloat_double;
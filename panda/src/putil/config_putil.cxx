@@ -89,6 +89,14 @@ ConfigVariableEnum<BamEnums::BamTextureMode> bam_texture_mode
  PRC_DESC("Set this to specify how textures should be written into Bam files."
           "See the panda source or documentation for available options."));
 
+ConfigVariableInt bam_decode_threads
+("bam-decode-threads", 0,
+ PRC_DESC("Set this to the number of additional threads that may be used to "
+          "decode large objects read from a bam file, such as animation "
+          "tables, in parallel.  The objects are decoded when "
+          "BamReader::resolve() is called.  When this is 0, every object is "
+          "decoded as soon as it is read."));
+
 ConfigureFn(config_putil) {
   init_libputil();
 }
@@ -0,0 +1,102 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file test_bamread.cxx
+ * @author agent
+ * @date 2026-10-16
+ */
+
+#include "pandabase.h"
+#include "bamFile.h"
+#include "pandaNode.h"
+#include "config_putil.h"
+#include "clockObject.h"
+#include "pnotify.h"
+
+using std::cerr;
+using std::string;
+
+/**
+ * Reads the indicated bam file once, and returns the elapsed time.
+ */
+static double
+read_bam(const Filename &filename) {
+  ClockObject *clock = ClockObject::get_global_clock();
+  double start = clock->get_real_time();
+
+  BamFile bam_file;
+  if (!bam_file.open_read(filename)) {
+    return -1.0;
+  }
+  PT(PandaNode) node = bam_file.read_node();
+  if (node == nullptr || !bam_file.resolve()) {
+    return -1.0;
+  }
+  bam_file.close();
+
+  return clock->get_real_time() - start;
+}
+
+/**
+ * Compares the time taken to read some bam files with and without decoding
+ * objects on multiple threads.
+ *
+ * Usage: test_bamread [-t num_threads] [-n num_passes] file.bam [...]
+ */
+int
+main(int argc, char **argv) {
+  int num_threads = 4;
+  int num_passes = 5;
+
+  int ai = 1;
+  while (ai < argc && argv[ai][0] == '-') {
+    string opt = argv[ai];
+    if (opt == "-t" && ai + 1 < argc) {
+      num_threads = atoi(argv[ai + 1]);
+    } else if (opt == "-n" && ai + 1 < argc) {
+      num_passes = atoi(argv[ai + 1]);
+    } else {
+      break;
+    }
+    ai += 2;
+  }
+
+  if (ai >= argc) {
+    cerr << "Usage: test_bamread [-t num_threads] [-n num_passes] file.bam [...]\n";
+    return 1;
+  }
+
+  for (; ai < argc; ++ai) {
+    Filename filename = Filename::from_os_specific(argv[ai]);
+
+    // Read it once first, so that both timings see a warm disk cache.
+    bam_decode_threads.set_value(0);
+    if (read_bam(filename) < 0.0) {
+      cerr << "Unable to read " << filename << "\n";
+      continue;
+    }
+
+    double serial = 0.0;
+    double parallel = 0.0;
+    for (int pass = 0; pass < num_passes; ++pass) {
+      bam_decode_threads.set_value(0);
+      serial += read_bam(filename);
+
+      bam_decode_threads.set_value(num_threads);
+      parallel += read_bam(filename);
+    }
+    serial /= num_passes;
+    parallel /= num_passes;
+
+    cerr << filename << ": " << serial * 1000.0 << " ms serially, "
+         << parallel * 1000.0 << " ms with " << num_threads
+         << " decode threads (" << serial / parallel << "x)\n";
+  }
+
+  return 0;
+}
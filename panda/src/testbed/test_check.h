@@ -0,0 +1,62 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file test_check.h
+ * @author agent
+ * @date 2026-10-17
+ */
+
+#ifndef TEST_CHECK_H
+#define TEST_CHECK_H
+
+#include "pandabase.h"
+
+#include <iostream>
+
+// A minimal harness for the test programs in this directory that exercise
+// interfaces which are not exposed to Python, and so can't be covered by the
+// pytest suite.  Each program should be a single translation unit.
+
+static int num_check_failures = 0;
+
+/**
+ * Reports the indicated condition, with its location, if it does not hold.
+ * The program keeps running, so that the other checks still get a chance.
+ */
+#define CHECK(condition) \
+  do { \
+    if (!(condition)) { \
+      std::cerr << __FILE__ << ":" << __LINE__ \
+                << ": check failed: " #condition "\n"; \
+      ++num_check_failures; \
+    } \
+  } while (0)
+
+/**
+ * Records a failure that was detected some other way, along with a message
+ * that has already been written to std::cerr.
+ */
+#define FAIL_CHECK() \
+  do { \
+    ++num_check_failures; \
+  } while (0)
+
+/**
+ * Writes a summary of the checks, and returns the exit status for main().
+ */
+static int
+report_checks() {
+  if (num_check_failures != 0) {
+    std::cerr << num_check_failures << " checks failed.\n";
+    return 1;
+  }
+  std::cerr << "All checks passed.\n";
+  return 0;
+}
+
+#endif
@@ -0,0 +1,212 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file test_coroutine_task.cxx
+ * @author agent
+ * @date 2026-10-17
+ */
+
+#include "pandabase.h"
+#include "coroutineTask.h"
+#include "asyncTaskManager.h"
+#include "eventParameter.h"
+#include "test_check.h"
+
+#include <stdexcept>
+
+#ifndef CPP_HAVE_COROUTINES
+#error This program must be compiled with C++20 coroutine support.
+#endif
+
+/**
+ * Awaits the indicated future, and stores its integer result, or -1 if it was
+ * cancelled.
+ */
+static PT(CoroutineTask)
+await_future(PT(AsyncFuture) future, int *result) {
+  TypedObject *value = co_await future;
+  if (value != nullptr) {
+    *result = DCAST(EventStoreInt, value)->get_value();
+  } else {
+    *result = -1;
+  }
+}
+
+/**
+ * Yields the indicated number of times, counting each step.
+ */
+static PT(CoroutineTask)
+count_steps(int num_steps, int *counter) {
+  for (int i = 0; i < num_steps; ++i) {
+    ++(*counter);
+    co_await AsyncTask::DS_cont;
+  }
+  ++(*counter);
+}
+
+/**
+ * Throws an exception after the first step.
+ */
+static PT(CoroutineTask)
+throw_exception(int *counter) {
+  ++(*counter);
+  co_await AsyncTask::DS_cont;
+  ++(*counter);
+  throw std::runtime_error("expected exception");
+}
+
+/**
+ * Checks that a coroutine is suspended while awaiting a future, and is resumed
+ * with its result.
+ */
+static void
+test_await() {
+  AsyncTaskManager *task_mgr = AsyncTaskManager::get_global_ptr();
+
+  PT(AsyncFuture) future = new AsyncFuture;
+  int result = 0;
+  PT(CoroutineTask) task = await_future(future, &result);
+  CHECK(task != nullptr);
+  CHECK(result == 0);
+
+  task_mgr->add(task);
+  task_mgr->poll();
+  CHECK(!task->done());
+  CHECK(task->get_fut_waiter() == future);
+  CHECK(result == 0);
+
+  future->set_result(new EventStoreInt(42));
+  task_mgr->poll();
+  CHECK(task->done());
+  CHECK(!task->cancelled());
+  CHECK(result == 42);
+}
+
+/**
+ * Checks that awaiting a future that is already done does not suspend.
+ */
+static void
+test_await_done() {
+  AsyncTaskManager *task_mgr = AsyncTaskManager::get_global_ptr();
+
+  PT(AsyncFuture) future = new AsyncFuture;
+  future->set_result(new EventStoreInt(7));
+
+  int result = 0;
+  PT(CoroutineTask) task = await_future(future, &result);
+  task_mgr->add(task);
+  task_mgr->poll();
+  CHECK(task->done());
+  CHECK(result == 7);
+}
+
+/**
+ * Checks that a cancelled future is awaited as nullptr.
+ */
+static void
+test_await_cancelled() {
+  AsyncTaskManager *task_mgr = AsyncTaskManager::get_global_ptr();
+
+  PT(AsyncFuture) future = new AsyncFuture;
+  int result = 0;
+  PT(CoroutineTask) task = await_future(future, &result);
+  task_mgr->add(task);
+  task_mgr->poll();
+  CHECK(!task->done());
+
+  future->cancel();
+  task_mgr->poll();
+  CHECK(task->done());
+  CHECK(!task->cancelled());
+  CHECK(result == -1);
+}
+
+/**
+ * Checks that cancelling the task cancels the future it is awaiting.
+ */
+static void
+test_cancel() {
+  AsyncTaskManager *task_mgr = AsyncTaskManager::get_global_ptr();
+
+  PT(AsyncFuture) future = new AsyncFuture;
+  int result = 0;
+  PT(CoroutineTask) task = await_future(future, &result);
+  task_mgr->add(task);
+  task_mgr->poll();
+  CHECK(!task->done());
+
+  CHECK(task->cancel());
+  task_mgr->poll();
+  CHECK(task->cancelled());
+  CHECK(future->cancelled());
+  CHECK(result == 0);
+}
+
+/**
+ * Checks that co_await DS_cont yields until the next epoch.
+ */
+static void
+test_yield() {
+  AsyncTaskManager *task_mgr = AsyncTaskManager::get_global_ptr();
+
+  int counter = 0;
+  PT(CoroutineTask) task = count_steps(3, &counter);
+  task_mgr->add(task);
+  CHECK(counter == 0);
+
+  for (int i = 1; i <= 3; ++i) {
+    task_mgr->poll();
+    CHECK(counter == i);
+    CHECK(!task->done());
+  }
+
+  task_mgr->poll();
+  CHECK(counter == 4);
+  CHECK(task->done());
+}
+
+/**
+ * Checks that an exception escaping the coroutine is not propagated, and that
+ * the coroutine is not resumed again afterwards.
+ */
+static void
+test_exception() {
+  AsyncTaskManager *task_mgr = AsyncTaskManager::get_global_ptr();
+
+  int counter = 0;
+  PT(CoroutineTask) task = throw_exception(&counter);
+  task_mgr->add(task);
+  task_mgr->poll();
+  CHECK(counter == 1);
+
+  // This step throws the exception, which interrupts the task manager.
+  task_mgr->poll();
+  CHECK(counter == 2);
+
+  for (int i = 0; i < 3 && !task->done(); ++i) {
+    task_mgr->poll();
+  }
+  CHECK(counter == 2);
+  CHECK(task->done());
+  CHECK(!task->cancelled());
+}
+
+/**
+ * Exercises CoroutineTask.  Returns nonzero if any of the checks failed.
+ */
+int
+main(int argc, char **argv) {
+  test_await();
+  test_await_done();
+  test_await_cancelled();
+  test_cancel();
+  test_yield();
+  test_exception();
+
+  return report_checks();
+}
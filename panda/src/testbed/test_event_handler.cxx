@@ -0,0 +1,238 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file test_event_handler.cxx
+ * @author agent
+ * @date 2026-10-17
+ */
+
+#include "pandabase.h"
+#include "eventHandler.h"
+#include "eventName.h"
+#include "eventNameCache.h"
+#include "eventQueue.h"
+#include "throw_event.h"
+#include "test_check.h"
+
+static int num_calls = 0;
+
+/**
+ * A hook that counts the number of times it was called.
+ */
+static void
+count_hook(const Event *event) {
+  ++num_calls;
+}
+
+/**
+ * A hook that adds the event's integer parameter to the indicated int.
+ */
+static void
+sum_hook(const Event *event, void *data) {
+  *(int *)data += event->get_parameter(0).get_int_value();
+}
+
+/**
+ * Dispatches an event with the indicated EventName and integer parameter
+ * directly to the handler.
+ */
+static void
+dispatch(EventHandler &handler, const EventName *name, int value = 0) {
+  PT(Event) event = new Event(name);
+  event->add_parameter(EventParameter(value));
+  handler.dispatch_event(event);
+}
+
+/**
+ * Checks that the same string always produces the same EventName, and that it
+ * is removed from the table once all references to it are gone.
+ */
+static void
+test_interned() {
+  size_t num_names = EventName::get_num_names();
+
+  CPT(EventName) a = EventName::make("test_interned");
+  CPT(EventName) b = EventName::make("test_interned");
+  CPT(EventName) c = EventName::make("test_interned2");
+  CHECK(a == b);
+  CHECK(a != c);
+  CHECK(a->get_name() == "test_interned");
+  CHECK(EventName::get_num_names() == num_names + 2);
+
+  {
+    Event event("test_interned");
+    CHECK(event.get_event_name() == a);
+    CHECK(event.get_name() == "test_interned");
+
+    event.set_name("test_interned2");
+    CHECK(event.get_event_name() == c);
+  }
+
+  a.clear();
+  CHECK(EventName::get_num_names() == num_names + 2);
+  b.clear();
+  CHECK(EventName::get_num_names() == num_names + 1);
+
+  // An event keeps its name alive.
+  {
+    Event event("test_interned3");
+    CHECK(EventName::get_num_names() == num_names + 2);
+  }
+  CHECK(EventName::get_num_names() == num_names + 1);
+
+  c.clear();
+  CHECK(EventName::get_num_names() == num_names);
+}
+
+/**
+ * Checks that an EventNameCache returns the interned names, and holds on to no
+ * more of them than it should.
+ */
+static void
+test_cache() {
+  size_t num_names = EventName::get_num_names();
+
+  EventNameCache cache(2);
+  const EventName *a = cache.get_name("test_cache_a");
+  CHECK(a == EventName::make("test_cache_a"));
+  CHECK(cache.get_name("test_cache_a") == a);
+  CHECK(cache.get_num_names() == 1);
+  CHECK(EventName::get_num_names() == num_names + 1);
+
+  // Filling up the cache starts a new generation, but a name that is still
+  // asked for is kept.
+  cache.get_name("test_cache_b");
+  cache.get_name("test_cache_c");
+  CHECK(cache.get_num_names() == 3);
+  CHECK(cache.get_name("test_cache_a") == a);
+  CHECK(cache.get_num_names() == 3);
+
+  // The next generation releases the name that was not asked for again.
+  cache.get_name("test_cache_d");
+  CHECK(cache.get_num_names() == 3);
+  CHECK(EventName::get_num_names() == num_names + 3);
+
+  for (int i = 0; i < 100; ++i) {
+    cache.get_name("test_cache_" + std::to_string(i));
+    CHECK(cache.get_num_names() <= 4);
+  }
+  CHECK(EventName::get_num_names() <= num_names + 4);
+
+  cache.clear();
+  CHECK(cache.get_num_names() == 0);
+  CHECK(EventName::get_num_names() == num_names);
+}
+
+/**
+ * Checks that hooks added by string and by EventName are the same hooks, and
+ * are called for events that were made either way.
+ */
+static void
+test_dispatch() {
+  EventQueue queue;
+  EventHandler handler(&queue);
+  CPT(EventName) name = EventName::make("test_dispatch");
+
+  num_calls = 0;
+  CHECK(handler.add_hook("test_dispatch", count_hook));
+  CHECK(!handler.add_hook(name, count_hook));
+  CHECK(handler.has_hook(name));
+  CHECK(handler.has_hook(name, count_hook));
+  CHECK(!handler.has_hook("test_dispatch2"));
+
+  throw_event_directly(handler, "test_dispatch");
+  CHECK(num_calls == 1);
+
+  dispatch(handler, name);
+  CHECK(num_calls == 2);
+
+  // An event with another name does not call the hook.
+  throw_event_directly(handler, "test_dispatch2");
+  CHECK(num_calls == 2);
+
+  // Events queued by name and by EventName are both dispatched.
+  queue.queue_event(new Event("test_dispatch"));
+  queue.queue_event(new Event(name));
+  queue.queue_event(new Event("test_dispatch_other"));
+  handler.process_events();
+  CHECK(num_calls == 4);
+  CHECK(queue.is_queue_empty());
+
+  CHECK(handler.remove_hook("test_dispatch", count_hook));
+  CHECK(!handler.has_hook(name));
+  dispatch(handler, name);
+  CHECK(num_calls == 4);
+}
+
+/**
+ * Checks that callback and lambda hooks are called with the event's
+ * parameters, and can all be removed at once.
+ */
+static void
+test_hook_kinds() {
+  EventQueue queue;
+  EventHandler handler(&queue);
+  CPT(EventName) name = EventName::make("test_hook_kinds");
+
+  int sum = 0;
+  int lambda_sum = 0;
+  CHECK(handler.add_hook(name, sum_hook, &sum));
+  CHECK(handler.has_hook("test_hook_kinds", sum_hook, &sum));
+  handler.add_hook("test_hook_kinds", [&] (const Event *event) {
+    lambda_sum += event->get_parameter(0).get_int_value();
+  });
+
+  dispatch(handler, name, 3);
+  throw_event_directly(handler, "test_hook_kinds", EventParameter(4));
+  CHECK(sum == 7);
+  CHECK(lambda_sum == 7);
+
+  CHECK(handler.remove_hooks("test_hook_kinds"));
+  CHECK(!handler.has_hook(name));
+  dispatch(handler, name, 5);
+  CHECK(sum == 7);
+  CHECK(lambda_sum == 7);
+}
+
+/**
+ * Checks that the future for an event is completed with the event.
+ */
+static void
+test_future() {
+  EventQueue queue;
+  EventHandler handler(&queue);
+
+  PT(AsyncFuture) future = handler.get_future("test_future");
+  CHECK(future == handler.get_future(EventName::make("test_future")));
+  CHECK(!future->done());
+
+  throw_event_directly(handler, "test_future_other");
+  CHECK(!future->done());
+
+  dispatch(handler, EventName::make("test_future"));
+  CHECK(future->done());
+  CHECK(future->get_result() != nullptr);
+
+  // A new future is created for the next time it is thrown.
+  CHECK(handler.get_future("test_future") != future);
+}
+
+/**
+ * Exercises the dispatching of events by their interned names.  Returns
+ * nonzero if any of the checks failed.
+ */
+int
+main(int argc, char **argv) {
+  test_interned();
+  test_cache();
+  test_dispatch();
+  test_hook_kinds();
+  test_future();
+
+  return report_checks();
+}
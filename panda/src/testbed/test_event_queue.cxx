@@ -0,0 +1,119 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file test_event_queue.cxx
+ * @author agent
+ * @date 2026-10-17
+ */
+
+#include "pandabase.h"
+#include "eventQueue.h"
+#include "event.h"
+#include "genericThread.h"
+#include "patomic.h"
+#include "pvector.h"
+#include "string_utils.h"
+
+using std::cerr;
+
+static const int num_producers = 8;
+static const int events_per_producer = 100000;
+
+/**
+ * Has several threads queue numbered events at the same time, while the main
+ * thread dequeues them.  Checks that no event is lost or duplicated, and that
+ * the events of each producer are dequeued in the order they were queued.
+ */
+int
+main(int argc, char **argv) {
+  if (!Thread::is_threading_supported()) {
+    cerr << "Threading support disabled, skipping test.\n";
+    return 0;
+  }
+
+  EventQueue queue;
+  patomic<int> num_running(num_producers);
+
+  pvector<PT(GenericThread)> threads;
+  for (int p = 0; p < num_producers; ++p) {
+    std::string name = "producer" + format_string(p);
+    PT(GenericThread) thread = new GenericThread(name, name, [&, name] () {
+      for (int i = 0; i < events_per_producer; ++i) {
+        Event *event = new Event(name);
+        event->add_parameter(EventParameter(i));
+        queue.queue_event(event);
+      }
+      num_running.fetch_sub(1);
+    });
+    threads.push_back(thread);
+  }
+
+  for (GenericThread *thread : threads) {
+    thread->start(TP_normal, true);
+  }
+
+  // Alternate between the two ways of dequeuing events, while the producers
+  // are still running.
+  pvector<int> next_seq(num_producers, 0);
+  int num_errors = 0;
+  EventQueue::Events events;
+  bool done = false;
+  bool batch = false;
+  while (!done) {
+    done = (num_running.load() == 0);
+
+    events.clear();
+    if (batch) {
+      queue.dequeue_events(events);
+    } else {
+      while (!queue.is_queue_empty()) {
+        events.push_back(queue.dequeue_event());
+      }
+    }
+    batch = !batch;
+
+    for (const Event *event : events) {
+      int p = atoi(event->get_name().c_str() + 8);
+      int seq = event->get_parameter(0).get_int_value();
+      if (p < 0 || p >= num_producers) {
+        cerr << "Got unexpected event " << *event << "\n";
+        ++num_errors;
+      } else if (seq != next_seq[p]) {
+        if (num_errors++ < 10) {
+          cerr << "Got " << event->get_name() << " event " << seq
+               << ", expected " << next_seq[p] << "\n";
+        }
+      } else {
+        ++next_seq[p];
+      }
+    }
+  }
+
+  for (GenericThread *thread : threads) {
+    thread->join();
+  }
+
+  for (int p = 0; p < num_producers; ++p) {
+    if (next_seq[p] != events_per_producer) {
+      cerr << "Got " << next_seq[p] << " of " << events_per_producer
+           << " events from producer" << p << "\n";
+      ++num_errors;
+    }
+  }
+  if (!queue.is_queue_empty()) {
+    cerr << "Events left on the queue.\n";
+    ++num_errors;
+  }
+
+  if (num_errors != 0) {
+    return 1;
+  }
+  cerr << "All " << num_producers * events_per_producer
+       << " events received in order.\n";
+  return 0;
+}
@@ -0,0 +1,124 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file test_parallel_for.cxx
+ * @author agent
+ * @date 2026-10-17
+ */
+
+#include "pandabase.h"
+#include "asyncTaskManager.h"
+#include "asyncTaskChain.h"
+#include "asyncTaskCollection.h"
+#include "patomic.h"
+#include "pnotify.h"
+#include "test_check.h"
+
+using std::cerr;
+
+/**
+ * Runs parallel_for() over a range of the indicated size, and checks that
+ * each index is visited exactly once.
+ */
+static void
+test_range(size_t begin, size_t end, size_t grain_size) {
+  AsyncTaskManager *task_mgr = AsyncTaskManager::get_global_ptr();
+
+  patomic<int> *counts = new patomic<int>[end];
+  for (size_t i = 0; i < end; ++i) {
+    counts[i] = 0;
+  }
+
+  task_mgr->parallel_for(begin, end, [=] (size_t i) {
+    counts[i].fetch_add(1);
+  }, grain_size);
+
+  size_t num_bad = 0;
+  for (size_t i = 0; i < end; ++i) {
+    if (counts[i] != (i >= begin ? 1 : 0)) {
+      ++num_bad;
+    }
+  }
+  if (num_bad != 0) {
+    cerr << "parallel_for(" << begin << ", " << end << ", grain " << grain_size
+         << ") visited " << num_bad << " indices the wrong number of times\n";
+    FAIL_CHECK();
+  }
+
+  delete[] counts;
+}
+
+/**
+ * Runs parallel_for() from within each iteration of another parallel_for().
+ */
+static void
+test_nested() {
+  AsyncTaskManager *task_mgr = AsyncTaskManager::get_global_ptr();
+
+  patomic<size_t> total(0);
+  task_mgr->parallel_for(0, 16, [&] (size_t i) {
+    task_mgr->parallel_for(0, 100, [&] (size_t j) {
+      total.fetch_add(j);
+    }, 1);
+  }, 1);
+
+  CHECK(total == 16 * (99 * 100 / 2));
+}
+
+/**
+ * Runs parallel_for() from within a task on the parallel chain itself, which
+ * must not deadlock even if all of the chain's threads do the same.
+ */
+static void
+test_from_task() {
+  AsyncTaskManager *task_mgr = AsyncTaskManager::get_global_ptr();
+  AsyncTaskChain *chain = task_mgr->get_parallel_chain();
+
+  patomic<size_t> total(0);
+  AsyncTaskCollection tasks;
+  int num_tasks = std::max(chain->get_num_threads(), 1) * 2;
+  for (int t = 0; t < num_tasks; ++t) {
+    PT(AsyncTask) task = chain->add([&] (AsyncTask *) {
+      task_mgr->parallel_for(0, 1000, [&] (size_t i) {
+        total.fetch_add(1);
+      });
+      return AsyncTask::DS_done;
+    }, "parallel_for_task");
+    tasks.add_task(task);
+  }
+
+  if (chain->get_num_threads() == 0) {
+    chain->wait_for_tasks();
+  }
+  for (size_t t = 0; t < tasks.get_num_tasks(); ++t) {
+    tasks.get_task(t)->wait();
+  }
+
+  CHECK(total == (size_t)num_tasks * 1000);
+}
+
+/**
+ * Exercises AsyncTaskManager::parallel_for(), which is not available to
+ * Python.  Returns nonzero if any of the checks failed.
+ */
+int
+main(int argc, char **argv) {
+  test_range(0, 0, 0);
+  test_range(5, 5, 0);
+  test_range(0, 1, 0);
+  test_range(0, 1000, 0);
+  test_range(0, 1000, 1);
+  test_range(0, 1000, 7);
+  test_range(0, 1000, 5000);
+  test_range(300, 100000, 0);
+
+  test_nested();
+  test_from_task();
+
+  return report_checks();
+}
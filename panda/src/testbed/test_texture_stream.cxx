@@ -0,0 +1,194 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file test_texture_stream.cxx
+ * @author agent
+ * @date 2026-10-17
+ */
+
+#include "pandabase.h"
+#include "textureStreamBudget.h"
+#include "texture.h"
+#include "test_check.h"
+
+/**
+ * Returns a 64x64 RGBA texture with all of its mipmap levels in RAM, from 64x64
+ * (16384 bytes) down to 1x1 (4 bytes).
+ */
+static PT(Texture)
+make_mipmapped_texture() {
+  PT(Texture) tex = new Texture("mipmapped");
+  tex->setup_2d_texture(64, 64, Texture::T_unsigned_byte, Texture::F_rgba8);
+  tex->set_ram_image(PTA_uchar::empty_array(64 * 64 * 4));
+  tex->generate_ram_mipmap_images();
+  CHECK(tex->get_num_ram_mipmap_images() == 7);
+  return tex;
+}
+
+/**
+ * Returns the number of bytes taken up by the indicated mipmap level and all
+ * of the smaller ones.
+ */
+static size_t
+get_bytes_from(Texture *tex, int level) {
+  size_t bytes = 0;
+  for (int n = level; n < tex->get_num_ram_mipmap_images(); ++n) {
+    bytes += tex->get_ram_mipmap_image_size(n);
+  }
+  return bytes;
+}
+
+/**
+ * Checks which mipmap level is chosen for a given number of bytes.
+ */
+static void
+test_stream_level() {
+  PT(Texture) tex = make_mipmapped_texture();
+
+  // Not even the 1x1 level fits, but we always upload at least that.
+  CHECK(TextureStreamBudget::get_stream_level(tex, 0) == 6);
+  CHECK(TextureStreamBudget::get_stream_level(tex, 3) == 6);
+
+  // 2x2 and 1x1 together take up 16 + 4 bytes.
+  CHECK(TextureStreamBudget::get_stream_level(tex, 19) == 6);
+  CHECK(TextureStreamBudget::get_stream_level(tex, 20) == 5);
+
+  size_t total = get_bytes_from(tex, 0);
+  CHECK(TextureStreamBudget::get_stream_level(tex, total) == 0);
+  CHECK(TextureStreamBudget::get_stream_level(tex, total - 1) == 1);
+
+  // The levels below min_level are never counted.
+  CHECK(TextureStreamBudget::get_stream_level(tex, total, 2) == 2);
+  CHECK(TextureStreamBudget::get_stream_level(tex, 0, 2) == 6);
+  CHECK(TextureStreamBudget::get_stream_level(tex, 0, 7) == 7);
+
+  // A texture without mipmap images is always uploaded whole.
+  PT(Texture) plain = new Texture("plain");
+  plain->setup_2d_texture(64, 64, Texture::T_unsigned_byte, Texture::F_rgba8);
+  plain->set_ram_image(PTA_uchar::empty_array(64 * 64 * 4));
+  CHECK(TextureStreamBudget::get_stream_level(plain, 0) == 0);
+}
+
+/**
+ * Checks that reserving levels deducts them from the budget, which is shared
+ * between all of the textures uploaded in the same frame.
+ */
+static void
+test_reserve() {
+  PT(Texture) tex1 = make_mipmapped_texture();
+  PT(Texture) tex2 = make_mipmapped_texture();
+
+  TextureStreamBudget budget;
+  CHECK(budget.get_bytes_left() == 0);
+
+  budget.begin_frame(-100);
+  CHECK(budget.get_bytes_left() == 0);
+
+  // Room for everything from 16x16 down, with 100 bytes to spare.
+  size_t from_16 = get_bytes_from(tex1, 2);
+  budget.begin_frame((int)from_16 + 100);
+  CHECK(budget.reserve(tex1, 0) == 2);
+  CHECK(budget.get_bytes_left() == 100);
+
+  // The next texture gets what's left: everything from 4x4 down, 84 bytes.
+  CHECK(budget.reserve(tex2, 0) == 4);
+  CHECK(budget.get_bytes_left() == 100 - get_bytes_from(tex2, 4));
+
+  // When not even the smallest level fits, it is still uploaded.
+  budget.begin_frame(2);
+  CHECK(budget.reserve(tex2, 0) == 6);
+  CHECK(budget.get_bytes_left() == 0);
+
+  // A fresh frame starts over.
+  budget.begin_frame((int)from_16);
+  CHECK(budget.get_bytes_left() == from_16);
+  CHECK(budget.reserve(tex1, 3) == 3);
+  CHECK(budget.get_bytes_left() == from_16 - get_bytes_from(tex1, 3));
+}
+
+/**
+ * Simulates the way a GSG streams a texture in over consecutive frames: the
+ * first upload starts from a small mipmap level, and on each subsequent frame
+ * the texture is uploaded again from a larger level, as long as that fits.
+ */
+static void
+test_stepping() {
+  PT(Texture) tex = make_mipmapped_texture();
+  size_t from_32 = get_bytes_from(tex, 1);
+  size_t total = get_bytes_from(tex, 0);
+
+  // Frame 1: the first upload only has room for 8x8 down to 1x1.
+  TextureStreamBudget budget;
+  budget.begin_frame(85);
+  int base_level = budget.reserve(tex, 0);
+  CHECK(base_level == 4);
+  CHECK(budget.get_bytes_left() == 1);
+
+  // Nothing larger fits in the rest of this frame.
+  CHECK(!budget.can_step(tex, base_level));
+
+  // Frame 2: the texture is uploaded again from 32x32.
+  budget.begin_frame((int)from_32);
+  CHECK(budget.can_step(tex, base_level));
+  base_level = budget.reserve(tex, 0);
+  CHECK(base_level == 1);
+  CHECK(budget.get_bytes_left() == 0);
+
+  // Frame 3: the same budget does not allow any further step.
+  budget.begin_frame((int)from_32);
+  CHECK(!budget.can_step(tex, base_level));
+  CHECK(budget.get_bytes_left() == from_32);
+
+  // Frame 4: the whole texture fits, which completes it.
+  budget.begin_frame((int)total);
+  CHECK(budget.can_step(tex, base_level));
+  base_level = budget.reserve(tex, 0);
+  CHECK(base_level == 0);
+
+  // A complete texture never needs another step.
+  budget.begin_frame((int)total * 2);
+  CHECK(!budget.can_step(tex, base_level));
+}
+
+/**
+ * Checks that a texture is not stepped while the budget is too small to upload
+ * anything larger than what is already resident.
+ */
+static void
+test_stepping_starved() {
+  PT(Texture) tex = make_mipmapped_texture();
+
+  TextureStreamBudget budget;
+  budget.begin_frame(0);
+  int base_level = budget.reserve(tex, 0);
+  CHECK(base_level == 6);
+
+  for (int i = 0; i < 3; ++i) {
+    budget.begin_frame(19);
+    CHECK(!budget.can_step(tex, base_level));
+  }
+
+  budget.begin_frame(20);
+  CHECK(budget.can_step(tex, base_level));
+  CHECK(budget.reserve(tex, 0) == 5);
+  CHECK(budget.get_bytes_left() == 0);
+}
+
+/**
+ * Exercises the selection of mipmap levels for texture streaming.  Returns
+ * nonzero if any of the checks failed.
+ */
+int
+main(int argc, char **argv) {
+  test_stream_level();
+  test_reserve();
+  test_stepping();
+  test_stepping_starved();
+
+  return report_checks();
+}
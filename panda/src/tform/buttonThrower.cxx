@@ -232,7 +232,7 @@ write(std::ostream &out, int indent_level) const {
 void ButtonThrower::
 do_specific_event(const string &event_name, double time) {
   if (_specific_flag) {
-    PT(Event) event = new Event(_prefix + event_name);
+    PT(Event) event = new Event(_event_names.get_name(_prefix + event_name));
 
     if (_time_flag) {
       event->add_parameter(time);
@@ -294,7 +294,7 @@ do_general_event(const ButtonEvent &button_event, const string &button_name) {
     return;
   }
 
-  PT(Event) event = new Event(event_name);
+  PT(Event) event = new Event(_event_names.get_name(event_name));
 
   if (_time_flag) {
     event->add_parameter(button_event._time);
@@ -19,6 +19,7 @@
 #include "buttonEventList.h"
 #include "dataNode.h"
 #include "eventParameter.h"
+#include "eventNameCache.h"
 #include "modifierButtons.h"
 #include "pmap.h"
 #include "pvector.h"
@@ -119,6 +120,9 @@ private:
   typedef small_vector<EventParameter> ParameterList;
   ParameterList _parameters;
 
+  // The names of the events thrown recently, with the prefix applied.
+  EventNameCache _event_names;
+
   typedef pvector<ModifierButtons> ThrowButtonDef;
   typedef pmap<ButtonHandle, ThrowButtonDef> ThrowButtons;
   ThrowButtons _throw_buttons;
@@ -893,9 +893,10 @@ throw_event_pattern(const string &pattern, const MouseWatcherRegion *region,
   }
 
   if (!event.empty()) {
-    throw_event(event, EventParameter(region), EventParameter(button_name));
+    const EventName *event_name = _event_names.get_name(event);
+    throw_event(event_name, EventParameter(region), EventParameter(button_name));
     if (_eh != nullptr)
-      throw_event_directly(*_eh, event, EventParameter(region),
+      throw_event_directly(*_eh, event_name, EventParameter(region),
                            EventParameter(button_name));
   }
 }
@@ -32,6 +32,7 @@
 #include "clockObject.h"
 #include "pvector.h"
 #include "displayRegion.h"
+#include "eventNameCache.h"
 
 class MouseWatcherParameter;
 class DisplayRegion;
@@ -240,6 +241,9 @@ private:
   std::string _within_pattern;
   std::string _without_pattern;
 
+  // The names of the events made from the above patterns recently.
+  EventNameCache _event_names;
+
   PT(PandaNode) _geometry;
 
   EventHandler *_eh;
@@ -0,0 +1,109 @@
+from panda3d import core
+import math
+import pytest
+
+
+@pytest.fixture
+def cache_anim_matrices():
+    var = core.ConfigVariableBool("cache-anim-matrices")
+    var.value = True
+    yield
+    var.clear_local_value()
+
+
+def get_value(channel, frame):
+    mat = core.Mat4()
+    channel.get_value(frame, mat)
+    return mat
+
+
+def test_xfm_table_cache_matrices(cache_anim_matrices):
+    bundle = core.AnimBundle("anim", 24, 3)
+    channel = core.AnimChannelMatrixXfmTable(bundle, "joint")
+    channel.set_table('x', core.CPTA_stdfloat([0, 1, 2]))
+    channel.set_table('h', core.CPTA_stdfloat([90]))
+
+    for frame in range(3):
+        expected = core.Mat4.rotate_mat(90, (0, 0, 1))
+        expected.set_row(3, (frame, 0, 0))
+        assert get_value(channel, frame).almost_equal(expected)
+
+    # Changing a table must discard the cached matrices.
+    channel.set_table('y', core.CPTA_stdfloat([3, 4, 5]))
+    assert get_value(channel, 1).get_row3(3).almost_equal((1, 4, 0))
+
+    channel.clear_table('h')
+    assert get_value(channel, 2).almost_equal(core.Mat4.translate_mat(2, 5, 0))
+
+
+def test_xfm_table_cache_mismatched_lengths(cache_anim_matrices):
+    # The tables of different lengths can't be cached, but must still give
+    # the right values.
+    bundle = core.AnimBundle("anim", 24, 2)
+    channel = core.AnimChannelMatrixXfmTable(bundle, "joint")
+    channel.set_table('x', core.CPTA_stdfloat([0, 1, 2]))
+    channel.set_table('z', core.CPTA_stdfloat([0, 1]))
+
+    assert get_value(channel, 2).get_row3(3).almost_equal((2, 0, 0))
+    assert get_value(channel, 1).get_row3(3).almost_equal((1, 0, 1))
+
+
+def test_xfm_table_compress_tables():
+    bundle = core.AnimBundle("anim", 24, 300)
+    channel = core.AnimChannelMatrixXfmTable(bundle, "joint")
+    xs = [math.sin(i * 0.05) * 10 for i in range(300)]
+    zs = [(i // 30) * 0.5 for i in range(300)]
+    channel.set_table('x', core.CPTA_stdfloat(xs))
+    channel.set_table('y', core.CPTA_stdfloat([2]))
+    channel.set_table('z', core.CPTA_stdfloat(zs))
+
+    channel.compress_tables(0.001)
+    assert channel.is_table_compressed('x')
+    assert channel.is_table_compressed('z')
+    assert not channel.is_table_compressed('y')
+
+    x_tolerance = 0.001 * (max(xs) - min(xs))
+    z_tolerance = 0.001 * (max(zs) - min(zs))
+    for frame in range(300):
+        pos = get_value(channel, frame).get_row3(3)
+        assert abs(pos.x - xs[frame]) <= x_tolerance
+        assert pos.y == 2
+        assert abs(pos.z - zs[frame]) <= z_tolerance
+
+    # Decompressing the whole table gives the same values.
+    x_table = channel.get_table('x')
+    assert len(x_table) == 300
+    for frame in range(300):
+        assert abs(x_table[frame] - xs[frame]) <= x_tolerance
+
+    # Replacing a table drops the compressed version.
+    channel.set_table('x', core.CPTA_stdfloat(xs))
+    assert not channel.is_table_compressed('x')
+    assert list(channel.get_table('x')) == pytest.approx(xs)
+
+
+@pytest.mark.parametrize("num_threads", [0, 2])
+def test_xfm_table_bam_decode_threads(num_threads):
+    bundle = core.AnimBundle("anim", 24, 50)
+    expected = {}
+    for j in range(8):
+        channel = core.AnimChannelMatrixXfmTable(bundle, "joint%d" % (j))
+        for k, table_id in enumerate('ijkxyzhpr'):
+            values = [math.sin(i * 0.1 + j + k) * (j + 1) for i in range(50)]
+            channel.set_table(table_id, core.CPTA_stdfloat(values))
+            expected[j, table_id] = values
+
+    data = core.AnimBundleNode("anim", bundle).encode_to_bam_stream()
+
+    decode_threads = core.ConfigVariableInt("bam-decode-threads")
+    decode_threads.value = num_threads
+    try:
+        node = core.PandaNode.decode_from_bam_stream(data)
+    finally:
+        decode_threads.clear_local_value()
+
+    assert isinstance(node, core.AnimBundleNode)
+    assert node.bundle.get_num_children() == 8
+    for (j, table_id), values in expected.items():
+        channel = node.bundle.find_child("joint%d" % (j))
+        assert list(channel.get_table(table_id)) == pytest.approx(values, abs=1e-5)
@@ -0,0 +1,111 @@
+from panda3d import core
+import pytest
+
+
+@pytest.fixture
+def clock():
+    clock = core.ClockObject.get_global_clock()
+    mode = clock.mode
+    frame_time = clock.frame_time
+    clock.mode = core.ClockObject.M_slave
+    yield clock
+    clock.mode = mode
+    clock.frame_time = frame_time
+
+
+def make_character(name):
+    """Makes a Character with a "root" joint and a "hand" joint below it, and
+    returns it along with an AnimControl that moves both joints along X."""
+
+    char = core.Character(name)
+    bundle = char.get_bundle(0)
+    root = core.CharacterJoint(char, bundle, bundle, "root", core.Mat4.ident_mat())
+    core.CharacterJoint(char, bundle, root, "hand", core.Mat4.ident_mat())
+
+    anim = core.AnimBundle("anim", 24, 2)
+    anim_root = core.AnimChannelMatrixXfmTable(anim, "root")
+    anim_hand = core.AnimChannelMatrixXfmTable(anim_root, "hand")
+    anim_root.set_table('x', core.CPTA_stdfloat([0, 1]))
+    anim_hand.set_table('x', core.CPTA_stdfloat([0, 2]))
+
+    control = bundle.bind_anim(anim, core.PartGroup.HMF_ok_wrong_root_name)
+    assert control is not None
+    return char, control
+
+
+def get_x(char, joint_name):
+    return char.find_joint(joint_name).get_transform().get_row3(3).x
+
+
+def set_lod_subset(char):
+    subset = core.PartSubset()
+    subset.add_include_joint("root")
+    subset.add_exclude_joint("hand")
+    char.get_bundle(0).set_lod_subset(subset)
+
+
+def test_partbundle_lod_reduced(clock):
+    char, control = make_character("char")
+    bundle = char.get_bundle(0)
+    set_lod_subset(char)
+
+    control.pose(0)
+    clock.frame_time = 1
+    bundle.update()
+    assert get_x(char, "root") == 0
+    assert get_x(char, "hand") == 0
+
+    # At reduced detail, only the joints in the subset are recomputed.
+    control.pose(1)
+    clock.frame_time = 2
+    bundle.update(True)
+    assert get_x(char, "root") == 1
+    assert get_x(char, "hand") == 0
+
+    # Going back to full detail brings the others up to date right away.
+    bundle.update(False)
+    assert get_x(char, "root") == 1
+    assert get_x(char, "hand") == 2
+
+
+def test_partbundle_lod_reduced_shared(clock):
+    # Two characters that share the same bundle, one of which is far away and
+    # one of which is close by.  Full detail must win, in whichever order they
+    # happen to be updated in a frame.
+    char, control = make_character("char")
+    other = core.Character("other")
+    other.merge_bundles(other.get_bundle_handle(0), char.get_bundle_handle(0))
+    assert other.get_bundle(0) == char.get_bundle(0)
+    bundle = char.get_bundle(0)
+    set_lod_subset(char)
+
+    control.pose(0)
+    clock.frame_time = 1
+    bundle.update(False)
+
+    control.pose(1)
+    clock.frame_time = 2
+    bundle.update(False)
+    bundle.update(True)
+    assert get_x(char, "hand") == 2
+
+    control.pose(0)
+    clock.frame_time = 3
+    bundle.update(True)
+    bundle.update(False)
+    assert get_x(char, "hand") == 0
+
+
+def test_character_clear_lod_subset(clock):
+    char, control = make_character("char")
+    set_lod_subset(char)
+    char.clear_lod_subset()
+
+    control.pose(0)
+    clock.frame_time = 1
+    char.get_bundle(0).update(True)
+
+    control.pose(1)
+    clock.frame_time = 2
+    char.get_bundle(0).update(True)
+    assert get_x(char, "hand") == 2
@@ -29,3 +29,123 @@ def test_collision_traverser_pickle():
     # Two colliders must still be the same object; this only works with our own
     # version of the pickle module, in direct.stdpy.pickle.
     assert trav.get_handler(collider1) == trav.get_handler(collider2)
+
+
+def test_collision_traverser_num_threads():
+    from panda3d.core import CollisionSphere, CollisionHandlerEvent
+
+    root = NodePath("root")
+    into = root.attach_new_node(CollisionNode("into"))
+    into.node().add_solid(CollisionSphere(0, 0, 0, 10))
+
+    queue = CollisionHandlerQueue()
+    event = CollisionHandlerEvent()
+    event.add_in_pattern("%fn-into-%in")
+
+    trav = CollisionTraverser()
+    for i in range(100):
+        collider = root.attach_new_node(CollisionNode("collider%d" % (i)))
+        collider.node().add_solid(CollisionSphere(i * 0.5, 0, 0, 1))
+        collider.node().set_into_collide_mask(0)
+        trav.add_collider(collider, queue if i % 2 else event)
+
+    def collide(num_threads):
+        trav.num_threads = num_threads
+        assert trav.num_threads == num_threads
+        trav.traverse(root)
+        return [(entry.get_from_node_path().name, entry.get_into_node_path().name)
+                for entry in queue.entries]
+
+    serial = collide(0)
+    assert len(serial) == 11
+
+    # The same entries must be found, and always in the same order.
+    parallel = collide(4)
+    assert sorted(parallel) == sorted(serial)
+    assert collide(4) == parallel
+
+
+def test_collision_traverser_many_solids():
+    from panda3d.core import CollisionSphere
+
+    # This node has enough solids to get a bounding volume hierarchy.
+    root = NodePath("root")
+    into = root.attach_new_node(CollisionNode("into"))
+    for x in range(10):
+        for y in range(10):
+            into.node().add_solid(CollisionSphere(x * 10, y * 10, 0, 1))
+
+    collider = root.attach_new_node(CollisionNode("collider"))
+    collider.node().add_solid(CollisionSphere(0, 0, 0, 12))
+    collider.set_pos(20, 20, 0)
+
+    queue = CollisionHandlerQueue()
+    trav = CollisionTraverser()
+    trav.add_collider(collider, queue)
+
+    def collide():
+        trav.traverse(root)
+        return sorted(tuple(entry.get_into().center) for entry in queue.entries)
+
+    assert collide() == [(10, 20, 0), (20, 10, 0), (20, 20, 0), (20, 30, 0), (30, 20, 0)]
+
+    # Changing the solids must be noticed.
+    into.node().set_solid(22, CollisionSphere(100, 100, 0, 1))
+    assert collide() == [(10, 20, 0), (20, 10, 0), (20, 30, 0), (30, 20, 0)]
+
+    collider.set_pos(100, 100, 0)
+    assert collide() == [(100, 100, 0)]
+
+
+def test_collision_traverser_large_geom():
+    from panda3d.core import CollisionRay, CollisionSegment, GeomNode, Geom
+    from panda3d.core import GeomVertexData, GeomVertexFormat, GeomVertexWriter
+    from panda3d.core import GeomTriangles, Point3
+
+    # A flat grid of 20x20 squares, enough to get batched triangle tests.
+    vdata = GeomVertexData("grid", GeomVertexFormat.get_v3(), Geom.UH_static)
+    vertex = GeomVertexWriter(vdata, "vertex")
+    for y in range(21):
+        for x in range(21):
+            vertex.add_data3(x, y, 0)
+
+    tris = GeomTriangles(Geom.UH_static)
+    for y in range(20):
+        for x in range(20):
+            i = y * 21 + x
+            tris.add_vertices(i, i + 1, i + 22)
+            tris.add_vertices(i, i + 22, i + 21)
+
+    geom = Geom(vdata)
+    geom.add_primitive(tris)
+    root = NodePath("root")
+    root.attach_new_node(GeomNode("grid")).node().add_geom(geom)
+
+    collider = root.attach_new_node(CollisionNode("collider"))
+    collider.node().set_into_collide_mask(0)
+    collider.node().set_from_collide_mask(GeomNode.get_default_collide_mask())
+
+    queue = CollisionHandlerQueue()
+    trav = CollisionTraverser()
+    trav.add_collider(collider, queue)
+
+    def collide():
+        trav.traverse(root)
+        return sorted(entry.get_surface_point(root) for entry in queue.entries)
+
+    collider.node().add_solid(CollisionRay(5.25, 7.5, 10, 0, 0, -1))
+    assert collide() == [Point3(5.25, 7.5, 0)]
+
+    # Pointing away from the grid.
+    collider.node().modify_solid(0).set_direction(0, 0, 1)
+    assert collide() == []
+
+    # A segment that stops just short of the grid, and one that crosses it.
+    collider.node().set_solid(0, CollisionSegment(3.5, 3.25, 2, 3.5, 3.25, 0.5))
+    assert collide() == []
+    collider.node().set_solid(0, CollisionSegment(3.5, 3.25, 2, 3.5, 3.25, -1))
+    assert collide() == [Point3(3.5, 3.25, 0)]
+
+    # Moving the collider must be taken into account.
+    collider.set_pos(10, 10, 0)
+    assert collide() == [Point3(13.5, 13.25, 0)]
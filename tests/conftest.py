@@ -11,6 +11,30 @@ def base():
     base.destroy()
 
 
+@pytest.fixture
+def run_concurrently():
+    """Returns a function that calls each of the given functions on its own
+    thread, all at once, and returns the list of their results."""
+    import threading
+
+    def run_concurrently(funcs):
+        results = [None] * len(funcs)
+
+        def run(i):
+            results[i] = funcs[i]()
+
+        threads = [threading.Thread(target=run, args=(i,)) for i in range(len(funcs))]
+        for thread in threads:
+            thread.start()
+        for thread in threads:
+            thread.join(10)
+            assert not thread.is_alive()
+
+        return results
+
+    return run_concurrently
+
+
 @pytest.fixture
 def tk_toplevel():
     tk = pytest.importorskip('tkinter')
@@ -0,0 +1,100 @@
+from panda3d import core
+import pytest
+
+
+@pytest.fixture(scope='module')
+def cull_region(graphics_pipe):
+    """Creates and returns a DisplayRegion on an offscreen buffer."""
+
+    engine = core.GraphicsEngine()
+    engine.set_threading_model("")
+
+    fbprops = core.FrameBufferProperties()
+    fbprops.force_hardware = True
+    fbprops.set_rgba_bits(8, 8, 8, 8)
+
+    buffer = engine.make_output(
+        graphics_pipe,
+        'buffer',
+        0,
+        fbprops,
+        core.WindowProperties.size(32, 32),
+        core.GraphicsPipe.BF_refuse_window,
+    )
+    engine.open_windows()
+
+    if buffer is None:
+        pytest.skip("GraphicsPipe cannot make offscreen buffers")
+
+    buffer.set_clear_color_active(True)
+    buffer.set_clear_color((0, 0, 0, 1))
+
+    yield buffer.make_display_region()
+
+    engine.remove_window(buffer)
+
+
+def make_overlapping_cards():
+    """Makes a scene of cards that overlap each other, so that the rendered
+    image depends on the order in which they are culled."""
+
+    scene = core.NodePath("root")
+    scene.set_attrib(core.CullBinAttrib.make("unsorted", 0))
+    scene.set_attrib(core.DepthTestAttrib.make(core.RenderAttrib.M_none))
+    scene.set_attrib(core.DepthWriteAttrib.make(core.DepthWriteAttrib.M_off))
+
+    cm = core.CardMaker("card")
+    for i in range(4):
+        branch = scene.attach_new_node("branch%d" % (i))
+        for j in range(4):
+            n = i * 4 + j
+            x = -1 + j * 0.5
+            z = -1 + i * 0.5
+            cm.set_frame(x - 0.2, x + 0.7, z - 0.2, z + 0.7)
+            cm.set_color(n / 16.0, 1 - n / 16.0, (n % 3) / 2.0, 1)
+            card = branch.attach_new_node(cm.generate())
+            card.set_y(2)
+
+    return scene
+
+
+def render_scene(region, scene):
+    camera = scene.attach_new_node(core.Camera("camera"))
+    lens = core.OrthographicLens()
+    lens.set_film_size(2, 2)
+    lens.set_near_far(1, 3)
+    camera.node().set_lens(lens)
+
+    region.active = True
+    region.camera = camera
+
+    texture = core.Texture("color")
+    region.window.add_render_texture(texture,
+                                     core.GraphicsOutput.RTM_copy_ram,
+                                     core.GraphicsOutput.RTP_color)
+    region.window.engine.render_frame()
+    region.window.clear_render_textures()
+    camera.remove_node()
+
+    return bytes(texture.get_ram_image_as("RGBA"))
+
+
+@pytest.mark.parametrize("depth", [0, 1])
+def test_cull_parallel_order(cull_region, depth):
+    num_threads = core.ConfigVariableInt("cull-num-threads")
+    parallel_depth = core.ConfigVariableInt("cull-parallel-depth")
+
+    scene = make_overlapping_cards()
+    serial = render_scene(cull_region, scene)
+    assert len(set(serial)) > 2
+
+    num_threads.set_value(2)
+    parallel_depth.set_value(depth)
+    try:
+        # Render a few times, since the helper threads may or may not get to
+        # claim any of the subtrees.
+        for i in range(5):
+            assert render_scene(cull_region, scene) == serial
+    finally:
+        num_threads.clear_local_value()
+        parallel_depth.clear_local_value()
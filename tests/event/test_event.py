@@ -1,4 +1,4 @@
-from panda3d.core import Event, EventQueue
+from panda3d.core import Event, EventQueue, EventHandler
 from contextlib import contextmanager
 import gc
 
@@ -62,3 +62,62 @@ def test_event_subclass_gc():
 
         gc.collect()
         assert len(gc.garbage) == 0
+
+
+def test_event_queue_order():
+    queue = EventQueue()
+    assert queue.is_queue_empty()
+
+    for name in ('a', 'b', 'c'):
+        queue.queue_event(Event(name))
+
+    assert not queue.is_queue_empty()
+    assert queue.dequeue_event().name == 'a'
+    assert queue.dequeue_event().name == 'b'
+    assert queue.dequeue_event().name == 'c'
+    assert queue.is_queue_empty()
+
+    queue.queue_event(Event('d'))
+    queue.clear()
+    assert queue.is_queue_empty()
+
+
+def test_event_name():
+    event = Event('test_event_name')
+    assert event.has_name()
+    assert event.name == 'test_event_name'
+
+    event.name = 'test_event_name2'
+    assert event.name == 'test_event_name2'
+    assert Event(event).name == 'test_event_name2'
+
+    event.clear_name()
+    assert not event.has_name()
+    assert event.name == ''
+
+
+def test_event_handler_future():
+    queue = EventQueue()
+    handler = EventHandler(queue)
+
+    future = handler.get_future('test_event_handler_future')
+    assert handler.get_future('test_event_handler_future') == future
+    assert not future.done()
+
+    queue.queue_event(Event('test_event_handler_future2'))
+    handler.process_events()
+    assert not future.done()
+
+    event = Event('test_event_handler_future')
+    queue.queue_event(event)
+    handler.process_events()
+    assert future.done()
+    assert future.result() == event
+
+    # The same name is looked up again for each new event.
+    future = handler.get_future('test_event_handler_future')
+    assert not future.done()
+    queue.queue_event(Event('test_event_handler_' + 'future'))
+    handler.process_events()
+    assert future.done()
+    assert future.result().name == 'test_event_handler_future'
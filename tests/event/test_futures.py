@@ -629,6 +629,103 @@ def test_future_done_callback_already_done():
     assert called[0]
 
 
+def test_task_manager_add_after():
+    task_mgr = core.AsyncTaskManager.get_global_ptr()
+    fut = core.AsyncFuture()
+
+    called = []
+    def first(task):
+        called.append(1)
+        return task.done
+
+    def second(task):
+        called.append(2)
+        return task.done
+
+    task1 = core.PythonTask(first, 'first')
+    task2 = core.PythonTask(second, 'second')
+    task_mgr.add_after(task1, task2)
+    task_mgr.add_after(fut, task1)
+
+    task_mgr.poll()
+    assert not task1.done()
+    assert not task2.done()
+    assert called == []
+
+    fut.set_result(None)
+    task_mgr.poll()
+    task_mgr.poll()
+    assert task1.done()
+    assert task2.done()
+    assert called == [1, 2]
+
+def test_task_manager_add_after_done():
+    # If the future is already done, the task is added right away.
+    task_mgr = core.AsyncTaskManager.get_global_ptr()
+    fut = core.AsyncFuture()
+    fut.set_result(None)
+
+    called = []
+    def func(task):
+        called.append(1)
+        return task.done
+
+    task = core.PythonTask(func, 'after_done')
+    task_mgr.add_after(fut, task)
+    assert task.manager == task_mgr
+
+    task_mgr.poll()
+    assert task.done()
+    assert called == [1]
+
+
+def test_task_manager_add_after_gather():
+    # A task may wait for several futures by way of gather().
+    task_mgr = core.AsyncTaskManager.get_global_ptr()
+    fut1 = core.AsyncFuture()
+    fut2 = core.AsyncFuture()
+
+    called = []
+    def func(task):
+        called.append(1)
+        return task.done
+
+    task = core.PythonTask(func, 'after_gather')
+    task_mgr.add_after(core.AsyncFuture.gather(fut1, fut2), task)
+
+    fut1.set_result(None)
+    task_mgr.poll()
+    assert not task.done()
+    assert called == []
+
+    fut2.set_result(None)
+    task_mgr.poll()
+    task_mgr.poll()
+    assert task.done()
+    assert called == [1]
+
+
+def test_task_manager_add_after_cancelled():
+    # The task is still run if the future it waits for is cancelled.
+    task_mgr = core.AsyncTaskManager.get_global_ptr()
+    fut = core.AsyncFuture()
+
+    called = []
+    def func(task):
+        called.append(1)
+        return task.done
+
+    task = core.PythonTask(func, 'after_cancelled')
+    task_mgr.add_after(fut, task)
+
+    fut.cancel()
+    task_mgr.poll()
+    task_mgr.poll()
+    assert task.done()
+    assert called == [1]
+
+
+
 def test_event_future():
     queue = core.EventQueue()
     handler = core.EventHandler(queue)
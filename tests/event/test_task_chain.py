@@ -0,0 +1,175 @@
+from panda3d import core
+import pytest
+import threading
+import time
+
+
+pytestmark = pytest.mark.skipif(not core.Thread.is_threading_supported(),
+                                reason="Threading support disabled")
+
+
+@pytest.fixture
+def stealing_chain(request):
+    """Yields a task chain with four threads, in work-stealing mode."""
+    task_mgr = core.AsyncTaskManager.get_global_ptr()
+    task_chain = task_mgr.make_task_chain(request.node.name)
+    task_chain.set_num_threads(4)
+    task_chain.set_work_stealing(True)
+    assert task_chain.get_work_stealing()
+
+    yield task_chain
+
+    task_chain.stop_threads()
+    task_mgr.remove(task_mgr.find_tasks_matching(request.node.name + "-*"))
+    task_mgr.remove_task_chain(task_chain.name)
+
+
+def add_task(task_chain, func, name, sort=0, priority=0):
+    task = core.PythonTask(func, task_chain.name + "-" + name)
+    task.set_task_chain(task_chain.name)
+    task.set_sort(sort)
+    task.set_priority(priority)
+    core.AsyncTaskManager.get_global_ptr().add(task)
+    return task
+
+
+def test_work_stealing_sort_order(stealing_chain):
+    events = []
+
+    def make_func(sort):
+        def func(task):
+            events.append(('start', sort))
+            time.sleep(0.001)
+            events.append(('end', sort))
+            return task.done
+        return func
+
+    for sort in range(3):
+        for i in range(20):
+            add_task(stealing_chain, make_func(sort), "%d-%d" % (sort, i), sort=sort)
+
+    stealing_chain.start_threads()
+    stealing_chain.wait_for_tasks()
+
+    assert len(events) == 120
+
+    # No task may start before all of the tasks with a lower sort have ended.
+    for sort in range(1, 3):
+        first_start = events.index(('start', sort))
+        last_end = len(events) - 1 - events[::-1].index(('end', sort - 1))
+        assert last_end < first_start
+
+
+def test_work_stealing_remove_claimed(stealing_chain):
+    # Tasks are only claimed in batches when there is more than one thread.
+    stealing_chain.set_num_threads(2)
+    task_mgr = core.AsyncTaskManager.get_global_ptr()
+    all_added = threading.Event()
+    removed = threading.Event()
+    started = threading.Semaphore(0)
+    ran = []
+
+    # This holds up the chain until all of the other tasks have been added,
+    # since no task in the next sort group can be started before it is done.
+    def blocker_func(task):
+        all_added.wait()
+        return task.done
+
+    add_task(stealing_chain, blocker_func, "blocker", sort=0)
+
+    def slow_func(task):
+        started.release()
+        removed.wait()
+        return task.done
+
+    def victim_func(task):
+        ran.append(task.name)
+        return task.done
+
+    # The first thread to get going claims half of the twelve tasks, which
+    # are slow0 and victims 0 through 4.  The other thread claims half of the
+    # rest, slow1 and victims 5 and 6.  Both then block in their slow task,
+    # leaving the victims queued up behind them.
+    victims = []
+    for i in range(2):
+        add_task(stealing_chain, slow_func, "slow%d" % (i), sort=1,
+                 priority=100 - i * 6)
+        for j in range(5):
+            victims.append(add_task(stealing_chain, victim_func,
+                                    "victim%d" % (len(victims)), sort=1,
+                                    priority=99 - i * 6 - j))
+
+    all_added.set()
+    started.acquire()
+    started.acquire()
+
+    claimed = [victim for victim in victims
+               if victim.state == core.AsyncTask.S_servicing]
+    assert len(claimed) >= 5
+
+    for victim in victims:
+        assert task_mgr.remove(victim)
+    removed.set()
+
+    stealing_chain.wait_for_tasks()
+
+    assert ran == []
+    for victim in victims:
+        assert victim.done()
+        assert victim.cancelled()
+
+
+def test_work_stealing_await(stealing_chain):
+    futures = [core.AsyncFuture() for i in range(20)]
+    results = []
+
+    def make_waiter(i):
+        async def waiter(task):
+            results.append(await futures[i])
+        return waiter
+
+    def make_setter(i):
+        def setter(task):
+            futures[i].set_result(i)
+            return task.done
+        return setter
+
+    # The futures are completed by tasks in the same sort group, which may
+    # well be run before the waiting tasks' results have been posted.
+    for i in range(20):
+        add_task(stealing_chain, make_waiter(i), "waiter%d" % (i), priority=1)
+        add_task(stealing_chain, make_setter(i), "setter%d" % (i), priority=0)
+
+    stealing_chain.start_threads()
+    stealing_chain.wait_for_tasks()
+
+    assert sorted(results) == list(range(20))
+
+
+def test_parallel_chain():
+    task_mgr = core.AsyncTaskManager.get_global_ptr()
+    task_chain = task_mgr.get_parallel_chain()
+    assert task_chain.name == "parallel"
+    assert task_chain.get_work_stealing()
+    assert task_chain.get_num_threads() > 0
+    assert task_mgr.get_parallel_chain() == task_chain
+    assert task_mgr.find_task_chain("parallel") == task_chain
+
+
+def test_parallel_chain_tasks():
+    # Other tasks can share the parallel chain's threads by naming it.
+    task_chain = core.AsyncTaskManager.get_global_ptr().get_parallel_chain()
+
+    results = []
+    def make_func(i):
+        def func(task):
+            results.append(i)
+            return task.done
+        return func
+
+    tasks = [add_task(task_chain, make_func(i), "task%d" % (i))
+             for i in range(20)]
+    for task in tasks:
+        task.wait()
+
+    assert sorted(results) == list(range(20))
@@ -0,0 +1,49 @@
+from panda3d import core
+
+import pytest
+
+
+@pytest.mark.skipif(not hasattr(core, 'compress_string'), reason="Requires zlib")
+def test_compress_string():
+    data = b'abcdefg' * 1000
+
+    for algorithm in (core.CA_zlib, core.CA_lz4, core.CA_zstd):
+        if not core.is_compression_algorithm_supported(algorithm):
+            continue
+
+        comp = core.compress_string(data, 6, algorithm)
+        assert 0 < len(comp) < len(data)
+
+        # The algorithm is recognized when decompressing.
+        assert core.decompress_string(comp) == data
+
+
+@pytest.mark.parametrize("algorithm", ["zlib", "lz4", "zstd"])
+@pytest.mark.skipif(not hasattr(core, 'compress_string'), reason="Requires zlib")
+def test_compress_multifile(algorithm):
+    algorithm = getattr(core, 'CA_' + algorithm)
+    if not core.is_compression_algorithm_supported(algorithm):
+        pytest.skip("Compression algorithm not supported")
+
+    data = bytes(range(256)) * 64
+
+    for block_size in (0, 1000):
+        stream = core.StringStream()
+        m = core.Multifile()
+        m.set_compression_algorithm(algorithm)
+        m.set_compression_block_size(block_size)
+        assert m.open_read_write(stream)
+        m.add_subfile("test.bin", core.StringStream(data), 6)
+        assert m.flush()
+        m.close()
+
+        m = core.Multifile()
+        assert m.open_read(core.IStreamWrapper(stream))
+        assert m.is_subfile_block_compressed(0) == (block_size != 0)
+        assert m.read_subfile(0) == data
+
+        subfile = m.open_read_subfile(0)
+        subfile.seekg(12345)
+        assert subfile.read(10) == data[12345:12355]
+        m.close_read_subfile(subfile)
+        m.close()
@@ -23,3 +23,114 @@ def test_multifile_password():
 
     m.set_encryption_password(b'\xc4\x97\xa1\x01\x85\xb6')
     assert m.get_encryption_password() == b'\xc4\x97\xa1\x01\x85\xb6'
+
+
+def test_multifile_block_compressed():
+    data = bytes(range(256)) * 64
+
+    stream = StringStream()
+    m = Multifile()
+    m.set_compression_block_size(1000)
+    assert m.open_read_write(stream)
+    source = StringStream(data)
+    m.add_subfile("test.bin", source, 6)
+    assert m.flush()
+
+    assert m.is_subfile_compressed(0)
+    assert m.is_subfile_block_compressed(0)
+    assert m.get_subfile_length(0) == len(data)
+    assert m.read_subfile(0) == data
+
+    subfile = m.open_read_subfile(0)
+    for pos in (12345, 0, 999, 1000, len(data) - 3):
+        subfile.seekg(pos)
+        assert subfile.read(10) == data[pos:pos + 10]
+        subfile.clear()
+    m.close_read_subfile(subfile)
+    m.close()
+
+
+def test_multifile_compressed_version():
+    # Without block compression, a compressed subfile doesn't require more
+    # than version 1.1, so we should still be readable by older Pandas.
+    stream = StringStream()
+    m = Multifile()
+    assert m.open_read_write(stream)
+    m.add_subfile("test.bin", StringStream(b"abc" * 100), 6)
+    assert m.flush()
+    assert m.is_subfile_compressed(0)
+    assert not m.is_subfile_block_compressed(0)
+    m.close()
+
+    assert stream.data[6:10] == b'\x01\x00\x01\x00'
+
+
+def test_multifile_block_compressed_version():
+    stream = StringStream()
+    m = Multifile()
+    m.set_compression_block_size(1000)
+    assert m.open_read_write(stream)
+    m.add_subfile("test.bin", StringStream(b"abc" * 1000), 6)
+    assert m.flush()
+    m.close()
+
+    assert stream.data[6:10] == b'\x01\x00\x02\x00'
+
+
+def test_multifile_block_compressed_append():
+    data = bytes(range(256)) * 16
+
+    stream = StringStream()
+    m = Multifile()
+    assert m.open_read_write(stream)
+    m.add_subfile("a.bin", StringStream(data), 6)
+    assert m.flush()
+    m.close()
+    assert stream.data[6:10] == b'\x01\x00\x01\x00'
+
+    # Adding a block-compressed subfile to an existing version 1.1 file should
+    # just bump the version, not repack the file (which would fail here, since
+    # there is no filename to repack to).
+    m = Multifile()
+    m.set_compression_block_size(1000)
+    assert m.open_read_write(stream)
+    m.add_subfile("b.bin", StringStream(data), 6)
+    assert m.flush()
+    m.close()
+    assert stream.data[6:10] == b'\x01\x00\x02\x00'
+
+    m = Multifile()
+    assert m.open_read(IStreamWrapper(stream))
+    assert m.get_num_subfiles() == 2
+    assert not m.is_subfile_block_compressed(m.find_subfile("a.bin"))
+    assert m.is_subfile_block_compressed(m.find_subfile("b.bin"))
+    assert m.read_subfile(m.find_subfile("a.bin")) == data
+    assert m.read_subfile(m.find_subfile("b.bin")) == data
+    m.close()
+
+
+def test_multifile_mount_read_only():
+    from panda3d.core import VirtualFileSystem, VirtualFileMountMultifile
+
+    stream = StringStream()
+    m = Multifile()
+    assert m.open_read_write(stream)
+    m.add_subfile("models/a.egg", StringStream(b"a"), 0)
+    m.add_subfile("models/sub/b.egg", StringStream(b"b"), 0)
+    assert m.flush()
+    m.close()
+
+    m = Multifile()
+    assert m.open_read(IStreamWrapper(stream))
+
+    vfs = VirtualFileSystem()
+    mount = VirtualFileMountMultifile(m)
+    assert vfs.mount(mount, "/mf", 0)
+
+    assert vfs.is_directory("/mf/models")
+    assert vfs.is_directory("/mf/models/sub")
+    assert not vfs.is_directory("/mf/models/a.egg")
+    assert vfs.is_regular_file("/mf/models/sub/b.egg")
+    assert vfs.exists("/mf/models/a.egg")
+    assert not vfs.exists("/mf/models/c.egg")
+    assert not vfs.exists("/mf/model")
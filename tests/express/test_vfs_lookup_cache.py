@@ -0,0 +1,110 @@
+from panda3d.core import VirtualFileSystem, VirtualFileMountSystem
+from panda3d.core import ConfigVariableBool, Filename
+import pytest
+
+
+@pytest.fixture
+def lookup_cache():
+    """Enables vfs-lookup-cache for the duration of the test."""
+    var = ConfigVariableBool("vfs-lookup-cache")
+    var.set_value(True)
+    yield var
+    var.clear_local_value()
+
+
+@pytest.fixture
+def disk_dir(tmp_path):
+    """Yields a fresh directory on disk, as a panda Filename."""
+    return Filename.from_os_specific(str(tmp_path))
+
+
+@pytest.fixture
+def vfs(disk_dir):
+    """Yields a private VirtualFileSystem with disk_dir mounted on /disk."""
+    vfs = VirtualFileSystem()
+    assert vfs.mount(VirtualFileMountSystem(disk_dir), "/disk", 0)
+    yield vfs
+    vfs.unmount_all()
+
+
+def write_disk_file(dir, name, data=b"data"):
+    """Writes a file directly to the disk, bypassing the VirtualFileSystem."""
+    with open(Filename(dir, name).to_os_specific(), "wb") as fh:
+        fh.write(data)
+
+
+def test_vfs_lookup_cache_hit(vfs, disk_dir, lookup_cache):
+    write_disk_file(disk_dir, "hit.txt")
+
+    # Looking up the same file again returns the remembered result.
+    file1 = vfs.get_file("/disk/hit.txt")
+    assert file1 is not None
+    file2 = vfs.get_file("/disk/hit.txt")
+    assert file2.this == file1.this
+
+    # A status-only lookup is remembered separately.
+    file3 = vfs.get_file("/disk/hit.txt", True)
+    assert file3 is not None
+    assert vfs.get_file("/disk/hit.txt", True).this == file3.this
+
+    # Failures are remembered too.
+    assert vfs.get_file("/disk/missing.txt") is None
+    assert vfs.get_file("/disk/missing.txt") is None
+
+
+def test_vfs_lookup_cache_disabled(vfs, disk_dir):
+    write_disk_file(disk_dir, "uncached.txt")
+
+    # Without the cache, each lookup consults the mounts anew.
+    file1 = vfs.get_file("/disk/uncached.txt")
+    file2 = vfs.get_file("/disk/uncached.txt")
+    assert file1 is not None
+    assert file2 is not None
+    assert file2.this != file1.this
+
+    assert not vfs.exists("/disk/later.txt")
+    write_disk_file(disk_dir, "later.txt")
+    assert vfs.exists("/disk/later.txt")
+
+
+def test_vfs_lookup_cache_mount(vfs, disk_dir, lookup_cache, tmp_path_factory):
+    other_dir = Filename.from_os_specific(str(tmp_path_factory.mktemp("other")))
+    write_disk_file(other_dir, "mounted.txt")
+
+    assert not vfs.exists("/other/mounted.txt")
+
+    # Adding a mount discards the remembered failure.
+    mount = VirtualFileMountSystem(other_dir)
+    assert vfs.mount(mount, "/other", 0)
+    file = vfs.get_file("/other/mounted.txt")
+    assert file is not None
+    assert vfs.get_file("/other/mounted.txt").this == file.this
+
+    # As does removing it again.
+    assert vfs.unmount(mount) == 1
+    assert not vfs.exists("/other/mounted.txt")
+    assert vfs.get_file("/other/mounted.txt") is None
+
+
+def test_vfs_lookup_cache_invalidate(vfs, disk_dir, lookup_cache):
+    assert not vfs.exists("/disk/created.txt")
+
+    # A file created behind the VirtualFileSystem's back isn't noticed...
+    write_disk_file(disk_dir, "created.txt")
+    assert not vfs.exists("/disk/created.txt")
+
+    # ...until the cache is invalidated.
+    vfs.invalidate_lookup_cache()
+    assert vfs.exists("/disk/created.txt")
+
+
+def test_vfs_lookup_cache_write(vfs, disk_dir, lookup_cache):
+    assert not vfs.exists("/disk/written.txt")
+
+    # Files created and deleted through the VirtualFileSystem are noticed
+    # right away.
+    assert vfs.write_file("/disk/written.txt", b"data", False)
+    assert vfs.exists("/disk/written.txt")
+
+    assert vfs.delete_file("/disk/written.txt")
+    assert not vfs.exists("/disk/written.txt")
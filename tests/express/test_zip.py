@@ -1,6 +1,8 @@
 from panda3d.core import ZipArchive, IStreamWrapper, StringStream, Filename
 from direct.stdpy.file import StreamIOWrapper
 import zipfile
+import struct
+import pytest
 from io import BytesIO
 
 
@@ -181,3 +183,73 @@ def test_zip_repack(tmp_path):
         assert zf.read("test1.txt") == b"contents of first file"
         assert "test2.txt" not in zf.namelist()
         assert zf.read("test3.txt") == b"contents of third file"
+
+
+@pytest.fixture(params=[False, True], ids=["stream", "mmap"])
+def zip_mmap(request):
+    from panda3d.core import ConfigVariableBool
+
+    var = ConfigVariableBool("zip-mmap")
+    var.value = request.param
+    yield request.param
+    var.clear_local_value()
+
+
+def test_zip_read_file(tmp_path, zip_mmap):
+    zip_path = tmp_path / "test_zip_read_file.zip"
+    zf = zipfile.ZipFile(zip_path, mode='w', allowZip64=True)
+    zf.writestr("test.txt", b"test stored", compress_type=zipfile.ZIP_STORED)
+    zf.writestr("test2.txt", b"test deflated", compress_type=zipfile.ZIP_DEFLATED)
+    zf.writestr("déjà.txt", b"test unicode", compress_type=zipfile.ZIP_STORED)
+    zf.comment = b"comment"
+    zf.close()
+
+    zip = ZipArchive()
+    zip.open_read(zip_path)
+
+    assert zip.is_read_valid()
+    assert zip.get_num_subfiles() == 3
+    assert zip.get_comment() == "comment"
+    assert zip.verify()
+
+    sf = zip.find_subfile("test.txt")
+    assert sf >= 0
+    assert zip.read_subfile(sf) == b"test stored"
+
+    stream = zip.open_read_subfile(sf)
+    stream.seekg(5)
+    assert stream.read(6) == b"stored"
+    ZipArchive.close_read_subfile(stream)
+
+    sf = zip.find_subfile("test2.txt")
+    assert sf >= 0
+    assert zip.read_subfile(sf) == b"test deflated"
+
+    sf = zip.find_subfile("déjà.txt")
+    assert sf >= 0
+    assert zip.read_subfile(sf) == b"test unicode"
+
+    zip.close()
+
+
+def test_zip_read_stored_length_mismatch(tmp_path, zip_mmap):
+    zip_path = tmp_path / "test_zip_read_stored_length_mismatch.zip"
+    zf = zipfile.ZipFile(zip_path, mode='w')
+    zf.writestr("test.txt", b"test stored", compress_type=zipfile.ZIP_STORED)
+    zf.close()
+
+    # Claim in the central directory that the stored file is much longer than
+    # the data that is actually present in the archive.
+    data = bytearray(zip_path.read_bytes())
+    cdir = data.index(b'PK\x01\x02')
+    struct.pack_into('<I', data, cdir + 24, 0x100000)
+    zip_path.write_bytes(bytes(data))
+
+    zip = ZipArchive()
+    assert zip.open_read(zip_path)
+
+    sf = zip.find_subfile("test.txt")
+    assert sf >= 0
+    assert zip.read_subfile(sf) == b""
+
+    zip.close()
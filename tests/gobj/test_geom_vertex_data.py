@@ -0,0 +1,103 @@
+from panda3d import core
+import pytest
+
+
+def make_skinned_data(num_rows):
+    vertex_array = core.GeomVertexArrayFormat()
+    vertex_array.add_column("vertex", 3, core.Geom.NT_float32, core.Geom.C_point)
+    vertex_array.add_column("normal", 3, core.Geom.NT_float32, core.Geom.C_normal)
+    blend_array = core.GeomVertexArrayFormat()
+    blend_array.add_column("transform_blend", 1, core.Geom.NT_uint16, core.Geom.C_index)
+
+    anim = core.GeomVertexAnimationSpec()
+    anim.set_panda()
+    fmt = core.GeomVertexFormat()
+    fmt.add_array(vertex_array)
+    fmt.add_array(blend_array)
+    fmt.set_animation(anim)
+    fmt = core.GeomVertexFormat.register_format(fmt)
+
+    xform0 = core.UserVertexTransform("xform0")
+    xform0.set_matrix(core.Mat4.translate_mat(1, 2, 3))
+    xform1 = core.UserVertexTransform("xform1")
+    xform1.set_matrix(core.Mat4.scale_mat(2))
+
+    table = core.TransformBlendTable()
+    table.add_blend(core.TransformBlend(xform0, 1.0))
+    table.add_blend(core.TransformBlend(xform0, 0.5, xform1, 0.5))
+    table.set_rows(core.SparseArray.lower_on(num_rows))
+
+    vdata = core.GeomVertexData("skinned", fmt, core.Geom.UH_static)
+    vdata.set_num_rows(num_rows)
+    vdata.set_transform_blend_table(table)
+
+    vertex = core.GeomVertexWriter(vdata, "vertex")
+    normal = core.GeomVertexWriter(vdata, "normal")
+    blend = core.GeomVertexWriter(vdata, "transform_blend")
+    for i in range(num_rows):
+        vertex.add_data3(i, -i, i * 0.5)
+        normal.add_data3(0, 0, 1)
+        blend.add_data1i((i // 7) % 2)
+
+    return vdata
+
+
+def expected_vertex(i):
+    v = core.Point3(i, -i, i * 0.5)
+    if (i // 7) % 2 == 0:
+        return v + core.Vec3(1, 2, 3)
+    else:
+        return v * 1.5 + core.Vec3(0.5, 1, 1.5)
+
+
+@pytest.mark.parametrize("num_threads", [0, 3])
+def test_geom_vertex_data_animate_vertices(num_threads):
+    page = core.load_prc_file_data("", "skinning-num-threads %d\n"
+                                       "skinning-parallel-min-vertices 16" % (num_threads))
+    try:
+        num_rows = 1000
+        vdata = make_skinned_data(num_rows)
+        animated = vdata.animate_vertices(True, core.Thread.get_current_thread())
+        assert animated.get_num_rows() == num_rows
+
+        vertex = core.GeomVertexReader(animated, "vertex")
+        normal = core.GeomVertexReader(animated, "normal")
+        for i in range(num_rows):
+            assert vertex.get_data3().almost_equal(expected_vertex(i), 0.001)
+            assert normal.get_data3().almost_equal(core.Vec3(0, 0, 1), 0.001)
+    finally:
+        core.unload_prc_file(page)
+
+
+@pytest.mark.parametrize("minor_ver", [44, 46])
+def test_geom_vertex_data_bam_round_trip(minor_ver):
+    num_rows = 1000
+    vdata = make_skinned_data(num_rows)
+
+    buf = core.DatagramBuffer()
+    writer = core.BamWriter(buf)
+    writer.set_file_minor_ver(minor_ver)
+    writer.init()
+    writer.write_object(vdata)
+    del writer
+
+    reader = core.BamReader(buf)
+    reader.init()
+    copy = reader.read_object()
+    reader.resolve()
+    del reader
+
+    vertex = core.GeomVertexReader(copy, "vertex")
+    for i in range(num_rows):
+        assert vertex.get_data3() == core.Point3(i, -i, i * 0.5)
+
+    # Modifying the data read from the bam file must not disturb the rest.
+    writer = core.GeomVertexWriter(copy, "vertex")
+    writer.set_row(1)
+    writer.set_data3(7, 8, 9)
+    del writer
+
+    vertex = core.GeomVertexReader(copy, "vertex")
+    assert vertex.get_data3() == core.Point3(0, 0, 0)
+    assert vertex.get_data3() == core.Point3(7, 8, 9)
+    assert vertex.get_data3() == core.Point3(2, -2, 1)
@@ -81,3 +81,24 @@ def test_shader_load_compute(vfs, ramdir):
     shad2 = Shader.load_compute(Shader.SL_GLSL, comp_file)
 
     assert shad2.this != shad1.this
+
+
+def test_shader_load_concurrent(vfs, ramdir, run_concurrently):
+    vert_file = Filename(ramdir, "concurrent.vert")
+    frag_file = Filename(ramdir, "concurrent.frag")
+
+    def load():
+        return Shader.load(Shader.SL_GLSL, vertex=vert_file, fragment=frag_file)
+
+    # A failed load must not leave the file marked as being loaded.
+    shaders = run_concurrently([load] * 4)
+    assert shaders == [None] * 4
+
+    vfs.write_file(vert_file, b"#version 100\nvoid main() {}\n", False)
+    vfs.write_file(frag_file, b"#version 100\nvoid main() {}\n", False)
+
+    # All of the threads get the same shader, from a single load.
+    shaders = run_concurrently([load] * 4)
+    assert shaders[0] is not None
+    for shader in shaders:
+        assert shader.this == shaders[0].this
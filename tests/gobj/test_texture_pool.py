@@ -430,3 +430,154 @@ def test_no_texture_filter_option(pool, pre_filter, image_rgb_path):
     texture = pool.load_texture(image_rgb_path, 3, False, core.LoaderOptions(0, core.LoaderOptions.TF_no_filters))
     assert isinstance(texture, core.Texture)
     assert texture.get_name() != 'preloaded'
+
+
+@pytest.fixture
+def max_texture_ram():
+    "This fixture sets a max-resident-texture-ram that is never reached."
+    var = core.ConfigVariableInt64('max-resident-texture-ram')
+    var.value = 1 << 40
+    core.Texture.lru_epoch()
+    yield var
+    var.clear_local_value()
+    core.Texture.lru_epoch()
+
+
+def evict_ram_images(max_texture_ram):
+    limit = max_texture_ram.value
+    try:
+        max_texture_ram.value = 0
+        core.Texture.lru_epoch()
+        core.Texture.lru_epoch()
+    finally:
+        max_texture_ram.value = limit
+        core.Texture.lru_epoch()
+
+
+def test_texture_ram_image_lru(pool, image_rgba_path, max_texture_ram):
+    lru = core.Texture.get_ram_image_lru()
+    assert lru.get_max_size() == 1 << 40
+
+    options = core.LoaderOptions(0, core.LoaderOptions.TF_preload)
+    tex = pool.load_texture(image_rgba_path, 4, False, options)
+    assert tex.has_ram_image()
+    assert lru.get_total_size() >= 4
+    evicted_size = core.Texture.get_ram_image_evicted_size()
+
+    evict_ram_images(max_texture_ram)
+
+    # The RAM image was released, but is reloaded from disk on demand.
+    assert not tex.has_ram_image()
+    assert core.Texture.get_ram_image_evicted_size() > evicted_size
+    assert tex.get_ram_image()
+    assert core.Texture.get_ram_image_evicted_size() == evicted_size
+
+
+def test_texture_ram_image_lru_unlimited(pool, image_rgba_path):
+    # Without a limit, the RAM images aren't tracked at all.
+    lru = core.Texture.get_ram_image_lru()
+    total_size = lru.get_total_size()
+
+    options = core.LoaderOptions(0, core.LoaderOptions.TF_preload)
+    tex = pool.load_texture(image_rgba_path, 4, False, options)
+    assert tex.has_ram_image()
+    assert tex.get_ram_image()
+    assert lru.get_total_size() == total_size
+
+
+def test_texture_ram_image_lru_modify(pool, image_rgba_path, max_texture_ram):
+    options = core.LoaderOptions(0, core.LoaderOptions.TF_preload)
+    tex = pool.load_texture(image_rgba_path, 4, False, options)
+    assert tex.loaded_from_image
+
+    # Once the image has been modified, it would be lost if it were released,
+    # so it must not be evicted any more.  It can still be reloaded from disk
+    # when asked to, though.
+    image = tex.modify_ram_image()
+    image[0] = 0x12
+    assert tex.loaded_from_image
+
+    evict_ram_images(max_texture_ram)
+    assert tex.has_ram_image()
+    assert tex.get_ram_image()[0] == 0x12
+
+    # Reloading it discards the modification, so that it may be evicted again.
+    assert tex.reload()
+    assert tex.get_ram_image()[0] != 0x12
+    evict_ram_images(max_texture_ram)
+    assert not tex.has_ram_image()
+
+
+def test_texture_ram_image_lru_set(pool, image_rgba_path, max_texture_ram):
+    options = core.LoaderOptions(0, core.LoaderOptions.TF_preload)
+    tex = pool.load_texture(image_rgba_path, 4, False, options)
+    assert tex.loaded_from_image
+
+    tex.set_ram_image(b'\x12\x34\x56\x78')
+    assert tex.loaded_from_image
+
+    evict_ram_images(max_texture_ram)
+    assert tex.has_ram_image()
+    assert bytes(tex.get_ram_image()) == b'\x12\x34\x56\x78'
+
+
+def test_texture_ram_image_lru_keep_texture_ram(pool, image_rgba_path, max_texture_ram):
+    keep_texture_ram = core.ConfigVariableBool('keep-texture-ram')
+    keep_texture_ram.value = True
+    try:
+        options = core.LoaderOptions(0, core.LoaderOptions.TF_preload)
+        tex = pool.load_texture(image_rgba_path, 4, False, options)
+        evicted_size = core.Texture.get_ram_image_evicted_size()
+
+        evict_ram_images(max_texture_ram)
+        assert tex.has_ram_image()
+        assert core.Texture.get_ram_image_evicted_size() == evicted_size
+    finally:
+        keep_texture_ram.clear_local_value()
+
+
+class SlowTextureFilter(object):
+    "A pre-load filter that counts the loads and makes them take a while."
+
+    def __init__(self):
+        self.calls = []
+
+    def pre_load(self, orig_filename, orig_alpha_filename,
+                 primary_file_num_channels, alpha_file_channel,
+                 read_mipmaps, options):
+        import time
+        self.calls.append(orig_filename)
+        time.sleep(0.2)
+        return None
+
+
+def test_load_texture_concurrent(pool, image_rgba_path, run_concurrently):
+    tex_filter = SlowTextureFilter()
+    register_filter(pool, tex_filter)
+    try:
+        textures = run_concurrently([lambda: pool.load_texture(image_rgba_path)] * 4)
+    finally:
+        pool.unregister_filter(tex_filter)
+
+    # Only one thread loaded the texture; the others waited for it.
+    assert len(tex_filter.calls) == 1
+    assert textures[0] is not None
+    for tex in textures:
+        assert tex == textures[0]
+
+
+def test_load_texture_concurrent_failure(pool, run_concurrently):
+    tex_filter = SlowTextureFilter()
+    register_filter(pool, tex_filter)
+    try:
+        textures = run_concurrently([lambda: pool.load_texture('/nonexistent.png')] * 3)
+
+        # Each failed load released its claim, so that each waiting thread
+        # got to try it again, rather than waiting forever.
+        assert textures == [None] * 3
+        assert len(tex_filter.calls) == 3
+
+        assert pool.load_texture('/nonexistent.png') is None
+        assert len(tex_filter.calls) == 4
+    finally:
+        pool.unregister_filter(tex_filter)
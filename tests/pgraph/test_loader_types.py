@@ -4,6 +4,8 @@ import tempfile
 import os
 from contextlib import contextmanager
 import sys
+import threading
+import time
 
 
 @pytest.fixture
@@ -226,3 +228,102 @@ def test_loader_file_type_registry_pickle():
 
     registry = LoaderFileTypeRegistry.get_global_ptr()
     assert loads(dumps(registry, -1)) == registry
+
+
+def test_loader_concurrent(test_filename, run_concurrently):
+    """Tests that concurrent loads of the same file share a single load."""
+
+    from panda3d.core import ModelPool
+    ModelPool.release_all_models()
+
+    calls = []
+
+    class SlowLoader:
+        extensions = ["test"]
+
+        @staticmethod
+        def load_file(path, options, record=None):
+            calls.append(path)
+            time.sleep(0.2)
+            return ModelRoot("loaded")
+
+    loader = Loader.get_global_ptr()
+    options = LoaderOptions(LoaderOptions.LF_no_disk_cache | LoaderOptions.LF_allow_instance)
+    with registered_type(SlowLoader):
+        models = run_concurrently([lambda: loader.load_sync(test_filename, options)] * 4)
+
+    assert len(calls) == 1
+    assert models[0] is not None
+    for model in models:
+        assert model == models[0]
+
+    ModelPool.release_model(models[0])
+
+
+def test_loader_concurrent_options(test_filename, run_concurrently):
+    """Tests that concurrent loads with different options are not shared."""
+
+    from panda3d.core import ModelPool
+    ModelPool.release_all_models()
+
+    calls = []
+    barrier = threading.Barrier(2, timeout=5)
+
+    class BarrierLoader:
+        extensions = ["test"]
+
+        @staticmethod
+        def load_file(path, options, record=None):
+            calls.append(path)
+            # Both loads must be running at the same time to get past this.
+            barrier.wait()
+            return ModelRoot("loaded")
+
+    loader = Loader.get_global_ptr()
+    options1 = LoaderOptions(LoaderOptions.LF_no_disk_cache)
+    options2 = LoaderOptions(LoaderOptions.LF_no_disk_cache)
+    options2.texture_flags = LoaderOptions.TF_preload
+    with registered_type(BarrierLoader):
+        models = run_concurrently([
+            lambda: loader.load_sync(test_filename, options1),
+            lambda: loader.load_sync(test_filename, options2),
+        ])
+
+    assert len(calls) == 2
+    assert models[0] is not None
+    assert models[1] is not None
+
+    ModelPool.release_all_models()
+
+
+def test_loader_concurrent_failure(test_filename, run_concurrently):
+    """Tests that a failed load lets a waiting thread try it again."""
+
+    from panda3d.core import ModelPool
+    ModelPool.release_all_models()
+
+    calls = []
+
+    class FailOnceLoader:
+        extensions = ["test"]
+
+        @staticmethod
+        def load_file(path, options, record=None):
+            calls.append(path)
+            time.sleep(0.2)
+            if len(calls) == 1:
+                raise Exception("test error")
+            return ModelRoot("loaded")
+
+    loader = Loader.get_global_ptr()
+    options = LoaderOptions(LoaderOptions.LF_no_disk_cache | LoaderOptions.LF_allow_instance)
+    with registered_type(FailOnceLoader):
+        models = run_concurrently([lambda: loader.load_sync(test_filename, options)] * 3)
+
+    # The first load failed, and then one of the other threads loaded it.
+    assert len(calls) == 2
+    models = [model for model in models if model is not None]
+    assert len(models) == 2
+    assert models[0] == models[1]
+
+    ModelPool.release_model(models[0])
@@ -1,4 +1,6 @@
 from panda3d.core import RenderState, TransparencyAttrib, ColorAttrib
+from panda3d.core import ColorScaleAttrib, ConfigVariableBool
+from panda3d.core import ConfigVariableDouble
 import pytest
 
 
@@ -19,3 +21,89 @@ def test_renderstate_make():
     assert state.has_attrib(TransparencyAttrib)
     assert state.attribs[ColorAttrib] == ColorAttrib.make_vertex()
     assert state.attribs[TransparencyAttrib] == TransparencyAttrib.make_default()
+
+
+def has_state_with_color_scale(scale):
+    return any(state.has_attrib(ColorScaleAttrib) and
+               state.get_attrib(ColorScaleAttrib).get_scale() == scale
+               for state in RenderState.get_states())
+
+
+@pytest.mark.skipif(not ConfigVariableBool('garbage-collect-states').value,
+                    reason="requires garbage-collect-states")
+def test_renderstate_clear_cache_releases_states():
+    a = RenderState.make(ColorScaleAttrib.make((0.5, 0.25, 0.125, 1)))
+    b = RenderState.make(ColorAttrib.make_flat((0.5, 0.25, 0.125, 1)))
+    c = a.compose(b)
+    assert c.has_attrib(ColorAttrib)
+
+    # The composition is now also in this thread's composition cache, which
+    # must not keep the states alive after the cache has been cleared.
+    del a, b, c
+    RenderState.clear_cache()
+    while RenderState.garbage_collect() > 0:
+        pass
+    assert not has_state_with_color_scale((0.5, 0.25, 0.125, 1))
+
+
+@pytest.mark.skipif(not ConfigVariableBool('garbage-collect-states').value,
+                    reason="requires garbage-collect-states")
+def test_renderstate_garbage_collect_releases_states():
+    a = RenderState.make(ColorScaleAttrib.make((0.25, 0.125, 0.5, 1)))
+    b = RenderState.make(ColorAttrib.make_flat((0.25, 0.125, 0.5, 1)))
+    c = a.compose(b)
+    assert c.has_attrib(ColorAttrib)
+    del a, b, c
+
+    # A full sweep marks the per-thread caches stale, so they let go of their
+    # states the next time they are used, and the next sweep can collect them.
+    RenderState.garbage_collect()
+    x = RenderState.make(ColorAttrib.make_flat((1, 0, 1, 1)))
+    y = RenderState.make(TransparencyAttrib.make(TransparencyAttrib.M_alpha))
+    assert x.compose(y).has_attrib(TransparencyAttrib)
+    while RenderState.garbage_collect() > 0:
+        pass
+    assert not has_state_with_color_scale((0.25, 0.125, 0.5, 1))
+
+
+@pytest.mark.skipif(not ConfigVariableBool('garbage-collect-states').value,
+                    reason="requires garbage-collect-states")
+def test_renderstate_garbage_collect_rate_zero():
+    rate = ConfigVariableDouble('garbage-collect-states-rate')
+    rate.set_value(0)
+    try:
+        a = RenderState.make(ColorScaleAttrib.make((0.75, 0.5, 0.25, 1)))
+        del a
+
+        # A rate of 0 disables the collection of states altogether.
+        RenderState.garbage_collect()
+        assert has_state_with_color_scale((0.75, 0.5, 0.25, 1))
+    finally:
+        rate.clear_local_value()
+
+    while RenderState.garbage_collect() > 0:
+        pass
+    assert not has_state_with_color_scale((0.75, 0.5, 0.25, 1))
+
+
+@pytest.mark.skipif(not ConfigVariableBool('garbage-collect-states').value,
+                    reason="requires garbage-collect-states")
+def test_renderstate_garbage_collect_budget():
+    a = RenderState.make(ColorScaleAttrib.make((0.125, 0.25, 0.75, 1)))
+
+    # Collect everything, so that our state is no longer a new one.
+    while RenderState.garbage_collect() > 0:
+        pass
+    del a
+
+    # Even with a budget that runs out immediately, every pass must make some
+    # progress through the older states.
+    budget = ConfigVariableDouble('garbage-collect-states-budget')
+    budget.set_value(1e-9)
+    try:
+        for i in range(RenderState.get_num_states() + 1):
+            RenderState.garbage_collect()
+    finally:
+        budget.clear_local_value()
+
+    assert not has_state_with_color_scale((0.125, 0.25, 0.75, 1))
@@ -1,4 +1,6 @@
 from panda3d.core import TransformState, Mat4, Mat3
+from panda3d.core import ConfigVariableBool, ConfigVariableDouble
+import pytest
 
 
 def test_transform_identity():
@@ -66,3 +68,90 @@ def test_transform_invalid():
 
     state2 = TransformState.make_invalid()
     assert state.this == state2.this
+
+
+def has_transform_with_pos(pos):
+    return any(state.has_pos() and state.get_pos() == pos
+               for state in TransformState.get_states())
+
+
+@pytest.mark.skipif(not ConfigVariableBool('garbage-collect-states').value,
+                    reason="requires garbage-collect-states")
+def test_transform_clear_cache_releases_states():
+    a = TransformState.make_pos((1.5, 2.5, 3.5))
+    b = TransformState.make_pos((4.5, 5.5, 6.5))
+    c = a.compose(b)
+    assert c.get_pos() == (6, 8, 10)
+
+    # The composition is now also in this thread's composition cache, which
+    # must not keep the states alive after the cache has been cleared.
+    del a, b, c
+    TransformState.clear_cache()
+    while TransformState.garbage_collect() > 0:
+        pass
+    assert not has_transform_with_pos((1.5, 2.5, 3.5))
+    assert not has_transform_with_pos((6, 8, 10))
+
+
+@pytest.mark.skipif(not ConfigVariableBool('garbage-collect-states').value,
+                    reason="requires garbage-collect-states")
+def test_transform_garbage_collect_releases_states():
+    a = TransformState.make_pos((2.5, 3.5, 4.5))
+    b = TransformState.make_pos((5.5, 6.5, 7.5))
+    c = a.compose(b)
+    assert c.get_pos() == (8, 10, 12)
+    del a, b, c
+
+    # A full sweep marks the per-thread caches stale, so they let go of their
+    # states the next time they are used, and the next sweep can collect them.
+    TransformState.garbage_collect()
+    x = TransformState.make_pos((0.25, 0, 0))
+    y = TransformState.make_pos((0, 0.25, 0))
+    assert x.compose(y).get_pos() == (0.25, 0.25, 0)
+    while TransformState.garbage_collect() > 0:
+        pass
+    assert not has_transform_with_pos((2.5, 3.5, 4.5))
+    assert not has_transform_with_pos((8, 10, 12))
+
+
+@pytest.mark.skipif(not ConfigVariableBool('garbage-collect-states').value,
+                    reason="requires garbage-collect-states")
+def test_transform_garbage_collect_rate_zero():
+    rate = ConfigVariableDouble('garbage-collect-states-rate')
+    rate.set_value(0)
+    try:
+        a = TransformState.make_pos((3.25, 4.25, 5.25))
+        del a
+
+        # A rate of 0 disables the collection altogether.
+        assert TransformState.garbage_collect() == 0
+        assert has_transform_with_pos((3.25, 4.25, 5.25))
+    finally:
+        rate.clear_local_value()
+
+    while TransformState.garbage_collect() > 0:
+        pass
+    assert not has_transform_with_pos((3.25, 4.25, 5.25))
+
+
+@pytest.mark.skipif(not ConfigVariableBool('garbage-collect-states').value,
+                    reason="requires garbage-collect-states")
+def test_transform_garbage_collect_budget():
+    a = TransformState.make_pos((3.5, 4.5, 5.5))
+
+    # Collect everything, so that our state is no longer a new one.
+    while TransformState.garbage_collect() > 0:
+        pass
+    del a
+
+    # Even with a budget that runs out immediately, every pass must make some
+    # progress through the older states.
+    budget = ConfigVariableDouble('garbage-collect-states-budget')
+    budget.set_value(1e-9)
+    try:
+        for i in range(TransformState.get_num_states() + 1):
+            TransformState.garbage_collect()
+    finally:
+        budget.clear_local_value()
+
+    assert not has_transform_with_pos((3.5, 4.5, 5.5))
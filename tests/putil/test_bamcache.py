@@ -1,4 +1,5 @@
 from panda3d import core
+import pytest
 
 
 def test_bamcache_flush_index():
@@ -6,3 +7,117 @@ def test_bamcache_flush_index():
     # consistently, and not intermittently, to avoid a noisy coverage report.
     cache = core.BamCache()
     cache.flush_index()
+
+
+def test_bamcache_journal(tmp_path):
+    root = core.Filename.from_os_specific(str(tmp_path / 'cache'))
+    source = core.Filename.from_os_specific(str(tmp_path / 'model.egg'))
+
+    cache1 = core.BamCache()
+    cache1.root = root
+    record = cache1.lookup(source, 'bam')
+    assert record is not None
+    assert not record.has_data()
+    record.set_data(core.PandaNode('model'))
+    assert cache1.store(record)
+    cache1.flush_index()
+
+    # The change should have been appended to the journal, rather than
+    # rewriting the index.
+    assert len(list((tmp_path / 'cache').glob('index-*.log'))) == 1
+
+    # Another cache sharing the same directory picks it up from the journal.
+    cache2 = core.BamCache()
+    cache2.root = root
+    stream = core.StringStream()
+    cache2.list_index(stream)
+    assert source.get_fullpath() in stream.data.decode()
+
+
+def store_model(cache, source):
+    record = cache.lookup(source, 'bam')
+    assert record is not None
+    record.set_data(core.PandaNode(source.get_basename()))
+    assert cache.store(record)
+
+
+def test_bamcache_journal_hit(tmp_path):
+    root = core.Filename.from_os_specific(str(tmp_path / 'cache'))
+    (tmp_path / 'model.egg').write_text('')
+    source = core.Filename.from_os_specific(str(tmp_path / 'model.egg'))
+
+    cache = core.BamCache()
+    cache.root = root
+    store_model(cache, source)
+    cache.flush_index()
+
+    journal, = (tmp_path / 'cache').glob('index-*.log')
+    size = journal.stat().st_size
+
+    # Merely finding the model in the cache doesn't need to be journaled.
+    record = cache.lookup(source, 'bam')
+    assert record is not None
+    assert record.has_data()
+    cache.flush_index()
+    assert journal.stat().st_size == size
+
+
+def test_bamcache_journal_compact(tmp_path):
+    journal_size = core.ConfigVariableInt('model-cache-journal-size')
+    journal_size.value = 2
+    try:
+        root = core.Filename.from_os_specific(str(tmp_path / 'cache'))
+        sources = []
+        for i in range(5):
+            (tmp_path / ('model%d.egg' % (i))).write_text('')
+            sources.append(core.Filename.from_os_specific(str(tmp_path / ('model%d.egg' % (i)))))
+
+        cache1 = core.BamCache()
+        cache1.root = root
+        cache2 = core.BamCache()
+        cache2.root = root
+
+        # Both caches append to the same journal, until one of them has to
+        # fold it into a new index.
+        for i, source in enumerate(sources):
+            cache = (cache1, cache2)[i % 2]
+            store_model(cache, source)
+            cache.flush_index()
+
+        assert (tmp_path / 'cache' / 'index.lock').exists()
+        assert len(list((tmp_path / 'cache').glob('index-*.boo'))) == 1
+
+        # None of the changes may have been lost in the process.
+        cache3 = core.BamCache()
+        cache3.root = root
+        stream = core.StringStream()
+        cache3.list_index(stream)
+        for source in sources:
+            assert source.get_fullpath() in stream.data.decode()
+    finally:
+        journal_size.clear_local_value()
+
+
+@pytest.mark.parametrize("algorithm", ["zlib", "lz4", "zstd"])
+def test_bamcache_compression(tmp_path, algorithm):
+    algorithm = getattr(core, 'CA_' + algorithm)
+    if not core.is_compression_algorithm_supported(algorithm):
+        pytest.skip("Compression algorithm not supported")
+
+    root = core.Filename.from_os_specific(str(tmp_path / 'cache'))
+    (tmp_path / 'model.egg').write_text('')
+    source = core.Filename.from_os_specific(str(tmp_path / 'model.egg'))
+
+    cache = core.BamCache()
+    cache.root = root
+    cache.compression = algorithm
+    store_model(cache, source)
+    cache.flush_index()
+
+    # A cache that doesn't compress can still read the compressed record.
+    cache = core.BamCache()
+    cache.root = root
+    record = cache.lookup(source, 'bam')
+    assert record is not None
+    assert record.has_data()
+    assert record.get_data().name == 'model.egg'